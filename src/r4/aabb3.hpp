@@ -0,0 +1,192 @@
+#pragma once
+
+#include <iostream>
+#include <limits>
+
+#include "config.hpp"
+#include "vector3.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief 3d axis-aligned bounding box.
+ * The box is defined by its minimal and maximal corner points.
+ * The box is empty if any component of the minimal point is greater than the corresponding component of the maximal point.
+ */
+template <class T> class aabb3{
+public:
+	/**
+	 * @brief Minimal corner point.
+	 */
+	vector3<T> p1;
+
+	/**
+	 * @brief Maximal corner point.
+	 */
+	vector3<T> p2;
+
+	/**
+	 * @brief Default constructor.
+	 * It does not initialize the box.
+	 */
+	constexpr aabb3() = default;
+
+	/**
+	 * @brief Constructor.
+	 * @param p1 - minimal corner point.
+	 * @param p2 - maximal corner point.
+	 */
+	constexpr aabb3(const vector3<T>& p1, const vector3<T>& p2)noexcept :
+			p1(p1),
+			p2(p2)
+	{}
+
+	/**
+	 * @brief Test boxes for equality.
+	 * @param b - box to test this box with.
+	 * @return true if minimal and maximal points of the boxes are equal.
+	 * @return false otherwise.
+	 */
+	constexpr bool operator==(const aabb3& b)const noexcept{
+		return this->p1 == b.p1 && this->p2 == b.p2;
+	}
+
+	/**
+	 * @brief Set this box to be empty.
+	 * Minimal point is set to maximal possible values and maximal point is set to
+	 * minimal possible values, so that uniting the empty box with any other box gives that other box.
+	 * @return reference to this box.
+	 */
+	constexpr aabb3& set_empty()noexcept{
+		typedef std::numeric_limits<T> limits;
+		this->p1 = vector3<T>(limits::max());
+		this->p2 = vector3<T>(limits::lowest());
+		return *this;
+	}
+
+	/**
+	 * @brief Check if the box is empty.
+	 * @return true if any component of minimal point is greater than corresponding component of maximal point.
+	 * @return false otherwise.
+	 */
+	constexpr bool is_empty()const noexcept{
+		return this->p1.x() > this->p2.x() || this->p1.y() > this->p2.y() || this->p1.z() > this->p2.z();
+	}
+
+	/**
+	 * @brief Get center point of the box.
+	 * @return center point of the box.
+	 */
+	constexpr vector3<T> center()const noexcept{
+		return (this->p1 + this->p2) / T(2);
+	}
+
+	/**
+	 * @brief Get dimensions of the box.
+	 * @return (width, height, depth) vector.
+	 */
+	constexpr vector3<T> dims()const noexcept{
+		return this->p2 - this->p1;
+	}
+
+	/**
+	 * @brief Get half-dimensions of the box.
+	 * @return vector from center point of the box to its maximal point.
+	 */
+	constexpr vector3<T> extent()const noexcept{
+		return this->dims() / T(2);
+	}
+
+	/**
+	 * @brief Extend this box to include the point.
+	 * @param p - point to include into the box.
+	 * @return reference to this box.
+	 */
+	constexpr aabb3& unite(const vector3<T>& p)noexcept{
+		this->p1 = min(this->p1, p);
+		this->p2 = max(this->p2, p);
+		return *this;
+	}
+
+	/**
+	 * @brief Unite this box with another one.
+	 * @param b - box to unite this box with.
+	 * @return reference to this box.
+	 */
+	constexpr aabb3& unite(const aabb3& b)noexcept{
+		this->p1 = min(this->p1, b.p1);
+		this->p2 = max(this->p2, b.p2);
+		return *this;
+	}
+
+	/**
+	 * @brief Intersect this box with another one.
+	 * If the boxes do not intersect, then the result is an empty box.
+	 * @param b - box to intersect this box with.
+	 * @return reference to this box.
+	 */
+	constexpr aabb3& intersect(const aabb3& b)noexcept{
+		this->p1 = max(this->p1, b.p1);
+		this->p2 = min(this->p2, b.p2);
+		return *this;
+	}
+
+	/**
+	 * @brief Test if the box contains the point.
+	 * Points on the box boundary are contained by the box.
+	 * @param p - point to test.
+	 * @return true if the box contains the point.
+	 * @return false otherwise.
+	 */
+	constexpr bool contains(const vector3<T>& p)const noexcept{
+		return
+				p.x() >= this->p1.x() && p.x() <= this->p2.x() &&
+				p.y() >= this->p1.y() && p.y() <= this->p2.y() &&
+				p.z() >= this->p1.z() && p.z() <= this->p2.z()
+			;
+	}
+
+	/**
+	 * @brief Test if this box overlaps another one.
+	 * Boxes touching by their boundaries overlap.
+	 * @param b - box to test.
+	 * @return true if the boxes have at least one common point.
+	 * @return false otherwise.
+	 */
+	constexpr bool overlaps(const aabb3& b)const noexcept{
+		return
+				this->p1.x() <= b.p2.x() && b.p1.x() <= this->p2.x() &&
+				this->p1.y() <= b.p2.y() && b.p1.y() <= this->p2.y() &&
+				this->p1.z() <= b.p2.z() && b.p1.z() <= this->p2.z()
+			;
+	}
+
+	/**
+	 * @brief Convert to aabb3 with different type of component.
+	 * @return converted aabb3.
+	 */
+	template <class TS> constexpr aabb3<TS> to()const noexcept{
+		return aabb3<TS>{
+				vector3<T>(this->p1).template to<TS>(),
+				vector3<T>(this->p2).template to<TS>()
+			};
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const aabb3<T>& b){
+		s << "[" << b.p1 << b.p2 << "]";
+		return s;
+	}
+};
+
+static_assert(sizeof(aabb3<float>) == sizeof(float) * 6, "size mismatch");
+static_assert(sizeof(aabb3<double>) == sizeof(double) * 6, "size mismatch");
+
+}
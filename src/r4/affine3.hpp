@@ -0,0 +1,655 @@
+#pragma once
+
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include <utki/debug.hpp>
+
+#include "config.hpp"
+
+#include "vector4.hpp"
+
+namespace r4{
+
+template <class T> class vector3;
+template <class T> class quaternion;
+template <class T> class matrix4;
+
+/**
+ * @brief 3x4 affine transformation matrix template class.
+ * This is the 3D counterpart of matrix2. The 3x4 matrix is thought of as it was 4x4 matrix with last row (0, 0, 0, 1),
+ * i.e. it is a combination of linear transformation given by the left 3x3 submatrix and translation given by the last column.
+ * Since the constant last row is neither stored nor multiplied, the affine transformations
+ * are composed, applied and inverted cheaper than with matrix4.
+ * Elements are stored in memory in row-major order.
+ */
+template <typename T> class affine3 : public std::array<vector4<T>, 3>{
+	typedef std::array<vector4<T>, 3> base_type;
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the matrix with any values.
+	 * Matrix elements are undefined after the matrix is created with this constructor.
+	 */
+	constexpr affine3() = default;
+
+	/**
+	 * @brief Construct initialized matrix.
+	 * Creates a matrix and initializes its rows with the given values.
+	 * @param row0 - 0th row of the matrix.
+	 * @param row1 - 1st row of the matrix.
+	 * @param row2 - 2nd row of the matrix.
+	 */
+	constexpr affine3(
+			const vector4<T>& row0,
+			const vector4<T>& row1,
+			const vector4<T>& row2
+		)noexcept :
+			base_type{{row0, row1, row2}}
+	{}
+
+	/**
+	 * @brief Construct from 4x4 matrix.
+	 * The matrix must be affine, i.e. its last row must be (0, 0, 0, 1).
+	 * The last row is dropped.
+	 * @param m - matrix to construct from.
+	 */
+	constexpr explicit affine3(const matrix4<T>& m)noexcept;
+
+	/**
+	 * @brief Construct rotation matrix.
+	 * Constructs matrix and initializes it to a rotation matrix from given unit quaternion.
+	 * @param quat - unit quaternion defining the rotation.
+	 */
+	constexpr affine3(const quaternion<T>& quat)noexcept;
+
+	constexpr affine3(const affine3&) = default;
+	affine3& operator=(const affine3&) = default;
+
+	/**
+	 * @brief Convert to different element type.
+	 * @return affine3 with converted element type.
+	 */
+	template <typename TT> constexpr affine3<TT> to()noexcept{
+		return affine3<TT>{
+				this->row(0).template to<TT>(),
+				this->row(1).template to<TT>(),
+				this->row(2).template to<TT>()
+			};
+	}
+
+	/**
+	 * @brief Convert to 4x4 matrix.
+	 * @return 4x4 matrix with (0, 0, 0, 1) as the last row.
+	 */
+	constexpr matrix4<T> to_matrix4()const noexcept;
+
+	/**
+	 * @brief Convert to 4x4 matrix.
+	 * Same as to_matrix4(), allows passing affine3 and products of affine matrix kinds where matrix4 is expected.
+	 * @return 4x4 matrix with (0, 0, 0, 1) as the last row.
+	 */
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Convert to quaternion.
+	 * The left 3x3 submatrix must be a rotation matrix, i.e. it must be orthonormal and have determinant of 1.
+	 * Translation is ignored.
+	 * @return unit quaternion representing the rotation.
+	 */
+	quaternion<T> to_quaternion()const noexcept;
+
+	/**
+	 * @brief Subtract matrix from this matrix.
+	 * @param m - matrix to subtract from this matrix.
+	 * @return resulting matrix of the subtraction.
+	 */
+	constexpr affine3 operator-(const affine3& m)const noexcept{
+		return {
+				this->row(0) - m.row(0),
+				this->row(1) - m.row(1),
+				this->row(2) - m.row(2)
+			};
+	}
+
+	/**
+	 * @brief Transform point by matrix.
+	 * Multiply vector V by this matrix M from the right (M * V).
+	 * The vector3 to transform is thought of as it was vector4 with w component set to 1,
+	 * so the point is transformed by the linear transformation and translated.
+	 * @param vec - point to transform.
+	 * @return Transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& vec)const noexcept;
+
+	/**
+	 * @brief Transform direction vector by matrix.
+	 * The vector is transformed by the linear transformation given by the left 3x3 submatrix,
+	 * translation is not applied, i.e. the vector3 is thought of as it was vector4 with w component set to 0.
+	 * @param vec - direction vector to transform.
+	 * @return Transformed direction vector.
+	 */
+	constexpr vector3<T> transform_direction(const vector3<T>& vec)const noexcept;
+
+	/**
+	 * @brief Transform array of points by matrix.
+	 * Same as operator*(const vector3<T>&) applied to each point of the array,
+	 * but with matrix elements loaded only once.
+	 * @param src - pointer to the first point to transform.
+	 * @param dst - pointer to where to store the first transformed point. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of points to transform.
+	 */
+	void transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform array of points by matrix in-place.
+	 * @param points - pointer to the first point to transform.
+	 * @param size - number of points to transform.
+	 */
+	void transform_points(vector3<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Get matrix row.
+	 * @param index - row index to get, must be from 0 to 2.
+	 * @return reference to vector4 representing the row of this matrix.
+	 */
+	constexpr vector4<T>& row(unsigned index)noexcept{
+		R4_ASSERT(index < 3);
+		return this->operator[](index);
+	}
+
+	/**
+	 * @brief Get constant matrix row.
+	 * @param index - row index to get, must be from 0 to 2.
+	 * @return constant reference to vector4 representing the row of this matrix.
+	 */
+	constexpr const vector4<T>& row(unsigned index)const noexcept{
+		R4_ASSERT(index < 3);
+		return this->operator[](index);
+	}
+
+	/**
+	 * @brief Get matrix column.
+	 * Constructs and returns a vector3 representing the requested matrix column.
+	 * The 3rd column is the translation.
+	 * @param index - column index to get, must be from 0 to 3;
+	 * @return vector3 representing the requested matrix column.
+	 */
+	constexpr vector3<T> col(unsigned index)const noexcept;
+
+	/**
+	 * @brief Multiply by matrix from the right.
+	 * Calculate result of this matrix M multiplied by another matrix K from the right (M * K).
+	 * Before the operation, both matrices are implicitly converted to matrix4 with last added row to be (0, 0, 0, 1).
+	 * Each row of the result is a linear combination of the rows of K, which takes 36 multiplications
+	 * instead of 64 needed for matrix4 product.
+	 * @param matr - matrix to multiply by (matrix K).
+	 * @return New matrix as a result of matrices product.
+	 */
+	constexpr affine3 operator*(const affine3& matr)const noexcept{
+		affine3 ret{};
+		for(unsigned r = 0; r != ret.size(); ++r){
+			const auto& m = this->row(r);
+			ret[r] = matr.row(0) * m[0] + matr.row(1) * m[1] + matr.row(2) * m[2];
+			ret[r][3] += m[3];
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Multiply by matrix from the right.
+	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& operator*=(const affine3& matr)noexcept{
+		return this->operator=(this->operator*(matr));
+	}
+
+	/**
+	 * @brief Multiply by matrix from the right.
+	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
+	 * This is the same as operator*=().
+	 * @param matr - matrix to multiply by.
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& right_mul(const affine3& matr)noexcept{
+		return this->operator*=(matr);
+	}
+
+	/**
+	 * @brief Multiply by matrix from the left.
+	 * Multiply this matrix M by another matrix K from the left (M  = K * M).
+	 * @param matr - matrix to multiply by.
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& left_mul(const affine3& matr)noexcept{
+		return this->operator=(matr.operator*(*this));
+	}
+
+	/**
+	 * @brief Multiply matrix4 by this matrix from the right.
+	 * Multiply matrix M by this matrix A from the right (M = M * A).
+	 * Takes 36 multiplications instead of 64 needed for matrix4 product.
+	 * @param m - matrix to multiply (matrix M).
+	 */
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept;
+
+	/**
+	 * @brief Multiply matrix4 by this matrix from the left.
+	 * Multiply matrix M by this matrix A from the left (M = A * M).
+	 * Takes 48 multiplications instead of 64 needed for matrix4 product.
+	 * @param m - matrix to multiply (matrix M).
+	 */
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept;
+
+	/**
+	 * @brief Initialize this matrix with identity matrix.
+	 */
+	constexpr affine3& set_identity()noexcept{
+		this->row(0) = {1, 0, 0, 0};
+		this->row(1) = {0, 1, 0, 0};
+		this->row(2) = {0, 0, 1, 0};
+		return *this;
+	}
+
+	/**
+	 * @brief Set each element of this matrix to a given number.
+	 * @param num - number to set each matrix element to.
+	 */
+	constexpr affine3& set(T num)noexcept{
+		for(auto& e : *this){
+			e.set(num);
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Set this matrix to be a rotation matrix.
+	 * Sets this matrix to a matrix representing a rotation defined by a unit quaternion.
+	 * Translation is set to 0.
+	 * @param quat - unit quaternion defining the rotation.
+	 * @return Reference to this matrix object.
+	 */
+	constexpr affine3& set(const quaternion<T>& quat)noexcept;
+
+	/**
+	 * @brief Multiply current matrix by scale matrix.
+	 * Multiplies this matrix M by scale matrix S from the right (M = M * S).
+	 * @param x - scaling factor in x direction.
+	 * @param y - scaling factor in y direction.
+	 * @param z - scaling factor in z direction.
+	 * @return reference to this matrix instance.
+	 */
+	constexpr affine3& scale(T x, T y, T z)noexcept{
+		for(auto& r : *this){
+			r[0] *= x;
+			r[1] *= y;
+			r[2] *= z;
+		}
+
+		// NOTE: 3rd column remains unchanged
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply current matrix by scale matrix.
+	 * Multiplies this matrix M by scale matrix S from the right (M = M * S).
+	 * @param s - scaling factor to be applied in all 3 directions (x, y and z).
+	 * @return reference to this matrix instance.
+	 */
+	constexpr affine3& scale(T s)noexcept{
+		return this->scale(s, s, s);
+	}
+
+	/**
+	 * @brief Multiply current matrix by scale matrix.
+	 * Multiplies this matrix M by scale matrix S from the right (M = M * S).
+	 * @param s - vector of scaling factors in x, y and z directions.
+	 * @return reference to this matrix instance.
+	 */
+	constexpr affine3& scale(const vector3<T>& s)noexcept;
+
+	/**
+	 * @brief Multiply this matrix by translation matrix.
+	 * Multiplies this matrix M by translation matrix T from the right (M = M * T).
+	 * @param x - x component of translation vector.
+	 * @param y - y component of translation vector.
+	 * @param z - z component of translation vector.
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& translate(T x, T y, T z)noexcept{
+		// NOTE: 0th, 1st and 2nd columns remain unchanged
+
+		// calculate 3rd column
+		for(auto& r : *this){
+			r[3] += r[0] * x + r[1] * y + r[2] * z;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply this matrix by translation matrix.
+	 * Multiplies this matrix M by translation matrix T from the right (M = M * T).
+	 * @param t - translation vector.
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& translate(const vector3<T>& t)noexcept;
+
+	/**
+	 * @brief Multiply this matrix by rotation matrix.
+	 * Multiplies this matrix M by rotation matrix R from the right (M = M * R).
+	 * @param q - unit quaternion, representing the rotation.
+	 * @return reference to this matrix object.
+	 */
+	constexpr affine3& rotate(const quaternion<T>& q)noexcept;
+
+	/**
+	 * @brief Calculate matrix determinant.
+	 * The determinant of the affine transformation is the determinant of its left 3x3 submatrix.
+	 * @return matrix determinant.
+	 */
+	constexpr T det()const noexcept{
+		const auto& r0 = this->row(0);
+		const auto& r1 = this->row(1);
+		const auto& r2 = this->row(2);
+		return r0[0] * (r1[1] * r2[2] - r1[2] * r2[1])
+				- r0[1] * (r1[0] * r2[2] - r1[2] * r2[0])
+				+ r0[2] * (r1[0] * r2[1] - r1[1] * r2[0]);
+	}
+
+	/**
+	 * @brief Calculate inverse of the matrix.
+	 * Only the left 3x3 submatrix is inverted, the inverse translation is
+	 * the negated translation transformed by the inverted submatrix.
+	 * The matrix must not be singular, i.e. its determinant must not be 0.
+	 * @return inverse matrix of this matrix.
+	 */
+	constexpr affine3 inv()const noexcept;
+
+	/**
+	 * @brief Invert this matrix.
+	 * @return reference to this matrix.
+	 */
+	constexpr affine3& invert()noexcept{
+		this->operator=(this->inv());
+		return *this;
+	}
+
+	/**
+	 * @brief Calculate inverse of rigid transformation matrix.
+	 * The left 3x3 submatrix must be a rotation matrix. The inverse of such matrix is
+	 * calculated by transposing the rotation submatrix and rotating the negated translation by it.
+	 * No scaling or shearing is allowed, for those use inv().
+	 * @return inverse matrix of this matrix.
+	 */
+	constexpr affine3 rigid_inv()const noexcept;
+
+	/**
+	 * @brief Snap each matrix component to 0.
+	 * For each component, set it to 0 if its absolute value does not exceed the given threshold.
+	 * @param threshold - the snapping threshold.
+	 * @return reference to this matrix.
+	 */
+	affine3& snap_to_zero(T threshold)noexcept{
+		for(auto& e : *this){
+			e.snap_to_zero(threshold);
+		}
+		return *this;
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const affine3<T>& mat){
+		s << "\n";
+		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << " " << mat[0][3] << "\\" << "\n";
+		s << "\t|" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << " " << mat[1][3] << "|" << "\n";
+		s << "\t\\" << mat[2][0] << " " << mat[2][1] << " " << mat[2][2] << " " << mat[2][3] << "/";
+		return s;
+	};
+};
+
+}
+
+#include "vector3.hpp"
+#include "quaternion.hpp"
+#include "matrix4.hpp"
+
+namespace r4{
+
+template <class T> constexpr affine3<T>::affine3(const matrix4<T>& m)noexcept :
+		base_type{{m[0], m[1], m[2]}}
+{
+	R4_ASSERT(m[3][0] == 0 && m[3][1] == 0 && m[3][2] == 0 && m[3][3] == 1);
+}
+
+template <class T> constexpr affine3<T>::affine3(const quaternion<T>& quat)noexcept :
+		base_type{}
+{
+	this->set(quat);
+}
+
+template <class T> constexpr matrix4<T> affine3<T>::to_matrix4()const noexcept{
+	return matrix4<T>(
+			this->row(0),
+			this->row(1),
+			this->row(2),
+			vector4<T>(0, 0, 0, 1)
+		);
+}
+
+template <class T> constexpr void affine3<T>::right_mul_to(matrix4<T>& m)const noexcept{
+	for(auto& r : m){
+		auto w = r[3];
+		r = this->row(0) * r[0] + this->row(1) * r[1] + this->row(2) * r[2];
+		r[3] += w;
+	}
+}
+
+template <class T> constexpr void affine3<T>::left_mul_to(matrix4<T>& m)const noexcept{
+	auto r0 = m[0];
+	auto r1 = m[1];
+	auto r2 = m[2];
+	for(unsigned i = 0; i != 3; ++i){
+		const auto& a = this->row(i);
+		m[i] = r0 * a[0] + r1 * a[1] + r2 * a[2] + m[3] * a[3];
+	}
+}
+
+template <class T> quaternion<T> affine3<T>::to_quaternion()const noexcept{
+	// Shepperd's method, to avoid loss of precision the quaternion component with
+	// largest absolute value is found first from the diagonal, then the rest are found from it.
+	using std::sqrt;
+
+	const auto& r0 = this->row(0);
+	const auto& r1 = this->row(1);
+	const auto& r2 = this->row(2);
+
+	T trace = r0[0] + r1[1] + r2[2];
+
+	if(trace > 0){
+		T s = sqrt(trace + T(1)) * T(2); // s = 4 * w
+		return quaternion<T>(
+				(r2[1] - r1[2]) / s,
+				(r0[2] - r2[0]) / s,
+				(r1[0] - r0[1]) / s,
+				s / T(4)
+			);
+	}else if(r0[0] > r1[1] && r0[0] > r2[2]){
+		T s = sqrt(T(1) + r0[0] - r1[1] - r2[2]) * T(2); // s = 4 * x
+		return quaternion<T>(
+				s / T(4),
+				(r0[1] + r1[0]) / s,
+				(r0[2] + r2[0]) / s,
+				(r2[1] - r1[2]) / s
+			);
+	}else if(r1[1] > r2[2]){
+		T s = sqrt(T(1) + r1[1] - r0[0] - r2[2]) * T(2); // s = 4 * y
+		return quaternion<T>(
+				(r0[1] + r1[0]) / s,
+				s / T(4),
+				(r1[2] + r2[1]) / s,
+				(r0[2] - r2[0]) / s
+			);
+	}
+
+	T s = sqrt(T(1) + r2[2] - r0[0] - r1[1]) * T(2); // s = 4 * z
+	return quaternion<T>(
+			(r0[2] + r2[0]) / s,
+			(r1[2] + r2[1]) / s,
+			s / T(4),
+			(r1[0] - r0[1]) / s
+		);
+}
+
+template <class T> constexpr vector3<T> affine3<T>::operator*(const vector3<T>& vec)const noexcept{
+	return vector3<T>(
+			this->row(0)[0] * vec[0] + this->row(0)[1] * vec[1] + this->row(0)[2] * vec[2] + this->row(0)[3],
+			this->row(1)[0] * vec[0] + this->row(1)[1] * vec[1] + this->row(1)[2] * vec[2] + this->row(1)[3],
+			this->row(2)[0] * vec[0] + this->row(2)[1] * vec[1] + this->row(2)[2] * vec[2] + this->row(2)[3]
+		);
+}
+
+template <class T> constexpr vector3<T> affine3<T>::transform_direction(const vector3<T>& vec)const noexcept{
+	return vector3<T>(
+			this->row(0)[0] * vec[0] + this->row(0)[1] * vec[1] + this->row(0)[2] * vec[2],
+			this->row(1)[0] * vec[0] + this->row(1)[1] * vec[1] + this->row(1)[2] * vec[2],
+			this->row(2)[0] * vec[0] + this->row(2)[1] * vec[1] + this->row(2)[2] * vec[2]
+		);
+}
+
+template <class T> void affine3<T>::transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept{
+	// copy matrix elements to locals, so that the compiler does not have to reload them
+	// in case dst aliases the matrix
+	const T m00 = this->row(0)[0], m01 = this->row(0)[1], m02 = this->row(0)[2], m03 = this->row(0)[3];
+	const T m10 = this->row(1)[0], m11 = this->row(1)[1], m12 = this->row(1)[2], m13 = this->row(1)[3];
+	const T m20 = this->row(2)[0], m21 = this->row(2)[1], m22 = this->row(2)[2], m23 = this->row(2)[3];
+
+	for(const vector3<T>* end = src + size; src != end; ++src, ++dst){
+		T x = (*src)[0];
+		T y = (*src)[1];
+		T z = (*src)[2];
+		(*dst)[0] = m00 * x + m01 * y + m02 * z + m03;
+		(*dst)[1] = m10 * x + m11 * y + m12 * z + m13;
+		(*dst)[2] = m20 * x + m21 * y + m22 * z + m23;
+	}
+}
+
+template <class T> constexpr vector3<T> affine3<T>::col(unsigned index)const noexcept{
+	return vector3<T>{
+			this->row(0)[index],
+			this->row(1)[index],
+			this->row(2)[index]
+		};
+}
+
+template <class T> constexpr affine3<T>& affine3<T>::set(const quaternion<T>& quat)noexcept{
+	// see matrix4::set(quaternion)
+
+	this->row(0)[0] = T(1) - T(2) * (utki::pow2(quat.y()) + utki::pow2(quat.z()));
+	this->row(1)[0] = T(2) * (quat.x() * quat.y() + quat.z() * quat.w());
+	this->row(2)[0] = T(2) * (quat.x() * quat.z() - quat.y() * quat.w());
+
+	this->row(0)[1] = T(2) * (quat.x() * quat.y() - quat.z() * quat.w());
+	this->row(1)[1] = T(1) - T(2) * (utki::pow2(quat.x()) + utki::pow2(quat.z()));
+	this->row(2)[1] = T(2) * (quat.z() * quat.y() + quat.x() * quat.w());
+
+	this->row(0)[2] = T(2) * (quat.x() * quat.z() + quat.y() * quat.w());
+	this->row(1)[2] = T(2) * (quat.y() * quat.z() - quat.x() * quat.w());
+	this->row(2)[2] = T(1) - T(2) * (utki::pow2(quat.x()) + utki::pow2(quat.y()));
+
+	this->row(0)[3] = T(0);
+	this->row(1)[3] = T(0);
+	this->row(2)[3] = T(0);
+
+	return *this;
+}
+
+template <class T> constexpr affine3<T>& affine3<T>::scale(const vector3<T>& s)noexcept{
+	return this->scale(s.x(), s.y(), s.z());
+}
+
+template <class T> constexpr affine3<T>& affine3<T>::translate(const vector3<T>& t)noexcept{
+	return this->translate(t.x(), t.y(), t.z());
+}
+
+template <class T> constexpr affine3<T>& affine3<T>::rotate(const quaternion<T>& q)noexcept{
+	// rotation does not change the translation, only the left 3x3 submatrix is multiplied
+	affine3<T> r(q);
+	for(auto& row : *this){
+		T x = row[0];
+		T y = row[1];
+		T z = row[2];
+		row[0] = x * r[0][0] + y * r[1][0] + z * r[2][0];
+		row[1] = x * r[0][1] + y * r[1][1] + z * r[2][1];
+		row[2] = x * r[0][2] + y * r[1][2] + z * r[2][2];
+	}
+	return *this;
+}
+
+template <class T> constexpr affine3<T> affine3<T>::inv()const noexcept{
+	const auto& r0 = this->row(0);
+	const auto& r1 = this->row(1);
+	const auto& r2 = this->row(2);
+
+	// cofactors of the left 3x3 submatrix
+	T c00 = r1[1] * r2[2] - r1[2] * r2[1];
+	T c01 = r1[2] * r2[0] - r1[0] * r2[2];
+	T c02 = r1[0] * r2[1] - r1[1] * r2[0];
+
+	T d = r0[0] * c00 + r0[1] * c01 + r0[2] * c02;
+	R4_ASSERT_INFO(d != 0, "affine3::inv(): matrix is singular");
+
+	// Multiplying by 1 / d is cheaper than dividing each element by d,
+	// but for integer types 1 / d truncates to 0 or 1, so the elements are divided by d.
+	T inv_d = std::is_integral<T>::value ? T(1) : T(1) / d;
+	auto div_d = [d, inv_d](T v){
+		if constexpr(std::is_integral<T>::value){
+			return T(v / d);
+		}else{
+			return T(v * inv_d);
+		}
+	};
+
+	// inverse of the 3x3 submatrix is its transposed matrix of cofactors divided by determinant
+	T i00 = div_d(c00);
+	T i01 = div_d(r0[2] * r2[1] - r0[1] * r2[2]);
+	T i02 = div_d(r0[1] * r1[2] - r0[2] * r1[1]);
+	T i10 = div_d(c01);
+	T i11 = div_d(r0[0] * r2[2] - r0[2] * r2[0]);
+	T i12 = div_d(r0[2] * r1[0] - r0[0] * r1[2]);
+	T i20 = div_d(c02);
+	T i21 = div_d(r0[1] * r2[0] - r0[0] * r2[1]);
+	T i22 = div_d(r0[0] * r1[1] - r0[1] * r1[0]);
+
+	// inverse translation is -(M^-1 * t)
+	return affine3<T>(
+			vector4<T>(i00, i01, i02, -(i00 * r0[3] + i01 * r1[3] + i02 * r2[3])),
+			vector4<T>(i10, i11, i12, -(i10 * r0[3] + i11 * r1[3] + i12 * r2[3])),
+			vector4<T>(i20, i21, i22, -(i20 * r0[3] + i21 * r1[3] + i22 * r2[3]))
+		);
+}
+
+template <class T> constexpr affine3<T> affine3<T>::rigid_inv()const noexcept{
+	affine3<T> ret{};
+	for(unsigned r = 0; r != ret.size(); ++r){
+		// inverse of rotation is its transpose
+		for(unsigned c = 0; c != 3; ++c){
+			ret[r][c] = this->row(c)[r];
+		}
+		// inverse translation is -(R^T * t)
+		ret[r][3] = -(ret[r][0] * this->row(0)[3] + ret[r][1] * this->row(1)[3] + ret[r][2] * this->row(2)[3]);
+	}
+	return ret;
+}
+
+static_assert(sizeof(affine3<float>) == sizeof(float) * 3 * 4, "size mismatch");
+static_assert(sizeof(affine3<double>) == sizeof(double) * 3 * 4, "size mismatch");
+
+}
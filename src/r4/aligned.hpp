@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "aligned_allocator.hpp"
+
+namespace r4{
+
+/**
+ * @brief Size of CPU cache line in bytes.
+ * Objects aligned to this boundary and not larger than it never straddle cache lines.
+ */
+constexpr size_t cache_line_size = 64;
+
+/**
+ * @brief Over-aligned variant of a type.
+ * Wraps the type so that objects of the wrapper are aligned to the given boundary.
+ * The wrapper derives from the wrapped type and inherits all of its constructors, so it is used
+ * in place of the wrapped type, e.g. aligned<matrix4<float>, 64> is a matrix4<float> which always starts at
+ * a cache line boundary, and aligned<vector4<float>> can be loaded into a SIMD register with an aligned load.
+ * Note, that sizeof() of the wrapper is rounded up to the alignment, so arrays of wrapped objects
+ * may have padding between the objects, e.g. aligned<vector3<float>> is 16 bytes long.
+ * Objects of the wrapper are aligned when created on stack, as members of other objects and in
+ * containers which use aligned_allocator, see aligned_vector.
+ * @param T - type to wrap.
+ * @param alignment - alignment boundary in bytes, must be a power of 2 and not less than natural alignment of T.
+ */
+template <class T, size_t alignment = 16> class alignas(alignment) aligned : public T{
+	static_assert(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of 2");
+	static_assert(alignment >= alignof(T), "alignment must not be less than natural alignment of the type");
+public:
+	using T::T;
+
+	/**
+	 * @brief Default constructor.
+	 * Default-initializes the wrapped object.
+	 */
+	constexpr aligned() = default;
+
+	/**
+	 * @brief Construct from the wrapped type.
+	 * Allows assigning results of the wrapped type operations to the aligned object.
+	 * @param v - value to initialize the wrapped object with.
+	 */
+	constexpr aligned(const T& v)noexcept :
+			T(v)
+	{}
+
+	/**
+	 * @brief Get reference to the wrapped object.
+	 * @return reference to the wrapped object.
+	 */
+	constexpr T& get()noexcept{
+		return *this;
+	}
+
+	/**
+	 * @brief Get constant reference to the wrapped object.
+	 * @return constant reference to the wrapped object.
+	 */
+	constexpr const T& get()const noexcept{
+		return *this;
+	}
+};
+
+/**
+ * @brief std::vector of over-aligned objects.
+ * Vector of aligned<T, alignment> whose storage is allocated with aligned_allocator,
+ * so that every element of the vector is aligned to the given boundary.
+ * @param T - type of the elements.
+ * @param alignment - alignment boundary in bytes.
+ */
+template <class T, size_t alignment = 16> using aligned_vector = std::vector<aligned<T, alignment>, aligned_allocator<aligned<T, alignment>, alignment>>;
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <limits>
+
+namespace r4{
+
+/**
+ * @brief Allocator of aligned memory.
+ * Standard library compatible allocator which allocates memory blocks aligned to the given boundary.
+ * Useful for containers of elements which are to be accessed with aligned SIMD loads and stores.
+ * @param T - type of elements.
+ * @param alignment - alignment boundary in bytes, must be a power of 2.
+ */
+template <class T, size_t alignment = 32> class aligned_allocator{
+	static_assert(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of 2");
+	static_assert(alignment >= alignof(T), "alignment must not be less than natural alignment of the type");
+public:
+	typedef T value_type;
+
+	template <class U> struct rebind{
+		typedef aligned_allocator<U, alignment> other;
+	};
+
+	constexpr aligned_allocator()noexcept = default;
+
+	template <class U> constexpr aligned_allocator(const aligned_allocator<U, alignment>&)noexcept{}
+
+	/**
+	 * @brief Allocate aligned memory block.
+	 * @param n - number of elements to allocate memory for.
+	 * @return pointer to the allocated memory block, aligned to the alignment boundary.
+	 * @throw std::bad_alloc - in case of failure.
+	 */
+	T* allocate(size_t n){
+		if(n > std::numeric_limits<size_t>::max() / sizeof(T)){
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+	}
+
+	/**
+	 * @brief Free memory block.
+	 * @param p - pointer to the memory block previously returned by allocate().
+	 * @param n - number of elements the memory block was allocated for.
+	 */
+	void deallocate(T* p, size_t)noexcept{
+		::operator delete(p, std::align_val_t(alignment));
+	}
+
+	template <class U> bool operator==(const aligned_allocator<U, alignment>&)const noexcept{
+		return true;
+	}
+
+	template <class U> bool operator!=(const aligned_allocator<U, alignment>&)const noexcept{
+		return false;
+	}
+};
+
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "matrix2.hpp"
+#include "matrix3.hpp"
+#include "matrix4.hpp"
+#include "quaternion.hpp"
+#include "dual_quaternion.hpp"
+#include "affine3.hpp"
+#include "rectangle.hpp"
+#include "segment2.hpp"
+#include "aabb3.hpp"
+#include "half.hpp"
+
+// The binary layout is defined as little-endian, it matches the in-memory layout of r4 types
+// only on little-endian platforms, so that arrays can be used in place without conversion.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#	error "r4 binary layout is not supported on big-endian platforms"
+#endif
+
+namespace r4{
+
+/**
+ * @brief Binary type identification of r4 types.
+ * Each type which can be stored in binary layout has a unique type id, which is stored in the binary header
+ * and checked when the data is read back. The lower 8 bits of the id identify the scalar type
+ * and the higher bits identify the kind of the object, e.g. vector3 or matrix4.
+ * The ids are part of the binary layout and must never change.
+ * Binary layout of an object is the sequence of its scalar components in little-endian byte order
+ * in the same order as they are stored in memory, i.e. x, y, z, w for vectors and quaternions,
+ * rows for matrices, position and dimensions for rectangle, first and second points for segment2 and aabb3.
+ * @param T - type to get binary type id of.
+ */
+template <class T> struct binary_traits;
+
+template <> struct binary_traits<float>{
+	static constexpr uint32_t type_id = 1;
+};
+
+template <> struct binary_traits<double>{
+	static constexpr uint32_t type_id = 2;
+};
+
+template <> struct binary_traits<int32_t>{
+	static constexpr uint32_t type_id = 3;
+};
+
+template <> struct binary_traits<half>{
+	static constexpr uint32_t type_id = 4;
+};
+
+template <class T> struct binary_traits<vector2<T>>{
+	static constexpr uint32_t type_id = (1 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<vector3<T>>{
+	static constexpr uint32_t type_id = (2 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<vector4<T>>{
+	static constexpr uint32_t type_id = (3 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<quaternion<T>>{
+	static constexpr uint32_t type_id = (4 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<dual_quaternion<T>>{
+	static constexpr uint32_t type_id = (5 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<matrix2<T>>{
+	static constexpr uint32_t type_id = (6 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<matrix3<T>>{
+	static constexpr uint32_t type_id = (7 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<matrix4<T>>{
+	static constexpr uint32_t type_id = (8 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<affine3<T>>{
+	static constexpr uint32_t type_id = (9 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<rectangle<T>>{
+	static constexpr uint32_t type_id = (10 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<segment2<T>>{
+	static constexpr uint32_t type_id = (11 << 8) | binary_traits<T>::type_id;
+};
+
+template <class T> struct binary_traits<aabb3<T>>{
+	static constexpr uint32_t type_id = (12 << 8) | binary_traits<T>::type_id;
+};
+
+/**
+ * @brief Header of binary array.
+ * Binary array consists of the header followed by padding up to data_offset, followed by count objects.
+ * All header fields are little-endian.
+ */
+struct binary_header{
+	/**
+	 * @brief Magic number identifying r4 binary array, the "r4ba" characters.
+	 */
+	static constexpr uint32_t magic_value = uint32_t('r') | (uint32_t('4') << 8) | (uint32_t('b') << 16) | (uint32_t('a') << 24);
+
+	/**
+	 * @brief Current version of the binary layout.
+	 */
+	static constexpr uint32_t version_value = 1;
+
+	/**
+	 * @brief Offset of the data from the beginning of the header.
+	 * The data is aligned to cache line size, so it is properly aligned for any r4 type when the header
+	 * is at page boundary, as it is for memory-mapped files.
+	 */
+	static constexpr uint64_t data_alignment = 64;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t type_id;
+	uint32_t element_size;
+	uint64_t count;
+	uint64_t data_offset;
+
+	/**
+	 * @brief Create header for array of objects.
+	 * @param count - number of objects in the array.
+	 * @return header.
+	 */
+	template <class T> static binary_header make(size_t count)noexcept{
+		binary_header h;
+		h.magic = magic_value;
+		h.version = version_value;
+		h.type_id = binary_traits<T>::type_id;
+		h.element_size = uint32_t(sizeof(T));
+		h.count = count;
+		h.data_offset = data_alignment;
+		return h;
+	}
+
+	/**
+	 * @brief Validate the header.
+	 * Checks that the header describes array of objects of the given type which fits into the given number of bytes.
+	 * @param size - size of the binary array including the header in bytes,
+	 *               or max value of size_t if the size is unknown, as it is when reading from stream.
+	 * @throw std::invalid_argument - in case the header is invalid or the array does not fit into the given size.
+	 */
+	template <class T> void validate(size_t size)const{
+		if(this->magic != magic_value){
+			throw std::invalid_argument("r4 binary: bad magic number");
+		}
+		if(this->version != version_value){
+			throw std::invalid_argument("r4 binary: unsupported version " + std::to_string(this->version));
+		}
+		if(this->type_id != binary_traits<T>::type_id || this->element_size != sizeof(T)){
+			throw std::invalid_argument("r4 binary: type mismatch");
+		}
+		if(this->data_offset < sizeof(binary_header) || this->data_offset % alignof(T) != 0){
+			throw std::invalid_argument("r4 binary: bad data offset");
+		}
+		if(this->data_offset > size || this->count > (size - this->data_offset) / sizeof(T)){
+			throw std::invalid_argument("r4 binary: data is truncated");
+		}
+	}
+};
+
+static_assert(sizeof(binary_header) == 32, "size mismatch");
+static_assert(std::is_trivially_copyable<binary_header>::value, "binary_header must be trivially copyable");
+
+/**
+ * @brief Get size of binary array.
+ * @param count - number of objects in the array.
+ * @return size of the binary array of the given number of objects in bytes, including the header.
+ */
+template <class T> size_t binary_size(size_t count)noexcept{
+	return size_t(binary_header::data_alignment) + count * sizeof(T);
+}
+
+/**
+ * @brief Write array of objects in binary layout to memory.
+ * @param dst - memory to write the binary array to, must have space for at least binary_size<T>(count) bytes.
+ * @param data - objects to write.
+ * @param count - number of objects to write.
+ */
+template <class T> void write_binary(void* dst, const T* data, size_t count)noexcept{
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+	auto p = static_cast<uint8_t*>(dst);
+	auto h = binary_header::make<T>(count);
+	std::memcpy(p, &h, sizeof(h));
+	std::memset(p + sizeof(h), 0, size_t(h.data_offset) - sizeof(h));
+	if(count != 0){
+		std::memcpy(p + h.data_offset, data, count * sizeof(T));
+	}
+}
+
+/**
+ * @brief Write array of objects in binary layout to stream.
+ * @param o - stream to write the binary array to, should be opened in binary mode.
+ * @param data - objects to write.
+ * @param count - number of objects to write.
+ * @throw std::runtime_error - in case writing to the stream fails.
+ */
+template <class T> void write_binary(std::ostream& o, const T* data, size_t count){
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+	auto h = binary_header::make<T>(count);
+	const char padding[binary_header::data_alignment - sizeof(h)] = {0};
+	o.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	o.write(padding, sizeof(padding));
+	o.write(reinterpret_cast<const char*>(data), std::streamsize(count * sizeof(T)));
+	if(!o){
+		throw std::runtime_error("r4 binary: writing to stream failed");
+	}
+}
+
+/**
+ * @brief Read array of objects in binary layout from stream.
+ * The objects are copied from the stream, for reading without copying use binary_view on memory-mapped file.
+ * @param i - stream to read the binary array from, should be opened in binary mode.
+ * @return the objects read.
+ * @throw std::invalid_argument - in case the binary array header is invalid.
+ * @throw std::runtime_error - in case reading from the stream fails.
+ */
+template <class T> std::vector<T> read_binary(std::istream& i){
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+	binary_header h;
+	if(!i.read(reinterpret_cast<char*>(&h), sizeof(h))){
+		throw std::runtime_error("r4 binary: reading header from stream failed");
+	}
+	h.validate<T>(std::numeric_limits<size_t>::max());
+
+	if(!i.ignore(std::streamsize(h.data_offset - sizeof(h)))){
+		throw std::runtime_error("r4 binary: reading from stream failed");
+	}
+
+	std::vector<T> ret;
+	// read in chunks, so that corrupted count does not lead to huge allocation before the data is actually read
+	const size_t chunk_size = (size_t(1) << 20) / sizeof(T) + 1;
+	for(size_t n = 0; n != h.count;){
+		size_t m = std::min(size_t(h.count - n), chunk_size);
+		ret.resize(n + m);
+		if(!i.read(reinterpret_cast<char*>(ret.data() + n), std::streamsize(m * sizeof(T)))){
+			throw std::runtime_error("r4 binary: data is truncated");
+		}
+		n += m;
+	}
+	return ret;
+}
+
+/**
+ * @brief View of binary array in memory.
+ * Provides access to objects of binary array without copying or parsing them.
+ * Typically used on memory-mapped files, see mapped_file, in which case loading of large arrays
+ * costs only the header validation and the pages of the file are read by the OS as they are accessed.
+ * The view does not own the memory, the memory must outlive the view.
+ * @param T - type of objects in the array.
+ */
+template <class T> class binary_view{
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+	const T* ptr = nullptr;
+	size_t num = 0;
+public:
+	typedef T value_type;
+	typedef const T* const_iterator;
+
+	/**
+	 * @brief Construct empty view.
+	 */
+	binary_view() = default;
+
+	/**
+	 * @brief Construct view of binary array in memory.
+	 * Validates the binary array header, the array size and alignment of the data.
+	 * @param buffer - memory holding the binary array.
+	 * @param size - size of the memory in bytes.
+	 * @throw std::invalid_argument - in case the binary array is invalid, truncated or the data is not aligned for T.
+	 */
+	binary_view(const void* buffer, size_t size){
+		if(size < sizeof(binary_header)){
+			throw std::invalid_argument("r4 binary: header is truncated");
+		}
+		binary_header h;
+		std::memcpy(&h, buffer, sizeof(h));
+		h.validate<T>(size);
+
+		auto data = static_cast<const uint8_t*>(buffer) + h.data_offset;
+		if(reinterpret_cast<uintptr_t>(data) % alignof(T) != 0){
+			throw std::invalid_argument("r4 binary: data is not aligned");
+		}
+
+		this->ptr = reinterpret_cast<const T*>(data);
+		this->num = size_t(h.count);
+	}
+
+	/**
+	 * @brief Get pointer to the first object.
+	 * @return pointer to the first object of the array.
+	 */
+	const T* data()const noexcept{
+		return this->ptr;
+	}
+
+	/**
+	 * @brief Get number of objects.
+	 * @return number of objects in the array.
+	 */
+	size_t size()const noexcept{
+		return this->num;
+	}
+
+	/**
+	 * @brief Check if the view is empty.
+	 * @return true if the array has no objects.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->num == 0;
+	}
+
+	const T* begin()const noexcept{
+		return this->ptr;
+	}
+
+	const T* end()const noexcept{
+		return this->ptr + this->num;
+	}
+
+	const T& operator[](size_t i)const noexcept{
+		ASSERT(i < this->num)
+		return this->ptr[i];
+	}
+};
+
+}
@@ -0,0 +1,563 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#if !defined(__cpp_lib_to_chars)
+#	include <cerrno>
+#	include <cstdio>
+#	include <cstdlib>
+#endif
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "matrix2.hpp"
+#include "matrix3.hpp"
+#include "matrix4.hpp"
+#include "quaternion.hpp"
+#include "dual_quaternion.hpp"
+#include "affine3.hpp"
+#include "rectangle.hpp"
+#include "aabb3.hpp"
+#include "half.hpp"
+#include "fixed.hpp"
+
+// Formatting and parsing of r4 types in the textual format produced by their operator<<,
+// without memory allocations and without iostreams.
+//
+// to_chars() writes the text to the caller's buffer [first, last). Floating point numbers are written
+// in the shortest form which parses back to the same value. On success it returns pointer past the last written character
+// and std::errc(), in case the buffer is too small it returns last and std::errc::value_too_large.
+// No null terminator is written.
+//
+// from_chars() parses the text from [first, last). Whitespace before each token is skipped, so text written
+// by both to_chars() and operator<< is accepted. On success it returns pointer past the parsed text and std::errc(),
+// otherwise it returns first and std::errc::invalid_argument or std::errc::result_out_of_range,
+// and the output value is not modified.
+//
+// In case the standard library does not support floating point std::to_chars()/std::from_chars(),
+// floating point numbers are formatted with std::snprintf() and parsed with std::strtod(),
+// which depend on the C locale, and the shortest round trip form is searched among %g formats of different precision.
+
+namespace r4{
+
+template <class T, typename std::enable_if<std::is_integral<T>::value, bool>::type = true> std::to_chars_result to_chars(char* first, char* last, T value)noexcept{
+	return std::to_chars(first, last, value);
+}
+
+template <class T, typename std::enable_if<std::is_integral<T>::value, bool>::type = true> std::from_chars_result from_chars(const char* first, const char* last, T& value)noexcept{
+	return std::from_chars(first, last, value);
+}
+
+template <class T, typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true> std::to_chars_result to_chars(char* first, char* last, T value)noexcept{
+#if defined(__cpp_lib_to_chars)
+	return std::to_chars(first, last, value);
+#else
+	// find the shortest precision which parses back to the same value
+	char buf[64];
+	int n;
+	for(int precision = std::numeric_limits<T>::digits10;; ++precision){
+		n = std::snprintf(buf, sizeof(buf), "%.*g", precision, double(value));
+		if(precision == std::numeric_limits<T>::max_digits10 || n < 0 || T(std::strtod(buf, nullptr)) == value){
+			break;
+		}
+	}
+	if(n < 0 || last - first < n){
+		return {last, std::errc::value_too_large};
+	}
+	std::copy(buf, buf + n, first);
+	return {first + n, std::errc()};
+#endif
+}
+
+template <class T, typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true> std::from_chars_result from_chars(const char* first, const char* last, T& value)noexcept{
+#if defined(__cpp_lib_to_chars)
+	return std::from_chars(first, last, value);
+#else
+	// copy to null-terminated buffer, std::strtod() does not accept end pointer
+	char buf[64];
+	size_t n = std::min(size_t(last - first), sizeof(buf) - 1);
+	std::copy(first, first + n, buf);
+	buf[n] = 0;
+
+	// std::strtod() skips leading whitespace and accepts '+' sign, std::from_chars() does not
+	if(n == 0 || buf[0] == '+' || buf[0] == ' ' || buf[0] == '\t' || buf[0] == '\n' || buf[0] == '\r'){
+		return {first, std::errc::invalid_argument};
+	}
+
+	char* end;
+	errno = 0;
+	double d = std::strtod(buf, &end);
+	if(end == buf){
+		return {first, std::errc::invalid_argument};
+	}
+	if(errno == ERANGE || (std::isfinite(d) && std::abs(d) > double(std::numeric_limits<T>::max()))){
+		return {first + (end - buf), std::errc::result_out_of_range};
+	}
+	value = T(d);
+	return {first + (end - buf), std::errc()};
+#endif
+}
+
+inline std::to_chars_result to_chars(char* first, char* last, half value)noexcept{
+	return to_chars(first, last, float(value));
+}
+
+inline std::from_chars_result from_chars(const char* first, const char* last, half& value)noexcept{
+	float f;
+	auto res = from_chars(first, last, f);
+	if(res.ec == std::errc()){
+		value = half(f);
+	}
+	return res;
+}
+
+template <unsigned frac_bits> std::to_chars_result to_chars(char* first, char* last, fixed<frac_bits> value)noexcept{
+	return to_chars(first, last, double(value));
+}
+
+template <unsigned frac_bits> std::from_chars_result from_chars(const char* first, const char* last, fixed<frac_bits>& value)noexcept{
+	double d;
+	auto res = from_chars(first, last, d);
+	if(res.ec != std::errc()){
+		return res;
+	}
+	if(std::isnan(d)){
+		return {first, std::errc::invalid_argument};
+	}
+	// check that the number rounded to nearest representable fixed-point number is in range
+	double raw = std::ldexp(d, int(frac_bits));
+	if(!(raw > -2147483648.5 && raw < 2147483647.5)){
+		return {first, std::errc::result_out_of_range};
+	}
+	value = fixed<frac_bits>(d);
+	return res;
+}
+
+namespace charconv_internal{
+
+class writer{
+	char* p;
+	char* const last;
+	bool ok = true;
+public:
+	writer(char* first, char* last)noexcept :
+			p(first),
+			last(last)
+	{}
+
+	void put(char c)noexcept{
+		if(!this->ok){
+			return;
+		}
+		if(this->p == this->last){
+			this->ok = false;
+			return;
+		}
+		*this->p++ = c;
+	}
+
+	void put(const char* s)noexcept{
+		for(; *s != 0; ++s){
+			this->put(*s);
+		}
+	}
+
+	template <class V> void put_value(const V& v)noexcept{
+		if(!this->ok){
+			return;
+		}
+		auto res = to_chars(this->p, this->last, v);
+		if(res.ec != std::errc()){
+			this->ok = false;
+			return;
+		}
+		this->p = res.ptr;
+	}
+
+	// writes values separated by ", " in parentheses
+	template <class V> void put_tuple(const V* v, size_t size)noexcept{
+		this->put('(');
+		for(size_t i = 0; i != size; ++i){
+			if(i != 0){
+				this->put(", ");
+			}
+			this->put_value(v[i]);
+		}
+		this->put(')');
+	}
+
+	// writes matrix rows separated by new lines and framed with pseudo-graphics
+	template <class M> void put_matrix(const M& m)noexcept{
+		for(size_t r = 0; r != m.size(); ++r){
+			bool first_row = r == 0;
+			bool last_row = r == m.size() - 1;
+			this->put("\n\t");
+			this->put(first_row ? '/' : last_row ? '\\' : '|');
+			for(size_t c = 0; c != m[r].size(); ++c){
+				if(c != 0){
+					this->put(' ');
+				}
+				this->put_value(m[r][c]);
+			}
+			this->put(first_row ? '\\' : last_row ? '/' : '|');
+		}
+	}
+
+	std::to_chars_result result()const noexcept{
+		if(this->ok){
+			return {this->p, std::errc()};
+		}
+		return {this->last, std::errc::value_too_large};
+	}
+};
+
+class reader{
+	const char* const first;
+	const char* p;
+	const char* const last;
+	std::errc ec = std::errc();
+
+	void skip_whitespace()noexcept{
+		for(; this->p != this->last; ++this->p){
+			switch(*this->p){
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+					continue;
+				default:
+					return;
+			}
+		}
+	}
+public:
+	reader(const char* first, const char* last)noexcept :
+			first(first),
+			p(first),
+			last(last)
+	{}
+
+	void expect(char c)noexcept{
+		if(this->ec != std::errc()){
+			return;
+		}
+		this->skip_whitespace();
+		if(this->p == this->last || *this->p != c){
+			this->ec = std::errc::invalid_argument;
+			return;
+		}
+		++this->p;
+	}
+
+	template <class V> void get_value(V& v)noexcept{
+		if(this->ec != std::errc()){
+			return;
+		}
+		this->skip_whitespace();
+		auto res = from_chars(this->p, this->last, v);
+		if(res.ec != std::errc()){
+			this->ec = res.ec;
+			return;
+		}
+		this->p = res.ptr;
+	}
+
+	template <class V> void get_tuple(V* v, size_t size)noexcept{
+		this->expect('(');
+		for(size_t i = 0; i != size; ++i){
+			if(i != 0){
+				this->expect(',');
+			}
+			this->get_value(v[i]);
+		}
+		this->expect(')');
+	}
+
+	template <class M> void get_matrix(M& m)noexcept{
+		for(size_t r = 0; r != m.size(); ++r){
+			bool first_row = r == 0;
+			bool last_row = r == m.size() - 1;
+			this->expect(first_row ? '/' : last_row ? '\\' : '|');
+			for(size_t c = 0; c != m[r].size(); ++c){
+				this->get_value(m[r][c]);
+			}
+			this->expect(first_row ? '\\' : last_row ? '/' : '|');
+		}
+	}
+
+	bool ok()const noexcept{
+		return this->ec == std::errc();
+	}
+
+	std::from_chars_result result()const noexcept{
+		if(this->ok()){
+			return {this->p, std::errc()};
+		}
+		return {this->first, this->ec};
+	}
+};
+
+}
+
+/**
+ * @brief Format vector2 as "(x, y)".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const vector2<T>& vec)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_tuple(vec.data(), vec.size());
+	return w.result();
+}
+
+/**
+ * @brief Format vector3 as "(x, y, z)".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const vector3<T>& vec)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_tuple(vec.data(), vec.size());
+	return w.result();
+}
+
+/**
+ * @brief Format vector4 as "(x, y, z, w)".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const vector4<T>& vec)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_tuple(vec.data(), vec.size());
+	return w.result();
+}
+
+/**
+ * @brief Format quaternion as "(x, y, z, w)".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const quaternion<T>& quat)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_tuple(quat.data(), quat.size());
+	return w.result();
+}
+
+/**
+ * @brief Format dual quaternion as "((x, y, z, w), (x, y, z, w))".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const dual_quaternion<T>& dq)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_tuple(dq.data(), dq.size());
+	return w.result();
+}
+
+/**
+ * @brief Format matrix2 as rows on separate lines.
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const matrix2<T>& mat)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_matrix(mat);
+	return w.result();
+}
+
+/**
+ * @brief Format matrix3 as rows on separate lines.
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const matrix3<T>& mat)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_matrix(mat);
+	return w.result();
+}
+
+/**
+ * @brief Format matrix4 as rows on separate lines.
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const matrix4<T>& mat)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_matrix(mat);
+	return w.result();
+}
+
+/**
+ * @brief Format affine3 as rows on separate lines.
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const affine3<T>& mat)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put_matrix(mat);
+	return w.result();
+}
+
+/**
+ * @brief Format rectangle as "[(x, y)(w, h)]".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const rectangle<T>& rect)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put('[');
+	w.put_value(rect.p);
+	w.put_value(rect.d);
+	w.put(']');
+	return w.result();
+}
+
+/**
+ * @brief Format aabb3 as "[(x1, y1, z1)(x2, y2, z2)]".
+ */
+template <class T> std::to_chars_result to_chars(char* first, char* last, const aabb3<T>& box)noexcept{
+	charconv_internal::writer w(first, last);
+	w.put('[');
+	w.put_value(box.p1);
+	w.put_value(box.p2);
+	w.put(']');
+	return w.result();
+}
+
+/**
+ * @brief Parse vector2 from "(x, y)".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, vector2<T>& vec)noexcept{
+	charconv_internal::reader r(first, last);
+	vector2<T> v;
+	r.get_tuple(v.data(), v.size());
+	if(r.ok()){
+		vec = v;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse vector3 from "(x, y, z)".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, vector3<T>& vec)noexcept{
+	charconv_internal::reader r(first, last);
+	vector3<T> v;
+	r.get_tuple(v.data(), v.size());
+	if(r.ok()){
+		vec = v;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse vector4 from "(x, y, z, w)".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, vector4<T>& vec)noexcept{
+	charconv_internal::reader r(first, last);
+	vector4<T> v;
+	r.get_tuple(v.data(), v.size());
+	if(r.ok()){
+		vec = v;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse quaternion from "(x, y, z, w)".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, quaternion<T>& quat)noexcept{
+	charconv_internal::reader r(first, last);
+	quaternion<T> q;
+	r.get_tuple(q.data(), q.size());
+	if(r.ok()){
+		quat = q;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse dual quaternion from "((x, y, z, w), (x, y, z, w))".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, dual_quaternion<T>& dq)noexcept{
+	charconv_internal::reader r(first, last);
+	dual_quaternion<T> q;
+	r.get_tuple(q.data(), q.size());
+	if(r.ok()){
+		dq = q;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse matrix2 from rows on separate lines.
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, matrix2<T>& mat)noexcept{
+	charconv_internal::reader r(first, last);
+	matrix2<T> m;
+	r.get_matrix(m);
+	if(r.ok()){
+		mat = m;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse matrix3 from rows on separate lines.
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, matrix3<T>& mat)noexcept{
+	charconv_internal::reader r(first, last);
+	matrix3<T> m;
+	r.get_matrix(m);
+	if(r.ok()){
+		mat = m;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse matrix4 from rows on separate lines.
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, matrix4<T>& mat)noexcept{
+	charconv_internal::reader r(first, last);
+	matrix4<T> m;
+	r.get_matrix(m);
+	if(r.ok()){
+		mat = m;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse affine3 from rows on separate lines.
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, affine3<T>& mat)noexcept{
+	charconv_internal::reader r(first, last);
+	affine3<T> m;
+	r.get_matrix(m);
+	if(r.ok()){
+		mat = m;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse rectangle from "[(x, y)(w, h)]".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, rectangle<T>& rect)noexcept{
+	charconv_internal::reader r(first, last);
+	rectangle<T> re;
+	r.expect('[');
+	r.get_value(re.p);
+	r.get_value(re.d);
+	r.expect(']');
+	if(r.ok()){
+		rect = re;
+	}
+	return r.result();
+}
+
+/**
+ * @brief Parse aabb3 from "[(x1, y1, z1)(x2, y2, z2)]".
+ */
+template <class T> std::from_chars_result from_chars(const char* first, const char* last, aabb3<T>& box)noexcept{
+	charconv_internal::reader r(first, last);
+	aabb3<T> b;
+	r.expect('[');
+	r.get_value(b.p1);
+	r.get_value(b.p2);
+	r.expect(']');
+	if(r.ok()){
+		box = b;
+	}
+	return r.result();
+}
+
+}
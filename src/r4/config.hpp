@@ -0,0 +1,39 @@
+#pragma once
+
+#include <utki/debug.hpp>
+
+// Compiler support helpers used by r4 headers.
+
+// R4_IS_CONSTANT_EVALUATED() is true when evaluated at compile time as part of constant expression
+// and false otherwise. It is used to fall back from SIMD intrinsics, which cannot be evaluated at compile time,
+// to plain scalar code. In case the compiler does not provide the means to detect constant evaluation, it is always false,
+// so float operations having SIMD specializations cannot be evaluated at compile time, unless R4_NO_SIMD is defined.
+#if defined(__has_builtin)
+#	if __has_builtin(__builtin_is_constant_evaluated)
+#		define R4_HAS_IS_CONSTANT_EVALUATED
+#	endif
+#endif
+#if !defined(R4_HAS_IS_CONSTANT_EVALUATED)
+#	if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#		define R4_HAS_IS_CONSTANT_EVALUATED
+#	endif
+#endif
+
+#if defined(R4_HAS_IS_CONSTANT_EVALUATED)
+#	define R4_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#	define R4_IS_CONSTANT_EVALUATED() false
+#endif
+
+// Assertions usable in constexpr functions.
+// Regular ASSERT() cannot be used in constexpr functions because it declares variables of non-literal types,
+// so the assertion failure is reported from a lambda, which is only called in case the assertion fails.
+// When it fails during compile time evaluation, it results in compilation error.
+// The assertions are single statements, so they are used with terminating semicolon.
+#ifdef DEBUG
+#	define R4_ASSERT_INFO(x, y) do{ if(!(x)){ [&](){ ASSERT_INFO_ALWAYS(x, y) }(); } }while(false)
+#	define R4_ASSERT(x) do{ if(!(x)){ [&](){ ASSERT_ALWAYS(x) }(); } }while(false)
+#else
+#	define R4_ASSERT_INFO(x, y) do{}while(false)
+#	define R4_ASSERT(x) do{}while(false)
+#endif
@@ -0,0 +1,467 @@
+#pragma once
+
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "config.hpp"
+
+#include "quaternion.hpp"
+
+namespace r4{
+
+template <class T> class vector3;
+template <class T> class matrix4;
+template <class T> class affine3;
+
+/**
+ * @brief Dual quaternion template class.
+ * Unit dual quaternion represents a rigid transformation, i.e. rotation followed by translation.
+ * The real part is the unit quaternion of the rotation and the dual part is (t * real) / 2,
+ * where t is the quaternion (tx, ty, tz, 0) of the translation.
+ * Compared to matrices, dual quaternions take 8 numbers instead of 12 or 16 and, being blended,
+ * they do not suffer from the volume loss artifacts of linear blending of matrices.
+ */
+template <typename T> class dual_quaternion : public std::array<quaternion<T>, 2>{
+	typedef std::array<quaternion<T>, 2> base_type;
+public:
+	/**
+	 * @brief Real part.
+	 */
+	constexpr quaternion<T>& real()noexcept{
+		return this->operator[](0);
+	}
+
+	/**
+	 * @brief Real part.
+	 */
+	constexpr const quaternion<T>& real()const noexcept{
+		return this->operator[](0);
+	}
+
+	/**
+	 * @brief Dual part.
+	 */
+	constexpr quaternion<T>& dual()noexcept{
+		return this->operator[](1);
+	}
+
+	/**
+	 * @brief Dual part.
+	 */
+	constexpr const quaternion<T>& dual()const noexcept{
+		return this->operator[](1);
+	}
+
+	/**
+	 * @brief Default constructor.
+	 * Note, that it does not initialize dual quaternion components,
+	 * right after creation the components are undefined.
+	 */
+	constexpr dual_quaternion() = default;
+
+	/**
+	 * @brief Create dual quaternion with given parts.
+	 * @param real - real part.
+	 * @param dual - dual part.
+	 */
+	constexpr dual_quaternion(const quaternion<T>& real, const quaternion<T>& dual)noexcept :
+			base_type{{real, dual}}
+	{}
+
+	/**
+	 * @brief Construct rigid transformation.
+	 * The transformation rotates first and then translates.
+	 * @param rot - unit quaternion of the rotation.
+	 * @param t - translation.
+	 */
+	constexpr dual_quaternion(const quaternion<T>& rot, const vector3<T>& t)noexcept;
+
+	/**
+	 * @brief Construct from affine transformation matrix.
+	 * The left 3x3 submatrix must be a rotation matrix.
+	 * @param m - matrix of the rigid transformation.
+	 */
+	explicit dual_quaternion(const affine3<T>& m)noexcept;
+
+	/**
+	 * @brief Construct from 4x4 matrix.
+	 * The matrix must be a rigid transformation matrix, i.e. the left upper 3x3 submatrix
+	 * must be a rotation matrix and the last row must be (0, 0, 0, 1).
+	 * @param m - matrix of the rigid transformation.
+	 */
+	explicit dual_quaternion(const matrix4<T>& m)noexcept;
+
+	/**
+	 * @brief Convert to dual quaternion with different type of component.
+	 * @return converted dual quaternion.
+	 */
+	template <typename TT> constexpr dual_quaternion<TT> to()noexcept{
+		return dual_quaternion<TT>{
+				this->real().template to<TT>(),
+				this->dual().template to<TT>()
+			};
+	}
+
+	/**
+	 * @brief Conjugate of this dual quaternion.
+	 * Both real and dual parts are complex conjugated.
+	 * For unit dual quaternion this is its inverse, i.e. the inverse transformation.
+	 * @return conjugate of this dual quaternion.
+	 */
+	constexpr dual_quaternion operator!()const noexcept{
+		return dual_quaternion(!this->real(), !this->dual());
+	}
+
+	/**
+	 * @brief Add dual quaternion and assign.
+	 * @param dq - dual quaternion to add.
+	 * @return reference to this dual quaternion instance.
+	 */
+	constexpr dual_quaternion& operator+=(const dual_quaternion& dq)noexcept{
+		this->real() += dq.real();
+		this->dual() += dq.dual();
+		return *this;
+	}
+
+	/**
+	 * @brief Addition of dual quaternions.
+	 * @param dq - dual quaternion to add.
+	 * @return resulting dual quaternion.
+	 */
+	constexpr dual_quaternion operator+(const dual_quaternion& dq)const noexcept{
+		return (dual_quaternion(*this) += dq);
+	}
+
+	/**
+	 * @brief Multiply by scalar and assign.
+	 * @param s - scalar to multiply by.
+	 * @return reference to this dual quaternion instance.
+	 */
+	constexpr dual_quaternion& operator*=(T s)noexcept{
+		this->real() *= s;
+		this->dual() *= s;
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply by scalar.
+	 * @param s - scalar to multiply by.
+	 * @return resulting dual quaternion.
+	 */
+	constexpr dual_quaternion operator*(T s)const noexcept{
+		return (dual_quaternion(*this) *= s);
+	}
+
+	/**
+	 * @brief Multiply scalar by dual quaternion.
+	 * @param s - scalar to multiply.
+	 * @param dq - dual quaternion to multiply by.
+	 * @return resulting dual quaternion.
+	 */
+	friend constexpr dual_quaternion operator*(T s, const dual_quaternion& dq)noexcept{
+		return dq * s;
+	}
+
+	/**
+	 * @brief Multiply by dual quaternion.
+	 * Composition of transformations, the resulting transformation
+	 * is the transformation dq followed by this transformation.
+	 * @param dq - dual quaternion to multiply by.
+	 * @return resulting dual quaternion.
+	 */
+	constexpr dual_quaternion operator%(const dual_quaternion& dq)const noexcept{
+		return dual_quaternion(
+				this->real() % dq.real(),
+				this->real() % dq.dual() + this->dual() % dq.real()
+			);
+	}
+
+	/**
+	 * @brief Multiply by dual quaternion and assign.
+	 * Multiplies this dual quaternion by another dual quaternion from the right.
+	 * @param dq - dual quaternion to multiply by.
+	 * @return reference to this dual quaternion instance.
+	 */
+	constexpr dual_quaternion& operator%=(const dual_quaternion& dq)noexcept{
+		return (*this = this->operator%(dq));
+	}
+
+	/**
+	 * @brief Initialize with identity dual quaternion.
+	 * Identity dual quaternion represents no transformation.
+	 * @return reference to this dual quaternion instance.
+	 */
+	constexpr dual_quaternion& set_identity()noexcept{
+		this->real().set_identity();
+		this->dual() = quaternion<T>(0, 0, 0, 0);
+		return *this;
+	}
+
+	/**
+	 * @brief Conjugate this dual quaternion.
+	 * @return reference to this dual quaternion instance.
+	 */
+	constexpr dual_quaternion& conjugate()noexcept{
+		return (*this = this->operator!());
+	}
+
+	/**
+	 * @brief Calculate dual quaternion norm.
+	 * This is the norm of the real part.
+	 * @return norm of the real part.
+	 */
+	T norm()const noexcept{
+		return this->real().norm();
+	}
+
+	/**
+	 * @brief Normalize dual quaternion.
+	 * Turns this dual quaternion to unit dual quaternion, i.e. the real part is made unit
+	 * and the dual part is made orthogonal to the real part.
+	 * Blended dual quaternions have to be normalized before using them as transformations.
+	 * @return reference to this dual quaternion instance.
+	 */
+	dual_quaternion& normalize()noexcept{
+		T n = this->norm();
+		ASSERT_INFO(n != 0, "dual_quaternion::normalize(): zero real part")
+		this->real() /= n;
+		this->dual() /= n;
+		this->dual() += this->real() * -(this->real() * this->dual());
+		return *this;
+	}
+
+	/**
+	 * @brief Get rotation.
+	 * @return unit quaternion of the rotation.
+	 */
+	constexpr const quaternion<T>& rotation()const noexcept{
+		return this->real();
+	}
+
+	/**
+	 * @brief Get translation.
+	 * The dual quaternion must be unit.
+	 * @return translation vector.
+	 */
+	constexpr vector3<T> translation()const noexcept;
+
+	/**
+	 * @brief Transform point.
+	 * The dual quaternion must be unit.
+	 * @param p - point to transform.
+	 * @return rotated and translated point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept;
+
+	/**
+	 * @brief Transform array of points.
+	 * Same as operator*(const vector3<T>&) applied to each point of the array.
+	 * @param src - pointer to the first point to transform.
+	 * @param dst - pointer to where to store the first transformed point. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of points to transform.
+	 */
+	void transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform array of points in place.
+	 * @param points - pointer to the first point to transform.
+	 * @param size - number of points to transform.
+	 */
+	void transform_points(vector3<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Convert to 4x4 matrix.
+	 * The dual quaternion must be unit.
+	 * @return rigid transformation matrix.
+	 */
+	constexpr matrix4<T> to_matrix4()const noexcept;
+
+	/**
+	 * @brief Convert to affine transformation matrix.
+	 * The dual quaternion must be unit.
+	 * @return rigid transformation matrix.
+	 */
+	constexpr affine3<T> to_affine3()const noexcept;
+
+	/**
+	 * @brief Blend dual quaternions.
+	 * Weighted sum of dual quaternions, normalized. Before summing up, the dual quaternions
+	 * whose real part is in opposite hemisphere to the first one are negated, so that the
+	 * blending goes the shortest path.
+	 * @param dqs - dual quaternions to blend.
+	 * @param indices - indices of the dual quaternions to blend.
+	 * @param weights - weights of the dual quaternions.
+	 * @param count - number of the dual quaternions to blend, must be greater than 0.
+	 * @return normalized blended dual quaternion.
+	 */
+	static dual_quaternion blend(const dual_quaternion* dqs, const unsigned* indices, const T* weights, unsigned count)noexcept;
+
+	/**
+	 * @brief Dual quaternion linear blend skinning.
+	 * Each point is influenced by a number of bones. For each point, the dual quaternions of its bones
+	 * are blended (see blend()) and the point is transformed by the result.
+	 * @param bones - dual quaternions of the bone transformations.
+	 * @param indices - bone indices, 'influences' indices per point.
+	 * @param weights - bone weights, 'influences' weights per point. Weights of each point should sum up to 1.
+	 * @param influences - number of bones influencing each point, must be greater than 0.
+	 *                     Points influenced by fewer bones can use zero weights.
+	 * @param src - pointer to the first point to transform.
+	 * @param dst - pointer to where to store the first transformed point. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of points to transform.
+	 */
+	static void skin(
+			const dual_quaternion* bones,
+			const unsigned* indices,
+			const T* weights,
+			unsigned influences,
+			const vector3<T>* src,
+			vector3<T>* dst,
+			size_t size
+		)noexcept;
+
+	friend std::ostream& operator<<(std::ostream& s, const dual_quaternion<T>& dq){
+		s << "(" << dq.real() << ", " << dq.dual() << ")";
+		return s;
+	}
+};
+
+}
+
+#include "vector3.hpp"
+#include "matrix4.hpp"
+#include "affine3.hpp"
+#include "simd.hpp"
+
+namespace r4{
+
+template <class T> constexpr dual_quaternion<T>::dual_quaternion(const quaternion<T>& rot, const vector3<T>& t)noexcept :
+		base_type{{
+				rot,
+				quaternion<T>(t.x(), t.y(), t.z(), 0) % rot * T(0.5)
+			}}
+{}
+
+template <class T> dual_quaternion<T>::dual_quaternion(const affine3<T>& m)noexcept :
+		dual_quaternion(m.to_quaternion(), m.col(3))
+{}
+
+template <class T> dual_quaternion<T>::dual_quaternion(const matrix4<T>& m)noexcept :
+		dual_quaternion(affine3<T>(m))
+{}
+
+template <class T> constexpr vector3<T> dual_quaternion<T>::translation()const noexcept{
+	// t = 2 * dual * conjugate(real)
+	const auto& r = this->real();
+	const auto& d = this->dual();
+	vector3<T> rv(r.x(), r.y(), r.z());
+	vector3<T> dv(d.x(), d.y(), d.z());
+	return (dv * r.w() - rv * d.w() + rv % dv) * T(2);
+}
+
+template <class T> constexpr vector3<T> dual_quaternion<T>::operator*(const vector3<T>& p)const noexcept{
+	return vector3<T>(p).rotate(this->real()) + this->translation();
+}
+
+template <class T> void dual_quaternion<T>::transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept{
+	vector3<T> t = this->translation();
+	this->real().rotate_points(src, dst, size);
+	for(vector3<T>* end = dst + size; dst != end; ++dst){
+		*dst += t;
+	}
+}
+
+template <class T> constexpr matrix4<T> dual_quaternion<T>::to_matrix4()const noexcept{
+	matrix4<T> ret(this->real());
+	vector3<T> t = this->translation();
+	ret[0][3] = t.x();
+	ret[1][3] = t.y();
+	ret[2][3] = t.z();
+	return ret;
+}
+
+template <class T> constexpr affine3<T> dual_quaternion<T>::to_affine3()const noexcept{
+	affine3<T> ret(this->real());
+	vector3<T> t = this->translation();
+	ret[0][3] = t.x();
+	ret[1][3] = t.y();
+	ret[2][3] = t.z();
+	return ret;
+}
+
+template <class T> dual_quaternion<T> dual_quaternion<T>::blend(const dual_quaternion* dqs, const unsigned* indices, const T* weights, unsigned count)noexcept{
+	ASSERT(count != 0)
+	const auto& first = dqs[*indices];
+	dual_quaternion ret = first * *weights;
+	for(unsigned i = 1; i != count; ++i){
+		const auto& dq = dqs[indices[i]];
+		// shortest path, see quaternion::slerp()
+		T w = first.real() * dq.real() < T(0) ? -weights[i] : weights[i];
+		ret.real() += dq.real() * w;
+		ret.dual() += dq.dual() * w;
+	}
+	return ret.normalize();
+}
+
+template <class T> void dual_quaternion<T>::skin(
+		const dual_quaternion* bones,
+		const unsigned* indices,
+		const T* weights,
+		unsigned influences,
+		const vector3<T>* src,
+		vector3<T>* dst,
+		size_t size
+	)noexcept
+{
+	for(const vector3<T>* end = src + size; src != end; ++src, ++dst, indices += influences, weights += influences){
+		*dst = blend(bones, indices, weights, influences) * (*src);
+	}
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of dual_quaternion<float> operations
+
+template <> inline void dual_quaternion<float>::skin(
+		const dual_quaternion* bones,
+		const unsigned* indices,
+		const float* weights,
+		unsigned influences,
+		const vector3<float>* src,
+		vector3<float>* dst,
+		size_t size
+	)noexcept
+{
+	ASSERT(influences != 0)
+
+	// process blocks of 4 points
+	for(const vector3<float>* end = src + (size & ~size_t(3)); src != end; src += 4, dst += 4, indices += 4 * influences, weights += 4 * influences){
+		simd::skin_block(
+				bones->real().data(),
+				indices,
+				weights,
+				influences,
+				src->data(),
+				dst->data()
+			);
+	}
+
+	// process remaining points one by one
+	for(const vector3<float>* end = src + (size & 3); src != end; ++src, ++dst, indices += influences, weights += influences){
+		*dst = blend(bones, indices, weights, influences) * (*src);
+	}
+}
+
+#endif // ~R4_SIMD
+
+static_assert(sizeof(dual_quaternion<float>) == sizeof(float) * 8, "size mismatch");
+static_assert(sizeof(dual_quaternion<double>) == sizeof(double) * 8, "size mismatch");
+
+}
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "matrix2.hpp"
+#include "matrix3.hpp"
+#include "matrix4.hpp"
+
+// Opt-in lazy evaluation of vector and matrix arithmetic.
+//
+// Expressions are started by wrapping operands with r4::lazy():
+//
+//     r4::vector4<float> r = r4::lazy(a) + r4::lazy(b) * s - c;
+//
+// Instead of creating a temporary vector for each operation, the whole expression is evaluated
+// in a single pass when it is assigned to a vector. Note, that operations on plain vectors, like b * s,
+// are still evaluated by the ordinary operators, so the expression has to be started before them.
+//
+// Chains of matrix products applied to a vector of the matrix dimension, like r4::lazy(m1) * m2 * m3 * v
+// with 4x4 matrices and vector4, are evaluated right to left as matrix-vector products, i.e. m1 * (m2 * (m3 * v)),
+// so no matrix-matrix products are done. Vectors of lower dimension, like vector3 multiplied by matrix4,
+// are transformed as homogeneous (x, y, z, 1) vectors whose extra components are dropped from the result,
+// so for those the matrix product is evaluated first, to give the same result as (m1 * m2 * m3) * v.
+//
+// Expressions hold references to their operands, so the operands must outlive the expression.
+// Do not store expressions involving temporaries to variables, evaluate them within the same full expression.
+
+namespace r4{
+
+/**
+ * @brief Base class of vector expressions.
+ * @param E - type of the derived expression class.
+ * @param V - type of the vector the expression evaluates to.
+ */
+template <class E, class V> class vector_expression{
+public:
+	typedef V result_type;
+	typedef typename V::value_type value_type;
+
+	/**
+	 * @brief Get element of the expression result.
+	 * @param i - index of the element.
+	 * @return value of the i-th element of the expression result.
+	 */
+	value_type operator[](size_t i)const noexcept{
+		return static_cast<const E&>(*this)[i];
+	}
+
+	/**
+	 * @brief Evaluate expression.
+	 * @return vector, the expression evaluates to.
+	 */
+	result_type eval()const noexcept{
+		result_type ret;
+		for(size_t i = 0; i != ret.size(); ++i){
+			ret[i] = static_cast<const E&>(*this)[i];
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Evaluate expression.
+	 * Same as eval().
+	 */
+	operator result_type()const noexcept{
+		return this->eval();
+	}
+};
+
+/**
+ * @brief Reference to a vector as an expression.
+ */
+template <class V> class vector_reference : public vector_expression<vector_reference<V>, V>{
+	const V& v;
+public:
+	vector_reference(const V& v)noexcept :
+			v(v)
+	{}
+
+	typename V::value_type operator[](size_t i)const noexcept{
+		return this->v[i];
+	}
+
+	const V& eval()const noexcept{
+		return this->v;
+	}
+};
+
+/**
+ * @brief Vector as an expression, held by value.
+ * Used to hold results of matrix-vector products.
+ */
+template <class V> class vector_value : public vector_expression<vector_value<V>, V>{
+	V v;
+public:
+	vector_value(const V& v)noexcept :
+			v(v)
+	{}
+
+	typename V::value_type operator[](size_t i)const noexcept{
+		return this->v[i];
+	}
+
+	const V& eval()const noexcept{
+		return this->v;
+	}
+};
+
+/**
+ * @brief Sum of two vector expressions.
+ */
+template <class L, class R> class vector_sum : public vector_expression<vector_sum<L, R>, typename L::result_type>{
+	static_assert(std::is_same<typename L::result_type, typename R::result_type>::value, "vector types mismatch");
+	L l;
+	R r;
+public:
+	vector_sum(const L& l, const R& r)noexcept :
+			l(l),
+			r(r)
+	{}
+
+	typename L::value_type operator[](size_t i)const noexcept{
+		return this->l[i] + this->r[i];
+	}
+};
+
+/**
+ * @brief Difference of two vector expressions.
+ */
+template <class L, class R> class vector_difference : public vector_expression<vector_difference<L, R>, typename L::result_type>{
+	static_assert(std::is_same<typename L::result_type, typename R::result_type>::value, "vector types mismatch");
+	L l;
+	R r;
+public:
+	vector_difference(const L& l, const R& r)noexcept :
+			l(l),
+			r(r)
+	{}
+
+	typename L::value_type operator[](size_t i)const noexcept{
+		return this->l[i] - this->r[i];
+	}
+};
+
+/**
+ * @brief Vector expression multiplied by scalar.
+ */
+template <class E> class vector_scaled : public vector_expression<vector_scaled<E>, typename E::result_type>{
+	E e;
+	typename E::value_type s;
+public:
+	vector_scaled(const E& e, typename E::value_type s)noexcept :
+			e(e),
+			s(s)
+	{}
+
+	typename E::value_type operator[](size_t i)const noexcept{
+		return this->e[i] * this->s;
+	}
+};
+
+/**
+ * @brief Vector expression divided by scalar.
+ */
+template <class E> class vector_quotient : public vector_expression<vector_quotient<E>, typename E::result_type>{
+	E e;
+	typename E::value_type s;
+public:
+	vector_quotient(const E& e, typename E::value_type s)noexcept :
+			e(e),
+			s(s)
+	{
+		ASSERT_INFO(s != 0, "r4::vector_quotient: division by 0")
+	}
+
+	typename E::value_type operator[](size_t i)const noexcept{
+		return this->e[i] / this->s;
+	}
+};
+
+/**
+ * @brief Negated vector expression.
+ */
+template <class E> class vector_negated : public vector_expression<vector_negated<E>, typename E::result_type>{
+	E e;
+public:
+	vector_negated(const E& e)noexcept :
+			e(e)
+	{}
+
+	typename E::value_type operator[](size_t i)const noexcept{
+		return -this->e[i];
+	}
+};
+
+/**
+ * @brief Base class of matrix expressions.
+ * Matrix expressions are not evaluated element-wise, they are either evaluated to a matrix
+ * or applied to a vector.
+ * @param E - type of the derived expression class.
+ * @param M - type of the matrix the expression evaluates to.
+ */
+template <class E, class M> class matrix_expression{
+public:
+	typedef M result_type;
+
+	/**
+	 * @brief Evaluate expression.
+	 * @return matrix, the expression evaluates to.
+	 */
+	result_type eval()const noexcept{
+		return static_cast<const E&>(*this).eval();
+	}
+
+	/**
+	 * @brief Evaluate expression.
+	 * Same as eval().
+	 */
+	operator result_type()const noexcept{
+		return this->eval();
+	}
+};
+
+/**
+ * @brief Reference to a matrix as an expression.
+ */
+template <class M> class matrix_reference : public matrix_expression<matrix_reference<M>, M>{
+	const M& m;
+public:
+	matrix_reference(const M& m)noexcept :
+			m(m)
+	{}
+
+	const M& eval()const noexcept{
+		return this->m;
+	}
+
+	/**
+	 * @brief Multiply vector by the matrix.
+	 * @param v - vector to multiply.
+	 * @return m * v.
+	 */
+	template <class V> V apply(const V& v)const noexcept{
+		return this->m * v;
+	}
+};
+
+// vector type of the matrix dimension
+template <class M> struct matrix_vector;
+template <class T> struct matrix_vector<matrix2<T>>{ typedef vector2<T> type; };
+template <class T> struct matrix_vector<matrix3<T>>{ typedef vector3<T> type; };
+template <class T> struct matrix_vector<matrix4<T>>{ typedef vector4<T> type; };
+
+/**
+ * @brief Product of two matrix expressions.
+ */
+template <class L, class R> class matrix_product : public matrix_expression<matrix_product<L, R>, typename L::result_type>{
+	L l;
+	R r;
+public:
+	matrix_product(const L& l, const R& r)noexcept :
+			l(l),
+			r(r)
+	{}
+
+	typename L::result_type eval()const noexcept{
+		return this->l.eval() * this->r.eval();
+	}
+
+	/**
+	 * @brief Multiply vector by the matrix product.
+	 * For vector of the matrix dimension (L * R) * v is calculated as L * (R * v).
+	 * Vectors of lower dimension are multiplied by the evaluated matrix product,
+	 * because L * (R * v) would lose the components dropped from R * v.
+	 * @param v - vector to multiply.
+	 * @return (l * r) * v.
+	 */
+	template <class V> V apply(const V& v)const noexcept{
+		if constexpr(std::is_same<V, typename matrix_vector<typename L::result_type>::type>::value){
+			return this->l.apply(this->r.apply(v));
+		}else{
+			return this->eval() * v;
+		}
+	}
+};
+
+template <class T> struct is_vector : std::false_type{};
+template <class T> struct is_vector<vector2<T>> : std::true_type{};
+template <class T> struct is_vector<vector3<T>> : std::true_type{};
+template <class T> struct is_vector<vector4<T>> : std::true_type{};
+
+template <class T> struct is_matrix : std::false_type{};
+template <class T> struct is_matrix<matrix2<T>> : std::true_type{};
+template <class T> struct is_matrix<matrix3<T>> : std::true_type{};
+template <class T> struct is_matrix<matrix4<T>> : std::true_type{};
+
+template <class E> struct is_vector_expression{
+private:
+	template <class D, class V> static std::true_type test(const vector_expression<D, V>*);
+	static std::false_type test(...);
+public:
+	static constexpr bool value = decltype(test(std::declval<const E*>()))::value;
+};
+
+template <class E> struct is_matrix_expression{
+private:
+	template <class D, class M> static std::true_type test(const matrix_expression<D, M>*);
+	static std::false_type test(...);
+public:
+	static constexpr bool value = decltype(test(std::declval<const E*>()))::value;
+};
+
+/**
+ * @brief Start lazy vector expression.
+ * @param v - vector.
+ * @return vector expression referring to the given vector.
+ */
+template <class V, typename std::enable_if<is_vector<V>::value, int>::type = 0>
+vector_reference<V> lazy(const V& v)noexcept{
+	return vector_reference<V>(v);
+}
+
+/**
+ * @brief Start lazy matrix expression.
+ * @param m - matrix.
+ * @return matrix expression referring to the given matrix.
+ */
+template <class M, typename std::enable_if<is_matrix<M>::value, int>::type = 0>
+matrix_reference<M> lazy(const M& m)noexcept{
+	return matrix_reference<M>(m);
+}
+
+// turn operand of expression operator to expression
+template <class E, typename std::enable_if<is_vector_expression<E>::value || is_matrix_expression<E>::value, int>::type = 0>
+const E& to_expression(const E& e)noexcept{
+	return e;
+}
+
+template <class V, typename std::enable_if<is_vector<V>::value || is_matrix<V>::value, int>::type = 0>
+auto to_expression(const V& v)noexcept -> decltype(lazy(v)){
+	return lazy(v);
+}
+
+template <class L, class R> struct is_vector_operands{
+	static constexpr bool value =
+			(is_vector_expression<L>::value && (is_vector_expression<R>::value || is_vector<R>::value)) ||
+			(is_vector<L>::value && is_vector_expression<R>::value);
+};
+
+template <class L, class R> struct is_matrix_operands{
+	static constexpr bool value =
+			(is_matrix_expression<L>::value && (is_matrix_expression<R>::value || is_matrix<R>::value)) ||
+			(is_matrix<L>::value && is_matrix_expression<R>::value);
+};
+
+template <class L, class R, typename std::enable_if<is_vector_operands<L, R>::value, int>::type = 0>
+auto operator+(const L& l, const R& r)noexcept
+		-> vector_sum<typename std::decay<decltype(to_expression(l))>::type, typename std::decay<decltype(to_expression(r))>::type>
+{
+	return {to_expression(l), to_expression(r)};
+}
+
+template <class L, class R, typename std::enable_if<is_vector_operands<L, R>::value, int>::type = 0>
+auto operator-(const L& l, const R& r)noexcept
+		-> vector_difference<typename std::decay<decltype(to_expression(l))>::type, typename std::decay<decltype(to_expression(r))>::type>
+{
+	return {to_expression(l), to_expression(r)};
+}
+
+template <class E, typename std::enable_if<is_vector_expression<E>::value, int>::type = 0>
+vector_negated<E> operator-(const E& e)noexcept{
+	return vector_negated<E>(e);
+}
+
+template <class E, typename std::enable_if<is_vector_expression<E>::value, int>::type = 0>
+vector_scaled<E> operator*(const E& e, typename E::value_type s)noexcept{
+	return vector_scaled<E>(e, s);
+}
+
+template <class E, typename std::enable_if<is_vector_expression<E>::value, int>::type = 0>
+vector_scaled<E> operator*(typename E::value_type s, const E& e)noexcept{
+	return vector_scaled<E>(e, s);
+}
+
+template <class E, typename std::enable_if<is_vector_expression<E>::value, int>::type = 0>
+vector_quotient<E> operator/(const E& e, typename E::value_type s)noexcept{
+	return vector_quotient<E>(e, s);
+}
+
+template <class L, class R, typename std::enable_if<is_matrix_operands<L, R>::value, int>::type = 0>
+auto operator*(const L& l, const R& r)noexcept
+		-> matrix_product<typename std::decay<decltype(to_expression(l))>::type, typename std::decay<decltype(to_expression(r))>::type>
+{
+	return {to_expression(l), to_expression(r)};
+}
+
+/**
+ * @brief Apply matrix expression to vector.
+ * The matrix-vector product is evaluated right away, by applying the matrices of the expression
+ * to the vector from right to left, or by applying the evaluated matrix product to vectors of lower
+ * dimension than the matrix. The result can take part in further vector expressions.
+ * @param m - matrix expression.
+ * @param v - vector or vector expression.
+ * @return the resulting vector held by value as a vector expression.
+ */
+template <class M, class V, typename std::enable_if<
+		is_matrix_expression<M>::value && (is_vector<V>::value || is_vector_expression<V>::value),
+		int
+	>::type = 0>
+auto operator*(const M& m, const V& v)noexcept
+		-> vector_value<typename std::decay<decltype(m.apply(to_expression(v).eval()))>::type>
+{
+	return m.apply(to_expression(v).eval());
+}
+
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+
+#include "config.hpp"
+
+namespace r4{
+
+/**
+ * @brief Fixed-point number.
+ * Signed 32-bit fixed-point number with given number of fractional bits, e.g. fixed<16> is the Q16.16 format.
+ * Addition and subtraction are exact and wrap around on overflow as for integers, multiplication and division
+ * round the result to nearest.
+ * fixed is implicitly constructible from arithmetic types and explicitly convertible to them,
+ * so it can be used as component type of vector2, vector3, vector4 and quaternion.
+ * All operations are constexpr.
+ * @param frac_bits - number of fractional bits.
+ */
+template <unsigned frac_bits> class fixed{
+	static_assert(frac_bits < 31, "too many fractional bits");
+
+	int32_t v;
+
+	static constexpr int64_t one = int64_t(1) << frac_bits;
+
+	struct from_raw_tag{};
+
+	constexpr fixed(int32_t raw, from_raw_tag)noexcept :
+			v(raw)
+	{}
+
+	// wrap around as for unsigned integers, signed overflow is undefined behaviour
+	static constexpr int32_t wrap(int64_t n)noexcept{
+		return int32_t(uint32_t(uint64_t(n)));
+	}
+
+	// convert floating point number to int32_t truncating towards zero, out of range values are saturated, NaN gives 0,
+	// conversion of out of range value with int32_t(n) is undefined behaviour
+	template <class N> static constexpr int32_t saturate(N n)noexcept{
+		if(n >= N(2147483648.0)){
+			return std::numeric_limits<int32_t>::max();
+		}
+		if(n <= N(-2147483649.0)){
+			return std::numeric_limits<int32_t>::min();
+		}
+		if(n != n){
+			return 0;
+		}
+		return int32_t(n);
+	}
+
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the number.
+	 */
+	fixed() = default;
+
+	/**
+	 * @brief Construct from integral type.
+	 * @param n - integer number to convert to fixed-point.
+	 */
+	template <class N, typename std::enable_if<std::is_integral<N>::value, bool>::type = true> constexpr fixed(N n)noexcept :
+			v(wrap(int64_t(n) * one))
+	{}
+
+	/**
+	 * @brief Construct from floating point type.
+	 * @param n - number to convert to fixed-point, it is rounded to nearest representable number.
+	 *            Numbers out of the representable range are saturated to lowest() or max(), NaN is converted to 0.
+	 */
+	template <class N, typename std::enable_if<std::is_floating_point<N>::value, bool>::type = true> constexpr fixed(N n)noexcept :
+			v(saturate(n * N(one) + (n < 0 ? N(-0.5) : N(0.5))))
+	{}
+
+	/**
+	 * @brief Create fixed-point number from its raw representation.
+	 * @param raw - raw representation, i.e. the number multiplied by 2^frac_bits.
+	 * @return fixed-point number.
+	 */
+	static constexpr fixed from_raw(int32_t raw)noexcept{
+		return fixed(raw, from_raw_tag());
+	}
+
+	/**
+	 * @brief Get raw representation.
+	 * @return the number multiplied by 2^frac_bits.
+	 */
+	constexpr int32_t raw()const noexcept{
+		return this->v;
+	}
+
+	/**
+	 * @brief Convert to arithmetic type.
+	 * Conversion to integral type truncates towards zero.
+	 * @return the number converted to the given arithmetic type.
+	 */
+	template <class N, typename std::enable_if<std::is_arithmetic<N>::value, bool>::type = true> explicit constexpr operator N()const noexcept{
+		if(std::is_floating_point<N>::value){
+			return N(this->v) / N(one);
+		}
+		return N(this->v / one);
+	}
+
+	constexpr fixed operator-()const noexcept{
+		return from_raw(wrap(-int64_t(this->v)));
+	}
+
+	constexpr fixed operator+()const noexcept{
+		return *this;
+	}
+
+	friend constexpr fixed operator+(fixed a, fixed b)noexcept{
+		return from_raw(wrap(int64_t(a.v) + b.v));
+	}
+
+	friend constexpr fixed operator-(fixed a, fixed b)noexcept{
+		return from_raw(wrap(int64_t(a.v) - b.v));
+	}
+
+	friend constexpr fixed operator*(fixed a, fixed b)noexcept{
+		int64_t p = int64_t(a.v) * b.v;
+		if(frac_bits == 0){
+			return from_raw(wrap(p));
+		}
+		// NOTE: right shift of negative number is arithmetic on all supported compilers
+		return from_raw(wrap((p + (one >> 1)) >> frac_bits));
+	}
+
+	friend constexpr fixed operator/(fixed a, fixed b)noexcept{
+		R4_ASSERT_INFO(b.v != 0, "fixed::operator/(): division by 0");
+		int64_t n = int64_t(a.v) * one;
+		int64_t q = n / b.v;
+		int64_t r = n % b.v;
+		// round to nearest, the remainder has the sign of the dividend
+		if(2 * (r < 0 ? -r : r) >= (b.v < 0 ? -int64_t(b.v) : int64_t(b.v))){
+			q += (n < 0) == (b.v < 0) ? 1 : -1;
+		}
+		return from_raw(wrap(q));
+	}
+
+	constexpr fixed& operator+=(fixed f)noexcept{
+		return *this = *this + f;
+	}
+
+	constexpr fixed& operator-=(fixed f)noexcept{
+		return *this = *this - f;
+	}
+
+	constexpr fixed& operator*=(fixed f)noexcept{
+		return *this = *this * f;
+	}
+
+	constexpr fixed& operator/=(fixed f)noexcept{
+		return *this = *this / f;
+	}
+
+	friend constexpr bool operator==(fixed a, fixed b)noexcept{
+		return a.v == b.v;
+	}
+
+	friend constexpr bool operator!=(fixed a, fixed b)noexcept{
+		return a.v != b.v;
+	}
+
+	friend constexpr bool operator<(fixed a, fixed b)noexcept{
+		return a.v < b.v;
+	}
+
+	friend constexpr bool operator<=(fixed a, fixed b)noexcept{
+		return a.v <= b.v;
+	}
+
+	friend constexpr bool operator>(fixed a, fixed b)noexcept{
+		return a.v > b.v;
+	}
+
+	friend constexpr bool operator>=(fixed a, fixed b)noexcept{
+		return a.v >= b.v;
+	}
+
+	/**
+	 * @brief Square root.
+	 * The result is truncated.
+	 * @param f - non-negative number to calculate square root of.
+	 * @return square root of the number.
+	 */
+	friend constexpr fixed sqrt(fixed f)noexcept{
+		R4_ASSERT_INFO(f.v >= 0, "sqrt(fixed): negative argument");
+		if(f.v <= 0){
+			return from_raw(0);
+		}
+
+		// integer square root of the raw value scaled by 2^frac_bits, bit by bit
+		uint64_t n = uint64_t(f.v) << frac_bits;
+		uint64_t res = 0;
+		uint64_t bit = uint64_t(1) << 62;
+		while(bit > n){
+			bit >>= 2;
+		}
+		while(bit != 0){
+			if(n >= res + bit){
+				n -= res + bit;
+				res = (res >> 1) + bit;
+			}else{
+				res >>= 1;
+			}
+			bit >>= 2;
+		}
+		return from_raw(int32_t(res));
+	}
+
+	friend constexpr fixed abs(fixed f)noexcept{
+		return f.v < 0 ? -f : f;
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, fixed f){
+		return s << double(f);
+	}
+};
+
+static_assert(sizeof(fixed<16>) == 4, "size mismatch");
+
+}
+
+namespace std{
+template <unsigned frac_bits> class numeric_limits<r4::fixed<frac_bits>>{
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = true;
+	static constexpr bool has_infinity = false;
+	static constexpr bool has_quiet_NaN = false;
+	static constexpr bool has_signaling_NaN = false;
+	static constexpr bool is_iec559 = false;
+	static constexpr bool is_bounded = true;
+	static constexpr bool is_modulo = true;
+	static constexpr int digits = 31;
+	static constexpr int radix = 2;
+	static constexpr float_round_style round_style = round_to_nearest;
+
+	static constexpr r4::fixed<frac_bits> min()noexcept{ return r4::fixed<frac_bits>::from_raw(1); }
+	static constexpr r4::fixed<frac_bits> lowest()noexcept{ return r4::fixed<frac_bits>::from_raw(numeric_limits<int32_t>::min()); }
+	static constexpr r4::fixed<frac_bits> max()noexcept{ return r4::fixed<frac_bits>::from_raw(numeric_limits<int32_t>::max()); }
+	static constexpr r4::fixed<frac_bits> epsilon()noexcept{ return r4::fixed<frac_bits>::from_raw(1); }
+	static constexpr r4::fixed<frac_bits> round_error()noexcept{ return r4::fixed<frac_bits>::from_raw(1); }
+};
+}
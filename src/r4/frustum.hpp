@@ -0,0 +1,294 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "vector4.hpp"
+#include "matrix4.hpp"
+#include "aabb3.hpp"
+#include "simd.hpp"
+
+namespace r4{
+
+/**
+ * @brief View frustum for visibility culling.
+ * The frustum is represented by six planes in the order: left, right, bottom, top, near, far.
+ * Each plane is stored as vector4 (a, b, c, d) such that a point (x, y, z) is on the inner side
+ * of the plane when a * x + b * y + c * z + d >= 0. Plane normals (a, b, c) are of unit length.
+ * The culling tests are conservative, i.e. an object is reported as visible if it intersects the frustum,
+ * but some objects near frustum corners which do not intersect it can also be reported as visible.
+ */
+template <class T> class frustum : public std::array<vector4<T>, 6>{
+	typedef std::array<vector4<T>, 6> base_type;
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the planes.
+	 */
+	frustum() = default;
+
+	/**
+	 * @brief Extract frustum planes from a transformation matrix.
+	 * The matrix is thought of as transforming points to the clip space in which the visible volume
+	 * is -w <= x, y, z <= w, as it is for matrices built with matrix4::set_frustum().
+	 * For a combined projection * view * model matrix the planes are extracted in the model space.
+	 * Planes with zero normal, e.g. the far plane of matrix4::set_perspective_infinite(), are replaced with
+	 * the plane (0, 0, 0, 1) which all points pass.
+	 * @param m - matrix to extract the frustum planes from.
+	 */
+	explicit frustum(const matrix4<T>& m)noexcept :
+			base_type{{
+				m[3] + m[0], // left
+				m[3] - m[0], // right
+				m[3] + m[1], // bottom
+				m[3] - m[1], // top
+				m[3] + m[2], // near
+				m[3] - m[2] // far
+			}}
+	{
+		for(auto& p : *this){
+			using std::sqrt;
+			T n = sqrt(p.x() * p.x() + p.y() * p.y() + p.z() * p.z());
+			if(n == 0){
+				// the plane is at infinity
+				p = vector4<T>(0, 0, 0, 1);
+				continue;
+			}
+			p /= n;
+		}
+	}
+
+	/**
+	 * @brief Test if the point is inside of the frustum.
+	 * @param p - point to test.
+	 * @return true if the point is inside of the frustum or on its boundary.
+	 * @return false otherwise.
+	 */
+	bool contains(const vector3<T>& p)const noexcept{
+		for(auto& pl : *this){
+			if(pl.x() * p.x() + pl.y() * p.y() + pl.z() * p.z() + pl.w() < 0){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Test if the box intersects the frustum.
+	 * The box is reported as not intersecting the frustum only if it is completely on the outer side of one of the planes.
+	 * @param b - box to test.
+	 * @return true if the box intersects the frustum.
+	 * @return false otherwise.
+	 */
+	bool intersects(const aabb3<T>& b)const noexcept{
+		using std::abs;
+		auto c = b.center();
+		auto e = b.extent();
+		for(auto& pl : *this){
+			T d = pl.x() * c.x() + pl.y() * c.y() + pl.z() * c.z() + pl.w();
+			T r = abs(pl.x()) * e.x() + abs(pl.y()) * e.y() + abs(pl.z()) * e.z();
+			if(d + r < 0){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Test if the sphere intersects the frustum.
+	 * The sphere is reported as not intersecting the frustum only if it is completely on the outer side of one of the planes.
+	 * @param s - sphere to test, (x, y, z) components are the sphere center and w component is the sphere radius.
+	 * @return true if the sphere intersects the frustum.
+	 * @return false otherwise.
+	 */
+	bool intersects(const vector4<T>& s)const noexcept{
+		for(auto& pl : *this){
+			if(pl.x() * s.x() + pl.y() * s.y() + pl.z() * s.z() + pl.w() + s.w() < 0){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Cull boxes against the frustum.
+	 * Tests all the boxes and writes the results as a bit mask.
+	 * Bit (i % 32) of visible[i / 32] is set if i'th box intersects the frustum and cleared otherwise.
+	 * @param boxes - boxes to test.
+	 * @param size - number of boxes.
+	 * @param visible - output bit mask, must have space for at least (size + 31) / 32 words.
+	 */
+	void cull_mask(const aabb3<T>* boxes, size_t size, uint32_t* visible)const noexcept;
+
+	/**
+	 * @brief Cull spheres against the frustum.
+	 * Tests all the spheres and writes the results as a bit mask.
+	 * Bit (i % 32) of visible[i / 32] is set if i'th sphere intersects the frustum and cleared otherwise.
+	 * @param spheres - spheres to test, (x, y, z) components are the sphere center and w component is the sphere radius.
+	 * @param size - number of spheres.
+	 * @param visible - output bit mask, must have space for at least (size + 31) / 32 words.
+	 */
+	void cull_mask(const vector4<T>* spheres, size_t size, uint32_t* visible)const noexcept;
+
+	/**
+	 * @brief Cull boxes against the frustum.
+	 * Tests all the boxes and writes indices of the boxes which intersect the frustum.
+	 * @param boxes - boxes to test.
+	 * @param size - number of boxes.
+	 * @param visible - output array of indices in increasing order, must have space for at least size indices.
+	 * @return number of indices written to the output array.
+	 */
+	size_t cull_indices(const aabb3<T>* boxes, size_t size, uint32_t* visible)const noexcept{
+		return this->cull_indices_impl(boxes, size, visible);
+	}
+
+	/**
+	 * @brief Cull spheres against the frustum.
+	 * Tests all the spheres and writes indices of the spheres which intersect the frustum.
+	 * @param spheres - spheres to test, (x, y, z) components are the sphere center and w component is the sphere radius.
+	 * @param size - number of spheres.
+	 * @param visible - output array of indices in increasing order, must have space for at least size indices.
+	 * @return number of indices written to the output array.
+	 */
+	size_t cull_indices(const vector4<T>* spheres, size_t size, uint32_t* visible)const noexcept{
+		return this->cull_indices_impl(spheres, size, visible);
+	}
+
+private:
+	template <class V> void cull_mask_impl(const V* v, size_t size, uint32_t* visible)const noexcept{
+		std::fill(visible, visible + (size + 31) / 32, 0);
+		for(size_t i = 0; i != size; ++i){
+			if(this->intersects(v[i])){
+				visible[i / 32] |= uint32_t(1) << (i % 32);
+			}
+		}
+	}
+
+	// culls chunks of objects to bit mask on stack and compacts the mask into indices
+	template <class V> size_t cull_indices_impl(const V* v, size_t size, uint32_t* visible)const noexcept{
+		ASSERT(size <= size_t(~uint32_t(0)))
+		const size_t chunk_words = 8;
+		const size_t chunk_size = chunk_words * 32;
+		uint32_t* out = visible;
+		for(size_t i = 0; i < size; i += chunk_size){
+			uint32_t masks[chunk_words];
+			size_t n = std::min(size - i, chunk_size);
+			this->cull_mask(v + i, n, masks);
+			for(size_t w = 0; w != (n + 31) / 32; ++w){
+				// branchless compaction, index is always written but the output pointer is advanced only for visible ones
+				uint32_t mask = masks[w];
+				for(uint32_t j = uint32_t(i + w * 32); mask != 0; ++j, mask >>= 1){
+					*out = j;
+					out += mask & 1;
+				}
+			}
+		}
+		return size_t(out - visible);
+	}
+};
+
+template <class T> void frustum<T>::cull_mask(const aabb3<T>* boxes, size_t size, uint32_t* visible)const noexcept{
+	this->cull_mask_impl(boxes, size, visible);
+}
+
+template <class T> void frustum<T>::cull_mask(const vector4<T>* spheres, size_t size, uint32_t* visible)const noexcept{
+	this->cull_mask_impl(spheres, size, visible);
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of frustum<float> culling, 4 objects are tested against all planes at once
+
+template <> inline void frustum<float>::cull_mask(const aabb3<float>* boxes, size_t size, uint32_t* visible)const noexcept{
+	std::fill(visible, visible + (size + 31) / 32, 0);
+
+	simd::float4 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+	for(unsigned k = 0; k != 6; ++k){
+		auto& pl = (*this)[k];
+		nx[k] = simd::splat(pl.x());
+		ny[k] = simd::splat(pl.y());
+		nz[k] = simd::splat(pl.z());
+		nw[k] = simd::splat(pl.w());
+		ax[k] = simd::abs(nx[k]);
+		ay[k] = simd::abs(ny[k]);
+		az[k] = simd::abs(nz[k]);
+	}
+
+	const auto zero = simd::splat(0.0f);
+	const auto half = simd::splat(0.5f);
+
+	auto p = reinterpret_cast<const float*>(boxes);
+
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4, p += 6 * 4){
+		// each box is (x1, y1, z1, x2, y2, z2), load (x1, y1, z1, x2) and (z1, x2, y2, z2) of every box and transpose
+		simd::float4 x1 = simd::load(p), y1 = simd::load(p + 6), z1 = simd::load(p + 12), x2 = simd::load(p + 18);
+		simd::transpose(x1, y1, z1, x2);
+		simd::float4 z1_dup = simd::load(p + 2), x2_dup = simd::load(p + 8), y2 = simd::load(p + 14), z2 = simd::load(p + 20);
+		simd::transpose(z1_dup, x2_dup, y2, z2);
+
+		auto cx = simd::mul(simd::add(x1, x2), half);
+		auto cy = simd::mul(simd::add(y1, y2), half);
+		auto cz = simd::mul(simd::add(z1, z2), half);
+		auto ex = simd::mul(simd::sub(x2, x1), half);
+		auto ey = simd::mul(simd::sub(y2, y1), half);
+		auto ez = simd::mul(simd::sub(z2, z1), half);
+
+		unsigned bits = 0xf;
+		for(unsigned k = 0; k != 6; ++k){
+			auto d = simd::mul_add(nx[k], cx, simd::mul_add(ny[k], cy, simd::mul_add(nz[k], cz, nw[k])));
+			auto r = simd::mul_add(ax[k], ex, simd::mul_add(ay[k], ey, simd::mul(az[k], ez)));
+			bits &= simd::mask_bits(simd::cmp_le(zero, simd::add(d, r)));
+		}
+		visible[i / 32] |= uint32_t(bits) << (i % 32);
+	}
+	for(; i != size; ++i){
+		if(this->intersects(boxes[i])){
+			visible[i / 32] |= uint32_t(1) << (i % 32);
+		}
+	}
+}
+
+template <> inline void frustum<float>::cull_mask(const vector4<float>* spheres, size_t size, uint32_t* visible)const noexcept{
+	std::fill(visible, visible + (size + 31) / 32, 0);
+
+	simd::float4 nx[6], ny[6], nz[6], nw[6];
+	for(unsigned k = 0; k != 6; ++k){
+		auto& pl = (*this)[k];
+		nx[k] = simd::splat(pl.x());
+		ny[k] = simd::splat(pl.y());
+		nz[k] = simd::splat(pl.z());
+		nw[k] = simd::splat(pl.w());
+	}
+
+	const auto zero = simd::splat(0.0f);
+
+	auto p = reinterpret_cast<const float*>(spheres);
+
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4, p += 4 * 4){
+		simd::float4 x = simd::load(p), y = simd::load(p + 4), z = simd::load(p + 8), r = simd::load(p + 12);
+		simd::transpose(x, y, z, r);
+
+		unsigned bits = 0xf;
+		for(unsigned k = 0; k != 6; ++k){
+			auto d = simd::mul_add(nx[k], x, simd::mul_add(ny[k], y, simd::mul_add(nz[k], z, simd::add(nw[k], r))));
+			bits &= simd::mask_bits(simd::cmp_le(zero, d));
+		}
+		visible[i / 32] |= uint32_t(bits) << (i % 32);
+	}
+	for(; i != size; ++i){
+		if(this->intersects(spheres[i])){
+			visible[i / 32] |= uint32_t(1) << (i % 32);
+		}
+	}
+}
+
+#endif
+
+}
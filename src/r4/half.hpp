@@ -0,0 +1,258 @@
+#pragma once
+
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__) && !defined(R4_NO_SIMD)
+#	include <immintrin.h>
+#	define R4_HALF_F16C
+#endif
+
+namespace r4{
+
+/**
+ * @brief 16-bit floating point number.
+ * IEEE 754 binary16 number with 1 sign bit, 5 exponent bits and 10 mantissa bits.
+ * Intended for storage-compressed data, e.g. vector3<half> takes 6 bytes instead of 12.
+ * Arithmetic operations are done by converting the operands to float and rounding the result back to half,
+ * conversion from float rounds to nearest even. Conversions use F16C instructions when enabled for the compiler.
+ * half is implicitly constructible from arithmetic types and explicitly convertible to them,
+ * so it can be used as component type of vector2, vector3, vector4 and quaternion.
+ */
+class half{
+	uint16_t v;
+
+	struct from_bits_tag{};
+
+	constexpr half(uint16_t bits, from_bits_tag)noexcept :
+			v(bits)
+	{}
+
+	static uint32_t float_bits(float f)noexcept{
+		uint32_t ret;
+		std::memcpy(&ret, &f, sizeof(ret));
+		return ret;
+	}
+
+	static float bits_float(uint32_t b)noexcept{
+		float ret;
+		std::memcpy(&ret, &b, sizeof(ret));
+		return ret;
+	}
+
+	static uint16_t from_float(float f)noexcept{
+#ifdef R4_HALF_F16C
+		return uint16_t(_cvtss_sh(f, 0));
+#else
+		const uint32_t f32_infinity = uint32_t(255) << 23;
+		const uint32_t f16_max = uint32_t(127 + 16) << 23;
+		const uint32_t denorm_magic = uint32_t((127 - 15) + (23 - 10) + 1) << 23;
+
+		uint32_t x = float_bits(f);
+		uint32_t sign = x & 0x80000000;
+		x ^= sign;
+
+		uint16_t ret;
+		if(x >= f16_max){
+			// infinity or NaN, NaN is converted to quiet NaN
+			ret = x > f32_infinity ? 0x7e00 : 0x7c00;
+		}else if(x < (uint32_t(113) << 23)){
+			// result is subnormal or zero, align mantissa bits with magic number addition
+			// which also rounds to nearest even
+			ret = uint16_t(float_bits(bits_float(x) + bits_float(denorm_magic)) - denorm_magic);
+		}else{
+			uint32_t mantissa_odd = (x >> 13) & 1;
+			// rebias exponent and round to nearest even
+			x += ((uint32_t(15) - uint32_t(127)) << 23) + 0xfff;
+			x += mantissa_odd;
+			ret = uint16_t(x >> 13);
+		}
+		return uint16_t(ret | (sign >> 16));
+#endif
+	}
+
+	static float to_float(uint16_t h)noexcept{
+#ifdef R4_HALF_F16C
+		return _cvtsh_ss(h);
+#else
+		const uint32_t shifted_exp = uint32_t(0x7c00) << 13;
+
+		uint32_t ret = uint32_t(h & 0x7fff) << 13;
+		uint32_t exp = ret & shifted_exp;
+		ret += uint32_t(127 - 15) << 23;
+
+		if(exp == shifted_exp){
+			// infinity or NaN
+			ret += uint32_t(128 - 16) << 23;
+		}else if(exp == 0){
+			// zero or subnormal, renormalize
+			ret += uint32_t(1) << 23;
+			ret = float_bits(bits_float(ret) - bits_float(uint32_t(113) << 23));
+		}
+
+		return bits_float(ret | (uint32_t(h & 0x8000) << 16));
+#endif
+	}
+
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the number.
+	 */
+	half() = default;
+
+	/**
+	 * @brief Construct from arithmetic type.
+	 * @param n - number to convert to half, it is rounded to nearest representable half.
+	 */
+	template <class N, typename std::enable_if<std::is_arithmetic<N>::value, bool>::type = true> half(N n)noexcept :
+			v(from_float(float(n)))
+	{}
+
+	/**
+	 * @brief Create half from its binary representation.
+	 * @param bits - binary representation of the half.
+	 * @return half number.
+	 */
+	static constexpr half from_bits(uint16_t bits)noexcept{
+		return half(bits, from_bits_tag());
+	}
+
+	/**
+	 * @brief Get binary representation.
+	 * @return binary representation of the half.
+	 */
+	constexpr uint16_t bits()const noexcept{
+		return this->v;
+	}
+
+	/**
+	 * @brief Convert to arithmetic type.
+	 * @return the number converted to the given arithmetic type.
+	 */
+	template <class N, typename std::enable_if<std::is_arithmetic<N>::value, bool>::type = true> explicit operator N()const noexcept{
+		return N(to_float(this->v));
+	}
+
+	constexpr half operator-()const noexcept{
+		return from_bits(this->v ^ 0x8000);
+	}
+
+	constexpr half operator+()const noexcept{
+		return *this;
+	}
+
+	friend half operator+(half a, half b)noexcept{
+		return half(float(a) + float(b));
+	}
+
+	friend half operator-(half a, half b)noexcept{
+		return half(float(a) - float(b));
+	}
+
+	friend half operator*(half a, half b)noexcept{
+		return half(float(a) * float(b));
+	}
+
+	friend half operator/(half a, half b)noexcept{
+		return half(float(a) / float(b));
+	}
+
+	half& operator+=(half h)noexcept{
+		return *this = *this + h;
+	}
+
+	half& operator-=(half h)noexcept{
+		return *this = *this - h;
+	}
+
+	half& operator*=(half h)noexcept{
+		return *this = *this * h;
+	}
+
+	half& operator/=(half h)noexcept{
+		return *this = *this / h;
+	}
+
+	friend bool operator==(half a, half b)noexcept{
+		return float(a) == float(b);
+	}
+
+	friend bool operator!=(half a, half b)noexcept{
+		return float(a) != float(b);
+	}
+
+	friend bool operator<(half a, half b)noexcept{
+		return float(a) < float(b);
+	}
+
+	friend bool operator<=(half a, half b)noexcept{
+		return float(a) <= float(b);
+	}
+
+	friend bool operator>(half a, half b)noexcept{
+		return float(a) > float(b);
+	}
+
+	friend bool operator>=(half a, half b)noexcept{
+		return float(a) >= float(b);
+	}
+
+	friend half sqrt(half h)noexcept{
+		using std::sqrt;
+		return half(sqrt(float(h)));
+	}
+
+	friend constexpr half abs(half h)noexcept{
+		return from_bits(h.v & 0x7fff);
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, half h){
+		return s << float(h);
+	}
+};
+
+static_assert(sizeof(half) == 2, "size mismatch");
+
+}
+
+namespace std{
+template <> class numeric_limits<r4::half>{
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = false;
+	static constexpr bool has_infinity = true;
+	static constexpr bool has_quiet_NaN = true;
+	static constexpr bool has_signaling_NaN = true;
+	static constexpr float_denorm_style has_denorm = denorm_present;
+	static constexpr bool has_denorm_loss = false;
+	static constexpr bool is_iec559 = true;
+	static constexpr bool is_bounded = true;
+	static constexpr bool is_modulo = false;
+	static constexpr int digits = 11;
+	static constexpr int digits10 = 3;
+	static constexpr int max_digits10 = 5;
+	static constexpr int radix = 2;
+	static constexpr int min_exponent = -13;
+	static constexpr int min_exponent10 = -4;
+	static constexpr int max_exponent = 16;
+	static constexpr int max_exponent10 = 4;
+	static constexpr float_round_style round_style = round_to_nearest;
+
+	static constexpr r4::half min()noexcept{ return r4::half::from_bits(0x0400); }
+	static constexpr r4::half lowest()noexcept{ return r4::half::from_bits(0xfbff); }
+	static constexpr r4::half max()noexcept{ return r4::half::from_bits(0x7bff); }
+	static constexpr r4::half epsilon()noexcept{ return r4::half::from_bits(0x1400); }
+	static constexpr r4::half round_error()noexcept{ return r4::half::from_bits(0x3800); }
+	static constexpr r4::half infinity()noexcept{ return r4::half::from_bits(0x7c00); }
+	static constexpr r4::half quiet_NaN()noexcept{ return r4::half::from_bits(0x7e00); }
+	static constexpr r4::half signaling_NaN()noexcept{ return r4::half::from_bits(0x7d00); }
+	static constexpr r4::half denorm_min()noexcept{ return r4::half::from_bits(0x0001); }
+};
+}
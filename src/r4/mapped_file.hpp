@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Read-only memory-mapped file.
+ * Maps the whole file into memory, the pages of the file are read by the OS on first access,
+ * so opening even very large files is fast. The mapping is at page boundary.
+ * Intended to be used together with binary_view for loading binary arrays of r4 types without copying:
+ * @code
+ * r4::mapped_file f("transforms.bin");
+ * r4::binary_view<r4::matrix4<float>> transforms(f.data(), f.size());
+ * @endcode
+ * The mapped_file must outlive the views of its memory.
+ */
+class mapped_file{
+	const void* ptr = nullptr;
+	size_t num_bytes = 0;
+
+	void unmap()noexcept{
+		if(!this->ptr){
+			return;
+		}
+#if defined(_WIN32)
+		UnmapViewOfFile(this->ptr);
+#else
+		munmap(const_cast<void*>(this->ptr), this->num_bytes);
+#endif
+		this->ptr = nullptr;
+		this->num_bytes = 0;
+	}
+
+public:
+	/**
+	 * @brief Construct object not mapping any file.
+	 */
+	mapped_file() = default;
+
+	/**
+	 * @brief Map file into memory.
+	 * @param path - path to the file to map.
+	 * @throw std::system_error - in case the file could not be opened or mapped.
+	 */
+	explicit mapped_file(const std::string& path){
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(file == INVALID_HANDLE_VALUE){
+			throw std::system_error(int(GetLastError()), std::system_category(), "could not open file: " + path);
+		}
+
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(file, &size)){
+			auto error = GetLastError();
+			CloseHandle(file);
+			throw std::system_error(int(error), std::system_category(), "could not get file size: " + path);
+		}
+
+		// empty files cannot be mapped
+		if(size.QuadPart == 0){
+			CloseHandle(file);
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		auto error = GetLastError();
+		CloseHandle(file);
+		if(!mapping){
+			throw std::system_error(int(error), std::system_category(), "could not map file: " + path);
+		}
+
+		// the view keeps the mapping alive, so the mapping handle can be closed right away
+		this->ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		error = GetLastError();
+		CloseHandle(mapping);
+		if(!this->ptr){
+			throw std::system_error(int(error), std::system_category(), "could not map file: " + path);
+		}
+		this->num_bytes = size_t(size.QuadPart);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if(fd < 0){
+			throw std::system_error(errno, std::generic_category(), "could not open file: " + path);
+		}
+
+		struct stat st;
+		if(fstat(fd, &st) != 0){
+			int error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "could not get file size: " + path);
+		}
+
+		// empty files cannot be mapped
+		if(st.st_size == 0){
+			::close(fd);
+			return;
+		}
+
+		// the mapping stays valid after the file descriptor is closed
+		void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		int error = errno;
+		::close(fd);
+		if(p == MAP_FAILED){
+			throw std::system_error(error, std::generic_category(), "could not map file: " + path);
+		}
+		this->ptr = p;
+		this->num_bytes = size_t(st.st_size);
+#endif
+	}
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	mapped_file(mapped_file&& f)noexcept :
+			ptr(f.ptr),
+			num_bytes(f.num_bytes)
+	{
+		f.ptr = nullptr;
+		f.num_bytes = 0;
+	}
+
+	mapped_file& operator=(mapped_file&& f)noexcept{
+		if(this != &f){
+			this->unmap();
+			std::swap(this->ptr, f.ptr);
+			std::swap(this->num_bytes, f.num_bytes);
+		}
+		return *this;
+	}
+
+	~mapped_file()noexcept{
+		this->unmap();
+	}
+
+	/**
+	 * @brief Get pointer to the mapped memory.
+	 * @return pointer to the beginning of the mapped file.
+	 * @return nullptr if no file is mapped or the file is empty.
+	 */
+	const void* data()const noexcept{
+		return this->ptr;
+	}
+
+	/**
+	 * @brief Get size of the mapped memory.
+	 * @return size of the mapped file in bytes.
+	 */
+	size_t size()const noexcept{
+		return this->num_bytes;
+	}
+};
+
+}
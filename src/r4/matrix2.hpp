@@ -5,15 +5,19 @@
 #include <algorithm>
 #include <iostream>
 #include <array>
+#include <cstddef>
 
 #include <utki/debug.hpp>
 
+#include "config.hpp"
+
 #include "vector2.hpp"
 #include "vector3.hpp"
 
 namespace r4{
 
 template <typename T> class vector2;
+template <class T> class rectangle;
 
 /**
  * @brief 2x3 matrix template class.
@@ -49,7 +53,7 @@ public:
 	 * @brief Convert to different element type.
 	 * @return matrix2 with converted element type.
 	 */
-	template <typename TT> matrix2<TT> to()noexcept{
+	template <typename TT> constexpr matrix2<TT> to()noexcept{
 		return matrix2<TT>{
 				this->row(0).template to<TT>(),
 				this->row(1).template to<TT>()
@@ -61,7 +65,7 @@ public:
 	 * @param m - matrix to subtract from this matrix.
 	 * @return resulting matrix of the subtraction.
 	 */
-	matrix2 operator-(const matrix2& m)const noexcept{
+	constexpr matrix2 operator-(const matrix2& m)const noexcept{
 		return {
 				this->row(0) - m.row(0),
 				this->row(1) - m.row(1)
@@ -78,15 +82,44 @@ public:
 	 * @param vec - vector2 to transform.
      * @return Transformed vector.
      */
-	vector2<T> operator*(const vector2<T>& vec)const noexcept;
+	constexpr vector2<T> operator*(const vector2<T>& vec)const noexcept;
+
+	/**
+	 * @brief Transform points.
+	 * Same as multiplying each point by this matrix, see operator*(vector2).
+	 * Typically used to transform vertices of 2d geometry, e.g. corners of quads.
+	 * @param src - source points.
+	 * @param dst - destination points, can be the same as src, but otherwise the ranges must not overlap.
+	 * @param size - number of points.
+	 */
+	void transform_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform points in place.
+	 * @param points - points to transform.
+	 * @param size - number of points.
+	 */
+	void transform_points(vector2<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Transform points and calculate their bounding rectangle.
+	 * Same as transform_points(), but also calculates the bounding rectangle of the transformed points in the same pass.
+	 * @param src - source points.
+	 * @param dst - destination points, can be the same as src, but otherwise the ranges must not overlap.
+	 * @param size - number of points.
+	 * @return bounding rectangle of the transformed points. Rectangle with all components 0 if size is 0.
+	 */
+	rectangle<T> transform_points_bound(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept;
 
 	/**
 	 * @brief Get matrix row.
 	 * @param index - row index to get, must be from 0 to 1.
      * @return reference to vector3 representing the row of this matrix.
      */
-	vector3<T>& row(unsigned index)noexcept{
-		ASSERT(index < 2)
+	constexpr vector3<T>& row(unsigned index)noexcept{
+		R4_ASSERT(index < 2);
 		return this->operator[](index);
 	}
 
@@ -95,8 +128,8 @@ public:
 	 * @param index - row index to get, must be from 0 to 1.
      * @return constant reference to vector3 representing the row of this matrix.
      */
-	const vector3<T>& row(unsigned index)const noexcept{
-		ASSERT(index < 2)
+	constexpr const vector3<T>& row(unsigned index)const noexcept{
+		R4_ASSERT(index < 2);
 		return this->operator[](index);
 	}
 
@@ -106,7 +139,7 @@ public:
 	 * @param index - column index to get, must be from 0 to 2;
 	 * @return vector2 representing the requested matrix column.
 	 */
-	vector2<T> col(unsigned index)const noexcept{
+	constexpr vector2<T> col(unsigned index)const noexcept{
 		return vector2<T>{
 				this->row(0)[index],
 				this->row(1)[index]
@@ -117,8 +150,10 @@ public:
 	 * @brief Transpose matrix.
      * The last column iz zeroed out.
 	 */
-	matrix2& transpose()noexcept{
-		std::swap(this->row(1)[0], this->row(0)[1]);
+	constexpr matrix2& transpose()noexcept{
+		T t = this->row(1)[0];
+		this->row(1)[0] = this->row(0)[1];
+		this->row(0)[1] = t;
 		this->row(0)[2] = T(0);
         this->row(1)[2] = T(0);
 		return *this;
@@ -131,7 +166,7 @@ public:
 	 * @param matr - matrix to multiply by (matrix K).
      * @return New matrix as a result of matrices product.
      */
-	matrix2 operator*(const matrix2& matr)const noexcept{
+	constexpr matrix2 operator*(const matrix2& matr)const noexcept{
 		return matrix2{
 				vector3<T>{this->row(0) * matr.col(0), this->row(0) * matr.col(1), this->row(0) * matr.col(2) + this->row(0)[2]},
 				vector3<T>{this->row(1) * matr.col(0), this->row(1) * matr.col(1), this->row(1) * matr.col(2) + this->row(1)[2]},
@@ -143,7 +178,7 @@ public:
 	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
      * @return reference to this matrix object.
      */
-	matrix2& operator*=(const matrix2& matr)noexcept{
+	constexpr matrix2& operator*=(const matrix2& matr)noexcept{
 		return this->operator=(this->operator*(matr));
 	}
 
@@ -165,7 +200,7 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix2& right_multiply(const matrix2& matr)noexcept{
+	constexpr matrix2& right_multiply(const matrix2& matr)noexcept{
 		return this->operator*=(matr);
 	}
 
@@ -175,14 +210,14 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix2& left_multiply(const matrix2& matr)noexcept{
+	constexpr matrix2& left_multiply(const matrix2& matr)noexcept{
 		return this->operator=(matr.operator*(*this));
 	}
 
 	/**
 	 * @brief Initialize this matrix with identity matrix.
 	 */
-	matrix2& set_identity()noexcept{
+	constexpr matrix2& set_identity()noexcept{
 		this->row(0) = {1, 0, 0};
 		this->row(1) = {0, 1, 0};
 		return *this;
@@ -195,7 +230,7 @@ public:
 	 * @param y - scaling factor in y direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix2& scale(T x, T y)noexcept{
+	constexpr matrix2& scale(T x, T y)noexcept{
 		// multiply this matrix from the right by the scale matrix:
 		//               / x 0 0 \
 		// this = this * \ 0 y 0 /
@@ -219,7 +254,7 @@ public:
 	 * @param s - scaling factor to be applied in all 2 directions (x and y).
 	 * @return reference to this matrix instance.
 	 */
-	matrix2& scale(T s)noexcept{
+	constexpr matrix2& scale(T s)noexcept{
 		return this->scale(s, s);
 	}
 
@@ -229,7 +264,7 @@ public:
 	 * @param s - vector of scaling factors in x and y directions, scaling factor in z direction is 1.
 	 * @return reference to this matrix instance.
 	 */
-	matrix2& scale(const vector2<T>& s)noexcept;
+	constexpr matrix2& scale(const vector2<T>& s)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by translation matrix.
@@ -238,7 +273,7 @@ public:
 	 * @param y - y component of translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix2& translate(T x, T y)noexcept{
+	constexpr matrix2& translate(T x, T y)noexcept{
 		// multiply this matrix from the right by the translation matrix:
 		//               / 1 0 x \
 		// this = this * \ 0 1 y /
@@ -258,7 +293,7 @@ public:
 	 * @param t - translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix2& translate(const vector2<T>& t)noexcept;
+	constexpr matrix2& translate(const vector2<T>& t)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by rotation matrix.
@@ -296,7 +331,7 @@ public:
 	 * @brief Calculate matrix determinant.
 	 * @return matrix determinant.
 	 */
-	T det()const noexcept{
+	constexpr T det()const noexcept{
 		//    |a b c|          |e f|          |d f|          |d e|
 		// det|d e f| = a * det|0 1| - b * det|0 1| + c * det|0 0| = ae - bd
 		//    |0 0 1|
@@ -309,13 +344,13 @@ public:
 	 *     T * T^-1 = I
 	 * @return right inverse matrix of this matrix.
 	 */
-	matrix2 inv()const noexcept;
+	constexpr matrix2 inv()const noexcept;
 
 	/**
 	 * @brief Invert this matrix.
 	 * @return reference to this matrix.
 	 */
-	matrix2& invert()noexcept{
+	constexpr matrix2& invert()noexcept{
 		this->operator=(this->inv());
 		return *this;
 	}
@@ -337,7 +372,7 @@ public:
 	 * @brief Set each element of this matrix to a given number.
 	 * @param num - number to set each matrix element to.
 	 */
-	matrix2& set(T num)noexcept{
+	constexpr matrix2& set(T num)noexcept{
 		for(auto& e : *this){
 			e.set(num);
 		}
@@ -346,7 +381,7 @@ public:
 
 	friend std::ostream& operator<<(std::ostream& s, const matrix2<T>& mat){
 		s << "\n";
-		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << "\\" << std::endl;
+		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << "\\" << "\n";
 		s << "\t\\" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << "/";
 		return s;
 	};
@@ -357,10 +392,12 @@ public:
 #include "vector2.hpp"
 #include "vector3.hpp"
 #include "matrix3.hpp"
+#include "rectangle.hpp"
+#include "simd.hpp"
 
 namespace r4{
 
-template <class T> vector2<T> matrix2<T>::operator*(const vector2<T>& vec)const noexcept{
+template <class T> constexpr vector2<T> matrix2<T>::operator*(const vector2<T>& vec)const noexcept{
 	// TRACE_ALWAYS(<< "this->row(1) = " << this->row(1) << " vec = " << vec << std::endl)
 	return vector2<T>(
 			this->row(0) * vec + this->row(0)[2],
@@ -368,15 +405,39 @@ template <class T> vector2<T> matrix2<T>::operator*(const vector2<T>& vec)const
 		);
 }
 
-template <class T> matrix2<T>& matrix2<T>::scale(const vector2<T>& s)noexcept{
+template <class T> void matrix2<T>::transform_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept{
+	for(auto e = src + size; src != e; ++src, ++dst){
+		*dst = this->operator*(*src);
+	}
+}
+
+template <class T> rectangle<T> matrix2<T>::transform_points_bound(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept{
+	using std::min;
+	using std::max;
+
+	if(size == 0){
+		return rectangle<T>(0, 0, 0, 0);
+	}
+
+	auto min_xy = this->operator*(*src);
+	auto max_xy = min_xy;
+	for(size_t i = 0; i != size; ++i){
+		dst[i] = this->operator*(src[i]);
+		min_xy = min(min_xy, dst[i]);
+		max_xy = max(max_xy, dst[i]);
+	}
+	return rectangle<T>(min_xy, max_xy - min_xy);
+}
+
+template <class T> constexpr matrix2<T>& matrix2<T>::scale(const vector2<T>& s)noexcept{
 	return this->scale(s.x(), s.y());
 }
 
-template <class T> matrix2<T>& matrix2<T>::translate(const vector2<T>& t)noexcept{
+template <class T> constexpr matrix2<T>& matrix2<T>::translate(const vector2<T>& t)noexcept{
 	return this->translate(t.x(), t.y());
 }
 
-template <class T> matrix2<T> matrix2<T>::inv()const noexcept{
+template <class T> constexpr matrix2<T> matrix2<T>::inv()const noexcept{
 	matrix3<T> m{
 		this->row(0),
 		this->row(1),
@@ -391,6 +452,119 @@ template <class T> matrix2<T> matrix2<T>::inv()const noexcept{
 	};
 }
 
+#ifdef R4_SIMD
+
+// SIMD specializations of matrix2<float> operations.
+// SIMD intrinsics cannot be evaluated at compile time, so during constant evaluation plain scalar code is used.
+
+template <> constexpr matrix2<float> matrix2<float>::operator*(const matrix2<float>& matr)const noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		return matrix2{
+				vector3<float>{this->row(0) * matr.col(0), this->row(0) * matr.col(1), this->row(0) * matr.col(2) + this->row(0)[2]},
+				vector3<float>{this->row(1) * matr.col(0), this->row(1) * matr.col(1), this->row(1) * matr.col(2) + this->row(1)[2]},
+			};
+	}
+	matrix2<float> ret{};
+	simd::mat23_mul(ret.front().data(), this->front().data(), matr.front().data());
+	return ret;
+}
+
+template <> inline void matrix2<float>::transform_points(const vector2<float>* src, vector2<float>* dst, size_t size)const noexcept{
+	// 2x3 affine matrix is a 4x4 matrix which does not touch z and w
+	const float m[] = {
+		this->row(0)[0], this->row(0)[1], 0, this->row(0)[2],
+		this->row(1)[0], this->row(1)[1], 0, this->row(1)[2],
+		0, 0, 1, 0,
+		0, 0, 0, 1
+	};
+	simd::transform_points<2, false>(m, reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline rectangle<float> matrix2<float>::transform_points_bound(const vector2<float>* src, vector2<float>* dst, size_t size)const noexcept{
+	using std::min;
+	using std::max;
+
+	if(size < 4){
+		rectangle<float> ret(0, 0, 0, 0);
+		if(size != 0){
+			// use generic implementation for small number of points
+			auto min_xy = this->operator*(*src);
+			auto max_xy = min_xy;
+			for(size_t i = 0; i != size; ++i){
+				dst[i] = this->operator*(src[i]);
+				min_xy = min(min_xy, dst[i]);
+				max_xy = max(max_xy, dst[i]);
+			}
+			ret = rectangle<float>(min_xy, max_xy - min_xy);
+		}
+		return ret;
+	}
+
+	const auto m00 = simd::splat(this->row(0)[0]);
+	const auto m01 = simd::splat(this->row(0)[1]);
+	const auto m02 = simd::splat(this->row(0)[2]);
+	const auto m10 = simd::splat(this->row(1)[0]);
+	const auto m11 = simd::splat(this->row(1)[1]);
+	const auto m12 = simd::splat(this->row(1)[2]);
+
+	// transform block of 4 points and store them, the transformed coordinates are returned in x and y
+	auto transform_block = [&](simd::float4& x, simd::float4& y, float* d){
+		auto tx = simd::mul_add(m01, y, simd::mul_add(m00, x, m02));
+		auto ty = simd::mul_add(m11, y, simd::mul_add(m10, x, m12));
+		simd::store2(d, tx, ty);
+		x = tx;
+		y = ty;
+	};
+
+	auto s = reinterpret_cast<const float*>(src);
+	auto d = reinterpret_cast<float*>(dst);
+
+	// In case size is not multiple of 4, the last block of 4 points overlaps with the previous one.
+	// Transforming some points twice does not change the result, but in case of in-place transformation
+	// the source points of the last block have to be loaded before they are overwritten.
+	simd::float4 last_x, last_y;
+	simd::load2(s + (size - 4) * 2, last_x, last_y);
+
+	simd::float4 min_x, min_y;
+	simd::load2(s, min_x, min_y);
+	transform_block(min_x, min_y, d);
+	auto max_x = min_x;
+	auto max_y = min_y;
+
+	auto accumulate = [&](simd::float4 x, simd::float4 y){
+		min_x = simd::min(min_x, x);
+		min_y = simd::min(min_y, y);
+		max_x = simd::max(max_x, x);
+		max_y = simd::max(max_y, y);
+	};
+
+	for(size_t i = 4; i + 4 <= size; i += 4){
+		simd::float4 x, y;
+		simd::load2(s + i * 2, x, y);
+		transform_block(x, y, d + i * 2);
+		accumulate(x, y);
+	}
+
+	if(size % 4 != 0){
+		transform_block(last_x, last_y, d + (size - 4) * 2);
+		accumulate(last_x, last_y);
+	}
+
+	float mn[8];
+	float mx[8];
+	simd::store2(mn, min_x, min_y);
+	simd::store2(mx, max_x, max_y);
+	vector2<float> min_xy(mn[0], mn[1]);
+	vector2<float> max_xy(mx[0], mx[1]);
+	for(unsigned k = 1; k != 4; ++k){
+		min_xy = min(min_xy, vector2<float>(mn[k * 2], mn[k * 2 + 1]));
+		max_xy = max(max_xy, vector2<float>(mx[k * 2], mx[k * 2 + 1]));
+	}
+	return rectangle<float>(min_xy, max_xy - min_xy);
+}
+
+#endif // ~R4_SIMD
+
 static_assert(sizeof(matrix2<float>) == sizeof(float) * 2 * 3, "size mismatch");
 static_assert(sizeof(matrix2<double>) == sizeof(double) * 2 * 3, "size mismatch");
 
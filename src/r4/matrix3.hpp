@@ -6,6 +6,8 @@
 
 #include <utki/debug.hpp>
 
+#include "config.hpp"
+
 #include "vector3.hpp"
 
 namespace r4{
@@ -49,7 +51,7 @@ public:
 	 * @brief Convert to different element type.
 	 * @return matrix3 with converted element type.
 	 */
-	template <typename TT> matrix3<TT> to()noexcept{
+	template <typename TT> constexpr matrix3<TT> to()noexcept{
 		return matrix3<TT>{
 				this->row(0).template to<TT>(),
 				this->row(1).template to<TT>(),
@@ -62,7 +64,7 @@ public:
 	 * @param m - matrix to subtract from this matrix.
 	 * @return resulting matrix of the subtraction.
 	 */
-	matrix3 operator-(const matrix3& m)const noexcept{
+	constexpr matrix3 operator-(const matrix3& m)const noexcept{
 		return {
 				this->row(0) - m.row(0),
 				this->row(1) - m.row(1),
@@ -77,7 +79,7 @@ public:
 	 * @param vec - vector to transform.
      * @return Transformed vector.
      */
-	vector2<T> operator*(const vector2<T>& vec)const noexcept;
+	constexpr vector2<T> operator*(const vector2<T>& vec)const noexcept;
 
 	/**
 	 * @brief Transform vector by matrix.
@@ -86,15 +88,15 @@ public:
 	 * @param vec - vector to transform.
      * @return Transformed vector.
      */
-	vector3<T> operator*(const vector3<T>& vec)const noexcept;
+	constexpr vector3<T> operator*(const vector3<T>& vec)const noexcept;
 
 	/**
 	 * @brief Get matrix row.
 	 * @param index - row index to get, must be from 0 to 2.
      * @return reference to vector3 representing the row of this matrix.
      */
-	vector3<T>& row(unsigned index)noexcept{
-		ASSERT(index < 3)
+	constexpr vector3<T>& row(unsigned index)noexcept{
+		R4_ASSERT(index < 3);
 		return this->operator[](index);
 	}
 
@@ -103,8 +105,8 @@ public:
 	 * @param index - row index to get, must be from 0 to 2.
      * @return constant reference to vector3 representing the row of this matrix.
      */
-	const vector3<T>& row(unsigned index)const noexcept{
-		ASSERT(index < 3)
+	constexpr const vector3<T>& row(unsigned index)const noexcept{
+		R4_ASSERT(index < 3);
 		return this->operator[](index);
 	}
 
@@ -114,7 +116,7 @@ public:
 	 * @param index - column index to get, must be from 0 to 2;
 	 * @return vector3 representing the requested matrix column.
 	 */
-	vector3<T> col(unsigned index)const noexcept{
+	constexpr vector3<T> col(unsigned index)const noexcept{
 		return vector3<T>{
 				this->row(0)[index],
 				this->row(1)[index],
@@ -125,10 +127,15 @@ public:
 	/**
 	 * @brief Transpose matrix.
 	 */
-	matrix3& transpose()noexcept{
-		std::swap(this->row(1)[0], this->row(0)[1]);
-		std::swap(this->row(2)[0], this->row(0)[2]);
-		std::swap(this->row(2)[1], this->row(1)[2]);
+	constexpr matrix3& transpose()noexcept{
+		// std::swap() is not constexpr in C++17
+		for(unsigned r = 0; r != this->size(); ++r){
+			for(unsigned c = r + 1; c != this->size(); ++c){
+				T t = this->row(r)[c];
+				this->row(r)[c] = this->row(c)[r];
+				this->row(c)[r] = t;
+			}
+		}
 		return *this;
 	}
 
@@ -137,7 +144,7 @@ public:
 	 * @param num - scalar to multiply the matrix by.
 	 * @return multiplied matrix.
 	 */
-	matrix3 operator*(T num)const noexcept{
+	constexpr matrix3 operator*(T num)const noexcept{
 		return {
 				this->row(0) * num,
 				this->row(1) * num,
@@ -150,7 +157,7 @@ public:
 	 * @param num - scalar to divide the matrix by.
 	 * @return divided matrix.
 	 */
-	matrix3 operator/(T num)const noexcept{
+	constexpr matrix3 operator/(T num)const noexcept{
 		return {
 				this->row(0) / num,
 				this->row(1) / num,
@@ -164,7 +171,7 @@ public:
 	 * @param matr - matrix to multiply by (matrix K).
      * @return New matrix as a result of matrices product.
      */
-	matrix3 operator*(const matrix3& matr)const noexcept{
+	constexpr matrix3 operator*(const matrix3& matr)const noexcept{
 		return matrix3{
 				vector3<T>{this->row(0) * matr.col(0), this->row(0) * matr.col(1), this->row(0) * matr.col(2)},
 				vector3<T>{this->row(1) * matr.col(0), this->row(1) * matr.col(1), this->row(1) * matr.col(2)},
@@ -177,7 +184,7 @@ public:
 	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
      * @return reference to this matrix object.
      */
-	matrix3& operator*=(const matrix3& matr)noexcept{
+	constexpr matrix3& operator*=(const matrix3& matr)noexcept{
 		return this->operator=(this->operator*(matr));
 	}
 
@@ -200,7 +207,7 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix3& right_multiply(const matrix3& matr)noexcept{
+	constexpr matrix3& right_multiply(const matrix3& matr)noexcept{
 		return this->operator*=(matr);
 	}
 
@@ -210,14 +217,14 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix3& left_multiply(const matrix3& matr)noexcept{
+	constexpr matrix3& left_multiply(const matrix3& matr)noexcept{
 		return this->operator=(matr.operator*(*this));
 	}
 
 	/**
 	 * @brief Initialize this matrix with identity matrix.
 	 */
-	matrix3& set_identity()noexcept{
+	constexpr matrix3& set_identity()noexcept{
 		this->row(0) = {1, 0, 0};
 		this->row(1) = {0, 1, 0};
 		this->row(2) = {0, 0, 1};
@@ -228,7 +235,7 @@ public:
 	 * @brief Set each element of this matrix to a given number.
 	 * @param num - number to set each matrix element to.
 	 */
-	matrix3& set(T num)noexcept{
+	constexpr matrix3& set(T num)noexcept{
 		for(auto& e : *this){
 			e.set(num);
 		}
@@ -242,7 +249,7 @@ public:
 	 * @param y - scaling factor in y direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix3& scale(T x, T y)noexcept{
+	constexpr matrix3& scale(T x, T y)noexcept{
 		// multiply this matrix from the right by the scale matrix:
 		//               / x 0 0 \
 		// this = this * | 0 y 0 |
@@ -270,7 +277,7 @@ public:
 	 * @param z - scaling factor in z direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix3& scale(T x, T y, T z)noexcept{
+	constexpr matrix3& scale(T x, T y, T z)noexcept{
 		// multiply this matrix from the right by the scale matrix:
 		//               / x 0 0 \
 		// this = this * | 0 y 0 |
@@ -292,7 +299,7 @@ public:
 	 * @param s - scaling factor to be applied in all 3 directions (x, y and z).
 	 * @return reference to this matrix instance.
 	 */
-	matrix3& scale(T s)noexcept{
+	constexpr matrix3& scale(T s)noexcept{
 		return this->scale(s, s, s);
 	}
 
@@ -302,7 +309,7 @@ public:
 	 * @param s - vector of scaling factors in x and y directions, scaling factor in z direction is 1.
 	 * @return reference to this matrix instance.
 	 */
-	matrix3& scale(const vector2<T>& s)noexcept;
+	constexpr matrix3& scale(const vector2<T>& s)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by translation matrix.
@@ -311,7 +318,7 @@ public:
 	 * @param y - y component of translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix3& translate(T x, T y)noexcept{
+	constexpr matrix3& translate(T x, T y)noexcept{
 		// multiply this matrix from the right by the translation matrix:
 		//               / 1 0 x \
 		// this = this * | 0 1 y |
@@ -332,7 +339,7 @@ public:
 	 * @param t - translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix3& translate(const vector2<T>& t)noexcept;
+	constexpr matrix3& translate(const vector2<T>& t)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by rotation matrix.
@@ -377,7 +384,7 @@ public:
 	 * @param c - index of the column to remove from this matrix.
 	 * @return determinant of the matrix constructed from this matrix by removing given row and given column.
 	 */
-	T minor(unsigned r, unsigned c)const noexcept{
+	constexpr T minor(unsigned r, unsigned c)const noexcept{
 		std::array<std::array<T, 2>, 2> mm;
 
 		for(unsigned dr = 0; dr != r; ++dr){
@@ -405,7 +412,7 @@ public:
 	 * @brief Calculate matrix determinant.
 	 * @return matrix determinant.
 	 */
-	T det()const noexcept{
+	constexpr T det()const noexcept{
 		//    |a b c|          |e f|          |d f|          |d e|
 		// det|d e f| = a * det|h i| - b * det|g i| + c * det|g h| = aei + bfg + cdh - ceg - bdi - afh
 		//    |g h i|
@@ -423,11 +430,11 @@ public:
 	 *     T * T^-1 = I
 	 * @return right inverse matrix of this matrix.
 	 */
-	matrix3<T> inv()const noexcept{
+	constexpr matrix3<T> inv()const noexcept{
 		T d = this->det();
 
 		// calculate matrix of minors
-		matrix3<T> mm;
+		matrix3<T> mm{};
 
 		T sign = 1;
 		for(unsigned r = 0; r != this->size(); ++r){
@@ -446,7 +453,7 @@ public:
 	 * @brief Invert this matrix.
 	 * @return reference to this matrix.
 	 */
-	matrix3& invert()noexcept{
+	constexpr matrix3& invert()noexcept{
 		this->operator=(this->inv());
 		return *this;
 	}
@@ -466,8 +473,8 @@ public:
 
 	friend std::ostream& operator<<(std::ostream& s, const matrix3<T>& mat){
 		s << "\n";
-		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << "\\" << std::endl;
-		s << "\t|" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << "|" << std::endl;
+		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << "\\" << "\n";
+		s << "\t|" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << "|" << "\n";
 		s << "\t\\" << mat[2][0] << " " << mat[2][1] << " " << mat[2][2] << "/";
 		return s;
 	};
@@ -477,10 +484,11 @@ public:
 
 #include "vector2.hpp"
 #include "vector3.hpp"
+#include "simd.hpp"
 
 namespace r4{
 
-template <class T> vector2<T> matrix3<T>::operator*(const vector2<T>& vec)const noexcept{
+template <class T> constexpr vector2<T> matrix3<T>::operator*(const vector2<T>& vec)const noexcept{
 	// TRACE_ALWAYS(<< "this->row(1) = " << this->row(1) << " vec = " << vec << std::endl)
 	return vector2<T>(
 			this->row(0) * vec,
@@ -488,7 +496,7 @@ template <class T> vector2<T> matrix3<T>::operator*(const vector2<T>& vec)const
 		);
 }
 
-template <class T> vector3<T> matrix3<T>::operator*(const vector3<T>& vec)const noexcept{
+template <class T> constexpr vector3<T> matrix3<T>::operator*(const vector3<T>& vec)const noexcept{
 	return vector3<T>(
 			this->row(0) * vec,
 			this->row(1) * vec,
@@ -496,14 +504,34 @@ template <class T> vector3<T> matrix3<T>::operator*(const vector3<T>& vec)const
 		);
 }
 
-template <class T> matrix3<T>& matrix3<T>::scale(const vector2<T>& s)noexcept{
+template <class T> constexpr matrix3<T>& matrix3<T>::scale(const vector2<T>& s)noexcept{
 	return this->scale(s.x, s.y);
 }
 
-template <class T> matrix3<T>& matrix3<T>::translate(const vector2<T>& t)noexcept{
+template <class T> constexpr matrix3<T>& matrix3<T>::translate(const vector2<T>& t)noexcept{
 	return this->translate(t.x(), t.y());
 }
 
+#ifdef R4_SIMD
+
+// SIMD specializations of matrix3<float> operations.
+// SIMD intrinsics cannot be evaluated at compile time, so during constant evaluation plain scalar code is used.
+
+template <> constexpr matrix3<float> matrix3<float>::operator*(const matrix3<float>& matr)const noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		return matrix3{
+				vector3<float>{this->row(0) * matr.col(0), this->row(0) * matr.col(1), this->row(0) * matr.col(2)},
+				vector3<float>{this->row(1) * matr.col(0), this->row(1) * matr.col(1), this->row(1) * matr.col(2)},
+				vector3<float>{this->row(2) * matr.col(0), this->row(2) * matr.col(1), this->row(2) * matr.col(2)}
+			};
+	}
+	matrix3<float> ret{};
+	simd::mat3_mul(ret.front().data(), this->front().data(), matr.front().data());
+	return ret;
+}
+
+#endif // ~R4_SIMD
+
 static_assert(sizeof(matrix3<float>) == sizeof(float) * 3 * 3, "size mismatch");
 static_assert(sizeof(matrix3<double>) == sizeof(double) * 3 * 3, "size mismatch");
 
@@ -3,9 +3,13 @@
 #include <algorithm>
 #include <iostream>
 #include <array>
+#include <cmath>
+#include <cstddef>
 
 #include <utki/debug.hpp>
 
+#include "config.hpp"
+
 #include "vector4.hpp"
 
 #ifdef minor
@@ -18,6 +22,9 @@ template <class T> class vector2;
 template <class T> class vector3;
 template <class T> class quaternion;
 template <class T> class matrix3;
+template <class T> class aabb3;
+template <class T> class orthographic_projection;
+template <class T> class perspective_projection;
 
 /**
  * @brief 4x4 matrix template class.
@@ -69,7 +76,7 @@ public:
 	 * @brief Convert to different element type.
 	 * @return matrix4 with converted element type.
 	 */
-	template <typename TT> matrix4<TT> to()noexcept{
+	template <typename TT> constexpr matrix4<TT> to()noexcept{
 		return matrix4<TT>{
 				this->row(0).template to<TT>(),
 				this->row(1).template to<TT>(),
@@ -83,7 +90,7 @@ public:
 	 * @param m - matrix to subtract from this matrix.
 	 * @return resulting matrix of the subtraction.
 	 */
-	matrix4 operator-(const matrix4& m)const noexcept{
+	constexpr matrix4 operator-(const matrix4& m)const noexcept{
 		return {
 				this->row(0) - m.row(0),
 				this->row(1) - m.row(1),
@@ -99,7 +106,7 @@ public:
 	 * @param vec - vector to transform.
      * @return Transformed vector.
      */
-	vector2<T> operator*(const vector2<T>& vec)const noexcept;
+	constexpr vector2<T> operator*(const vector2<T>& vec)const noexcept;
 
 	/**
 	 * @brief Transform vector by matrix.
@@ -108,7 +115,7 @@ public:
 	 * @param vec - vector to transform.
      * @return Transformed vector.
      */
-	vector3<T> operator*(const vector3<T>& vec)const noexcept;
+	constexpr vector3<T> operator*(const vector3<T>& vec)const noexcept;
 
 	/**
 	 * @brief Transform vector by matrix.
@@ -117,15 +124,135 @@ public:
 	 * @param vec - vector to transform.
      * @return Transformed vector.
      */
-	vector4<T> operator*(const vector4<T>& vec)const noexcept;
+	constexpr vector4<T> operator*(const vector4<T>& vec)const noexcept;
+
+	/**
+	 * @brief Transform array of vectors by matrix.
+	 * Same as operator*(const vector2<T>&) applied to each vector of the array,
+	 * but with matrix elements loaded only once and with vectorization where possible.
+	 * @param src - pointer to the first vector to transform.
+	 * @param dst - pointer to where to store the first transformed vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform array of vectors by matrix.
+	 * Same as operator*(const vector3<T>&) applied to each vector of the array,
+	 * but with matrix elements loaded only once and with vectorization where possible.
+	 * @param src - pointer to the first vector to transform.
+	 * @param dst - pointer to where to store the first transformed vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform array of vectors by matrix.
+	 * Same as operator*(const vector4<T>&) applied to each vector of the array,
+	 * but with matrix elements loaded only once and with vectorization where possible.
+	 * @param src - pointer to the first vector to transform.
+	 * @param dst - pointer to where to store the first transformed vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(const vector4<T>* src, vector4<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Transform array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to transform.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(vector2<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Transform array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to transform.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(vector3<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Transform array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to transform.
+	 * @param size - number of vectors to transform.
+	 */
+	void transform_points(vector4<T>* points, size_t size)const noexcept{
+		this->transform_points(points, points, size);
+	}
+
+	/**
+	 * @brief Project array of vectors by matrix.
+	 * Each vector V is thought of as 4d vector (x, y, 0, 1) and is transformed by this matrix M.
+	 * Then the perspective divide is done, i.e. the resulting vector is (x', y') / w', where (x', y', z', w') = M * V.
+	 * @param src - pointer to the first vector to project.
+	 * @param dst - pointer to where to store the first projected vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Project array of vectors by matrix.
+	 * Each vector V is thought of as 4d vector (x, y, z, 1) and is transformed by this matrix M.
+	 * Then the perspective divide is done, i.e. the resulting vector is (x', y', z') / w', where (x', y', z', w') = M * V.
+	 * @param src - pointer to the first vector to project.
+	 * @param dst - pointer to where to store the first projected vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Project array of vectors by matrix.
+	 * Each vector V is transformed by this matrix M and then the perspective divide is done,
+	 * i.e. the resulting vector is (x', y', z', w') / w', where (x', y', z', w') = M * V.
+	 * @param src - pointer to the first vector to project.
+	 * @param dst - pointer to where to store the first projected vector. Can be same as src,
+	 *              otherwise the source and destination ranges must not overlap.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(const vector4<T>* src, vector4<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Project array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to project.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(vector2<T>* points, size_t size)const noexcept{
+		this->project_points(points, points, size);
+	}
+
+	/**
+	 * @brief Project array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to project.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(vector3<T>* points, size_t size)const noexcept{
+		this->project_points(points, points, size);
+	}
+
+	/**
+	 * @brief Project array of vectors by matrix in-place.
+	 * @param points - pointer to the first vector to project.
+	 * @param size - number of vectors to project.
+	 */
+	void project_points(vector4<T>* points, size_t size)const noexcept{
+		this->project_points(points, points, size);
+	}
 
 	/**
 	 * @brief Get matrix row.
 	 * @param rowNum - row number to get, must be from 0 to 3.
      * @return reference to vector4 representing the row of this matrix.
      */
-	vector4<T>& row(unsigned rowNum)noexcept{
-		ASSERT(rowNum < 4)
+	constexpr vector4<T>& row(unsigned rowNum)noexcept{
+		R4_ASSERT(rowNum < 4);
 		return this->operator[](rowNum);
 	}
 
@@ -134,8 +261,8 @@ public:
 	 * @param rowNum - row number to get, must be from 0 to 3.
      * @return reference to vector4 representing the row of this matrix.
      */
-	const vector4<T>& row(unsigned rowNum)const noexcept{
-		ASSERT(rowNum < 4)
+	constexpr const vector4<T>& row(unsigned rowNum)const noexcept{
+		R4_ASSERT(rowNum < 4);
 		return this->operator[](rowNum);
 	}
 
@@ -145,7 +272,7 @@ public:
 	 * @param index - column index to get, must be from 0 to 3;
 	 * @return vector4 representing the requested matrix column.
 	 */
-	vector4<T> col(unsigned index)const noexcept{
+	constexpr vector4<T> col(unsigned index)const noexcept{
 		return vector4<T>{
 				this->row(0)[index],
 				this->row(1)[index],
@@ -160,7 +287,7 @@ public:
 	 * @param matr - matrix to multiply by (matrix K).
      * @return New matrix as a result of matrices product.
      */
-	matrix4 operator*(const matrix4& matr)const noexcept{
+	constexpr matrix4 operator*(const matrix4& matr)const noexcept{
 		return matrix4{
 				vector4<T>{this->row(0) * matr.col(0), this->row(0) * matr.col(1), this->row(0) * matr.col(2), this->row(0) * matr.col(3)},
 				vector4<T>{this->row(1) * matr.col(0), this->row(1) * matr.col(1), this->row(1) * matr.col(2), this->row(1) * matr.col(3)},
@@ -174,7 +301,7 @@ public:
 	 * @param num - scalar to multiply the matrix by.
 	 * @return multiplied matrix.
 	 */
-	matrix4 operator*(T num)const noexcept{
+	constexpr matrix4 operator*(T num)const noexcept{
 		return {
 				this->row(0) * num,
 				this->row(1) * num,
@@ -188,7 +315,7 @@ public:
 	 * @param num - scalar to divide the matrix by.
 	 * @return divided matrix.
 	 */
-	matrix4 operator/(T num)const noexcept{
+	constexpr matrix4 operator/(T num)const noexcept{
 		return {
 				this->row(0) / num,
 				this->row(1) / num,
@@ -200,15 +327,15 @@ public:
 	/**
 	 * @brief Transpose matrix.
 	 */
-	matrix4& transpose()noexcept{
-		std::swap(this->row(1)[0], this->row(0)[1]);
-		std::swap(this->row(2)[0], this->row(0)[2]);
-		std::swap(this->row(3)[0], this->row(0)[3]);
-
-		std::swap(this->row(2)[1], this->row(1)[2]);
-		std::swap(this->row(3)[1], this->row(1)[3]);
-
-		std::swap(this->row(3)[2], this->row(2)[3]);
+	constexpr matrix4& transpose()noexcept{
+		// std::swap() is not constexpr in C++17
+		for(unsigned r = 0; r != this->size(); ++r){
+			for(unsigned c = r + 1; c != this->size(); ++c){
+				T t = this->row(r)[c];
+				this->row(r)[c] = this->row(c)[r];
+				this->row(c)[r] = t;
+			}
+		}
 		return *this;
 	}
 
@@ -217,7 +344,7 @@ public:
 	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
      * @return reference to this matrix object.
      */
-	matrix4& operator*=(const matrix4& matr)noexcept{
+	constexpr matrix4& operator*=(const matrix4& matr)noexcept{
 		return this->operator=(this->operator*(matr));
 	}
 
@@ -226,7 +353,7 @@ public:
 	 * @param n - scalar to multiply the matrix by.
 	 * @return reference to this matrix4.
 	 */
-	matrix4& operator*=(T n){
+	constexpr matrix4& operator*=(T n){
 		this->row(0) *= n;
 		this->row(1) *= n;
 		this->row(2) *= n;
@@ -241,7 +368,7 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& right_mul(const matrix4& matr)noexcept{
+	constexpr matrix4& right_mul(const matrix4& matr)noexcept{
 		return this->operator*=(matr);
 	}
 
@@ -251,14 +378,14 @@ public:
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& left_mul(const matrix4& matr)noexcept{
+	constexpr matrix4& left_mul(const matrix4& matr)noexcept{
 		return this->operator=(matr.operator*(*this));
 	}
 
 	/**
 	 * @brief Initialize this matrix with identity matrix.
 	 */
-	matrix4& set_identity()noexcept{
+	constexpr matrix4& set_identity()noexcept{
 		this->row(0) = vector4<T>(1, 0, 0, 0);
 		this->row(1) = vector4<T>(0, 1, 0, 0);
 		this->row(2) = vector4<T>(0, 0, 1, 0);
@@ -277,15 +404,15 @@ public:
 	 * @param farVal - distance to the far clipping plane. Must be positive.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& set_frustum(T left, T right, T bottom, T top, T nearVal, T farVal)noexcept{
+	constexpr matrix4& set_frustum(T left, T right, T bottom, T top, T nearVal, T farVal)noexcept{
 		T w = right - left;
-		ASSERT(w != 0)
+		R4_ASSERT(w != 0);
 
 		T h = top - bottom;
-		ASSERT(h != 0)
+		R4_ASSERT(h != 0);
 
 		T d = farVal - nearVal;
-		ASSERT(d != 0)
+		R4_ASSERT(d != 0);
 
 		matrix4& f = *this;
 		f[0][0] = 2 * nearVal / w;
@@ -323,19 +450,240 @@ public:
 	 * @param farVal - distance to the far clipping plane. Must be positive.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& frustum(T left, T right, T bottom, T top, T nearVal, T farVal)noexcept{
-		matrix4 f;
+	constexpr matrix4& frustum(T left, T right, T bottom, T top, T nearVal, T farVal)noexcept{
+		T w = right - left;
+		R4_ASSERT(w != 0);
 
-		f.set_frustum(left, right, bottom, top, nearVal, farVal);
+		T h = top - bottom;
+		R4_ASSERT(h != 0);
 
-		return this->right_mul(f);
+		T d = farVal - nearVal;
+		R4_ASSERT(d != 0);
+
+		return this->right_mul_frustum(
+				2 * nearVal / w,
+				2 * nearVal / h,
+				-(farVal + nearVal) / d,
+				(right + left) / w,
+				(top + bottom) / h,
+				-2 * farVal * nearVal / d
+			);
 	}
 
+	/**
+	 * @brief Set current matrix to orthographic projection matrix.
+	 * Parameters are identical to glOrtho() function from OpenGL.
+	 * @param left - left vertical clipping plane.
+	 * @param right - right vertical clipping plane.
+	 * @param bottom - bottom horizontal clipping plane.
+	 * @param top - top horizontal clipping plane.
+	 * @param near_val - distance to near depth clipping plane.
+	 * @param far_val - distance to far depth clipping plane.
+	 * @return reference to this matrix instance.
+	 */
+	constexpr matrix4& set_ortho(T left, T right, T bottom, T top, T near_val, T far_val)noexcept{
+		T w = right - left;
+		R4_ASSERT(w != 0);
+
+		T h = top - bottom;
+		R4_ASSERT(h != 0);
+
+		T d = far_val - near_val;
+		R4_ASSERT(d != 0);
+
+		this->row(0) = vector4<T>(2 / w, 0, 0, -(right + left) / w);
+		this->row(1) = vector4<T>(0, 2 / h, 0, -(top + bottom) / h);
+		this->row(2) = vector4<T>(0, 0, -2 / d, -(far_val + near_val) / d);
+		this->row(3) = vector4<T>(0, 0, 0, 1);
+
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply current matrix by orthographic projection matrix.
+	 * Multiplies this matrix M by orthographic projection matrix O from the right (M = M * O).
+	 * Parameters are identical to glOrtho() function from OpenGL.
+	 * @param left - left vertical clipping plane.
+	 * @param right - right vertical clipping plane.
+	 * @param bottom - bottom horizontal clipping plane.
+	 * @param top - top horizontal clipping plane.
+	 * @param near_val - distance to near depth clipping plane.
+	 * @param far_val - distance to far depth clipping plane.
+	 * @return reference to this matrix instance.
+	 */
+	constexpr matrix4& ortho(T left, T right, T bottom, T top, T near_val, T far_val)noexcept{
+		T w = right - left;
+		R4_ASSERT(w != 0);
+
+		T h = top - bottom;
+		R4_ASSERT(h != 0);
+
+		T d = far_val - near_val;
+		R4_ASSERT(d != 0);
+
+		return this->right_mul_ortho(
+				vector3<T>(2 / w, 2 / h, -2 / d),
+				vector3<T>(-(right + left) / w, -(top + bottom) / h, -(far_val + near_val) / d)
+			);
+	}
+
+	/**
+	 * @brief Set current matrix to perspective projection matrix.
+	 * Parameters are identical to gluPerspective() function from OpenGL.
+	 * The result is the same as set_frustum() with the symmetric frustum.
+	 * @param fovy - field of view angle in y direction, in radians.
+	 * @param aspect - aspect ratio of the viewport, width / height.
+	 * @param near_val - distance to near depth clipping plane. Must be positive.
+	 * @param far_val - distance to far depth clipping plane. Must be positive.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& set_perspective(T fovy, T aspect, T near_val, T far_val)noexcept{
+		using std::tan;
+
+		R4_ASSERT(aspect != 0);
+
+		T d = far_val - near_val;
+		R4_ASSERT(d != 0);
+
+		T f = 1 / tan(fovy / 2);
+
+		this->row(0) = vector4<T>(f / aspect, 0, 0, 0);
+		this->row(1) = vector4<T>(0, f, 0, 0);
+		this->row(2) = vector4<T>(0, 0, -(far_val + near_val) / d, -2 * far_val * near_val / d);
+		this->row(3) = vector4<T>(0, 0, -1, 0);
+
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply current matrix by perspective projection matrix.
+	 * Multiplies this matrix M by perspective projection matrix P from the right (M = M * P).
+	 * Parameters are identical to gluPerspective() function from OpenGL.
+	 * @param fovy - field of view angle in y direction, in radians.
+	 * @param aspect - aspect ratio of the viewport, width / height.
+	 * @param near_val - distance to near depth clipping plane. Must be positive.
+	 * @param far_val - distance to far depth clipping plane. Must be positive.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& perspective(T fovy, T aspect, T near_val, T far_val)noexcept{
+		using std::tan;
+
+		T top = near_val * tan(fovy / 2);
+		T right = top * aspect;
+		return this->frustum(-right, right, -top, top, near_val, far_val);
+	}
+
+	/**
+	 * @brief Set current matrix to infinite perspective projection matrix.
+	 * Same as set_perspective() with the far clipping plane at infinity,
+	 * the depth range is mapped to [-1, 1] as in OpenGL.
+	 * @param fovy - field of view angle in y direction, in radians.
+	 * @param aspect - aspect ratio of the viewport, width / height.
+	 * @param near_val - distance to near depth clipping plane. Must be positive.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& set_perspective_infinite(T fovy, T aspect, T near_val)noexcept{
+		using std::tan;
+
+		R4_ASSERT(aspect != 0);
+
+		T f = 1 / tan(fovy / 2);
+
+		this->row(0) = vector4<T>(f / aspect, 0, 0, 0);
+		this->row(1) = vector4<T>(0, f, 0, 0);
+		this->row(2) = vector4<T>(0, 0, -1, -2 * near_val);
+		this->row(3) = vector4<T>(0, 0, -1, 0);
+
+		return *this;
+	}
+
+	/**
+	 * @brief Set current matrix to reversed-Z infinite perspective projection matrix.
+	 * Same as set_perspective() with the far clipping plane at infinity, but the depth is mapped
+	 * to [0, 1] range with near clipping plane at depth 1 and infinity at depth 0, as used with
+	 * floating point depth buffers and glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE) in OpenGL or in Vulkan and Direct3D.
+	 * Reversed depth distributes the floating point precision evenly over the distance.
+	 * @param fovy - field of view angle in y direction, in radians.
+	 * @param aspect - aspect ratio of the viewport, width / height.
+	 * @param near_val - distance to near depth clipping plane. Must be positive.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& set_perspective_reversed_z(T fovy, T aspect, T near_val)noexcept{
+		using std::tan;
+
+		R4_ASSERT(aspect != 0);
+
+		T f = 1 / tan(fovy / 2);
+
+		this->row(0) = vector4<T>(f / aspect, 0, 0, 0);
+		this->row(1) = vector4<T>(0, f, 0, 0);
+		this->row(2) = vector4<T>(0, 0, 0, near_val);
+		this->row(3) = vector4<T>(0, 0, -1, 0);
+
+		return *this;
+	}
+
+	/**
+	 * @brief Set current matrix to viewing matrix.
+	 * Parameters are identical to gluLookAt() function from OpenGL.
+	 * The viewing matrix transforms the world coordinates to the eye coordinates, where the eye is
+	 * at the origin looking in the negative z direction with the up vector projected to the positive y direction.
+	 * @param eye - position of the eye point.
+	 * @param center - position of the reference point the eye is looking at.
+	 * @param up - direction of the up vector, must not be parallel to the viewing direction.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& set_look_at(const vector3<T>& eye, const vector3<T>& center, const vector3<T>& up)noexcept;
+
+	/**
+	 * @brief Multiply current matrix by viewing matrix.
+	 * Multiplies this matrix M by viewing matrix V from the right (M = M * V).
+	 * Parameters are identical to gluLookAt() function from OpenGL, see set_look_at().
+	 * @param eye - position of the eye point.
+	 * @param center - position of the reference point the eye is looking at.
+	 * @param up - direction of the up vector, must not be parallel to the viewing direction.
+	 * @return reference to this matrix instance.
+	 */
+	matrix4& look_at(const vector3<T>& eye, const vector3<T>& center, const vector3<T>& up)noexcept;
+
+	/**
+	 * @brief Build array of orthographic projection matrices.
+	 * Same as calling set_ortho() for each matrix.
+	 * @param volumes - viewing volumes, the p1 corner of the volume is (left, bottom, near_val)
+	 *                  and the p2 corner is (right, top, far_val) in terms of set_ortho() parameters.
+	 * @param dst - output matrices.
+	 * @param size - number of matrices.
+	 */
+	static void make_ortho(const aabb3<T>* volumes, matrix4* dst, size_t size)noexcept;
+
+	/**
+	 * @brief Build array of perspective projection matrices.
+	 * Same as calling set_perspective() for each matrix.
+	 * @param fovy - field of view angles in y direction, in radians.
+	 * @param aspect - aspect ratios of the viewports.
+	 * @param near_val - distances to near depth clipping planes.
+	 * @param far_val - distances to far depth clipping planes.
+	 * @param dst - output matrices.
+	 * @param size - number of matrices.
+	 */
+	static void make_perspective(const T* fovy, const T* aspect, const T* near_val, const T* far_val, matrix4* dst, size_t size)noexcept;
+
+	/**
+	 * @brief Build array of viewing matrices.
+	 * Same as calling set_look_at() for each matrix.
+	 * @param eye - positions of the eye points.
+	 * @param center - positions of the reference points.
+	 * @param up - directions of the up vectors, must not be parallel to the viewing directions.
+	 * @param dst - output matrices.
+	 * @param size - number of matrices.
+	 */
+	static void make_look_at(const vector3<T>* eye, const vector3<T>* center, const vector3<T>* up, matrix4* dst, size_t size)noexcept;
+
 	/**
 	 * @brief Set each element of this matrix to a given number.
 	 * @param num - number to set each matrix element to.
 	 */
-	matrix4& set(T num)noexcept{
+	constexpr matrix4& set(T num)noexcept{
 		for(auto& e : *this){
 			e.set(num);
 		}
@@ -348,7 +696,7 @@ public:
      * @param quat - unit quaternion defining the rotation.
      * @return Reference to this matrix object.
      */
-	matrix4& set(const quaternion<T>& quat)noexcept;
+	constexpr matrix4& set(const quaternion<T>& quat)noexcept;
 
 	/**
 	 * @brief Multiply current matrix by scale matrix.
@@ -358,7 +706,7 @@ public:
 	 * @param y - scaling factor in y direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& scale(T x, T y)noexcept{
+	constexpr matrix4& scale(T x, T y)noexcept{
 		// update 0th column
 		this->row(0)[0] *= x;
 		this->row(1)[0] *= x;
@@ -383,7 +731,7 @@ public:
 	 * @param z - scaling factor in z direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& scale(T x, T y, T z)noexcept{
+	constexpr matrix4& scale(T x, T y, T z)noexcept{
 		// update 0th and 1st columns
 		this->scale(x, y);
 
@@ -403,7 +751,7 @@ public:
 	 * @param s - scaling factor to be applied in all 3 directions (x, y and z).
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& scale(T s)noexcept{
+	constexpr matrix4& scale(T s)noexcept{
 		return this->scale(s, s, s);
 	}
 
@@ -413,7 +761,7 @@ public:
 	 * @param s - vector of scaling factors in x and y directions, scaling factor in z direction is 1.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& scale(const vector2<T>& s)noexcept;
+	constexpr matrix4& scale(const vector2<T>& s)noexcept;
 
 	/**
 	 * @brief Multiply current matrix by scale matrix.
@@ -421,7 +769,7 @@ public:
 	 * @param s - vector of scaling factors in x, y and z directions.
 	 * @return reference to this matrix instance.
 	 */
-	matrix4& scale(const vector3<T>& s)noexcept;
+	constexpr matrix4& scale(const vector3<T>& s)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by translation matrix.
@@ -432,7 +780,7 @@ public:
 	 * @param y - y component of translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& translate(T x, T y)noexcept{
+	constexpr matrix4& translate(T x, T y)noexcept{
 		// NOTE: 0th, 1st and 2nd columns remain unchanged
 
 		// calculate 3rd column
@@ -452,7 +800,7 @@ public:
 	 * @param z - z component of translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& translate(T x, T y, T z)noexcept{
+	constexpr matrix4& translate(T x, T y, T z)noexcept{
 		// NOTE: 0th, 1st and 2nd columns remain unchanged
 		this->translate(x, y);
 
@@ -472,7 +820,7 @@ public:
 	 * @param t - translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& translate(const vector2<T>& t)noexcept;
+	constexpr matrix4& translate(const vector2<T>& t)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by translation matrix.
@@ -480,7 +828,7 @@ public:
 	 * @param t - translation vector.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& translate(const vector3<T>& t)noexcept;
+	constexpr matrix4& translate(const vector3<T>& t)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by rotation matrix.
@@ -488,7 +836,7 @@ public:
 	 * @param q - unit quaternion, representing the rotation.
 	 * @return reference to this matrix object.
 	 */
-	matrix4& rotate(const quaternion<T>& q)noexcept;
+	constexpr matrix4& rotate(const quaternion<T>& q)noexcept;
 
 	/**
 	 * @brief Multiply this matrix by rotation matrix.
@@ -517,13 +865,13 @@ public:
 	 * @param c - index of the column to remove.
 	 * @return minor matrix.
 	 */
-	matrix3<T> minor_matrix(unsigned r, unsigned c)const noexcept;
+	constexpr matrix3<T> minor_matrix(unsigned r, unsigned c)const noexcept;
 
 	/**
 	 * @brief Claculate minor.
 	 * This is equivalent to matrix_minor(r, c).det().
 	 */
-	T minor(unsigned r, unsigned c)const noexcept{
+	constexpr T minor(unsigned r, unsigned c)const noexcept{
 		return this->minor_matrix(r, c).det();
 	}
 
@@ -531,15 +879,7 @@ public:
 	 * @brief Calculate matrix determinant.
 	 * @return matrix determinant.
 	 */
-	T det()const noexcept{
-		T ret = 0;
-		T sign = 1;
-		for(unsigned i = 0; i != this->row(0).size(); ++i, sign = -sign){
-			ret += sign * this->row(0)[i] * this->minor(0, i);
-		}
-
-		return ret;
-	}
+	constexpr T det()const noexcept;
 
 	/**
 	 * @brief Snap each matrix component to 0.
@@ -558,36 +898,87 @@ public:
 	 * @brief Calculate right inverse of the matrix.
 	 * The resulting inverse matrix is to multiply this matrix from the right to get identioty matrix.
 	 *     T * T^-1 = I
+	 * In case the matrix is singular, i.e. its determinant is 0, the inverse does not exist
+	 * and zero matrix is returned.
 	 * @return right inverse matrix of this matrix.
+	 * @return zero matrix if this matrix is singular.
 	 */
-	matrix4<T> inv()const noexcept{
-		T d = this->det();
-
-		// calculate matrix of minors
-		matrix4<T> mm;
+	constexpr matrix4<T> inv()const noexcept;
 
-		T sign = 1;
-		for(unsigned r = 0; r != this->size(); ++r){
-			for(unsigned c = 0; c != this->row(r).size(); ++c){
-				mm[r][c] = sign * this->minor(r, c);
-				sign = -sign;
-			}
-			sign = -sign;
-		}
+	/**
+	 * @brief Invert this matrix.
+	 * Singular matrix is set to zero matrix, see inv().
+	 * @return reference to this matrix.
+	 */
+	constexpr matrix4& invert()noexcept{
+		this->operator=(this->inv());
+		return *this;
+	}
 
-		mm.transpose();
+	/**
+	 * @brief Calculate inverse of affine transformation matrix.
+	 * The matrix must have (0, 0, 0, 1) as its last row, i.e. be a combination of linear transformation
+	 * given by the upper left 3x3 submatrix and translation given by the last column.
+	 * Only the 3x3 submatrix is inverted, which is much cheaper than the general inv().
+	 * In case the 3x3 submatrix is singular, zero matrix is returned.
+	 * @return inverse matrix of this matrix.
+	 * @return zero matrix if the 3x3 submatrix is singular.
+	 */
+	constexpr matrix4<T> affine_inv()const noexcept;
 
-		return mm / d;
-	}
+	/**
+	 * @brief Calculate inverse of rigid transformation matrix.
+	 * The matrix must be a combination of rotation given by the upper left 3x3 submatrix
+	 * and translation given by the last column, the last row must be (0, 0, 0, 1).
+	 * The inverse of such matrix is calculated by transposing the rotation submatrix and
+	 * rotating the negated translation by it. No scaling or shearing is allowed,
+	 * for those use affine_inv().
+	 * @return inverse matrix of this matrix.
+	 */
+	constexpr matrix4<T> rigid_inv()const noexcept;
 
 	friend std::ostream& operator<<(std::ostream& s, const matrix4<T>& mat){
 		s << "\n";
-		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << " " << mat[0][3] << "\\" << std::endl;
-		s << "\t|" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << " " << mat[1][3] << "|" << std::endl;
-		s << "\t|" << mat[2][0] << " " << mat[2][1] << " " << mat[2][2] << " " << mat[2][3] << "|" << std::endl;
+		s << "\t/" << mat[0][0] << " " << mat[0][1] << " " << mat[0][2] << " " << mat[0][3] << "\\" << "\n";
+		s << "\t|" << mat[1][0] << " " << mat[1][1] << " " << mat[1][2] << " " << mat[1][3] << "|" << "\n";
+		s << "\t|" << mat[2][0] << " " << mat[2][1] << " " << mat[2][2] << " " << mat[2][3] << "|" << "\n";
 		s << "\t\\" << mat[3][0] << " " << mat[3][1] << " " << mat[3][2] << " " << mat[3][3] << "/";
 		return s;
 	};
+
+private:
+	// The sparse multiplication kernels are shared with the corresponding matrix kinds.
+	template <class> friend class orthographic_projection;
+	template <class> friend class perspective_projection;
+
+	// Multiply by orthographic projection matrix from the right, the matrix is scaling by s followed by translation by t.
+	constexpr matrix4& right_mul_ortho(const vector3<T>& s, const vector3<T>& t)noexcept{
+		this->translate(t);
+		return this->scale(s);
+	}
+
+	// Multiply by perspective projection matrix from the right, the matrix is of the form
+	// / sx 0  ox 0  \
+	// | 0  sy oy 0  |
+	// | 0  0  sz tz |
+	// \ 0  0  -1 0  /
+	// It has only 7 non-trivial elements, so multiply only by those.
+	constexpr matrix4& right_mul_frustum(T sx, T sy, T sz, T ox, T oy, T tz)noexcept{
+		for(auto& row : *this){
+			T x = row[0];
+			T y = row[1];
+			T z = row[2];
+			row[0] = x * sx;
+			row[1] = y * sy;
+			row[2] = x * ox + y * oy + z * sz - row[3];
+			row[3] = z * tz;
+		}
+		return *this;
+	}
+
+	// Inverse calculated from 2x2 minors shared by all the cofactors.
+	// This is the generic implementation of inv(), also used for compile time evaluation of specialized inv().
+	constexpr matrix4<T> inv_by_minors()const noexcept;
 };
 
 }
@@ -596,17 +987,19 @@ public:
 #include "vector3.hpp"
 #include "quaternion.hpp"
 #include "matrix3.hpp"
+#include "aabb3.hpp"
+#include "simd.hpp"
 
 namespace r4{
 
-template <class T> vector2<T> matrix4<T>::operator*(const vector2<T>& vec)const noexcept{
+template <class T> constexpr vector2<T> matrix4<T>::operator*(const vector2<T>& vec)const noexcept{
 	return vector2<T>(
 			this->row(0) * vec,
 			this->row(1) * vec
 		);
 }
 
-template <class T> vector3<T> matrix4<T>::operator*(const vector3<T>& vec)const noexcept{
+template <class T> constexpr vector3<T> matrix4<T>::operator*(const vector3<T>& vec)const noexcept{
 	return vector3<T>(
 			this->row(0) * vec,
 			this->row(1) * vec,
@@ -614,7 +1007,7 @@ template <class T> vector3<T> matrix4<T>::operator*(const vector3<T>& vec)const
 		);
 }
 
-template <class T> vector4<T> matrix4<T>::operator*(const vector4<T>& vec)const noexcept{
+template <class T> constexpr vector4<T> matrix4<T>::operator*(const vector4<T>& vec)const noexcept{
 	return vector4<T>(
 			this->row(0) * vec,
 			this->row(1) * vec,
@@ -623,24 +1016,111 @@ template <class T> vector4<T> matrix4<T>::operator*(const vector4<T>& vec)const
 		);
 }
 
-template <class T> matrix4<T>& matrix4<T>::scale(const vector3<T>& s)noexcept{
+template <class T> void matrix4<T>::transform_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept{
+	// copy matrix elements to local variables to let the compiler keep them in registers
+	const T m00 = (*this)[0][0], m01 = (*this)[0][1], m03 = (*this)[0][3];
+	const T m10 = (*this)[1][0], m11 = (*this)[1][1], m13 = (*this)[1][3];
+
+	for(auto end = src + size; src != end; ++src, ++dst){
+		T x = src->x();
+		T y = src->y();
+		dst->x() = m00 * x + m01 * y + m03;
+		dst->y() = m10 * x + m11 * y + m13;
+	}
+}
+
+template <class T> void matrix4<T>::transform_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept{
+	// copy matrix elements to local variables to let the compiler keep them in registers
+	const T m00 = (*this)[0][0], m01 = (*this)[0][1], m02 = (*this)[0][2], m03 = (*this)[0][3];
+	const T m10 = (*this)[1][0], m11 = (*this)[1][1], m12 = (*this)[1][2], m13 = (*this)[1][3];
+	const T m20 = (*this)[2][0], m21 = (*this)[2][1], m22 = (*this)[2][2], m23 = (*this)[2][3];
+
+	for(auto end = src + size; src != end; ++src, ++dst){
+		T x = src->x();
+		T y = src->y();
+		T z = src->z();
+		dst->x() = m00 * x + m01 * y + m02 * z + m03;
+		dst->y() = m10 * x + m11 * y + m12 * z + m13;
+		dst->z() = m20 * x + m21 * y + m22 * z + m23;
+	}
+}
+
+template <class T> void matrix4<T>::transform_points(const vector4<T>* src, vector4<T>* dst, size_t size)const noexcept{
+	const matrix4& m = *this;
+	for(auto end = src + size; src != end; ++src, ++dst){
+		*dst = m * (*src);
+	}
+}
+
+template <class T> void matrix4<T>::project_points(const vector2<T>* src, vector2<T>* dst, size_t size)const noexcept{
+	// copy matrix elements to local variables to let the compiler keep them in registers
+	const T m00 = (*this)[0][0], m01 = (*this)[0][1], m03 = (*this)[0][3];
+	const T m10 = (*this)[1][0], m11 = (*this)[1][1], m13 = (*this)[1][3];
+	const T m30 = (*this)[3][0], m31 = (*this)[3][1], m33 = (*this)[3][3];
+
+	for(auto end = src + size; src != end; ++src, ++dst){
+		T x = src->x();
+		T y = src->y();
+		T w = m30 * x + m31 * y + m33;
+		dst->x() = (m00 * x + m01 * y + m03) / w;
+		dst->y() = (m10 * x + m11 * y + m13) / w;
+	}
+}
+
+template <class T> void matrix4<T>::project_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept{
+	// copy matrix elements to local variables to let the compiler keep them in registers
+	const T m00 = (*this)[0][0], m01 = (*this)[0][1], m02 = (*this)[0][2], m03 = (*this)[0][3];
+	const T m10 = (*this)[1][0], m11 = (*this)[1][1], m12 = (*this)[1][2], m13 = (*this)[1][3];
+	const T m20 = (*this)[2][0], m21 = (*this)[2][1], m22 = (*this)[2][2], m23 = (*this)[2][3];
+	const T m30 = (*this)[3][0], m31 = (*this)[3][1], m32 = (*this)[3][2], m33 = (*this)[3][3];
+
+	for(auto end = src + size; src != end; ++src, ++dst){
+		T x = src->x();
+		T y = src->y();
+		T z = src->z();
+		T w = m30 * x + m31 * y + m32 * z + m33;
+		dst->x() = (m00 * x + m01 * y + m02 * z + m03) / w;
+		dst->y() = (m10 * x + m11 * y + m12 * z + m13) / w;
+		dst->z() = (m20 * x + m21 * y + m22 * z + m23) / w;
+	}
+}
+
+template <class T> void matrix4<T>::project_points(const vector4<T>* src, vector4<T>* dst, size_t size)const noexcept{
+	const matrix4& m = *this;
+	for(auto end = src + size; src != end; ++src, ++dst){
+		auto v = m * (*src);
+		*dst = v / v.w();
+	}
+}
+
+template <class T> constexpr matrix4<T>& matrix4<T>::scale(const vector3<T>& s)noexcept{
 	return this->scale(s.x(), s.y(), s.z());
 }
 
-template <class T> matrix4<T>& matrix4<T>::scale(const vector2<T>& s)noexcept{
+template <class T> constexpr matrix4<T>& matrix4<T>::scale(const vector2<T>& s)noexcept{
 	return this->scale(s.x(), s.y());
 }
 
-template <class T> matrix4<T>& matrix4<T>::translate(const vector2<T>& t)noexcept{
+template <class T> constexpr matrix4<T>& matrix4<T>::translate(const vector2<T>& t)noexcept{
 	return this->translate(t.x(), t.y());
 }
 
-template <class T> matrix4<T>& matrix4<T>::translate(const vector3<T>& t)noexcept{
+template <class T> constexpr matrix4<T>& matrix4<T>::translate(const vector3<T>& t)noexcept{
 	return this->translate(t.x(), t.y(), t.z());
 }
 
-template <class T> matrix4<T>& matrix4<T>::rotate(const quaternion<T>& q)noexcept{
-	return this->right_mul(matrix4<T>(q));
+template <class T> constexpr matrix4<T>& matrix4<T>::rotate(const quaternion<T>& q)noexcept{
+	// the last row and column of the rotation matrix are trivial, so only the left 3x4 submatrix is multiplied
+	matrix4<T> r(q);
+	for(auto& row : *this){
+		T x = row[0];
+		T y = row[1];
+		T z = row[2];
+		row[0] = x * r[0][0] + y * r[1][0] + z * r[2][0];
+		row[1] = x * r[0][1] + y * r[1][1] + z * r[2][1];
+		row[2] = x * r[0][2] + y * r[1][2] + z * r[2][2];
+	}
+	return *this;
 }
 
 template <class T> matrix4<T>& matrix4<T>::rotate(const vector3<T>& rot)noexcept{
@@ -651,11 +1131,57 @@ template <class T> matrix4<T>& matrix4<T>::rotate(T rot)noexcept{
 	return this->rotate(vector3<T>(0, 0, rot));
 }
 
+template <class T> matrix4<T>& matrix4<T>::set_look_at(const vector3<T>& eye, const vector3<T>& center, const vector3<T>& up)noexcept{
+	auto f = (center - eye).normalize();
+	auto side = f % up;
+	R4_ASSERT(side.norm_pow2() != 0);
+	side.normalize();
+	auto u = side % f;
+
+	this->row(0) = vector4<T>(side, -(side * eye));
+	this->row(1) = vector4<T>(u, -(u * eye));
+	this->row(2) = vector4<T>(-f, f * eye);
+	this->row(3) = vector4<T>(0, 0, 0, 1);
+
+	return *this;
+}
+
+template <class T> matrix4<T>& matrix4<T>::look_at(const vector3<T>& eye, const vector3<T>& center, const vector3<T>& up)noexcept{
+	matrix4<T> v;
+	v.set_look_at(eye, center, up);
+
+	// the viewing matrix is affine, so the product takes 36 multiplications instead of 64
+	for(auto& r : *this){
+		auto w = r[3];
+		r = v[0] * r[0] + v[1] * r[1] + v[2] * r[2];
+		r[3] += w;
+	}
+	return *this;
+}
+
+template <class T> void matrix4<T>::make_ortho(const aabb3<T>* volumes, matrix4* dst, size_t size)noexcept{
+	for(auto e = volumes + size; volumes != e; ++volumes, ++dst){
+		dst->set_ortho(volumes->p1.x(), volumes->p2.x(), volumes->p1.y(), volumes->p2.y(), volumes->p1.z(), volumes->p2.z());
+	}
+}
+
+template <class T> void matrix4<T>::make_perspective(const T* fovy, const T* aspect, const T* near_val, const T* far_val, matrix4* dst, size_t size)noexcept{
+	for(size_t i = 0; i != size; ++i){
+		dst[i].set_perspective(fovy[i], aspect[i], near_val[i], far_val[i]);
+	}
+}
+
+template <class T> void matrix4<T>::make_look_at(const vector3<T>* eye, const vector3<T>* center, const vector3<T>* up, matrix4* dst, size_t size)noexcept{
+	for(size_t i = 0; i != size; ++i){
+		dst[i].set_look_at(eye[i], center[i], up[i]);
+	}
+}
+
 template <class T> constexpr matrix4<T>::matrix4(const quaternion<T>& quat)noexcept{
 	this->set(quat);
 }
 
-template <class T> matrix4<T>& matrix4<T>::set(const quaternion<T>& quat)noexcept{
+template <class T> constexpr matrix4<T>& matrix4<T>::set(const quaternion<T>& quat)noexcept{
 	// Quaternion to matrix conversion:
 	//     /  1-(2y^2+2z^2)   2xy-2zw         2xz+2yw         0   \
 	// M = |  2xy+2zw         1-(2x^2+2z^2)   2yz-2xw         0   |
@@ -689,8 +1215,8 @@ template <class T> matrix4<T>& matrix4<T>::set(const quaternion<T>& quat)noexcep
 	return *this;
 }
 
-template <class T> matrix3<T> matrix4<T>::minor_matrix(unsigned r, unsigned c)const noexcept{
-	matrix3<T> ret;
+template <class T> constexpr matrix3<T> matrix4<T>::minor_matrix(unsigned r, unsigned c)const noexcept{
+	matrix3<T> ret{};
 
 	for(unsigned dr = 0; dr != r; ++dr){
 		for(unsigned dc = 0; dc != c; ++dc){
@@ -713,6 +1239,307 @@ template <class T> matrix3<T> matrix4<T>::minor_matrix(unsigned r, unsigned c)co
 	return ret;
 }
 
+template <class T> constexpr T matrix4<T>::det()const noexcept{
+	// Laplace expansion by the first two rows, each term is a product of 2x2 minors of
+	// the first two rows and complementary 2x2 minors of the last two rows
+	const auto& r0 = this->row(0);
+	const auto& r1 = this->row(1);
+	const auto& r2 = this->row(2);
+	const auto& r3 = this->row(3);
+
+	T s0 = r0[0] * r1[1] - r1[0] * r0[1];
+	T s1 = r0[0] * r1[2] - r1[0] * r0[2];
+	T s2 = r0[0] * r1[3] - r1[0] * r0[3];
+	T s3 = r0[1] * r1[2] - r1[1] * r0[2];
+	T s4 = r0[1] * r1[3] - r1[1] * r0[3];
+	T s5 = r0[2] * r1[3] - r1[2] * r0[3];
+
+	T c0 = r2[0] * r3[1] - r3[0] * r2[1];
+	T c1 = r2[0] * r3[2] - r3[0] * r2[2];
+	T c2 = r2[0] * r3[3] - r3[0] * r2[3];
+	T c3 = r2[1] * r3[2] - r3[1] * r2[2];
+	T c4 = r2[1] * r3[3] - r3[1] * r2[3];
+	T c5 = r2[2] * r3[3] - r3[2] * r2[3];
+
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+template <class T> constexpr matrix4<T> matrix4<T>::inv()const noexcept{
+	return this->inv_by_minors();
+}
+
+template <class T> constexpr matrix4<T> matrix4<T>::inv_by_minors()const noexcept{
+	// Same 2x2 minors as in det() are shared by all the cofactors.
+	const auto& r0 = this->row(0);
+	const auto& r1 = this->row(1);
+	const auto& r2 = this->row(2);
+	const auto& r3 = this->row(3);
+
+	T s0 = r0[0] * r1[1] - r1[0] * r0[1];
+	T s1 = r0[0] * r1[2] - r1[0] * r0[2];
+	T s2 = r0[0] * r1[3] - r1[0] * r0[3];
+	T s3 = r0[1] * r1[2] - r1[1] * r0[2];
+	T s4 = r0[1] * r1[3] - r1[1] * r0[3];
+	T s5 = r0[2] * r1[3] - r1[2] * r0[3];
+
+	T c0 = r2[0] * r3[1] - r3[0] * r2[1];
+	T c1 = r2[0] * r3[2] - r3[0] * r2[2];
+	T c2 = r2[0] * r3[3] - r3[0] * r2[3];
+	T c3 = r2[1] * r3[2] - r3[1] * r2[2];
+	T c4 = r2[1] * r3[3] - r3[1] * r2[3];
+	T c5 = r2[2] * r3[3] - r3[2] * r2[3];
+
+	T d = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if(d == 0){
+		// singular matrix
+		return matrix4<T>{};
+	}
+
+	// transposed matrix of cofactors
+	matrix4<T> adj(
+			vector4<T>(
+					r1[1] * c5 - r1[2] * c4 + r1[3] * c3,
+					-r0[1] * c5 + r0[2] * c4 - r0[3] * c3,
+					r3[1] * s5 - r3[2] * s4 + r3[3] * s3,
+					-r2[1] * s5 + r2[2] * s4 - r2[3] * s3
+				),
+			vector4<T>(
+					-r1[0] * c5 + r1[2] * c2 - r1[3] * c1,
+					r0[0] * c5 - r0[2] * c2 + r0[3] * c1,
+					-r3[0] * s5 + r3[2] * s2 - r3[3] * s1,
+					r2[0] * s5 - r2[2] * s2 + r2[3] * s1
+				),
+			vector4<T>(
+					r1[0] * c4 - r1[1] * c2 + r1[3] * c0,
+					-r0[0] * c4 + r0[1] * c2 - r0[3] * c0,
+					r3[0] * s4 - r3[1] * s2 + r3[3] * s0,
+					-r2[0] * s4 + r2[1] * s2 - r2[3] * s0
+				),
+			vector4<T>(
+					-r1[0] * c3 + r1[1] * c1 - r1[2] * c0,
+					r0[0] * c3 - r0[1] * c1 + r0[2] * c0,
+					-r3[0] * s3 + r3[1] * s1 - r3[2] * s0,
+					r2[0] * s3 - r2[1] * s1 + r2[2] * s0
+				)
+		);
+
+	return adj / d;
+}
+
+template <class T> constexpr matrix4<T> matrix4<T>::affine_inv()const noexcept{
+	R4_ASSERT(this->row(3)[0] == 0 && this->row(3)[1] == 0 && this->row(3)[2] == 0 && this->row(3)[3] == 1);
+
+	const auto& r0 = this->row(0);
+	const auto& r1 = this->row(1);
+	const auto& r2 = this->row(2);
+
+	// transposed matrix of cofactors of the upper left 3x3 submatrix
+	matrix3<T> adj(
+			vector3<T>(r1[1] * r2[2] - r1[2] * r2[1], r0[2] * r2[1] - r0[1] * r2[2], r0[1] * r1[2] - r0[2] * r1[1]),
+			vector3<T>(r1[2] * r2[0] - r1[0] * r2[2], r0[0] * r2[2] - r0[2] * r2[0], r0[2] * r1[0] - r0[0] * r1[2]),
+			vector3<T>(r1[0] * r2[1] - r1[1] * r2[0], r0[1] * r2[0] - r0[0] * r2[1], r0[0] * r1[1] - r0[1] * r1[0])
+		);
+
+	T d = r0[0] * adj[0][0] + r0[1] * adj[1][0] + r0[2] * adj[2][0];
+	if(d == 0){
+		// singular matrix
+		return matrix4<T>{};
+	}
+
+	matrix4<T> ret{};
+	for(unsigned r = 0; r != 3; ++r){
+		for(unsigned c = 0; c != 3; ++c){
+			ret[r][c] = adj[r][c] / d;
+		}
+		// inverse translation is -(M^-1 * t)
+		ret[r][3] = -(ret[r][0] * r0[3] + ret[r][1] * r1[3] + ret[r][2] * r2[3]);
+	}
+	ret[3] = vector4<T>(0, 0, 0, 1);
+
+	return ret;
+}
+
+template <class T> constexpr matrix4<T> matrix4<T>::rigid_inv()const noexcept{
+	R4_ASSERT(this->row(3)[0] == 0 && this->row(3)[1] == 0 && this->row(3)[2] == 0 && this->row(3)[3] == 1);
+
+	matrix4<T> ret{};
+	for(unsigned r = 0; r != 3; ++r){
+		// inverse of rotation is its transpose
+		for(unsigned c = 0; c != 3; ++c){
+			ret[r][c] = this->row(c)[r];
+		}
+		// inverse translation is -(R^T * t)
+		ret[r][3] = -(ret[r][0] * this->row(0)[3] + ret[r][1] * this->row(1)[3] + ret[r][2] * this->row(2)[3]);
+	}
+	ret[3] = vector4<T>(0, 0, 0, 1);
+
+	return ret;
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of matrix4<float> operations.
+// SIMD intrinsics cannot be evaluated at compile time, so during constant evaluation plain scalar code is used.
+
+template <> constexpr matrix4<float> matrix4<float>::operator*(const matrix4<float>& matr)const noexcept{
+	matrix4<float> ret{};
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(unsigned r = 0; r != ret.size(); ++r){
+			for(unsigned c = 0; c != ret[r].size(); ++c){
+				for(unsigned i = 0; i != ret.size(); ++i){
+					ret[r][c] += this->row(r)[i] * matr[i][c];
+				}
+			}
+		}
+	}else{
+		simd::mat_mul(ret.front().data(), this->front().data(), matr.front().data());
+	}
+	return ret;
+}
+
+template <> constexpr matrix4<float>& matrix4<float>::operator*=(const matrix4<float>& matr)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		return this->operator=(this->operator*(matr));
+	}
+	// NOTE: simd::mat_mul() reads both matrices before storing the result, so it is safe to use this matrix as output
+	simd::mat_mul(this->front().data(), this->front().data(), matr.front().data());
+	return *this;
+}
+
+template <> constexpr vector4<float> matrix4<float>::operator*(const vector4<float>& vec)const noexcept{
+	vector4<float> ret{};
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(unsigned r = 0; r != ret.size(); ++r){
+			for(unsigned i = 0; i != ret.size(); ++i){
+				ret[r] += this->row(r)[i] * vec[i];
+			}
+		}
+		return ret;
+	}
+	simd::store(
+			ret.data(),
+			simd::mat_vec(
+					simd::load(this->row(0).data()),
+					simd::load(this->row(1).data()),
+					simd::load(this->row(2).data()),
+					simd::load(this->row(3).data()),
+					simd::load(vec.data())
+				)
+		);
+	return ret;
+}
+
+template <> constexpr vector3<float> matrix4<float>::operator*(const vector3<float>& vec)const noexcept{
+	return vector3<float>(this->operator*(vector4<float>(vec, 1)));
+}
+
+template <> inline void matrix4<float>::transform_points(const vector2<float>* src, vector2<float>* dst, size_t size)const noexcept{
+	simd::transform_points<2, false>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline void matrix4<float>::transform_points(const vector3<float>* src, vector3<float>* dst, size_t size)const noexcept{
+	simd::transform_points<3, false>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline void matrix4<float>::transform_points(const vector4<float>* src, vector4<float>* dst, size_t size)const noexcept{
+	simd::transform_points4<false>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline void matrix4<float>::project_points(const vector2<float>* src, vector2<float>* dst, size_t size)const noexcept{
+	simd::transform_points<2, true>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline void matrix4<float>::project_points(const vector3<float>* src, vector3<float>* dst, size_t size)const noexcept{
+	simd::transform_points<3, true>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> inline void matrix4<float>::project_points(const vector4<float>* src, vector4<float>* dst, size_t size)const noexcept{
+	simd::transform_points4<true>(this->front().data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+template <> constexpr matrix4<float> matrix4<float>::inv()const noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		return this->inv_by_minors();
+	}
+	matrix4<float> ret{};
+	if(simd::mat_inv(ret[0].data(), this->row(0).data()) == 0){
+		// singular matrix, the result of mat_inv() is undefined
+		return matrix4<float>{};
+	}
+	return ret;
+}
+
+template <> inline void matrix4<float>::make_look_at(const vector3<float>* eye, const vector3<float>* center, const vector3<float>* up, matrix4<float>* dst, size_t size)noexcept{
+	// build 4 matrices at a time, the vectors are processed in structure-of-arrays form
+	const auto zero = simd::splat(0.0f);
+	const auto one = simd::splat(1.0f);
+	const auto row3 = simd::load(vector4<float>(0, 0, 0, 1).data());
+
+	auto e = eye + size;
+	for(; e - eye >= 4; eye += 4, center += 4, up += 4, dst += 4){
+		simd::float4 ex, ey, ez;
+		simd::float4 cx, cy, cz;
+		simd::float4 ux, uy, uz;
+		simd::load3(eye->data(), ex, ey, ez);
+		simd::load3(center->data(), cx, cy, cz);
+		simd::load3(up->data(), ux, uy, uz);
+
+		// zero length vectors are normalized to (1, 0, 0) as vector3::normalize() does
+		auto fx = simd::sub(cx, ex);
+		auto fy = simd::sub(cy, ey);
+		auto fz = simd::sub(cz, ez);
+		auto norm_pow2 = simd::mul_add(fx, fx, simd::mul_add(fy, fy, simd::mul(fz, fz)));
+		auto is_zero = simd::cmp_eq(norm_pow2, zero);
+		auto inv_norm = simd::div(one, simd::sqrt(norm_pow2));
+		fx = simd::select(is_zero, one, simd::mul(fx, inv_norm));
+		fy = simd::select(is_zero, zero, simd::mul(fy, inv_norm));
+		fz = simd::select(is_zero, zero, simd::mul(fz, inv_norm));
+
+		// side = f x up
+		auto sx = simd::sub(simd::mul(fy, uz), simd::mul(fz, uy));
+		auto sy = simd::sub(simd::mul(fz, ux), simd::mul(fx, uz));
+		auto sz = simd::sub(simd::mul(fx, uy), simd::mul(fy, ux));
+		norm_pow2 = simd::mul_add(sx, sx, simd::mul_add(sy, sy, simd::mul(sz, sz)));
+		is_zero = simd::cmp_eq(norm_pow2, zero);
+		R4_ASSERT(simd::mask_bits(is_zero) == 0);
+		inv_norm = simd::div(one, simd::sqrt(norm_pow2));
+		sx = simd::select(is_zero, one, simd::mul(sx, inv_norm));
+		sy = simd::select(is_zero, zero, simd::mul(sy, inv_norm));
+		sz = simd::select(is_zero, zero, simd::mul(sz, inv_norm));
+
+		// u = side x f
+		ux = simd::sub(simd::mul(sy, fz), simd::mul(sz, fy));
+		uy = simd::sub(simd::mul(sz, fx), simd::mul(sx, fz));
+		uz = simd::sub(simd::mul(sx, fy), simd::mul(sy, fx));
+
+		auto st = simd::negate(simd::mul_add(sx, ex, simd::mul_add(sy, ey, simd::mul(sz, ez))));
+		auto ut = simd::negate(simd::mul_add(ux, ex, simd::mul_add(uy, ey, simd::mul(uz, ez))));
+		auto ft = simd::mul_add(fx, ex, simd::mul_add(fy, ey, simd::mul(fz, ez)));
+		fx = simd::negate(fx);
+		fy = simd::negate(fy);
+		fz = simd::negate(fz);
+
+		// transpose from structure-of-arrays to the rows of the 4 matrices
+		simd::transpose(sx, sy, sz, st);
+		simd::transpose(ux, uy, uz, ut);
+		simd::transpose(fx, fy, fz, ft);
+
+		const simd::float4 rows[3][4] = {{sx, sy, sz, st}, {ux, uy, uz, ut}, {fx, fy, fz, ft}};
+		for(unsigned k = 0; k != 4; ++k){
+			auto& m = dst[k];
+			simd::store(m[0].data(), rows[0][k]);
+			simd::store(m[1].data(), rows[1][k]);
+			simd::store(m[2].data(), rows[2][k]);
+			simd::store(m[3].data(), row3);
+		}
+	}
+	for(; eye != e; ++eye, ++center, ++up, ++dst){
+		dst->set_look_at(*eye, *center, *up);
+	}
+}
+
+#endif // ~R4_SIMD
+
 static_assert(sizeof(matrix4<float>) == sizeof(float) * 4 * 4, "size mismatch");
 static_assert(sizeof(matrix4<double>) == sizeof(double) * 4 * 4, "size mismatch");
 
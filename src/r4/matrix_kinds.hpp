@@ -0,0 +1,608 @@
+#pragma once
+
+#include <type_traits>
+
+#include "config.hpp"
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+#include "vector4.hpp"
+#include "quaternion.hpp"
+#include "matrix4.hpp"
+#include "affine3.hpp"
+
+namespace r4{
+
+// Sparse matrix kinds.
+//
+// Each kind is a 4x4 transformation matrix of known sparse structure which stores only its non-trivial elements.
+// The kind is carried in the type, so that multiplication of kinds is dispatched at compile time to the minimal kernel,
+// e.g. translation3 * translation3 is a vector addition and matrix4 * rotation3 does not multiply by zeros of the rotation matrix.
+// Products of affine kinds (translation3, scaling3, rotation3, orthographic_projection and affine3) are affine3,
+// products involving perspective_projection or matrix4 are matrix4. All kinds are implicitly convertible to matrix4,
+// so generic code which works with matrix4 accepts them as well.
+//
+// Each kind provides the multiplication kernels:
+// - right_mul_to(m) multiplies matrix m by the kind from the right, i.e. m = m * kind,
+// - left_mul_to(m) multiplies matrix m by the kind from the left, i.e. m = kind * m,
+// for m being matrix4, and also affine3 for affine kinds.
+
+/**
+ * @brief Translation matrix.
+ * Matrix of the form
+ * @code
+ * / 1 0 0 x \
+ * | 0 1 0 y |
+ * | 0 0 1 z |
+ * \ 0 0 0 1 /
+ * @endcode
+ */
+template <class T> class translation3{
+public:
+	/**
+	 * @brief Translation vector.
+	 */
+	vector3<T> t;
+
+	translation3() = default;
+
+	constexpr explicit translation3(const vector3<T>& t)noexcept :
+			t(t)
+	{}
+
+	constexpr translation3(T x, T y, T z)noexcept :
+			t(x, y, z)
+	{}
+
+	constexpr affine3<T> to_affine3()const noexcept{
+		return affine3<T>{
+			vector4<T>{1, 0, 0, this->t[0]},
+			vector4<T>{0, 1, 0, this->t[1]},
+			vector4<T>{0, 0, 1, this->t[2]}
+		};
+	}
+
+	constexpr matrix4<T> to_matrix4()const noexcept{
+		return this->to_affine3().to_matrix4();
+	}
+
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Transform point.
+	 * @param p - point to transform.
+	 * @return transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return p + this->t;
+	}
+
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept{
+		m.translate(this->t);
+	}
+
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] += m[3] * this->t[i];
+		}
+	}
+
+	constexpr void right_mul_to(affine3<T>& m)const noexcept{
+		m.translate(this->t);
+	}
+
+	constexpr void left_mul_to(affine3<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i][3] += this->t[i];
+		}
+	}
+
+	friend constexpr translation3 operator*(const translation3& a, const translation3& b)noexcept{
+		return translation3(a.t + b.t);
+	}
+};
+
+/**
+ * @brief Scaling matrix.
+ * Matrix of the form
+ * @code
+ * / x 0 0 0 \
+ * | 0 y 0 0 |
+ * | 0 0 z 0 |
+ * \ 0 0 0 1 /
+ * @endcode
+ */
+template <class T> class scaling3{
+public:
+	/**
+	 * @brief Scaling factors.
+	 */
+	vector3<T> s;
+
+	scaling3() = default;
+
+	constexpr explicit scaling3(const vector3<T>& s)noexcept :
+			s(s)
+	{}
+
+	constexpr scaling3(T x, T y, T z)noexcept :
+			s(x, y, z)
+	{}
+
+	constexpr affine3<T> to_affine3()const noexcept{
+		return affine3<T>{
+			vector4<T>{this->s[0], 0, 0, 0},
+			vector4<T>{0, this->s[1], 0, 0},
+			vector4<T>{0, 0, this->s[2], 0}
+		};
+	}
+
+	constexpr matrix4<T> to_matrix4()const noexcept{
+		return this->to_affine3().to_matrix4();
+	}
+
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Transform point.
+	 * @param p - point to transform.
+	 * @return transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return p.comp_mul(this->s);
+	}
+
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept{
+		m.scale(this->s);
+	}
+
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] *= this->s[i];
+		}
+	}
+
+	constexpr void right_mul_to(affine3<T>& m)const noexcept{
+		m.scale(this->s);
+	}
+
+	constexpr void left_mul_to(affine3<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] *= this->s[i];
+		}
+	}
+
+	friend constexpr scaling3 operator*(const scaling3& a, const scaling3& b)noexcept{
+		return scaling3(a.s.comp_mul(b.s));
+	}
+};
+
+/**
+ * @brief Rotation matrix.
+ * Matrix of the form
+ * @code
+ * / r r r 0 \
+ * | r r r 0 |
+ * | r r r 0 |
+ * \ 0 0 0 1 /
+ * @endcode
+ * The rotation is stored as unit quaternion.
+ */
+template <class T> class rotation3{
+public:
+	/**
+	 * @brief Unit quaternion defining the rotation.
+	 */
+	quaternion<T> q;
+
+	rotation3() = default;
+
+	constexpr explicit rotation3(const quaternion<T>& q)noexcept :
+			q(q)
+	{}
+
+	constexpr affine3<T> to_affine3()const noexcept{
+		return affine3<T>(this->q);
+	}
+
+	constexpr matrix4<T> to_matrix4()const noexcept{
+		return matrix4<T>(this->q);
+	}
+
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Transform point.
+	 * @param p - point to transform.
+	 * @return transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return vector3<T>(p).rotate(this->q);
+	}
+
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept{
+		m.rotate(this->q);
+	}
+
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept{
+		auto r = this->to_affine3();
+		auto r0 = m[0];
+		auto r1 = m[1];
+		auto r2 = m[2];
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] = r0 * r[i][0] + r1 * r[i][1] + r2 * r[i][2];
+		}
+	}
+
+	constexpr void right_mul_to(affine3<T>& m)const noexcept{
+		m.rotate(this->q);
+	}
+
+	constexpr void left_mul_to(affine3<T>& m)const noexcept{
+		auto r = this->to_affine3();
+		auto r0 = m[0];
+		auto r1 = m[1];
+		auto r2 = m[2];
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] = r0 * r[i][0] + r1 * r[i][1] + r2 * r[i][2];
+		}
+	}
+
+	friend constexpr rotation3 operator*(const rotation3& a, const rotation3& b)noexcept{
+		return rotation3(a.q % b.q);
+	}
+};
+
+/**
+ * @brief Orthographic projection matrix.
+ * Matrix of the form
+ * @code
+ * / sx 0  0  tx \
+ * | 0  sy 0  ty |
+ * | 0  0  sz tz |
+ * \ 0  0  0  1  /
+ * @endcode
+ * i.e. scaling followed by translation.
+ */
+template <class T> class orthographic_projection{
+public:
+	/**
+	 * @brief Scaling factors.
+	 */
+	vector3<T> s;
+
+	/**
+	 * @brief Translation vector.
+	 */
+	vector3<T> t;
+
+	orthographic_projection() = default;
+
+	constexpr orthographic_projection(const vector3<T>& s, const vector3<T>& t)noexcept :
+			s(s),
+			t(t)
+	{}
+
+	/**
+	 * @brief Construct orthographic projection matrix.
+	 * Parameters are identical to glOrtho() function from OpenGL.
+	 * @param left - left vertical clipping plane.
+	 * @param right - right vertical clipping plane.
+	 * @param bottom - bottom horizontal clipping plane.
+	 * @param top - top horizontal clipping plane.
+	 * @param near_val - distance to near depth clipping plane.
+	 * @param far_val - distance to far depth clipping plane.
+	 */
+	constexpr orthographic_projection(T left, T right, T bottom, T top, T near_val, T far_val)noexcept :
+			s(0),
+			t(0)
+	{
+		T w = right - left;
+		R4_ASSERT(w != 0);
+
+		T h = top - bottom;
+		R4_ASSERT(h != 0);
+
+		T d = far_val - near_val;
+		R4_ASSERT(d != 0);
+
+		this->s = vector3<T>(2 / w, 2 / h, -2 / d);
+		this->t = vector3<T>(-(right + left) / w, -(top + bottom) / h, -(far_val + near_val) / d);
+	}
+
+	constexpr affine3<T> to_affine3()const noexcept{
+		return affine3<T>{
+			vector4<T>{this->s[0], 0, 0, this->t[0]},
+			vector4<T>{0, this->s[1], 0, this->t[1]},
+			vector4<T>{0, 0, this->s[2], this->t[2]}
+		};
+	}
+
+	constexpr matrix4<T> to_matrix4()const noexcept{
+		return this->to_affine3().to_matrix4();
+	}
+
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Transform point.
+	 * @param p - point to transform.
+	 * @return transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return p.comp_mul(this->s) + this->t;
+	}
+
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept{
+		m.right_mul_ortho(this->s, this->t);
+	}
+
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] = m[i] * this->s[i] + m[3] * this->t[i];
+		}
+	}
+
+	constexpr void right_mul_to(affine3<T>& m)const noexcept{
+		m.translate(this->t);
+		m.scale(this->s);
+	}
+
+	constexpr void left_mul_to(affine3<T>& m)const noexcept{
+		for(unsigned i = 0; i != 3; ++i){
+			m[i] *= this->s[i];
+			m[i][3] += this->t[i];
+		}
+	}
+
+	friend constexpr orthographic_projection operator*(const orthographic_projection& a, const orthographic_projection& b)noexcept{
+		return orthographic_projection(a.s.comp_mul(b.s), a.s.comp_mul(b.t) + a.t);
+	}
+};
+
+/**
+ * @brief Perspective projection matrix.
+ * Matrix of the form
+ * @code
+ * / sx 0  ox 0  \
+ * | 0  sy oy 0  |
+ * | 0  0  sz tz |
+ * \ 0  0  -1 0  /
+ * @endcode
+ * as produced by matrix4::set_frustum().
+ */
+template <class T> class perspective_projection{
+public:
+	/**
+	 * @brief Diagonal elements (sx, sy, sz).
+	 */
+	vector3<T> s;
+
+	/**
+	 * @brief Elements of the third column (ox, oy).
+	 */
+	vector2<T> o;
+
+	/**
+	 * @brief Depth translation tz.
+	 */
+	T tz;
+
+	perspective_projection() = default;
+
+	/**
+	 * @brief Construct perspective projection matrix.
+	 * Parameters are identical to glFrustum() function from OpenGL.
+	 * @param left - left vertical clipping plane.
+	 * @param right - right vertical clipping plane.
+	 * @param bottom - bottom horizontal clipping plane.
+	 * @param top - top horizontal clipping plane.
+	 * @param near_val - distance to near depth clipping plane. Must be positive.
+	 * @param far_val - distance to far depth clipping plane. Must be positive.
+	 */
+	constexpr perspective_projection(T left, T right, T bottom, T top, T near_val, T far_val)noexcept :
+			s(0),
+			o(0),
+			tz(0)
+	{
+		T w = right - left;
+		R4_ASSERT(w != 0);
+
+		T h = top - bottom;
+		R4_ASSERT(h != 0);
+
+		T d = far_val - near_val;
+		R4_ASSERT(d != 0);
+
+		this->s = vector3<T>(2 * near_val / w, 2 * near_val / h, -(far_val + near_val) / d);
+		this->o = vector2<T>((right + left) / w, (top + bottom) / h);
+		this->tz = -2 * far_val * near_val / d;
+	}
+
+	constexpr matrix4<T> to_matrix4()const noexcept{
+		return matrix4<T>{
+			vector4<T>{this->s[0], 0, this->o[0], 0},
+			vector4<T>{0, this->s[1], this->o[1], 0},
+			vector4<T>{0, 0, this->s[2], this->tz},
+			vector4<T>{0, 0, -1, 0}
+		};
+	}
+
+	constexpr operator matrix4<T>()const noexcept{
+		return this->to_matrix4();
+	}
+
+	/**
+	 * @brief Transform vector.
+	 * @param v - vector to transform.
+	 * @return transformed vector, perspective divide is not done.
+	 */
+	constexpr vector4<T> operator*(const vector4<T>& v)const noexcept{
+		return vector4<T>(
+				this->s[0] * v[0] + this->o[0] * v[2],
+				this->s[1] * v[1] + this->o[1] * v[2],
+				this->s[2] * v[2] + this->tz * v[3],
+				-v[2]
+			);
+	}
+
+	constexpr void right_mul_to(matrix4<T>& m)const noexcept{
+		m.right_mul_frustum(this->s[0], this->s[1], this->s[2], this->o[0], this->o[1], this->tz);
+	}
+
+	constexpr void left_mul_to(matrix4<T>& m)const noexcept{
+		auto r2 = m[2];
+		m[0] = m[0] * this->s[0] + r2 * this->o[0];
+		m[1] = m[1] * this->s[1] + r2 * this->o[1];
+		m[2] = r2 * this->s[2] + m[3] * this->tz;
+		m[3] = -r2;
+	}
+};
+
+/**
+ * @brief Traits of matrix kinds.
+ * is_kind is true for the sparse matrix kinds and affine3.
+ * is_affine is true for kinds which are affine transformations, i.e. whose product is affine3.
+ * @param M - matrix type.
+ */
+template <class M> struct matrix_kind_traits{
+	static constexpr bool is_kind = false;
+	static constexpr bool is_affine = false;
+};
+
+template <class T> struct matrix_kind_traits<translation3<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = true;
+};
+
+template <class T> struct matrix_kind_traits<scaling3<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = true;
+};
+
+template <class T> struct matrix_kind_traits<rotation3<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = true;
+};
+
+template <class T> struct matrix_kind_traits<orthographic_projection<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = true;
+};
+
+template <class T> struct matrix_kind_traits<affine3<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = true;
+};
+
+template <class T> struct matrix_kind_traits<perspective_projection<T>>{
+	typedef T scalar_type;
+	static constexpr bool is_kind = true;
+	static constexpr bool is_affine = false;
+};
+
+/**
+ * @brief Multiply affine matrix kinds.
+ * Products of two matrices of the same kind are handled by the kinds themselves.
+ * @return affine3 product of the matrices.
+ */
+template <
+		class A,
+		class B,
+		typename std::enable_if<
+				matrix_kind_traits<A>::is_affine && matrix_kind_traits<B>::is_affine && !std::is_same<A, B>::value,
+				bool
+			>::type = true
+	>
+constexpr affine3<typename matrix_kind_traits<A>::scalar_type> operator*(const A& a, const B& b)noexcept{
+	typedef typename matrix_kind_traits<A>::scalar_type T;
+	static_assert(std::is_same<T, typename matrix_kind_traits<B>::scalar_type>::value, "scalar types mismatch");
+
+	if constexpr(std::is_same<A, affine3<T>>::value){
+		affine3<T> ret = a;
+		b.right_mul_to(ret);
+		return ret;
+	}else if constexpr(std::is_same<B, affine3<T>>::value){
+		affine3<T> ret = b;
+		a.left_mul_to(ret);
+		return ret;
+	}else if constexpr(std::is_same<B, rotation3<T>>::value){
+		// the rotation matrix has to be calculated anyway, so apply the cheaper kernel of the other kind to it
+		auto ret = b.to_affine3();
+		a.left_mul_to(ret);
+		return ret;
+	}else{
+		auto ret = a.to_affine3();
+		b.right_mul_to(ret);
+		return ret;
+	}
+}
+
+/**
+ * @brief Multiply matrix kinds one of which is projective.
+ * @return matrix4 product of the matrices.
+ */
+template <
+		class A,
+		class B,
+		typename std::enable_if<
+				matrix_kind_traits<A>::is_kind && matrix_kind_traits<B>::is_kind
+						&& !(matrix_kind_traits<A>::is_affine && matrix_kind_traits<B>::is_affine),
+				bool
+			>::type = true
+	>
+constexpr matrix4<typename matrix_kind_traits<A>::scalar_type> operator*(const A& a, const B& b)noexcept{
+	static_assert(
+			std::is_same<typename matrix_kind_traits<A>::scalar_type, typename matrix_kind_traits<B>::scalar_type>::value,
+			"scalar types mismatch"
+		);
+
+	if constexpr(matrix_kind_traits<B>::is_affine){
+		auto ret = b.to_matrix4();
+		a.left_mul_to(ret);
+		return ret;
+	}else{
+		auto ret = a.to_matrix4();
+		b.right_mul_to(ret);
+		return ret;
+	}
+}
+
+/**
+ * @brief Multiply matrix4 by matrix kind from the right.
+ * @return matrix4 product of the matrices.
+ */
+template <class T, class K, typename std::enable_if<matrix_kind_traits<K>::is_kind, bool>::type = true>
+constexpr matrix4<T> operator*(const matrix4<T>& m, const K& k)noexcept{
+	static_assert(std::is_same<T, typename matrix_kind_traits<K>::scalar_type>::value, "scalar types mismatch");
+	auto ret = m;
+	k.right_mul_to(ret);
+	return ret;
+}
+
+/**
+ * @brief Multiply matrix4 by matrix kind from the left.
+ * @return matrix4 product of the matrices.
+ */
+template <class T, class K, typename std::enable_if<matrix_kind_traits<K>::is_kind, bool>::type = true>
+constexpr matrix4<T> operator*(const K& k, const matrix4<T>& m)noexcept{
+	static_assert(std::is_same<T, typename matrix_kind_traits<K>::scalar_type>::value, "scalar types mismatch");
+	auto ret = m;
+	k.left_mul_to(ret);
+	return ret;
+}
+
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "vector3.hpp"
+#include "quaternion.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Unit vector packed to 32 bits.
+ * The unit vector is mapped to a point on octahedron which is unfolded onto a square,
+ * the two coordinates of the point on the square are stored as 16-bit signed normalized integers.
+ * Takes a third of the vector3<float> size, the maximal angular error is about 0.005 degrees.
+ * Useful for storing normals and other directions in vertex buffers.
+ */
+class packed_unit_vector3{
+	uint32_t v;
+
+	static constexpr float scale = 32767;
+
+	struct from_bits_tag{};
+
+	constexpr packed_unit_vector3(uint32_t bits, from_bits_tag)noexcept :
+			v(bits)
+	{}
+
+	static uint32_t pack_snorm16(int32_t x, int32_t y)noexcept{
+		return uint32_t(uint16_t(int16_t(x))) | (uint32_t(uint16_t(int16_t(y))) << 16);
+	}
+
+	template <class T> static T sign_not_zero(T a)noexcept{
+		return a < T(0) ? T(-1) : T(1);
+	}
+
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the packed vector.
+	 */
+	packed_unit_vector3() = default;
+
+	/**
+	 * @brief Pack unit vector.
+	 * @param vec - vector to pack, must be non-zero, it is normalized in the process of packing.
+	 */
+	template <class T> explicit packed_unit_vector3(const vector3<T>& vec)noexcept{
+		using std::abs;
+		using std::round;
+
+		T s = abs(vec.x()) + abs(vec.y()) + abs(vec.z());
+		ASSERT(s != T(0))
+
+		T x = vec.x() / s;
+		T y = vec.y() / s;
+		if(vec.z() < T(0)){
+			// fold the lower hemisphere of the octahedron over the upper one
+			T fx = (T(1) - abs(y)) * sign_not_zero(x);
+			T fy = (T(1) - abs(x)) * sign_not_zero(y);
+			x = fx;
+			y = fy;
+		}
+
+		this->v = pack_snorm16(int32_t(round(x * T(scale))), int32_t(round(y * T(scale))));
+	}
+
+	/**
+	 * @brief Create packed vector from its binary representation.
+	 * @param bits - binary representation.
+	 * @return packed vector.
+	 */
+	static constexpr packed_unit_vector3 from_bits(uint32_t bits)noexcept{
+		return packed_unit_vector3(bits, from_bits_tag());
+	}
+
+	/**
+	 * @brief Get binary representation.
+	 * @return binary representation of the packed vector.
+	 */
+	constexpr uint32_t bits()const noexcept{
+		return this->v;
+	}
+
+	constexpr bool operator==(const packed_unit_vector3& p)const noexcept{
+		return this->v == p.v;
+	}
+
+	/**
+	 * @brief Unpack the vector.
+	 * @return unpacked unit vector.
+	 */
+	template <class T> vector3<T> to()const noexcept{
+		using std::abs;
+		using std::max;
+		using std::min;
+
+		T x = max(T(int16_t(uint16_t(this->v))) / T(scale), T(-1));
+		T y = max(T(int16_t(uint16_t(this->v >> 16))) / T(scale), T(-1));
+		T z = T(1) - abs(x) - abs(y);
+
+		// unfold the lower hemisphere
+		T t = max(-z, T(0));
+		x += x >= T(0) ? -t : t;
+		y += y >= T(0) ? -t : t;
+
+		return vector3<T>(x, y, z).normalize();
+	}
+
+	/**
+	 * @brief Pack array of unit vectors.
+	 * @param src - vectors to pack.
+	 * @param dst - output packed vectors.
+	 * @param size - number of vectors.
+	 */
+	template <class T> static void pack(const vector3<T>* src, packed_unit_vector3* dst, size_t size)noexcept{
+		for(auto e = src + size; src != e; ++src, ++dst){
+			*dst = packed_unit_vector3(*src);
+		}
+	}
+
+	/**
+	 * @brief Unpack array of unit vectors.
+	 * @param src - packed vectors.
+	 * @param dst - output unpacked vectors.
+	 * @param size - number of vectors.
+	 */
+	template <class T> static void unpack(const packed_unit_vector3* src, vector3<T>* dst, size_t size)noexcept{
+		for(auto e = src + size; src != e; ++src, ++dst){
+			*dst = src->to<T>();
+		}
+	}
+};
+
+static_assert(sizeof(packed_unit_vector3) == 4, "size mismatch");
+
+/**
+ * @brief Unit quaternion packed to 64 bits.
+ * Smallest three encoding: the component with the largest absolute value is dropped and restored
+ * from the unit length condition, the sign of the quaternion is chosen so that the dropped component is positive.
+ * The remaining three components are in range [-1/sqrt(2), 1/sqrt(2)] and are stored as 20-bit integers,
+ * the index of the dropped component is stored in the upper 2 bits.
+ * Takes half of the quaternion<float> size, the maximal component error is about 2e-6.
+ * Since q and -q represent the same rotation, the unpacked quaternion may differ from the packed one by sign.
+ */
+class packed_quaternion{
+	uint64_t v;
+
+	static constexpr unsigned component_bits = 20;
+	static constexpr uint64_t component_mask = (uint64_t(1) << component_bits) - 1;
+	static constexpr unsigned index_shift = 62;
+
+	// sqrt(2)
+	static constexpr double range = 1.41421356237309504880;
+
+	struct from_bits_tag{};
+
+	constexpr packed_quaternion(uint64_t bits, from_bits_tag)noexcept :
+			v(bits)
+	{}
+
+public:
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the packed quaternion.
+	 */
+	packed_quaternion() = default;
+
+	/**
+	 * @brief Pack unit quaternion.
+	 * @param q - unit quaternion to pack.
+	 */
+	template <class T> explicit packed_quaternion(const quaternion<T>& q)noexcept{
+		using std::abs;
+		using std::round;
+		using std::min;
+		using std::max;
+
+		unsigned largest = 0;
+		for(unsigned i = 1; i != 4; ++i){
+			if(abs(q[i]) > abs(q[largest])){
+				largest = i;
+			}
+		}
+
+		T sign = q[largest] < T(0) ? T(-1) : T(1);
+
+		this->v = uint64_t(largest) << index_shift;
+		for(unsigned i = 0, shift = 2 * component_bits; i != 4; ++i){
+			if(i == largest){
+				continue;
+			}
+			// map [-1/sqrt(2), 1/sqrt(2)] to [0, 2^component_bits - 1]
+			T c = (q[i] * sign * T(range) + T(1)) * T(component_mask / 2);
+			c = min(max(round(c), T(0)), T(component_mask));
+			this->v |= uint64_t(c) << shift;
+			shift -= component_bits;
+		}
+	}
+
+	/**
+	 * @brief Create packed quaternion from its binary representation.
+	 * @param bits - binary representation.
+	 * @return packed quaternion.
+	 */
+	static constexpr packed_quaternion from_bits(uint64_t bits)noexcept{
+		return packed_quaternion(bits, from_bits_tag());
+	}
+
+	/**
+	 * @brief Get binary representation.
+	 * @return binary representation of the packed quaternion.
+	 */
+	constexpr uint64_t bits()const noexcept{
+		return this->v;
+	}
+
+	constexpr bool operator==(const packed_quaternion& p)const noexcept{
+		return this->v == p.v;
+	}
+
+	/**
+	 * @brief Unpack the quaternion.
+	 * @return unpacked unit quaternion.
+	 */
+	template <class T> quaternion<T> to()const noexcept{
+		using std::sqrt;
+		using std::max;
+
+		unsigned largest = unsigned(this->v >> index_shift);
+
+		quaternion<T> ret;
+		T sum = 0;
+		for(unsigned i = 0, shift = 2 * component_bits; i != 4; ++i){
+			if(i == largest){
+				continue;
+			}
+			T c = T((this->v >> shift) & component_mask);
+			ret[i] = (c / T(component_mask / 2) - T(1)) / T(range);
+			sum += ret[i] * ret[i];
+			shift -= component_bits;
+		}
+		ret[largest] = sqrt(max(T(1) - sum, T(0)));
+		return ret;
+	}
+
+	/**
+	 * @brief Pack array of unit quaternions.
+	 * @param src - quaternions to pack.
+	 * @param dst - output packed quaternions.
+	 * @param size - number of quaternions.
+	 */
+	template <class T> static void pack(const quaternion<T>* src, packed_quaternion* dst, size_t size)noexcept{
+		for(auto e = src + size; src != e; ++src, ++dst){
+			*dst = packed_quaternion(*src);
+		}
+	}
+
+	/**
+	 * @brief Unpack array of unit quaternions.
+	 * @param src - packed quaternions.
+	 * @param dst - output unpacked quaternions.
+	 * @param size - number of quaternions.
+	 */
+	template <class T> static void unpack(const packed_quaternion* src, quaternion<T>* dst, size_t size)noexcept{
+		for(auto e = src + size; src != e; ++src, ++dst){
+			*dst = src->to<T>();
+		}
+	}
+};
+
+static_assert(sizeof(packed_quaternion) == 8, "size mismatch");
+
+#ifdef R4_SIMD
+
+// SIMD specializations of batch packing of float vectors, 4 vectors at a time
+
+// NOTE: armv7 NEON has no exact division, so packing is not specialized there, to give the same bits as the scalar code
+#	if !defined(R4_SIMD_NEON) || defined(__aarch64__)
+template <> inline void packed_unit_vector3::pack<float>(const vector3<float>* src, packed_unit_vector3* dst, size_t size)noexcept{
+	const auto zero = simd::splat(0.0f);
+	const auto one = simd::splat(1.0f);
+	const auto minus_one = simd::splat(-1.0f);
+	const auto s = simd::splat(scale);
+
+	auto e = src + size;
+	for(; e - src >= 4; src += 4, dst += 4){
+		simd::float4 x, y, z;
+		simd::load3(reinterpret_cast<const float*>(src), x, y, z);
+
+		// NOTE: the arithmetic and rounding are the same as in the scalar constructor, so the results are bit-exact
+		auto sum = simd::add(simd::add(simd::abs(x), simd::abs(y)), simd::abs(z));
+		x = simd::div(x, sum);
+		y = simd::div(y, sum);
+
+		auto fx = simd::mul(simd::sub(one, simd::abs(y)), simd::select(simd::cmp_lt(x, zero), minus_one, one));
+		auto fy = simd::mul(simd::sub(one, simd::abs(x)), simd::select(simd::cmp_lt(y, zero), minus_one, one));
+		auto lower = simd::cmp_lt(z, zero);
+		x = simd::select(lower, fx, x);
+		y = simd::select(lower, fy, y);
+
+		int32_t xi[4];
+		int32_t yi[4];
+		simd::store_int(xi, simd::to_int4(simd::round(simd::mul(x, s))));
+		simd::store_int(yi, simd::to_int4(simd::round(simd::mul(y, s))));
+		for(unsigned k = 0; k != 4; ++k){
+			dst[k].v = pack_snorm16(xi[k], yi[k]);
+		}
+	}
+	for(; src != e; ++src, ++dst){
+		*dst = packed_unit_vector3(*src);
+	}
+}
+#	endif
+
+template <> inline void packed_unit_vector3::unpack<float>(const packed_unit_vector3* src, vector3<float>* dst, size_t size)noexcept{
+	const auto zero = simd::splat(0.0f);
+	const auto one = simd::splat(1.0f);
+	const auto minus_one = simd::splat(-1.0f);
+	const auto inv_scale = simd::splat(1.0f / scale);
+
+	auto e = src + size;
+	for(; e - src >= 4; src += 4, dst += 4){
+		auto b = simd::load_int(reinterpret_cast<const int32_t*>(src));
+
+		// sign-extend lower and upper 16 bits
+		auto x = simd::max(simd::mul(simd::to_float4(simd::shift_right<16>(simd::shift_left<16>(b))), inv_scale), minus_one);
+		auto y = simd::max(simd::mul(simd::to_float4(simd::shift_right<16>(b)), inv_scale), minus_one);
+		auto z = simd::sub(simd::sub(one, simd::abs(x)), simd::abs(y));
+
+		auto t = simd::max(simd::negate(z), zero);
+		x = simd::add(x, simd::select(simd::cmp_le(zero, x), simd::negate(t), t));
+		y = simd::add(y, simd::select(simd::cmp_le(zero, y), simd::negate(t), t));
+
+		auto inv_norm = simd::div(one, simd::sqrt(simd::mul_add(x, x, simd::mul_add(y, y, simd::mul(z, z)))));
+		simd::store3(reinterpret_cast<float*>(dst), simd::mul(x, inv_norm), simd::mul(y, inv_norm), simd::mul(z, inv_norm));
+	}
+	for(; src != e; ++src, ++dst){
+		*dst = src->to<float>();
+	}
+}
+
+#endif
+
+}
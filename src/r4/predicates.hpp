@@ -0,0 +1,614 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+
+namespace r4{
+
+/**
+ * @brief Robust geometric predicates.
+ * Adaptive precision orientation and in-circle tests after J. R. Shewchuk,
+ * "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+ * Each predicate first evaluates the determinant in plain double arithmetic together with a bound of its rounding error.
+ * Only when the error bound does not allow to tell the sign of the determinant, which happens just for nearly degenerate inputs,
+ * the determinant is evaluated exactly using floating-point expansion arithmetic.
+ * So, the sign of the returned value is always correct, while the predicates are almost as fast as plain evaluation.
+ * The magnitude of the returned value is an approximation of the determinant.
+ * The predicates require IEEE 754 double arithmetic with round-to-nearest-even rounding and no extended precision
+ * of intermediate results, e.g. x87 FPU is not supported.
+ */
+namespace predicates{
+
+// Expansion arithmetic.
+// A number is represented exactly as an expansion, a sum of doubles (components) which do not overlap
+// and are sorted by increasing magnitude.
+
+constexpr double epsilon = 1.1102230246251565e-16; // 2^-53
+
+// error bounds of the predicates, see the paper
+constexpr double result_error_bound = (3.0 + 8.0 * epsilon) * epsilon;
+constexpr double orient2d_error_bound_a = (3.0 + 16.0 * epsilon) * epsilon;
+constexpr double orient2d_error_bound_b = (2.0 + 12.0 * epsilon) * epsilon;
+constexpr double orient2d_error_bound_c = (9.0 + 64.0 * epsilon) * epsilon * epsilon;
+constexpr double orient3d_error_bound_a = (7.0 + 56.0 * epsilon) * epsilon;
+constexpr double incircle_error_bound_a = (10.0 + 96.0 * epsilon) * epsilon;
+
+/**
+ * @brief Exact sum of two doubles.
+ * @param a - first summand, its magnitude must not be less than the one of b.
+ * @param b - second summand.
+ * @param x - rounded sum.
+ * @param y - rounding error, so that a + b = x + y exactly.
+ */
+inline void fast_two_sum(double a, double b, double& x, double& y)noexcept{
+	x = a + b;
+	y = b - (x - a);
+}
+
+/**
+ * @brief Exact sum of two doubles.
+ * @param a - first summand.
+ * @param b - second summand.
+ * @param x - rounded sum.
+ * @param y - rounding error, so that a + b = x + y exactly.
+ */
+inline void two_sum(double a, double b, double& x, double& y)noexcept{
+	x = a + b;
+	double bv = x - a;
+	double av = x - bv;
+	y = (a - av) + (b - bv);
+}
+
+/**
+ * @brief Rounding error of difference of two doubles.
+ * @param a - minuend.
+ * @param b - subtrahend.
+ * @param x - rounded difference a - b.
+ * @return rounding error, so that a - b = x + error exactly.
+ */
+inline double two_diff_tail(double a, double b, double x)noexcept{
+	double bv = a - x;
+	double av = x + bv;
+	return (a - av) + (bv - b);
+}
+
+/**
+ * @brief Exact difference of two doubles.
+ * @param a - minuend.
+ * @param b - subtrahend.
+ * @param x - rounded difference.
+ * @param y - rounding error, so that a - b = x + y exactly.
+ */
+inline void two_diff(double a, double b, double& x, double& y)noexcept{
+	x = a - b;
+	y = two_diff_tail(a, b, x);
+}
+
+/**
+ * @brief Exact product of two doubles.
+ * @param a - first multiplier.
+ * @param b - second multiplier.
+ * @param x - rounded product.
+ * @param y - rounding error, so that a * b = x + y exactly.
+ */
+inline void two_product(double a, double b, double& x, double& y)noexcept{
+	x = a * b;
+	// NOTE: Dekker's splitting is not used since the compiler may contract it to FMA instructions
+	//       (e.g. with -ffp-contract=fast), which breaks its exactness, while std::fma() is exact in any case
+	y = std::fma(a, b, -x);
+}
+
+/**
+ * @brief Exact difference of two two-component expansions.
+ * Computes (a1 + a0) - (b1 + b0) = x3 + x2 + x1 + x0 exactly.
+ */
+inline void two_two_diff(double a1, double a0, double b1, double b0, double& x3, double& x2, double& x1, double& x0)noexcept{
+	double i, j, k;
+	two_diff(a0, b0, i, x0);
+	two_sum(a1, i, j, k);
+	two_diff(k, b1, i, x1);
+	two_sum(j, i, x3, x2);
+}
+
+/**
+ * @brief Sum of two expansions.
+ * Zero components are eliminated from the result.
+ * @param elen - number of components of the first expansion.
+ * @param e - components of the first expansion.
+ * @param flen - number of components of the second expansion.
+ * @param f - components of the second expansion.
+ * @param h - output expansion, must have space for elen + flen components, must not overlap with the inputs.
+ * @return number of components of the result.
+ */
+inline size_t expansion_sum(size_t elen, const double* e, size_t flen, const double* f, double* h)noexcept{
+	if(elen == 0 || flen == 0){
+		if(elen == 0){
+			e = f;
+			elen = flen;
+		}
+		for(size_t i = 0; i != elen; ++i){
+			h[i] = e[i];
+		}
+		return elen;
+	}
+
+	size_t ei = 0, fi = 0;
+	double enow = e[0];
+	double fnow = f[0];
+
+	// take components in order of increasing magnitude
+	auto next = [&](){
+		double ret;
+		if(fi == flen || (ei != elen && (fnow > enow) == (fnow > -enow))){
+			ret = enow;
+			if(++ei != elen){
+				enow = e[ei];
+			}
+		}else{
+			ret = fnow;
+			if(++fi != flen){
+				fnow = f[fi];
+			}
+		}
+		return ret;
+	};
+
+	size_t hi = 0;
+	double q = next();
+	double hh;
+	if(ei != elen && fi != flen){
+		// the next component is not smaller than the first one
+		fast_two_sum(next(), q, q, hh);
+	}else{
+		two_sum(q, next(), q, hh);
+	}
+	if(hh != 0){
+		h[hi++] = hh;
+	}
+	while(ei != elen || fi != flen){
+		two_sum(q, next(), q, hh);
+		if(hh != 0){
+			h[hi++] = hh;
+		}
+	}
+	if(q != 0 || hi == 0){
+		h[hi++] = q;
+	}
+	return hi;
+}
+
+/**
+ * @brief Product of expansion and double.
+ * Zero components are eliminated from the result.
+ * @param elen - number of components of the expansion.
+ * @param e - components of the expansion.
+ * @param b - double to multiply by.
+ * @param h - output expansion, must have space for 2 * elen components, must not overlap with the input.
+ * @return number of components of the result.
+ */
+inline size_t scale_expansion(size_t elen, const double* e, double b, double* h)noexcept{
+	if(elen == 0){
+		return 0;
+	}
+
+	size_t hi = 0;
+	double q, hh;
+	two_product(e[0], b, q, hh);
+	if(hh != 0){
+		h[hi++] = hh;
+	}
+	for(size_t i = 1; i != elen; ++i){
+		double p1, p0, sum;
+		two_product(e[i], b, p1, p0);
+		two_sum(q, p0, sum, hh);
+		if(hh != 0){
+			h[hi++] = hh;
+		}
+		fast_two_sum(p1, sum, q, hh);
+		if(hh != 0){
+			h[hi++] = hh;
+		}
+	}
+	if(q != 0 || hi == 0){
+		h[hi++] = q;
+	}
+	return hi;
+}
+
+/**
+ * @brief Expansion of fixed capacity.
+ * @param N - maximal number of components.
+ */
+template <size_t N> struct expansion{
+	double c[N];
+	size_t size = 0;
+
+	/**
+	 * @brief Get approximate value.
+	 * @return the most significant component, it has the sign of the expansion value.
+	 */
+	double approximation()const noexcept{
+		return this->size == 0 ? 0 : this->c[this->size - 1];
+	}
+};
+
+/**
+ * @brief Exact difference of two doubles as expansion.
+ */
+inline expansion<2> difference(double a, double b)noexcept{
+	expansion<2> ret;
+	two_diff(a, b, ret.c[1], ret.c[0]);
+	ret.size = 2;
+	return ret;
+}
+
+/**
+ * @brief Sum of two expansions.
+ */
+template <size_t N, size_t M> expansion<N + M> sum(const expansion<N>& e, const expansion<M>& f)noexcept{
+	expansion<N + M> ret;
+	ret.size = expansion_sum(e.size, e.c, f.size, f.c, ret.c);
+	return ret;
+}
+
+/**
+ * @brief Negated expansion.
+ */
+template <size_t N> expansion<N> negate(expansion<N> e)noexcept{
+	for(size_t i = 0; i != e.size; ++i){
+		e.c[i] = -e.c[i];
+	}
+	return e;
+}
+
+/**
+ * @brief Product of two expansions.
+ */
+template <size_t N, size_t M> expansion<2 * N * M> product(const expansion<N>& e, const expansion<M>& f)noexcept{
+	expansion<2 * N * M> ret;
+	if(f.size == 0){
+		return ret;
+	}
+	ret.size = scale_expansion(e.size, e.c, f.c[0], ret.c);
+	for(size_t i = 1; i != f.size; ++i){
+		double t[2 * N];
+		double s[2 * N * M];
+		size_t tlen = scale_expansion(e.size, e.c, f.c[i], t);
+		ret.size = expansion_sum(ret.size, ret.c, tlen, t, s);
+		for(size_t j = 0; j != ret.size; ++j){
+			ret.c[j] = s[j];
+		}
+	}
+	return ret;
+}
+
+// Predicates.
+
+/**
+ * @brief Orientation of three points in plane.
+ * @param a - first point.
+ * @param b - second point.
+ * @param c - third point.
+ * @return positive value if the points are in counterclockwise order.
+ * @return negative value if the points are in clockwise order.
+ * @return zero if the points are collinear.
+ * The returned value approximates twice the signed area of the triangle abc.
+ */
+inline double orient2d(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c)noexcept;
+
+/**
+ * @brief Orientation of four points in space.
+ * @param a - first point.
+ * @param b - second point.
+ * @param c - third point.
+ * @param d - fourth point.
+ * @return positive value if the point d lies below the plane passing through a, b and c,
+ *         where below is defined so that a, b and c appear in counterclockwise order when viewed from above the plane.
+ * @return negative value if the point d lies above the plane.
+ * @return zero if the points are coplanar.
+ * The returned value approximates six times the signed volume of the tetrahedron abcd.
+ */
+inline double orient3d(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>& d)noexcept;
+
+/**
+ * @brief Test point against circle.
+ * @param a - first point of the circle, the points a, b and c must be in counterclockwise order.
+ * @param b - second point of the circle.
+ * @param c - third point of the circle.
+ * @param d - point to test.
+ * @return positive value if the point d lies inside of the circle passing through a, b and c.
+ * @return negative value if the point d lies outside of the circle.
+ * @return zero if the four points are cocircular.
+ * The sign of the result is reversed if a, b and c are in clockwise order.
+ */
+inline double incircle(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>& d)noexcept;
+
+/**
+ * @brief Orientation of many points relative to a line.
+ * Same as calling orient2d(a, b, points[i]) for each point, but the filter stage is done for all the points
+ * in a single loop which the compiler can vectorize, and only the points for which the filter fails are evaluated exactly.
+ * @param a - first point of the line.
+ * @param b - second point of the line.
+ * @param points - points to test.
+ * @param size - number of points.
+ * @param dst - output array of size results, can be the same as points memory only if it does not overlap otherwise.
+ */
+inline void orient2d(const vector2<double>& a, const vector2<double>& b, const vector2<double>* points, size_t size, double* dst)noexcept;
+
+/**
+ * @brief Orientation of many points relative to a plane.
+ * Same as calling orient3d(a, b, c, points[i]) for each point, see the batch form of orient2d().
+ * @param a - first point of the plane.
+ * @param b - second point of the plane.
+ * @param c - third point of the plane.
+ * @param points - points to test.
+ * @param size - number of points.
+ * @param dst - output array of size results.
+ */
+inline void orient3d(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>* points, size_t size, double* dst)noexcept;
+
+/**
+ * @brief Test many points against circle.
+ * Same as calling incircle(a, b, c, points[i]) for each point, see the batch form of orient2d().
+ * @param a - first point of the circle.
+ * @param b - second point of the circle.
+ * @param c - third point of the circle.
+ * @param points - points to test.
+ * @param size - number of points.
+ * @param dst - output array of size results.
+ */
+inline void incircle(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>* points, size_t size, double* dst)noexcept;
+
+// exact and adaptive stages of the predicates, called when the filter fails
+inline double orient2d_adaptive(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, double detsum)noexcept;
+inline double orient3d_exact(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>& d)noexcept;
+inline double incircle_exact(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>& d)noexcept;
+
+inline double orient2d(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c)noexcept{
+	double detleft = (a.x() - c.x()) * (b.y() - c.y());
+	double detright = (a.y() - c.y()) * (b.x() - c.x());
+	double det = detleft - detright;
+
+	// when the products have different signs the sign of the determinant is certain
+	double detsum;
+	if(detleft > 0){
+		if(detright <= 0){
+			return det;
+		}
+		detsum = detleft + detright;
+	}else if(detleft < 0){
+		if(detright >= 0){
+			return det;
+		}
+		detsum = -detleft - detright;
+	}else{
+		return det;
+	}
+
+	double error_bound = orient2d_error_bound_a * detsum;
+	if(det >= error_bound || -det >= error_bound){
+		return det;
+	}
+	return orient2d_adaptive(a, b, c, detsum);
+}
+
+inline double orient2d_adaptive(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, double detsum)noexcept{
+	double acx = a.x() - c.x();
+	double bcx = b.x() - c.x();
+	double acy = a.y() - c.y();
+	double bcy = b.y() - c.y();
+
+	// evaluate the determinant of rounded differences exactly
+	double detleft, detlefttail, detright, detrighttail;
+	two_product(acx, bcy, detleft, detlefttail);
+	two_product(acy, bcx, detright, detrighttail);
+	double bb[4];
+	two_two_diff(detleft, detlefttail, detright, detrighttail, bb[3], bb[2], bb[1], bb[0]);
+
+	double det = bb[0] + bb[1] + bb[2] + bb[3];
+	double error_bound = orient2d_error_bound_b * detsum;
+	if(det >= error_bound || -det >= error_bound){
+		return det;
+	}
+
+	// account for rounding errors of the differences
+	double acxtail = two_diff_tail(a.x(), c.x(), acx);
+	double bcxtail = two_diff_tail(b.x(), c.x(), bcx);
+	double acytail = two_diff_tail(a.y(), c.y(), acy);
+	double bcytail = two_diff_tail(b.y(), c.y(), bcy);
+	if(acxtail == 0 && acytail == 0 && bcxtail == 0 && bcytail == 0){
+		return det;
+	}
+
+	using std::abs;
+	error_bound = orient2d_error_bound_c * detsum + result_error_bound * abs(det);
+	det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+	if(det >= error_bound || -det >= error_bound){
+		return det;
+	}
+
+	// evaluate exactly
+	double s1, s0, t1, t0, u[4];
+
+	two_product(acxtail, bcy, s1, s0);
+	two_product(acytail, bcx, t1, t0);
+	two_two_diff(s1, s0, t1, t0, u[3], u[2], u[1], u[0]);
+	double c1[8];
+	size_t c1len = expansion_sum(4, bb, 4, u, c1);
+
+	two_product(acx, bcytail, s1, s0);
+	two_product(acy, bcxtail, t1, t0);
+	two_two_diff(s1, s0, t1, t0, u[3], u[2], u[1], u[0]);
+	double c2[12];
+	size_t c2len = expansion_sum(c1len, c1, 4, u, c2);
+
+	two_product(acxtail, bcytail, s1, s0);
+	two_product(acytail, bcxtail, t1, t0);
+	two_two_diff(s1, s0, t1, t0, u[3], u[2], u[1], u[0]);
+	double d[16];
+	size_t dlen = expansion_sum(c2len, c2, 4, u, d);
+
+	return d[dlen - 1];
+}
+
+inline double orient3d(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>& d)noexcept{
+	double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+	double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+	double adz = a.z() - d.z(), bdz = b.z() - d.z(), cdz = c.z() - d.z();
+
+	double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	double cdxady = cdx * ady, adxcdy = adx * cdy;
+	double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+	double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+
+	using std::abs;
+	double permanent =
+			(abs(bdxcdy) + abs(cdxbdy)) * abs(adz) +
+			(abs(cdxady) + abs(adxcdy)) * abs(bdz) +
+			(abs(adxbdy) + abs(bdxady)) * abs(cdz);
+	double error_bound = orient3d_error_bound_a * permanent;
+	if(det > error_bound || -det > error_bound){
+		return det;
+	}
+	return orient3d_exact(a, b, c, d);
+}
+
+inline double orient3d_exact(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>& d)noexcept{
+	auto adx = difference(a.x(), d.x()), bdx = difference(b.x(), d.x()), cdx = difference(c.x(), d.x());
+	auto ady = difference(a.y(), d.y()), bdy = difference(b.y(), d.y()), cdy = difference(c.y(), d.y());
+	auto adz = difference(a.z(), d.z()), bdz = difference(b.z(), d.z()), cdz = difference(c.z(), d.z());
+
+	auto bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+	auto ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+	auto ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+	return sum(sum(product(bc, adz), product(ca, bdz)), product(ab, cdz)).approximation();
+}
+
+inline double incircle(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>& d)noexcept{
+	double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+	double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+
+	double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	double alift = adx * adx + ady * ady;
+
+	double cdxady = cdx * ady, adxcdy = adx * cdy;
+	double blift = bdx * bdx + bdy * bdy;
+
+	double adxbdy = adx * bdy, bdxady = bdx * ady;
+	double clift = cdx * cdx + cdy * cdy;
+
+	double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+	using std::abs;
+	double permanent =
+			(abs(bdxcdy) + abs(cdxbdy)) * alift +
+			(abs(cdxady) + abs(adxcdy)) * blift +
+			(abs(adxbdy) + abs(bdxady)) * clift;
+	double error_bound = incircle_error_bound_a * permanent;
+	if(det > error_bound || -det > error_bound){
+		return det;
+	}
+	return incircle_exact(a, b, c, d);
+}
+
+inline double incircle_exact(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>& d)noexcept{
+	auto adx = difference(a.x(), d.x()), bdx = difference(b.x(), d.x()), cdx = difference(c.x(), d.x());
+	auto ady = difference(a.y(), d.y()), bdy = difference(b.y(), d.y()), cdy = difference(c.y(), d.y());
+
+	auto alift = sum(product(adx, adx), product(ady, ady));
+	auto blift = sum(product(bdx, bdx), product(bdy, bdy));
+	auto clift = sum(product(cdx, cdx), product(cdy, cdy));
+
+	auto bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+	auto ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+	auto ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+	return sum(sum(product(alift, bc), product(blift, ca)), product(clift, ab)).approximation();
+}
+
+// The batch forms write the filtered determinant or 0 in case the filter fails, in a branchless loop,
+// then the zeros are evaluated with the single point predicate. Exact zeros are also re-evaluated,
+// but for them the single point predicate is fast.
+
+inline void orient2d(const vector2<double>& a, const vector2<double>& b, const vector2<double>* points, size_t size, double* dst)noexcept{
+	for(size_t i = 0; i != size; ++i){
+		double acx = a.x() - points[i].x(), bcx = b.x() - points[i].x();
+		double acy = a.y() - points[i].y(), bcy = b.y() - points[i].y();
+		double detleft = acx * bcy;
+		double detright = acy * bcx;
+		double det = detleft - detright;
+		using std::abs;
+		double error_bound = orient2d_error_bound_a * (abs(detleft) + abs(detright));
+		dst[i] = abs(det) > error_bound ? det : 0;
+	}
+	for(size_t i = 0; i != size; ++i){
+		if(dst[i] == 0){
+			dst[i] = orient2d(a, b, points[i]);
+		}
+	}
+}
+
+inline void orient3d(const vector3<double>& a, const vector3<double>& b, const vector3<double>& c, const vector3<double>* points, size_t size, double* dst)noexcept{
+	for(size_t i = 0; i != size; ++i){
+		const auto& d = points[i];
+		double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+		double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+		double adz = a.z() - d.z(), bdz = b.z() - d.z(), cdz = c.z() - d.z();
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+		double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+
+		using std::abs;
+		double permanent =
+				(abs(bdxcdy) + abs(cdxbdy)) * abs(adz) +
+				(abs(cdxady) + abs(adxcdy)) * abs(bdz) +
+				(abs(adxbdy) + abs(bdxady)) * abs(cdz);
+		dst[i] = abs(det) > orient3d_error_bound_a * permanent ? det : 0;
+	}
+	for(size_t i = 0; i != size; ++i){
+		if(dst[i] == 0){
+			dst[i] = orient3d(a, b, c, points[i]);
+		}
+	}
+}
+
+inline void incircle(const vector2<double>& a, const vector2<double>& b, const vector2<double>& c, const vector2<double>* points, size_t size, double* dst)noexcept{
+	for(size_t i = 0; i != size; ++i){
+		const auto& d = points[i];
+		double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+		double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double alift = adx * adx + ady * ady;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double blift = bdx * bdx + bdy * bdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+		double clift = cdx * cdx + cdy * cdy;
+
+		double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+		using std::abs;
+		double permanent =
+				(abs(bdxcdy) + abs(cdxbdy)) * alift +
+				(abs(cdxady) + abs(adxcdy)) * blift +
+				(abs(adxbdy) + abs(bdxady)) * clift;
+		dst[i] = abs(det) > incircle_error_bound_a * permanent ? det : 0;
+	}
+	for(size_t i = 0; i != size; ++i){
+		if(dst[i] == 0){
+			dst[i] = incircle(a, b, c, points[i]);
+		}
+	}
+}
+
+}
+
+}
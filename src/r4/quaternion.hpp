@@ -4,9 +4,12 @@
 #include <array>
 
 #include <cmath>
+#include <cstddef>
 
 #include <utki/debug.hpp>
 
+#include "config.hpp"
+
 namespace r4{
 
 template <class T> class vector3;
@@ -21,56 +24,56 @@ public:
 	/**
 	 * @brief x component.
 	 */
-	T& x()noexcept{
+	constexpr T& x()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief x component.
 	 */
-	const T& x()const noexcept{
+	constexpr const T& x()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief y component.
 	 */
-	T& y()noexcept{
+	constexpr T& y()noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief y component.
 	 */
-	const T& y()const noexcept{
+	constexpr const T& y()const noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief z component.
 	 */
-	T& z()noexcept{
+	constexpr T& z()noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief z component.
 	 */
-	const T& z()const noexcept{
+	constexpr const T& z()const noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief w component.
 	 */
-	T& w()noexcept{
+	constexpr T& w()noexcept{
 		return this->operator[](3);
 	}
 
 	/**
 	 * @brief w component.
 	 */
-	const T& w()const noexcept{
+	constexpr const T& w()const noexcept{
 		return this->operator[](3);
 	}
 
@@ -109,7 +112,7 @@ public:
 	 * component as argument of the target type constructor.
 	 * @return converted quaternion.
 	 */
-	template <typename TT> quaternion<TT> to()noexcept{
+	template <typename TT> constexpr quaternion<TT> to()noexcept{
 		return quaternion<TT>{
 				TT(this->x()),
 				TT(this->y()),
@@ -123,7 +126,7 @@ public:
 	 * Note, complex conjugate of quaternion (x, y, z, w) is (-x, -y, -z, w).
 	 * @return quaternion instance which is a complex conjugate of this quaternion.
 	 */
-	quaternion operator!()const noexcept{
+	constexpr quaternion operator!()const noexcept{
 		return quaternion(-this->x(), -this->y(), -this->z(), this->w());
 	}
 
@@ -133,7 +136,7 @@ public:
      * @param q - quaternion to add to this quaternion.
      * @return Reference to this quaternion object.
      */
-	quaternion& operator+=(const quaternion& q)noexcept{
+	constexpr quaternion& operator+=(const quaternion& q)noexcept{
 		this->x() += q.x();
 		this->y() += q.y();
 		this->z() += q.z();
@@ -147,7 +150,7 @@ public:
      * @param q - quaternion to add.
      * @return A quaternion object representing sum of quaternions.
      */
-	quaternion operator+(const quaternion& q)const noexcept{
+	constexpr quaternion operator+(const quaternion& q)const noexcept{
 		return (quaternion(*this) += q);
 	}
 
@@ -157,7 +160,7 @@ public:
 	 * @param s - scalar value to multiply by.
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& operator*=(T s)noexcept{
+	constexpr quaternion& operator*=(T s)noexcept{
 		this->x() *= s;
 		this->y() *= s;
 		this->z() *= s;
@@ -170,7 +173,7 @@ public:
 	 * @param s - scalar value to multiply by.
 	 * @return resulting quaternion instance.
 	 */
-	quaternion operator*(T s)const noexcept{
+	constexpr quaternion operator*(T s)const noexcept{
 		return (quaternion(*this) *= s);
 	}
 
@@ -180,7 +183,7 @@ public:
 	 * @param quat - quaternion to multiply by.
 	 * @return quaternion resulting from multiplication of given scalar by given quaternion.
 	 */
-	friend quaternion operator*(T num, const quaternion& quat)noexcept{
+	friend constexpr quaternion operator*(T num, const quaternion& quat)noexcept{
 		return quat * num;
 	}
 
@@ -190,7 +193,7 @@ public:
 	 * @param s - scalar value to divide by.
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& operator/=(T s)noexcept{
+	constexpr quaternion& operator/=(T s)noexcept{
 		this->x() /= s;
 		this->y() /= s;
 		this->z() /= s;
@@ -203,7 +206,7 @@ public:
 	 * @param s - scalar value to divide by.
 	 * @return resulting quaternion instance.
 	 */
-	quaternion operator/(T s)const noexcept{
+	constexpr quaternion operator/(T s)const noexcept{
 		return (quaternion(*this) /= s);
 	}
 
@@ -214,7 +217,7 @@ public:
 	 * x1 * x2 + y1 * y2 + z1 * z2 + w1 * w2
 	 * @return result of the dot product.
 	 */
-	T operator*(const quaternion& q)const noexcept{
+	constexpr T operator*(const quaternion& q)const noexcept{
 		return this->x() * q.x()
 				+ this->y() * q.y()
 				+ this->z() * q.z()
@@ -229,7 +232,7 @@ public:
 	 * @param q - quaternion to multiply by.
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& operator%=(const quaternion& q)noexcept{
+	constexpr quaternion& operator%=(const quaternion& q)noexcept{
 		T a = (this->w() + this->x()) * (q.w() + q.x());
 		T b = (this->z() - this->y()) * (q.y() - q.z());
 		T c = (this->x() - this->w()) * (q.y() + q.z());
@@ -253,7 +256,7 @@ public:
 	 * @param q - quaternion to multiply by.
 	 * @return resulting quaternion instance.
 	 */
-	quaternion operator%(const quaternion& q)const noexcept{
+	constexpr quaternion operator%(const quaternion& q)const noexcept{
 		return (quaternion(*this) %= q);
 	}
 
@@ -263,7 +266,7 @@ public:
 	 * It is a unit quaternion representing no rotation.
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& set_identity()noexcept{
+	constexpr quaternion& set_identity()noexcept{
 		this->x() = T(0);
 		this->y() = T(0);
 		this->z() = T(0);
@@ -276,7 +279,7 @@ public:
 	 * Note, complex conjugate of quaternion (x, y, z, w) is (-x, -y, -z, w).
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& conjugate()noexcept{
+	constexpr quaternion& conjugate()noexcept{
 		return (*this = this->operator!());
 	}
 
@@ -285,7 +288,7 @@ public:
 	 * Note, negating quaternion means changing the sign of its every component.
 	 * @return reference to this quaternion instance.
 	 */
-	quaternion& negate()noexcept{
+	constexpr quaternion& negate()noexcept{
 		this->x() = -this->x();
 		this->y() = -this->y();
 		this->z() = -this->z();
@@ -297,7 +300,7 @@ public:
 	 * @brief Calculate power 2 of quaternion norm.
 	 * @return power 2 of norm.
 	 */
-	T norm_pow2()const noexcept{
+	constexpr T norm_pow2()const noexcept{
 		return (*this) * (*this);
 	}
 
@@ -368,7 +371,28 @@ public:
 	 * to a rotation matrix.
      * @return Rotation matrix.
      */
-	matrix4<T> to_matrix4()const noexcept;
+	constexpr matrix4<T> to_matrix4()const noexcept;
+
+	/**
+	 * @brief Rotate array of vectors.
+	 * Assuming that this quaternion is a unit quaternion, rotates each vector of the array by it.
+	 * The result is the same as calling vector3::rotate() for each vector, but is faster than that.
+	 * @param src - pointer to the first vector to rotate.
+	 * @param dst - pointer to the first vector to store the rotated vectors to, can be the same as src,
+	 *              but otherwise the ranges must not overlap.
+	 * @param size - number of vectors.
+	 */
+	void rotate_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept;
+
+	/**
+	 * @brief Rotate array of vectors in place.
+	 * Same as rotate_points(points, points, size).
+	 * @param points - pointer to the first vector to rotate.
+	 * @param size - number of vectors.
+	 */
+	void rotate_points(vector3<T>* points, size_t size)const noexcept{
+		this->rotate_points(points, points, size);
+	}
 
 	/**
 	 * @brief Spherical linear interpolation.
@@ -410,8 +434,8 @@ public:
 		// to make SLERP. If alpha is small then we do a simple linear
 		// interpolation between quaternions instead of SLERP!
 		// It is also used to avoid divide by zero since sin(0) is 0.
-		// We made threshold for cos(alpha) > 0.9f (if cos(alpha) == 1 then alpha is 0).
-		if(cosalpha > T(0.9f)){
+		// We made threshold for cos(alpha) < 0.9995f (if cos(alpha) == 1 then alpha is 0).
+		if(cosalpha < T(0.9995f)){
 			using std::acos;
 			using std::sin;
 
@@ -431,6 +455,56 @@ public:
 		return (*this) * sc1 + quat * (sc2 * sign);
 	}
 
+	/**
+	 * @brief Normalized linear interpolation.
+	 * Calculates linear interpolation between two quaternions and normalizes the result.
+	 * The first quaternion is this one and the second is passed as argument.
+	 * Same as slerp() the interpolation goes along the shortest path, i.e. the second
+	 * quaternion is negated if the angle between quaternions is greater than 90 degrees.
+	 * The result follows the same path as SLERP, but not at a constant angular velocity.
+	 * It is much cheaper than SLERP and is good enough when quaternions are close to each other.
+	 * @param quat - quaternion to interpolate to.
+	 * @param t - interpolation parameter, value from [0 : 1].
+	 * @return Resulting quaternion of NLERP(this, quat, t).
+	 */
+	quaternion nlerp(const quaternion& quat, T t)const noexcept{
+		T sign = (*this) * quat < T(0) ? T(-1) : T(1);
+		return ((*this) * (1 - t) + quat * (t * sign)).normalize();
+	}
+
+	/**
+	 * @brief Spherical linear interpolation of arrays of quaternions.
+	 * For each i calculates from[i].slerp(to[i], t[i]) and stores it to dst[i].
+	 * Instead of calling trigonometric functions the interpolation scales are calculated
+	 * with a polynomial approximation (D. Eberly, A Fast and Accurate Algorithm for Computing SLERP),
+	 * absolute error of the scales does not exceed 7.3e-7 for t from [0 : 1].
+	 * Note, that the error does not depend on T, so for double the result is less precise than the one of slerp().
+	 * Quaternions are assumed to be unit quaternions.
+	 * @param from - quaternions to interpolate from.
+	 * @param to - quaternions to interpolate to.
+	 * @param t - interpolation parameters, values from [0 : 1].
+	 * @param dst - array to store the interpolated quaternions to, can be the same as from or to,
+	 *              but otherwise must not overlap with them.
+	 * @param size - number of quaternions in each of the arrays.
+	 */
+	static void slerp(const quaternion* from, const quaternion* to, const T* t, quaternion* dst, size_t size)noexcept;
+
+	/**
+	 * @brief Normalized linear interpolation of arrays of quaternions.
+	 * For each i calculates from[i].nlerp(to[i], t[i]) and stores it to dst[i].
+	 * @param from - quaternions to interpolate from.
+	 * @param to - quaternions to interpolate to.
+	 * @param t - interpolation parameters, values from [0 : 1].
+	 * @param dst - array to store the interpolated quaternions to, can be the same as from or to,
+	 *              but otherwise must not overlap with them.
+	 * @param size - number of quaternions in each of the arrays.
+	 */
+	static void nlerp(const quaternion* from, const quaternion* to, const T* t, quaternion* dst, size_t size)noexcept{
+		for(const quaternion* end = from + size; from != end; ++from, ++to, ++t, ++dst){
+			*dst = from->nlerp(*to, *t);
+		}
+	}
+
 	friend std::ostream& operator<<(std::ostream& s, const quaternion<T>& quat){
 		s << "(" << quat.x() << ", " << quat.y() << ", " << quat.z() << ", " << quat.w() << ")";
 		return s;
@@ -441,6 +515,7 @@ public:
 
 #include "vector3.hpp"
 #include "matrix4.hpp"
+#include "simd.hpp"
 
 namespace r4{
 
@@ -462,10 +537,93 @@ template <class T> quaternion<T>& quaternion<T>::set_rotation(const vector3<T>&
 	return this->set_rotation(axis.x(), axis.y(), axis.z(), angle);
 }
 
-template <class T> matrix4<T> quaternion<T>::to_matrix4()const noexcept{
+template <class T> constexpr matrix4<T> quaternion<T>::to_matrix4()const noexcept{
 	return matrix4<T>(*this);
 }
 
+template <class T> void quaternion<T>::rotate_points(const vector3<T>* src, vector3<T>* dst, size_t size)const noexcept{
+	vector3<T> u(this->x(), this->y(), this->z());
+	T w = this->w();
+	for(const vector3<T>* end = src + size; src != end; ++src, ++dst){
+		// see vector3::rotate()
+		vector3<T> t = (u % (*src)) * T(2);
+		*dst = *src + t * w + u % t;
+	}
+}
+
+template <class T> void quaternion<T>::slerp(const quaternion* from, const quaternion* to, const T* t, quaternion* dst, size_t size)noexcept{
+	// SLERP scale sin(t * alpha) / sin(alpha) is expanded to series of (cos(alpha) - 1) as
+	// t * (1 + b[0] * (1 + b[1] * (1 + ... ))), b[i] = (u[i] * t^2 - v[i]) * (cos(alpha) - 1),
+	// where u[i] = 1 / (i * (2 * i + 1)), v[i] = i / (2 * i + 1), i = 1, 2, ...
+	// The series is truncated to 12 terms and the last term is multiplied by mu = 1.894, which
+	// minimizes maximal error of the truncated series for cos(alpha) from [0 : 1].
+	const unsigned num_terms = 12;
+	const T mu = T(1.894);
+	T u[num_terms];
+	T v[num_terms];
+	for(unsigned i = 1; i <= num_terms; ++i){
+		u[i - 1] = T(1) / T(i * (2 * i + 1));
+		v[i - 1] = T(i) / T(2 * i + 1);
+	}
+	u[num_terms - 1] *= mu;
+	v[num_terms - 1] *= mu;
+
+	for(const quaternion* end = from + size; from != end; ++from, ++to, ++t, ++dst){
+		T cosalpha = (*from) * (*to);
+
+		// shortest path, see slerp(quat, t)
+		T sign = 1;
+		if(cosalpha < T(0)){
+			sign = -1;
+			cosalpha = -cosalpha;
+		}
+
+		T xm1 = cosalpha - 1;
+		T d = 1 - *t;
+		T t2 = *t * *t;
+		T d2 = d * d;
+
+		T sc1 = 1;
+		T sc2 = 1;
+		for(unsigned i = num_terms; i != 0; --i){
+			sc1 = 1 + (u[i - 1] * d2 - v[i - 1]) * xm1 * sc1;
+			sc2 = 1 + (u[i - 1] * t2 - v[i - 1]) * xm1 * sc2;
+		}
+		sc1 *= d;
+		sc2 *= *t * sign;
+
+		*dst = (*from) * sc1 + (*to) * sc2;
+	}
+}
+
+#ifdef R4_SIMD
+
+template <> inline void quaternion<float>::slerp(const quaternion* from, const quaternion* to, const float* t, quaternion* dst, size_t size)noexcept{
+	simd::interpolate<false>(
+			reinterpret_cast<const float*>(from),
+			reinterpret_cast<const float*>(to),
+			t,
+			reinterpret_cast<float*>(dst),
+			size
+		);
+}
+
+template <> inline void quaternion<float>::nlerp(const quaternion* from, const quaternion* to, const float* t, quaternion* dst, size_t size)noexcept{
+	simd::interpolate<true>(
+			reinterpret_cast<const float*>(from),
+			reinterpret_cast<const float*>(to),
+			t,
+			reinterpret_cast<float*>(dst),
+			size
+		);
+}
+
+template <> inline void quaternion<float>::rotate_points(const vector3<float>* src, vector3<float>* dst, size_t size)const noexcept{
+	simd::rotate_points(this->data(), reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), size);
+}
+
+#endif // ~R4_SIMD
+
 static_assert(sizeof(quaternion<float>) == sizeof(float) * 4, "size mismatch");
 static_assert(sizeof(quaternion<double>) == sizeof(double) * 4, "size mismatch");
 
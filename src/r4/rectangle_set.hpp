@@ -0,0 +1,580 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <utki/debug.hpp>
+
+#include "rectangle.hpp"
+#include "aligned_allocator.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Array of rectangles in structure-of-arrays layout.
+ * The x, y, width and height of the rectangles are stored in four separate arrays (lanes).
+ * Each lane is aligned and padded to a multiple of the widest SIMD register size,
+ * so that operations on all rectangles, like clipping many glyph or widget rectangles by a scissor rectangle,
+ * are done with aligned SIMD loads and stores.
+ * The operations mirror the ones of rectangle. Padding elements of the lanes are kept as empty rectangles.
+ */
+template <class T> class rectangle_set{
+public:
+	/**
+	 * @brief Alignment of lanes in bytes.
+	 */
+	static constexpr size_t alignment = 32;
+
+	/**
+	 * @brief Type of aligned array of scalars.
+	 */
+	typedef std::vector<T, aligned_allocator<T, alignment>> lane_type;
+
+private:
+	static_assert(alignment % sizeof(T) == 0, "element type size must be divisor of lanes alignment");
+
+	// lane sizes are padded to a multiple of this number of elements
+	static constexpr size_t lane_granularity = alignment / sizeof(T);
+
+	static size_t pad(size_t size)noexcept{
+		return (size + lane_granularity - 1) / lane_granularity * lane_granularity;
+	}
+
+	// all four lanes are stored one after another in a single buffer
+	lane_type buffer;
+
+	size_t num = 0;
+
+	// padded lane size, can be bigger than needed for num rectangles after compact()
+	size_t stride = 0;
+
+	// clear padding elements after the last rectangle
+	void clear_padding()noexcept{
+		for(unsigned l = 0; l != 4; ++l){
+			std::fill(this->lane(l) + this->size(), this->lane(l) + this->stride, T(0));
+		}
+	}
+public:
+	/**
+	 * @brief Construct empty array.
+	 */
+	rectangle_set() = default;
+
+	/**
+	 * @brief Construct array of given size.
+	 * All rectangles are initialized to (0, 0, 0, 0).
+	 * @param size - number of rectangles in the array.
+	 */
+	explicit rectangle_set(size_t size) :
+			buffer(pad(size) * 4),
+			num(size),
+			stride(pad(size))
+	{}
+
+	/**
+	 * @brief Construct array from array of rectangles.
+	 * Gathers the components of the given rectangles to the lanes.
+	 * @param src - pointer to the first rectangle.
+	 * @param size - number of rectangles.
+	 */
+	rectangle_set(const rectangle<T>* src, size_t size) :
+			rectangle_set(size)
+	{
+		this->gather(src, size);
+	}
+
+	rectangle_set(const rectangle_set&) = default;
+	rectangle_set& operator=(const rectangle_set&) = default;
+
+	rectangle_set(rectangle_set&& s)noexcept :
+			buffer(std::move(s.buffer)),
+			num(s.num),
+			stride(s.stride)
+	{
+		s.num = 0;
+		s.stride = 0;
+	}
+
+	rectangle_set& operator=(rectangle_set&& s)noexcept{
+		this->buffer = std::move(s.buffer);
+		this->num = s.num;
+		this->stride = s.stride;
+		s.num = 0;
+		s.stride = 0;
+		return *this;
+	}
+
+	/**
+	 * @brief Get number of rectangles in the array.
+	 * @return number of rectangles.
+	 */
+	size_t size()const noexcept{
+		return this->num;
+	}
+
+	/**
+	 * @brief Change number of rectangles in the array.
+	 * Rectangles which fit into the new size preserve their values, new rectangles are initialized to (0, 0, 0, 0).
+	 * @param size - new number of rectangles.
+	 */
+	void resize(size_t size){
+		rectangle_set s(size);
+		size_t n = std::min(size, this->size());
+		for(unsigned l = 0; l != 4; ++l){
+			std::copy(this->lane(l), this->lane(l) + n, s.lane(l));
+		}
+		this->operator=(std::move(s));
+	}
+
+	/**
+	 * @brief Get lane.
+	 * @param index - index of the lane, 0 for x, 1 for y, 2 for width and 3 for height.
+	 * @return pointer to the first element of the lane, the pointer is aligned to 'alignment' boundary.
+	 */
+	T* lane(unsigned index)noexcept{
+		ASSERT(index < 4)
+		return this->buffer.data() + index * this->stride;
+	}
+
+	/**
+	 * @brief Get lane.
+	 * @param index - index of the lane, 0 for x, 1 for y, 2 for width and 3 for height.
+	 * @return pointer to the first element of the lane, the pointer is aligned to 'alignment' boundary.
+	 */
+	const T* lane(unsigned index)const noexcept{
+		ASSERT(index < 4)
+		return this->buffer.data() + index * this->stride;
+	}
+
+	/**
+	 * @brief Lane of x coordinates of rectangle origins.
+	 */
+	T* x()noexcept{
+		return this->lane(0);
+	}
+
+	/**
+	 * @brief Lane of x coordinates of rectangle origins.
+	 */
+	const T* x()const noexcept{
+		return this->lane(0);
+	}
+
+	/**
+	 * @brief Lane of y coordinates of rectangle origins.
+	 */
+	T* y()noexcept{
+		return this->lane(1);
+	}
+
+	/**
+	 * @brief Lane of y coordinates of rectangle origins.
+	 */
+	const T* y()const noexcept{
+		return this->lane(1);
+	}
+
+	/**
+	 * @brief Lane of rectangle widths.
+	 */
+	T* w()noexcept{
+		return this->lane(2);
+	}
+
+	/**
+	 * @brief Lane of rectangle widths.
+	 */
+	const T* w()const noexcept{
+		return this->lane(2);
+	}
+
+	/**
+	 * @brief Lane of rectangle heights.
+	 */
+	T* h()noexcept{
+		return this->lane(3);
+	}
+
+	/**
+	 * @brief Lane of rectangle heights.
+	 */
+	const T* h()const noexcept{
+		return this->lane(3);
+	}
+
+	/**
+	 * @brief Get rectangle.
+	 * @param i - index of the rectangle.
+	 * @return rectangle composed of the i-th elements of the lanes.
+	 */
+	rectangle<T> operator[](size_t i)const noexcept{
+		ASSERT(i < this->size())
+		return rectangle<T>(this->x()[i], this->y()[i], this->w()[i], this->h()[i]);
+	}
+
+	/**
+	 * @brief Set rectangle.
+	 * @param i - index of the rectangle.
+	 * @param r - value to set the rectangle to.
+	 * @return reference to this array.
+	 */
+	rectangle_set& set(size_t i, const rectangle<T>& r)noexcept{
+		ASSERT(i < this->size())
+		this->x()[i] = r.p.x();
+		this->y()[i] = r.p.y();
+		this->w()[i] = r.d.x();
+		this->h()[i] = r.d.y();
+		return *this;
+	}
+
+	/**
+	 * @brief Load rectangles from array of rectangles.
+	 * Resizes this array to the given size and gathers the components of the given rectangles to the lanes.
+	 * @param src - pointer to the first rectangle.
+	 * @param size - number of rectangles.
+	 * @return reference to this array.
+	 */
+	rectangle_set& gather(const rectangle<T>* src, size_t size);
+
+	/**
+	 * @brief Store rectangles to array of rectangles.
+	 * Scatters the lanes to the array of rectangles.
+	 * @param dst - pointer to the array of size() rectangles to store the rectangles to.
+	 */
+	void scatter(rectangle<T>* dst)const noexcept;
+
+	/**
+	 * @brief Intersect all rectangles with given rectangle.
+	 * Same as calling rectangle::intersect() for each rectangle of the array.
+	 * Rectangles which do not intersect the given one get zero width or height.
+	 * @param rect - rectangle to intersect the rectangles with, e.g. a clipping rectangle.
+	 * @return reference to this array.
+	 */
+	rectangle_set& intersect(const rectangle<T>& rect)noexcept;
+
+	/**
+	 * @brief Get union of all rectangles.
+	 * Same as uniting the first rectangle of the array with all the other ones using rectangle::unite().
+	 * @return smallest rectangle containing all the rectangles of the array.
+	 * @return rectangle (0, 0, 0, 0) if the array is empty.
+	 */
+	rectangle<T> unite()const noexcept;
+
+	/**
+	 * @brief Test if rectangles overlap given point.
+	 * Tests all the rectangles with rectangle::overlaps() and writes the results as a bit mask.
+	 * Bit (i % 32) of hits[i / 32] is set if i'th rectangle overlaps the point and cleared otherwise.
+	 * @param point - point to test, e.g. a mouse pointer position.
+	 * @param hits - output bit mask, must have space for at least (size() + 31) / 32 words.
+	 */
+	void overlaps(const vector2<T>& point, uint32_t* hits)const noexcept;
+
+	/**
+	 * @brief Remove empty rectangles.
+	 * Removes rectangles with zero or negative width or height, e.g. the ones clipped away by intersect().
+	 * The order of the remaining rectangles is preserved. The lanes are not reallocated.
+	 * @param indices - output array of original indices of the remaining rectangles in increasing order,
+	 *                  must have space for at least size() indices. Can be nullptr if indices are not needed.
+	 * @return number of remaining rectangles, i.e. new size of the array.
+	 */
+	size_t compact(uint32_t* indices = nullptr)noexcept;
+};
+
+template <class T> rectangle_set<T>& rectangle_set<T>::gather(const rectangle<T>* src, size_t size){
+	if(this->size() != size){
+		this->operator=(rectangle_set(size));
+	}
+	T* px = this->x();
+	T* py = this->y();
+	T* pw = this->w();
+	T* ph = this->h();
+	for(size_t i = 0; i != size; ++i, ++src){
+		px[i] = src->p.x();
+		py[i] = src->p.y();
+		pw[i] = src->d.x();
+		ph[i] = src->d.y();
+	}
+	return *this;
+}
+
+template <class T> void rectangle_set<T>::scatter(rectangle<T>* dst)const noexcept{
+	const T* px = this->x();
+	const T* py = this->y();
+	const T* pw = this->w();
+	const T* ph = this->h();
+	for(size_t i = 0; i != this->size(); ++i, ++dst){
+		dst->p.x() = px[i];
+		dst->p.y() = py[i];
+		dst->d.x() = pw[i];
+		dst->d.y() = ph[i];
+	}
+}
+
+template <class T> rectangle_set<T>& rectangle_set<T>::intersect(const rectangle<T>& rect)noexcept{
+	T* px = this->x();
+	T* py = this->y();
+	T* pw = this->w();
+	T* ph = this->h();
+	for(size_t i = 0; i != this->size(); ++i){
+		rectangle<T> r(px[i], py[i], pw[i], ph[i]);
+		r.intersect(rect);
+		px[i] = r.p.x();
+		py[i] = r.p.y();
+		pw[i] = r.d.x();
+		ph[i] = r.d.y();
+	}
+	return *this;
+}
+
+template <class T> rectangle<T> rectangle_set<T>::unite()const noexcept{
+	if(this->size() == 0){
+		return rectangle<T>(0, 0, 0, 0);
+	}
+	rectangle<T> ret = this->operator[](0);
+	for(size_t i = 1; i != this->size(); ++i){
+		ret.unite(this->operator[](i));
+	}
+	return ret;
+}
+
+template <class T> void rectangle_set<T>::overlaps(const vector2<T>& point, uint32_t* hits)const noexcept{
+	std::fill(hits, hits + (this->size() + 31) / 32, 0);
+	for(size_t i = 0; i != this->size(); ++i){
+		if(this->operator[](i).overlaps(point)){
+			hits[i / 32] |= uint32_t(1) << (i % 32);
+		}
+	}
+}
+
+template <class T> size_t rectangle_set<T>::compact(uint32_t* indices)noexcept{
+	ASSERT(this->size() <= size_t(~uint32_t(0)))
+	T* px = this->x();
+	T* py = this->y();
+	T* pw = this->w();
+	T* ph = this->h();
+	size_t n = 0;
+	for(size_t i = 0; i != this->size(); ++i){
+		if(!(pw[i] > 0 && ph[i] > 0)){
+			continue;
+		}
+		px[n] = px[i];
+		py[n] = py[i];
+		pw[n] = pw[i];
+		ph[n] = ph[i];
+		if(indices){
+			indices[n] = uint32_t(i);
+		}
+		++n;
+	}
+	this->num = n;
+	this->clear_padding();
+	return n;
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of rectangle_set<float> operations
+
+template <> inline rectangle_set<float>& rectangle_set<float>::gather(const rectangle<float>* src, size_t size){
+	if(this->size() != size){
+		this->operator=(rectangle_set(size));
+	}
+	float* px = this->x();
+	float* py = this->y();
+	float* pw = this->w();
+	float* ph = this->h();
+	auto s = reinterpret_cast<const float*>(src);
+
+	// transpose blocks of 4 rectangles
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4, s += 4 * 4){
+		auto x = simd::load(s);
+		auto y = simd::load(s + 4);
+		auto w = simd::load(s + 8);
+		auto h = simd::load(s + 12);
+		simd::transpose(x, y, w, h);
+		simd::store(px + i, x);
+		simd::store(py + i, y);
+		simd::store(pw + i, w);
+		simd::store(ph + i, h);
+	}
+	for(; i != size; ++i, s += 4){
+		px[i] = s[0];
+		py[i] = s[1];
+		pw[i] = s[2];
+		ph[i] = s[3];
+	}
+	return *this;
+}
+
+template <> inline void rectangle_set<float>::scatter(rectangle<float>* dst)const noexcept{
+	const float* px = this->x();
+	const float* py = this->y();
+	const float* pw = this->w();
+	const float* ph = this->h();
+	auto d = reinterpret_cast<float*>(dst);
+
+	// transpose blocks of 4 rectangles
+	size_t i = 0;
+	for(; i + 4 <= this->size(); i += 4, d += 4 * 4){
+		auto x = simd::load(px + i);
+		auto y = simd::load(py + i);
+		auto w = simd::load(pw + i);
+		auto h = simd::load(ph + i);
+		simd::transpose(x, y, w, h);
+		simd::store(d, x);
+		simd::store(d + 4, y);
+		simd::store(d + 8, w);
+		simd::store(d + 12, h);
+	}
+	for(; i != this->size(); ++i, d += 4){
+		d[0] = px[i];
+		d[1] = py[i];
+		d[2] = pw[i];
+		d[3] = ph[i];
+	}
+}
+
+template <> inline rectangle_set<float>& rectangle_set<float>::intersect(const rectangle<float>& rect)noexcept{
+	float *px = this->x(), *py = this->y(), *pw = this->w(), *ph = this->h();
+	auto rx1 = simd::splatv(rect.p.x());
+	auto ry1 = simd::splatv(rect.p.y());
+	auto rx2 = simd::splatv(rect.x2());
+	auto ry2 = simd::splatv(rect.y2());
+
+	// padding elements are empty rectangles, they remain empty after intersection
+	for(size_t i = 0; i != this->stride; i += simd::floatv_size){
+		auto x = simd::loadv(px + i), y = simd::loadv(py + i);
+
+		// NOTE: operands order is swapped to match std::min() and std::max() semantics when comparing NaNs
+		auto x2 = simd::min(rx2, simd::add(x, simd::loadv(pw + i)));
+		auto y2 = simd::min(ry2, simd::add(y, simd::loadv(ph + i)));
+		x = simd::max(rx1, x);
+		y = simd::max(ry1, y);
+
+		simd::storev(px + i, x);
+		simd::storev(py + i, y);
+		simd::storev(pw + i, simd::sub(x2, simd::min(x2, x)));
+		simd::storev(ph + i, simd::sub(y2, simd::min(y2, y)));
+	}
+	return *this;
+}
+
+template <> inline rectangle<float> rectangle_set<float>::unite()const noexcept{
+	// padding elements must not take part in the union, so only whole blocks are processed with SIMD
+	size_t blocks_end = this->size() / simd::floatv_size * simd::floatv_size;
+	if(blocks_end == 0){
+		rectangle<float> ret = this->size() == 0 ? rectangle<float>(0, 0, 0, 0) : this->operator[](0);
+		for(size_t i = 1; i < this->size(); ++i){
+			ret.unite(this->operator[](i));
+		}
+		return ret;
+	}
+
+	const float *px = this->x(), *py = this->y(), *pw = this->w(), *ph = this->h();
+	auto x1 = simd::loadv(px), y1 = simd::loadv(py);
+	auto x2 = simd::add(x1, simd::loadv(pw)), y2 = simd::add(y1, simd::loadv(ph));
+	for(size_t i = simd::floatv_size; i != blocks_end; i += simd::floatv_size){
+		auto x = simd::loadv(px + i), y = simd::loadv(py + i);
+		x1 = simd::min(x, x1);
+		y1 = simd::min(y, y1);
+		x2 = simd::max(simd::add(x, simd::loadv(pw + i)), x2);
+		y2 = simd::max(simd::add(y, simd::loadv(ph + i)), y2);
+	}
+
+	alignas(alignment) float mx1[simd::floatv_size], my1[simd::floatv_size], mx2[simd::floatv_size], my2[simd::floatv_size];
+	simd::storev(mx1, x1);
+	simd::storev(my1, y1);
+	simd::storev(mx2, x2);
+	simd::storev(my2, y2);
+	vector2<float> p1(mx1[0], my1[0]), p2(mx2[0], my2[0]);
+	for(size_t j = 1; j != simd::floatv_size; ++j){
+		using std::min;
+		using std::max;
+		p1 = min(p1, vector2<float>(mx1[j], my1[j]));
+		p2 = max(p2, vector2<float>(mx2[j], my2[j]));
+	}
+	for(size_t i = blocks_end; i != this->size(); ++i){
+		using std::min;
+		using std::max;
+		p1 = min(p1, vector2<float>(px[i], py[i]));
+		p2 = max(p2, vector2<float>(px[i] + pw[i], py[i] + ph[i]));
+	}
+	return rectangle<float>(p1, p2 - p1);
+}
+
+template <> inline void rectangle_set<float>::overlaps(const vector2<float>& point, uint32_t* hits)const noexcept{
+	const float *px = this->x(), *py = this->y(), *pw = this->w(), *ph = this->h();
+	auto x = simd::splatv(point.x());
+	auto y = simd::splatv(point.y());
+
+	// SIMD register size is a divisor of 32, so whole blocks fit into the bit mask words,
+	// padding elements are empty rectangles and do not overlap any point
+	for(size_t w = 0; w != (this->size() + 31) / 32; ++w){
+		uint32_t bits = 0;
+		for(size_t i = w * 32; i != std::min((w + 1) * 32, this->stride); i += simd::floatv_size){
+			auto x1 = simd::loadv(px + i), y1 = simd::loadv(py + i);
+			auto m = simd::and_mask(
+					simd::and_mask(simd::cmp_le(x1, x), simd::cmp_le(y1, y)),
+					simd::and_mask(simd::cmp_lt(x, simd::add(x1, simd::loadv(pw + i))), simd::cmp_lt(y, simd::add(y1, simd::loadv(ph + i))))
+				);
+			bits |= uint32_t(simd::mask_bits(m)) << (i % 32);
+		}
+		hits[w] = bits;
+	}
+}
+
+template <> inline size_t rectangle_set<float>::compact(uint32_t* indices)noexcept{
+	ASSERT(this->size() <= size_t(~uint32_t(0)))
+	float *px = this->x(), *py = this->y(), *pw = this->w(), *ph = this->h();
+	auto zero = simd::splatv(0);
+	size_t n = 0;
+	for(size_t i = 0; i < this->size(); i += simd::floatv_size){
+		unsigned mask = simd::mask_bits(simd::and_mask(
+				simd::cmp_lt(zero, simd::loadv(pw + i)),
+				simd::cmp_lt(zero, simd::loadv(ph + i))
+			));
+
+		// padding elements are empty, so they are never kept
+		if(n == i && mask == (1u << simd::floatv_size) - 1){
+			// nothing removed so far and the whole block is kept, no need to move the rectangles
+			if(indices){
+				for(size_t j = i; j != i + simd::floatv_size; ++j){
+					indices[j] = uint32_t(j);
+				}
+			}
+			n += simd::floatv_size;
+			continue;
+		}
+
+		// branchless compaction, rectangle is always written but the output position is advanced only for kept ones
+		for(size_t j = i; mask != 0; ++j, mask >>= 1){
+			px[n] = px[j];
+			py[n] = py[j];
+			pw[n] = pw[j];
+			ph[n] = ph[j];
+			if(indices){
+				indices[n] = uint32_t(j);
+			}
+			n += mask & 1;
+		}
+	}
+	this->num = n;
+	this->clear_padding();
+	return n;
+}
+
+#endif // ~R4_SIMD
+
+}
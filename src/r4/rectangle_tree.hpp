@@ -0,0 +1,768 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "rectangle.hpp"
+#include "aligned_allocator.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Bounding volume hierarchy of 2d rectangles.
+ * R-tree which indexes many rectangles for fast point, overlap and nearest neighbour queries.
+ * Each stored rectangle is identified by an integer id which is assigned when the rectangle is added to the tree.
+ * Ids of removed rectangles are reused by subsequent insertions.
+ * Nodes are stored in a flat array, each node has up to node_width children. Bounds of the children are
+ * stored in the node in structure-of-arrays layout, so that all children of a node are tested at once.
+ * The rectangles are assumed to have non-negative dimensions.
+ */
+template <class T> class rectangle_tree{
+public:
+	/**
+	 * @brief Maximal number of children of a tree node.
+	 */
+	static constexpr unsigned node_width = 4;
+
+private:
+	typedef uint32_t index_type;
+
+	static constexpr index_type none = ~index_type(0);
+
+	// nodes other than the root having less children are dissolved on removal and their children are reinserted
+	static constexpr unsigned min_node_size = node_width / 2;
+
+	// rectangle as its minimal and maximal corner coordinates
+	struct box{
+		T x1, y1, x2, y2;
+
+		box() = default;
+
+		box(T x1, T y1, T x2, T y2)noexcept :
+				x1(x1), y1(y1), x2(x2), y2(y2)
+		{}
+
+		box(const rectangle<T>& r)noexcept :
+				x1(r.p.x()), y1(r.p.y()), x2(r.x2()), y2(r.y2())
+		{}
+
+		T area()const noexcept{
+			return (this->x2 - this->x1) * (this->y2 - this->y1);
+		}
+
+		box& unite(const box& b)noexcept{
+			using std::min;
+			using std::max;
+			this->x1 = min(this->x1, b.x1);
+			this->y1 = min(this->y1, b.y1);
+			this->x2 = max(this->x2, b.x2);
+			this->y2 = max(this->y2, b.y2);
+			return *this;
+		}
+
+		// doubled center coordinate along the axis
+		T center(unsigned axis)const noexcept{
+			return axis == 0 ? this->x1 + this->x2 : this->y1 + this->y2;
+		}
+
+		// squared distance from the point to the closest point of the box
+		T distance_pow2(const vector2<T>& p)const noexcept{
+			using std::max;
+			T dx = max(max(this->x1 - p.x(), p.x() - this->x2), T(0));
+			T dy = max(max(this->y1 - p.y(), p.y() - this->y2), T(0));
+			return dx * dx + dy * dy;
+		}
+	};
+
+	struct alignas(16) node{
+		// bounds of the children
+		T min_x[node_width];
+		T min_y[node_width];
+		T max_x[node_width];
+		T max_y[node_width];
+
+		// indices of child nodes, or rectangle ids in case of leaf node
+		index_type child[node_width];
+
+		index_type parent;
+
+		// number of children
+		unsigned size;
+
+		bool leaf;
+
+		box child_box(unsigned i)const noexcept{
+			return box(this->min_x[i], this->min_y[i], this->max_x[i], this->max_y[i]);
+		}
+
+		void set_child(unsigned i, const box& b, index_type c)noexcept{
+			this->min_x[i] = b.x1;
+			this->min_y[i] = b.y1;
+			this->max_x[i] = b.x2;
+			this->max_y[i] = b.y2;
+			this->child[i] = c;
+		}
+
+		unsigned slot_of(index_type c)const noexcept{
+			for(unsigned i = 0; i != this->size; ++i){
+				if(this->child[i] == c){
+					return i;
+				}
+			}
+			ASSERT(false)
+			return 0;
+		}
+	};
+
+	struct item{
+		rectangle<T> rect;
+
+		// leaf node containing the rectangle, none if the id is not in use
+		index_type leaf;
+	};
+
+	std::vector<node, aligned_allocator<node, alignof(node)>> nodes;
+	std::vector<index_type> free_nodes;
+
+	std::vector<item> items;
+	std::vector<index_type> free_ids;
+
+	index_type root = none;
+
+	// bitmask of node's children whose bounds overlap the point
+	static unsigned overlap_mask(const node& n, const vector2<T>& p)noexcept{
+		unsigned ret = 0;
+		for(unsigned i = 0; i != n.size; ++i){
+			if(
+					p.x() >= n.min_x[i] &&
+					p.y() >= n.min_y[i] &&
+					p.x() < n.max_x[i] &&
+					p.y() < n.max_y[i]
+				)
+			{
+				ret |= 1 << i;
+			}
+		}
+		return ret;
+	}
+
+	// bitmask of node's children whose bounds have common area with the box
+	static unsigned overlap_mask(const node& n, const box& b)noexcept{
+		using std::min;
+		using std::max;
+		unsigned ret = 0;
+		for(unsigned i = 0; i != n.size; ++i){
+			if(
+					max(b.x1, n.min_x[i]) < min(b.x2, n.max_x[i]) &&
+					max(b.y1, n.min_y[i]) < min(b.y2, n.max_y[i])
+				)
+			{
+				ret |= 1 << i;
+			}
+		}
+		return ret;
+	}
+
+	box node_box(index_type n)const noexcept{
+		auto& nd = this->nodes[n];
+		ASSERT(nd.size != 0)
+		box ret = nd.child_box(0);
+		for(unsigned i = 1; i != nd.size; ++i){
+			ret.unite(nd.child_box(i));
+		}
+		return ret;
+	}
+
+	index_type alloc_node(bool leaf){
+		index_type ret;
+		if(this->free_nodes.empty()){
+			ret = index_type(this->nodes.size());
+			this->nodes.emplace_back();
+		}else{
+			ret = this->free_nodes.back();
+			this->free_nodes.pop_back();
+		}
+		auto& n = this->nodes[ret];
+		n = node{};
+		n.parent = none;
+		n.leaf = leaf;
+		return ret;
+	}
+
+	// make the entry a child of the node, without updating bounds of the node in its parent
+	void attach(index_type n, unsigned slot, const box& b, index_type c)noexcept{
+		auto& nd = this->nodes[n];
+		nd.set_child(slot, b, c);
+		if(nd.leaf){
+			this->items[c].leaf = n;
+		}else{
+			this->nodes[c].parent = n;
+		}
+	}
+
+	// update bounds of the node's ancestors after the node's children were changed
+	void propagate_bounds(index_type n)noexcept{
+		for(index_type p = this->nodes[n].parent; p != none; n = p, p = this->nodes[n].parent){
+			auto& pn = this->nodes[p];
+			unsigned slot = pn.slot_of(n);
+			pn.set_child(slot, this->node_box(n), n);
+		}
+	}
+
+	// number of levels below the root node, 0 if the root is a leaf
+	unsigned height()const noexcept{
+		unsigned ret = 0;
+		for(index_type n = this->root; !this->nodes[n].leaf; n = this->nodes[n].child[0]){
+			++ret;
+		}
+		return ret;
+	}
+
+	// descend from the root to the node at the given level, whose bounds need least enlargement to include the box,
+	// level is the height above leaves, 0 for leaf nodes
+	index_type choose_node(const box& b, unsigned level)const noexcept;
+
+	void add_child(index_type n, const box& b, index_type c);
+
+	// remove child from the node, without updating bounds of the node in its parent
+	void detach(index_type n, unsigned slot)noexcept{
+		auto& nd = this->nodes[n];
+		ASSERT(slot < nd.size)
+		--nd.size;
+		if(slot != nd.size){
+			nd.set_child(slot, nd.child_box(nd.size), nd.child[nd.size]);
+		}
+	}
+
+	template <class F> void visit(index_type n, const vector2<T>& p, F& f)const{
+		auto& nd = this->nodes[n];
+		unsigned mask = overlap_mask(nd, p);
+		for(unsigned i = 0; mask != 0; ++i, mask >>= 1){
+			if((mask & 1) == 0){
+				continue;
+			}
+			if(nd.leaf){
+				f(size_t(nd.child[i]));
+			}else{
+				this->visit(nd.child[i], p, f);
+			}
+		}
+	}
+
+	template <class F> void visit(index_type n, const box& b, F& f)const{
+		auto& nd = this->nodes[n];
+		unsigned mask = overlap_mask(nd, b);
+		for(unsigned i = 0; mask != 0; ++i, mask >>= 1){
+			if((mask & 1) == 0){
+				continue;
+			}
+			if(nd.leaf){
+				f(size_t(nd.child[i]));
+			}else{
+				this->visit(nd.child[i], b, f);
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Construct empty tree.
+	 */
+	rectangle_tree() = default;
+
+	/**
+	 * @brief Construct tree from given rectangles.
+	 * Same as calling build() on empty tree.
+	 * @param rects - pointer to array of rectangles.
+	 * @param size - number of rectangles in the array.
+	 */
+	rectangle_tree(const rectangle<T>* rects, size_t size){
+		this->build(rects, size);
+	}
+
+	/**
+	 * @brief Bulk load the tree.
+	 * All rectangles previously stored in the tree are removed and the tree is built anew
+	 * from the given rectangles using Sort-Tile-Recursive packing.
+	 * The rectangles get ids equal to their indices in the array.
+	 * Bulk loading is much faster than inserting the rectangles one by one and results in better tree quality.
+	 * @param rects - pointer to array of rectangles.
+	 * @param size - number of rectangles in the array.
+	 */
+	void build(const rectangle<T>* rects, size_t size);
+
+	/**
+	 * @brief Add rectangle to the tree.
+	 * @param rect - rectangle to add.
+	 * @return id of the added rectangle.
+	 */
+	size_t insert(const rectangle<T>& rect);
+
+	/**
+	 * @brief Remove rectangle from the tree.
+	 * Tree nodes which become underfull are dissolved and their children are inserted back into the tree,
+	 * so the tree stays balanced and compact under many removals.
+	 * @param id - id of the rectangle to remove.
+	 */
+	void remove(size_t id);
+
+	/**
+	 * @brief Change rectangle stored in the tree.
+	 * The rectangle is changed in place and bounds of the tree nodes containing it are updated.
+	 * This is cheaper than removing and inserting the rectangle back, but the tree quality
+	 * degrades if the rectangle is moved far from its original location.
+	 * @param id - id of the rectangle to change.
+	 * @param rect - new rectangle.
+	 */
+	void refit(size_t id, const rectangle<T>& rect)noexcept;
+
+	/**
+	 * @brief Remove all rectangles from the tree.
+	 */
+	void clear()noexcept{
+		this->nodes.clear();
+		this->free_nodes.clear();
+		this->items.clear();
+		this->free_ids.clear();
+		this->root = none;
+	}
+
+	/**
+	 * @brief Get number of rectangles stored in the tree.
+	 * @return number of rectangles stored in the tree.
+	 */
+	size_t size()const noexcept{
+		return this->items.size() - this->free_ids.size();
+	}
+
+	/**
+	 * @brief Check if the tree is empty.
+	 * @return true if there are no rectangles stored in the tree.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->root == none;
+	}
+
+	/**
+	 * @brief Get rectangle by id.
+	 * @param id - id of the rectangle.
+	 * @return the rectangle.
+	 */
+	const rectangle<T>& operator[](size_t id)const noexcept{
+		ASSERT(id < this->items.size() && this->items[id].leaf != none)
+		return this->items[id].rect;
+	}
+
+	/**
+	 * @brief Get bounding rectangle of all rectangles stored in the tree.
+	 * @return bounding rectangle of all rectangles stored in the tree.
+	 */
+	rectangle<T> bounds()const noexcept{
+		ASSERT(!this->empty())
+		auto b = this->node_box(this->root);
+		return rectangle<T>(b.x1, b.y1, b.x2 - b.x1, b.y2 - b.y1);
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the point.
+	 * The point overlapping is as defined by rectangle::overlaps().
+	 * @param point - point to find the overlapping rectangles for.
+	 * @param f - function to call for each found rectangle, receives id of the rectangle as argument.
+	 */
+	template <class F> void query(const vector2<T>& point, F&& f)const{
+		if(this->empty()){
+			return;
+		}
+		this->visit(this->root, point, f);
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the point.
+	 * The point overlapping is as defined by rectangle::overlaps().
+	 * @param point - point to find the overlapping rectangles for.
+	 * @return ids of the found rectangles, in unspecified order.
+	 */
+	std::vector<size_t> query(const vector2<T>& point)const{
+		std::vector<size_t> ret;
+		this->query(point, [&ret](size_t id){ret.push_back(id);});
+		return ret;
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the rectangle.
+	 * Rectangles overlap if their intersection has non-zero area.
+	 * @param rect - rectangle to find the overlapping rectangles for.
+	 * @param f - function to call for each found rectangle, receives id of the rectangle as argument.
+	 */
+	template <class F> void query(const rectangle<T>& rect, F&& f)const{
+		if(this->empty()){
+			return;
+		}
+		this->visit(this->root, box(rect), f);
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the rectangle.
+	 * Rectangles overlap if their intersection has non-zero area.
+	 * @param rect - rectangle to find the overlapping rectangles for.
+	 * @return ids of the found rectangles, in unspecified order.
+	 */
+	std::vector<size_t> query(const rectangle<T>& rect)const{
+		std::vector<size_t> ret;
+		this->query(rect, [&ret](size_t id){ret.push_back(id);});
+		return ret;
+	}
+
+	/**
+	 * @brief Find rectangles nearest to the point.
+	 * Distance from the point to a rectangle is the distance to the rectangle's closest point,
+	 * it is zero for points inside of the rectangle.
+	 * @param point - point to find the nearest rectangles for.
+	 * @param k - number of rectangles to find.
+	 * @return ids of the k nearest rectangles, sorted by increasing distance.
+	 *         If the tree has less than k rectangles, then all of them are returned.
+	 */
+	std::vector<size_t> nearest(const vector2<T>& point, size_t k = 1)const;
+};
+
+}
+
+namespace r4{
+
+template <class T> void rectangle_tree<T>::add_child(index_type n, const box& b, index_type c){
+	if(this->nodes[n].size != node_width){
+		auto slot = this->nodes[n].size++;
+		this->attach(n, slot, b, c);
+		this->propagate_bounds(n);
+		return;
+	}
+
+	// the node is full, split it into two along the axis of the largest spread of children centers
+	struct entry{
+		box b;
+		index_type c;
+	};
+
+	std::array<entry, node_width + 1> entries;
+	{
+		auto& nd = this->nodes[n];
+		for(unsigned i = 0; i != node_width; ++i){
+			entries[i] = entry{nd.child_box(i), nd.child[i]};
+		}
+		entries[node_width] = entry{b, c};
+	}
+
+	unsigned axis;
+	{
+		box spread(entries[0].b.center(0), entries[0].b.center(1), entries[0].b.center(0), entries[0].b.center(1));
+		for(auto& e : entries){
+			spread.unite(box(e.b.center(0), e.b.center(1), e.b.center(0), e.b.center(1)));
+		}
+		axis = spread.x2 - spread.x1 >= spread.y2 - spread.y1 ? 0 : 1;
+	}
+
+	std::sort(
+			entries.begin(),
+			entries.end(),
+			[axis](const entry& a, const entry& b){
+				return a.b.center(axis) < b.b.center(axis);
+			}
+		);
+
+	const unsigned num_left = (node_width + 2) / 2;
+
+	auto sibling = this->alloc_node(this->nodes[n].leaf);
+
+	this->nodes[n].size = num_left;
+	for(unsigned i = 0; i != num_left; ++i){
+		this->attach(n, i, entries[i].b, entries[i].c);
+	}
+
+	this->nodes[sibling].size = node_width + 1 - num_left;
+	for(unsigned i = num_left; i != node_width + 1; ++i){
+		this->attach(sibling, i - num_left, entries[i].b, entries[i].c);
+	}
+
+	auto parent = this->nodes[n].parent;
+	if(parent == none){
+		// the root was split, grow the tree
+		auto new_root = this->alloc_node(false);
+		this->nodes[new_root].size = 2;
+		this->attach(new_root, 0, this->node_box(n), n);
+		this->attach(new_root, 1, this->node_box(sibling), sibling);
+		this->root = new_root;
+		return;
+	}
+
+	{
+		auto& pn = this->nodes[parent];
+		pn.set_child(pn.slot_of(n), this->node_box(n), n);
+	}
+	this->add_child(parent, this->node_box(sibling), sibling);
+}
+
+template <class T> typename rectangle_tree<T>::index_type rectangle_tree<T>::choose_node(const box& b, unsigned level)const noexcept{
+	index_type n = this->root;
+	for(unsigned h = this->height(); h != level; --h){
+		auto& nd = this->nodes[n];
+		ASSERT(!nd.leaf)
+		unsigned best = 0;
+		T best_enlargement = T(0);
+		T best_area = T(0);
+		for(unsigned i = 0; i != nd.size; ++i){
+			auto cb = nd.child_box(i);
+			T area = cb.area();
+			T enlargement = cb.unite(b).area() - area;
+			if(i == 0 || enlargement < best_enlargement || (enlargement == best_enlargement && area < best_area)){
+				best = i;
+				best_enlargement = enlargement;
+				best_area = area;
+			}
+		}
+		n = nd.child[best];
+	}
+	return n;
+}
+
+template <class T> void rectangle_tree<T>::build(const rectangle<T>* rects, size_t size){
+	this->clear();
+
+	ASSERT(size < size_t(none))
+
+	if(size == 0){
+		return;
+	}
+
+	this->items.resize(size);
+
+	struct entry{
+		box b;
+		index_type c;
+	};
+
+	std::vector<entry> level;
+	level.reserve(size);
+	for(size_t i = 0; i != size; ++i){
+		this->items[i].rect = rects[i];
+		level.push_back(entry{box(rects[i]), index_type(i)});
+	}
+
+	this->nodes.reserve(size / (node_width - 1) + 1);
+
+	auto compare = [](unsigned axis){
+		return [axis](const entry& a, const entry& b){
+			return a.b.center(axis) < b.b.center(axis);
+		};
+	};
+
+	// build the tree level by level, bottom-up
+	std::vector<entry> next;
+	for(bool leaf = true;; leaf = false){
+		size_t num_nodes = (level.size() + node_width - 1) / node_width;
+
+		// sort entries by x, cut them into vertical slices, sort each slice by y and pack into nodes
+		size_t num_slices = size_t(std::ceil(std::sqrt(double(num_nodes))));
+		size_t slice_size = (num_nodes + num_slices - 1) / num_slices * node_width;
+
+		std::sort(level.begin(), level.end(), compare(0));
+
+		next.clear();
+		for(size_t s = 0; s < level.size(); s += slice_size){
+			auto slice_end = std::min(s + slice_size, level.size());
+			std::sort(level.begin() + s, level.begin() + slice_end, compare(1));
+
+			for(size_t i = s; i < slice_end; i += node_width){
+				auto n = this->alloc_node(leaf);
+				auto num_children = unsigned(std::min(size_t(node_width), slice_end - i));
+				this->nodes[n].size = num_children;
+				for(unsigned j = 0; j != num_children; ++j){
+					this->attach(n, j, level[i + j].b, level[i + j].c);
+				}
+				next.push_back(entry{this->node_box(n), n});
+			}
+		}
+
+		if(next.size() == 1){
+			this->root = next.front().c;
+			break;
+		}
+
+		level.swap(next);
+	}
+}
+
+template <class T> size_t rectangle_tree<T>::insert(const rectangle<T>& rect){
+	index_type id;
+	if(this->free_ids.empty()){
+		ASSERT(this->items.size() < size_t(none))
+		id = index_type(this->items.size());
+		this->items.emplace_back();
+	}else{
+		id = this->free_ids.back();
+		this->free_ids.pop_back();
+	}
+	this->items[id].rect = rect;
+
+	box b(rect);
+
+	if(this->empty()){
+		this->root = this->alloc_node(true);
+	}
+
+	this->add_child(this->choose_node(b, 0), b, id);
+
+	return id;
+}
+
+template <class T> void rectangle_tree<T>::remove(size_t id){
+	ASSERT(id < this->items.size() && this->items[id].leaf != none)
+
+	auto leaf = this->items[id].leaf;
+	this->items[id].leaf = none;
+	this->free_ids.push_back(index_type(id));
+
+	this->detach(leaf, this->nodes[leaf].slot_of(index_type(id)));
+
+	// go up to the root, dissolve underfull nodes and update bounds of the rest
+	struct orphan{
+		index_type n;
+		unsigned level;
+	};
+	std::vector<orphan> orphans;
+	unsigned level = 0;
+	for(index_type n = leaf; n != this->root; ++level){
+		auto parent = this->nodes[n].parent;
+		auto slot = this->nodes[parent].slot_of(n);
+		if(this->nodes[n].size < min_node_size){
+			this->detach(parent, slot);
+			orphans.push_back(orphan{n, level});
+		}else{
+			this->nodes[parent].set_child(slot, this->node_box(n), n);
+		}
+		n = parent;
+	}
+
+	if(this->nodes[this->root].size == 0){
+		// non-leaf root has at least two children and loses at most one of them,
+		// so only the leaf root can become empty, i.e. the last rectangle was removed
+		ASSERT(orphans.empty())
+		this->clear();
+		return;
+	}
+
+	// reinsert children of the dissolved nodes at the same level they were at
+	for(auto& o : orphans){
+		// NOTE: copy the node, since adding children may reallocate the nodes array
+		auto on = this->nodes[o.n];
+		for(unsigned i = 0; i != on.size; ++i){
+			auto b = on.child_box(i);
+			this->add_child(this->choose_node(b, o.level), b, on.child[i]);
+		}
+		this->free_nodes.push_back(o.n);
+	}
+
+	// shrink the tree while the root has only one child node
+	while(!this->nodes[this->root].leaf && this->nodes[this->root].size == 1){
+		auto old_root = this->root;
+		this->root = this->nodes[old_root].child[0];
+		this->nodes[this->root].parent = none;
+		this->free_nodes.push_back(old_root);
+	}
+}
+
+template <class T> void rectangle_tree<T>::refit(size_t id, const rectangle<T>& rect)noexcept{
+	ASSERT(id < this->items.size() && this->items[id].leaf != none)
+
+	auto& i = this->items[id];
+	i.rect = rect;
+
+	auto& leaf = this->nodes[i.leaf];
+	leaf.set_child(leaf.slot_of(index_type(id)), box(rect), index_type(id));
+	this->propagate_bounds(i.leaf);
+}
+
+template <class T> std::vector<size_t> rectangle_tree<T>::nearest(const vector2<T>& point, size_t k)const{
+	std::vector<size_t> ret;
+	if(this->empty() || k == 0){
+		return ret;
+	}
+
+	// best-first search, queue contains nodes and rectangles ordered by distance to the point
+	struct entry{
+		T distance_pow2;
+		index_type index;
+		bool is_node;
+
+		bool operator<(const entry& e)const noexcept{
+			// std::priority_queue is a max-heap, so compare in reverse
+			return this->distance_pow2 > e.distance_pow2;
+		}
+	};
+
+	std::priority_queue<entry> queue;
+	queue.push(entry{T(0), this->root, true});
+
+	while(!queue.empty()){
+		auto e = queue.top();
+		queue.pop();
+
+		if(!e.is_node){
+			ret.push_back(size_t(e.index));
+			if(ret.size() == k){
+				break;
+			}
+			continue;
+		}
+
+		auto& nd = this->nodes[e.index];
+		for(unsigned i = 0; i != nd.size; ++i){
+			queue.push(entry{nd.child_box(i).distance_pow2(point), nd.child[i], !nd.leaf});
+		}
+	}
+
+	return ret;
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of rectangle_tree<float> node tests
+
+template <> inline unsigned rectangle_tree<float>::overlap_mask(const node& n, const vector2<float>& p)noexcept{
+	auto x = simd::splat(p.x());
+	auto y = simd::splat(p.y());
+
+	auto m = simd::and_mask(
+			simd::and_mask(simd::cmp_le(simd::load(n.min_x), x), simd::cmp_le(simd::load(n.min_y), y)),
+			simd::and_mask(simd::cmp_lt(x, simd::load(n.max_x)), simd::cmp_lt(y, simd::load(n.max_y)))
+		);
+	return simd::mask_bits(m) & ((1u << n.size) - 1);
+}
+
+template <> inline unsigned rectangle_tree<float>::overlap_mask(const node& n, const box& b)noexcept{
+	auto m = simd::and_mask(
+			simd::cmp_lt(simd::max(simd::splat(b.x1), simd::load(n.min_x)), simd::min(simd::splat(b.x2), simd::load(n.max_x))),
+			simd::cmp_lt(simd::max(simd::splat(b.y1), simd::load(n.min_y)), simd::min(simd::splat(b.y2), simd::load(n.max_y)))
+		);
+	return simd::mask_bits(m) & ((1u << n.size) - 1);
+}
+
+#endif
+
+}
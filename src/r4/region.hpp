@@ -0,0 +1,426 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "rectangle.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief 2d region, an arbitrary set of points represented as a union of rectangles.
+ * Unlike rectangle::unite(), which gives a bounding rectangle, operations on regions are exact,
+ * e.g. union of two disjoint rectangles is a region of just these two rectangles.
+ * Intended to be used with integer coordinates, e.g. for tracking damaged areas of a screen.
+ * The region is stored as list of non-overlapping rectangles in y-x banded order, same as X11 and pixman regions do:
+ * - the rectangles are grouped into horizontal bands, all rectangles of a band have same top and bottom coordinates;
+ * - bands do not overlap vertically and are sorted from top to bottom;
+ * - rectangles of a band are sorted from left to right and neither overlap nor touch each other;
+ * - vertically adjacent bands always differ in horizontal extents of their rectangles, otherwise they are merged into one band.
+ * Such representation is unique, so regions covering same set of points are equal.
+ * Union, intersection and subtraction run in time linear in number of rectangles of the operand regions
+ * by merging the bands of the operands from top to bottom.
+ * Points of a region are the ones overlapped by its rectangles, see rectangle::overlaps().
+ */
+template <class T> class region{
+	std::vector<rectangle<T>> rects;
+
+	// index of the rectangle after the last one of the band beginning at given index
+	static size_t band_end(const std::vector<rectangle<T>>& rects, size_t begin)noexcept{
+		size_t i = begin + 1;
+		for(; i != rects.size() && rects[i].p.y() == rects[begin].p.y(); ++i){}
+		return i;
+	}
+
+	// appends to 'out' the union of horizontal spans of two bands, as a band of given vertical extent
+	static void unite_spans(
+			const rectangle<T>* a,
+			const rectangle<T>* a_end,
+			const rectangle<T>* b,
+			const rectangle<T>* b_end,
+			T y1,
+			T y2,
+			std::vector<rectangle<T>>& out,
+			size_t band_begin
+		)
+	{
+		while(a != a_end || b != b_end){
+			const rectangle<T>* r;
+			if(b == b_end || (a != a_end && a->p.x() <= b->p.x())){
+				r = a++;
+			}else{
+				r = b++;
+			}
+			if(out.size() != band_begin && out.back().x2() >= r->p.x()){
+				using std::max;
+				out.back().d.x() = max(out.back().x2(), r->x2()) - out.back().p.x();
+			}else{
+				out.emplace_back(r->p.x(), y1, r->d.x(), y2 - y1);
+			}
+		}
+	}
+
+	// appends to 'out' the intersection of horizontal spans of two bands, as a band of given vertical extent
+	static void intersect_spans(
+			const rectangle<T>* a,
+			const rectangle<T>* a_end,
+			const rectangle<T>* b,
+			const rectangle<T>* b_end,
+			T y1,
+			T y2,
+			std::vector<rectangle<T>>& out,
+			size_t
+		)
+	{
+		while(a != a_end && b != b_end){
+			using std::min;
+			using std::max;
+			T x1 = max(a->p.x(), b->p.x());
+			T x2 = min(a->x2(), b->x2());
+			if(x1 < x2){
+				out.emplace_back(x1, y1, x2 - x1, y2 - y1);
+			}
+			if(a->x2() < b->x2()){
+				++a;
+			}else{
+				++b;
+			}
+		}
+	}
+
+	// appends to 'out' the horizontal spans of band 'a' with spans of band 'b' subtracted, as a band of given vertical extent
+	static void subtract_spans(
+			const rectangle<T>* a,
+			const rectangle<T>* a_end,
+			const rectangle<T>* b,
+			const rectangle<T>* b_end,
+			T y1,
+			T y2,
+			std::vector<rectangle<T>>& out,
+			size_t
+		)
+	{
+		if(a == a_end){
+			return;
+		}
+
+		// left end of the part of the current span of 'a' which is not processed yet
+		T x1 = a->p.x();
+		while(a != a_end){
+			for(; b != b_end && b->x2() <= x1; ++b){}
+
+			if(b == b_end || b->p.x() >= a->x2()){
+				// rest of the span is not covered
+				out.emplace_back(x1, y1, a->x2() - x1, y2 - y1);
+			}else{
+				if(b->p.x() > x1){
+					out.emplace_back(x1, y1, b->p.x() - x1, y2 - y1);
+				}
+				x1 = b->x2();
+				if(x1 < a->x2()){
+					// the subtracted span ends inside of the current span
+					++b;
+					continue;
+				}
+			}
+
+			++a;
+			if(a != a_end){
+				x1 = a->p.x();
+			}
+		}
+	}
+
+	typedef void (*spans_operation)(
+			const rectangle<T>*,
+			const rectangle<T>*,
+			const rectangle<T>*,
+			const rectangle<T>*,
+			T,
+			T,
+			std::vector<rectangle<T>>&,
+			size_t
+		);
+
+	// merges band which begins at 'band_begin' into the previous band if they are adjacent and have same spans
+	static bool coalesce(std::vector<rectangle<T>>& out, size_t prev_band_begin, size_t band_begin)noexcept{
+		size_t n = out.size() - band_begin;
+		if(n == 0 || prev_band_begin == band_begin || band_begin - prev_band_begin != n){
+			return false;
+		}
+		if(out[prev_band_begin].y2() != out[band_begin].p.y()){
+			return false;
+		}
+		for(size_t i = 0; i != n; ++i){
+			const auto& p = out[prev_band_begin + i];
+			const auto& r = out[band_begin + i];
+			if(p.p.x() != r.p.x() || p.d.x() != r.d.x()){
+				return false;
+			}
+		}
+		T h = out[band_begin].d.y();
+		for(size_t i = prev_band_begin; i != band_begin; ++i){
+			out[i].d.y() += h;
+		}
+		out.resize(band_begin);
+		return true;
+	}
+
+	// applies the operation to each horizontal slice of the two regions in which the bands of both regions do not change
+	static std::vector<rectangle<T>> merge(
+			const std::vector<rectangle<T>>& a,
+			const std::vector<rectangle<T>>& b,
+			spans_operation op
+		)
+	{
+		std::vector<rectangle<T>> out;
+		out.reserve(a.size() + b.size());
+
+		size_t ia = 0, ib = 0;
+		size_t prev_band_begin = 0;
+
+		T y;
+		if(a.empty()){
+			if(b.empty()){
+				return out;
+			}
+			y = b.front().p.y();
+		}else if(b.empty()){
+			y = a.front().p.y();
+		}else{
+			using std::min;
+			y = min(a.front().p.y(), b.front().p.y());
+		}
+
+		size_t a_end = a.empty() ? 0 : band_end(a, 0);
+		size_t b_end = b.empty() ? 0 : band_end(b, 0);
+
+		while(ia != a.size() || ib != b.size()){
+			// the slice ends where any of the current bands begins or ends
+			bool a_covers = ia != a.size() && a[ia].p.y() <= y;
+			bool b_covers = ib != b.size() && b[ib].p.y() <= y;
+			T y_next;
+			if(ia == a.size()){
+				y_next = b_covers ? b[ib].y2() : b[ib].p.y();
+			}else if(ib == b.size()){
+				y_next = a_covers ? a[ia].y2() : a[ia].p.y();
+			}else{
+				using std::min;
+				y_next = min(a_covers ? a[ia].y2() : a[ia].p.y(), b_covers ? b[ib].y2() : b[ib].p.y());
+			}
+
+			// bands which do not cover the slice take part in the operation as empty ones
+			size_t band_begin = out.size();
+			op(
+					a.data() + ia,
+					a.data() + (a_covers ? a_end : ia),
+					b.data() + ib,
+					b.data() + (b_covers ? b_end : ib),
+					y,
+					y_next,
+					out,
+					band_begin
+				);
+			if(!coalesce(out, prev_band_begin, band_begin) && out.size() != band_begin){
+				prev_band_begin = band_begin;
+			}
+
+			y = y_next;
+			if(a_covers && a[ia].y2() == y){
+				ia = a_end;
+				if(ia != a.size()){
+					a_end = band_end(a, ia);
+				}
+			}
+			if(b_covers && b[ib].y2() == y){
+				ib = b_end;
+				if(ib != b.size()){
+					b_end = band_end(b, ib);
+				}
+			}
+		}
+		return out;
+	}
+
+public:
+	/**
+	 * @brief Construct empty region.
+	 */
+	region() = default;
+
+	/**
+	 * @brief Construct region from rectangle.
+	 * @param rect - rectangle to construct the region from.
+	 *               Rectangle with zero or negative width or height gives empty region.
+	 */
+	region(const rectangle<T>& rect){
+		if(rect.d.x() > 0 && rect.d.y() > 0){
+			this->rects.push_back(rect);
+		}
+	}
+
+	/**
+	 * @brief Get rectangles of the region.
+	 * @return non-overlapping rectangles of the region in y-x banded order.
+	 */
+	const std::vector<rectangle<T>>& rectangles()const noexcept{
+		return this->rects;
+	}
+
+	/**
+	 * @brief Check if the region is empty.
+	 * @return true if the region has no points.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->rects.empty();
+	}
+
+	/**
+	 * @brief Make the region empty.
+	 */
+	void clear()noexcept{
+		this->rects.clear();
+	}
+
+	/**
+	 * @brief Get bounding rectangle.
+	 * @return smallest rectangle containing the region.
+	 * @return rectangle (0, 0, 0, 0) if the region is empty.
+	 */
+	rectangle<T> bounding_box()const noexcept{
+		if(this->rects.empty()){
+			return rectangle<T>(0, 0, 0, 0);
+		}
+		T x1 = this->rects.front().p.x();
+		T x2 = this->rects.front().x2();
+		for(const auto& r : this->rects){
+			using std::min;
+			using std::max;
+			x1 = min(x1, r.p.x());
+			x2 = max(x2, r.x2());
+		}
+		T y1 = this->rects.front().p.y();
+		return rectangle<T>(x1, y1, x2 - x1, this->rects.back().y2() - y1);
+	}
+
+	/**
+	 * @brief Test regions for equality.
+	 * @param r - region to compare this region to.
+	 * @return true if the regions consist of same points.
+	 * @return false otherwise.
+	 */
+	bool operator==(const region& r)const noexcept{
+		return this->rects == r.rects;
+	}
+
+	/**
+	 * @brief Test regions for inequality.
+	 * @param r - region to compare this region to.
+	 * @return true if the regions do not consist of same points.
+	 * @return false otherwise.
+	 */
+	bool operator!=(const region& r)const noexcept{
+		return !this->operator==(r);
+	}
+
+	/**
+	 * @brief Test if the region overlaps given point.
+	 * Finds the band and the rectangle with binary search.
+	 * @param point - point to test for overlapping.
+	 * @return true if the region overlaps the given point.
+	 * @return false otherwise.
+	 */
+	bool overlaps(const vector2<T>& point)const noexcept{
+		// bottoms of the bands grow monotonically, find first band which ends below the point
+		auto band = std::upper_bound(
+				this->rects.begin(),
+				this->rects.end(),
+				point.y(),
+				[](T y, const rectangle<T>& r){return y < r.y2();}
+			);
+		if(band == this->rects.end() || point.y() < band->p.y()){
+			return false;
+		}
+		auto end = this->rects.begin() + band_end(this->rects, size_t(band - this->rects.begin()));
+		auto i = std::upper_bound(
+				band,
+				end,
+				point.x(),
+				[](T x, const rectangle<T>& r){return x < r.x2();}
+			);
+		return i != end && i->p.x() <= point.x();
+	}
+
+	/**
+	 * @brief Unite this region with given region.
+	 * @param r - region to unite this region with.
+	 * @return reference to this region.
+	 */
+	region& unite(const region& r){
+		this->rects = merge(this->rects, r.rects, &unite_spans);
+		return *this;
+	}
+
+	/**
+	 * @brief Intersect this region with given region.
+	 * @param r - region to intersect this region with.
+	 * @return reference to this region.
+	 */
+	region& intersect(const region& r){
+		if(this->rects.empty() || r.rects.empty()){
+			this->rects.clear();
+			return *this;
+		}
+		this->rects = merge(this->rects, r.rects, &intersect_spans);
+		return *this;
+	}
+
+	/**
+	 * @brief Subtract given region from this region.
+	 * @param r - region to subtract from this region.
+	 * @return reference to this region.
+	 */
+	region& subtract(const region& r){
+		if(this->rects.empty() || r.rects.empty()){
+			return *this;
+		}
+		this->rects = merge(this->rects, r.rects, &subtract_spans);
+		return *this;
+	}
+
+	/**
+	 * @brief Move region.
+	 * @param delta - vector to move the region by.
+	 * @return reference to this region.
+	 */
+	region& translate(const vector2<T>& delta)noexcept{
+		for(auto& r : this->rects){
+			r.p += delta;
+		}
+		return *this;
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const region<T>& r){
+		s << "{";
+		for(const auto& rect : r.rects){
+			s << rect;
+		}
+		s << "}";
+		return s;
+	}
+};
+
+}
@@ -1,6 +1,16 @@
 #pragma once
 
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.hpp"
 #include "vector2.hpp"
+#include "rectangle.hpp"
+#include "simd.hpp"
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
 #ifdef min
@@ -33,7 +43,7 @@ public:
 	 * @brief Get (x1, y2) point.
 	 * @return (x1, y2) point.
 	 */
-	vector2<T> x1_y2()const noexcept{
+	constexpr vector2<T> x1_y2()const noexcept{
 		return {
 				this->p1.x(),
 				this->p2.y()
@@ -44,7 +54,7 @@ public:
 	 * @brief Get (x2, y1) point.
 	 * @return (x2, y1) point.
 	 */
-	vector2<T> x2_y1()const noexcept{
+	constexpr vector2<T> x2_y1()const noexcept{
 		return {
 				this->p2.x(),
 				this->p1.y()
@@ -55,7 +65,7 @@ public:
 	 * @brief Get x2 - x1.
 	 * @return x2 - x1.
 	 */
-	T dx()const noexcept{
+	constexpr T dx()const noexcept{
 		return this->p2.x() - this->p1.x();
 	}
 
@@ -63,7 +73,7 @@ public:
 	 * @brief Get y2 - y1.
 	 * @return y2 - y1.
 	 */
-	T dy()const noexcept{
+	constexpr T dy()const noexcept{
 		return this->p2.y() - this->p1.y();
 	}
 
@@ -71,7 +81,7 @@ public:
 	 * @brief Get (dx, dy) vector.
 	 * @return (dx, dy) vector.
 	 */
-	vector2<T> dx_dy()const noexcept{
+	constexpr vector2<T> dx_dy()const noexcept{
 		return this->p2 - this->p1;
 	}
 
@@ -80,7 +90,7 @@ public:
 	 * @return dx if it spositive.
 	 * @return 0 otherwise.
 	 */
-	T width()const noexcept{
+	constexpr T width()const noexcept{
 		using std::max;
 		return max(T(0), this->dx());
 	}
@@ -90,7 +100,7 @@ public:
 	 * @return dy if it spositive.
 	 * @return 0 otherwise.
 	 */
-	T height()const noexcept{
+	constexpr T height()const noexcept{
 		using std::max;
 		return max(T(0), this->dy());
 	}
@@ -99,7 +109,7 @@ public:
 	 * @brief Get dimensions of the segment's bounding box.
 	 * @return (width, height) vector.
 	 */
-	vector2<T> dims()const noexcept{
+	constexpr vector2<T> dims()const noexcept{
 		using std::max;
 		return {
 				this->width(),
@@ -113,7 +123,7 @@ public:
 	 * minimal possible values of the value_type representing components of p1 and p2.
 	 * @return reference to this object.
 	 */
-	segment2& set_empty_bounding_box()noexcept{
+	constexpr segment2& set_empty_bounding_box()noexcept{
 		using std::numeric_limits;
 		typedef numeric_limits<typename decltype(this->p1)::value_type> limits;
 		this->p1 = decltype(this->p1){
@@ -121,8 +131,8 @@ public:
 				limits::max()
 			};
 		this->p2 = decltype(this->p2){
-				limits::min(),
-				limits::min()
+				limits::lowest(),
+				limits::lowest()
 			};
 		return *this;
 	}
@@ -134,7 +144,7 @@ public:
 	 * @param bb - another bounding box to unite this one with.
 	 * @return reference to this object.
 	 */
-	segment2& unite(const segment2& bb)noexcept{
+	constexpr segment2& unite(const segment2& bb)noexcept{
 		using std::min;
 		using std::max;
 
@@ -143,6 +153,368 @@ public:
 
 		return *this;
 	}
+
+	/**
+	 * @brief Calculate bounding box of points.
+	 * @param points - pointer to array of points.
+	 * @param size - number of points in the array.
+	 * @return bounding box of the points. Empty bounding box if size is 0.
+	 */
+	static segment2 bounding_box(const vector2<T>* points, size_t size)noexcept;
+
+	/**
+	 * @brief Test if this segment intersects another one.
+	 * Segments touching each other by end points or lying on the same line and overlapping also intersect.
+	 * For integer component type the test is exact as long as absolute values of the coordinates are less than 2^30.
+	 * @param s - segment to test for intersection with.
+	 * @return true if segments have at least one common point.
+	 * @return false otherwise.
+	 */
+	constexpr bool intersects(const segment2& s)const noexcept{
+		auto d1 = orientation(s.p1, s.p2, this->p1);
+		auto d2 = orientation(s.p1, s.p2, this->p2);
+		auto d3 = orientation(this->p1, this->p2, s.p1);
+		auto d4 = orientation(this->p1, this->p2, s.p2);
+
+		if(((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))){
+			return true;
+		}
+
+		// one of the end points lies on the line of the other segment
+		return
+				(d1 == 0 && s.bounds_contain(this->p1)) ||
+				(d2 == 0 && s.bounds_contain(this->p2)) ||
+				(d3 == 0 && this->bounds_contain(s.p1)) ||
+				(d4 == 0 && this->bounds_contain(s.p2))
+			;
+	}
+
+	/**
+	 * @brief Find intersection point of this segment with another one.
+	 * For integer component type the intersection point is rounded to the nearest integer point,
+	 * absolute values of the coordinates must be less than 2^30.
+	 * @param s - segment to intersect this segment with.
+	 * @param point - receives the intersection point, it is not changed if there is no single intersection point.
+	 * @return true if the segments intersect in a single point.
+	 * @return false if the segments do not intersect or are parallel.
+	 */
+	constexpr bool intersection(const segment2& s, vector2<T>& point)const noexcept{
+		auto r = this->dx_dy();
+		auto q = s.dx_dy();
+
+		auto den = cross(r, q);
+		if(den == 0){
+			return false;
+		}
+
+		auto w = s.p1 - this->p1;
+
+		// intersection point is p1 + r * t = s.p1 + q * u, where 0 <= t, u <= 1
+		auto t_num = cross(w, q);
+		auto u_num = cross(w, r);
+		if(den < 0){
+			den = -den;
+			t_num = -t_num;
+			u_num = -u_num;
+		}
+		if(t_num < 0 || t_num > den || u_num < 0 || u_num > den){
+			return false;
+		}
+
+		point = this->p1 + scale_by_ratio(r, t_num, den);
+		return true;
+	}
+
+	/**
+	 * @brief Get point of the segment closest to the given point.
+	 * For integer component type the closest point is rounded to the nearest integer point,
+	 * absolute values of the coordinates must be less than 2^30.
+	 * @param p - point to find the closest segment point for.
+	 * @return point of the segment closest to the given point.
+	 */
+	constexpr vector2<T> closest_point(const vector2<T>& p)const noexcept{
+		auto d = this->dx_dy();
+		auto proj = dot(p - this->p1, d);
+		if(proj <= 0){
+			return this->p1;
+		}
+		auto len_pow2 = dot(d, d);
+		if(proj >= len_pow2){
+			return this->p2;
+		}
+		return this->p1 + scale_by_ratio(d, proj, len_pow2);
+	}
+
+	/**
+	 * @brief Clip this segment by rectangle.
+	 * Clips the segment by the closed rectangle using Liang-Barsky algorithm.
+	 * The direction of the segment is preserved.
+	 * For integer component type the clipped end points are rounded to the nearest integer.
+	 * @param rect - rectangle to clip the segment by, its dimensions must be non-negative.
+	 * @return true if the segment has common points with the rectangle, the segment is clipped.
+	 * @return false if the segment is completely outside of the rectangle, the segment is left unchanged.
+	 */
+	bool clip(const rectangle<T>& rect)noexcept;
+
+	/**
+	 * @brief Clip segments by rectangle.
+	 * Clips each segment by the closed rectangle as clip(rect) does and writes the segments
+	 * which have common points with the rectangle to the output array, preserving their order.
+	 * The segments completely outside of the rectangle are dropped.
+	 * @param src - segments to clip.
+	 * @param size - number of segments.
+	 * @param rect - rectangle to clip the segments by, its dimensions must be non-negative.
+	 * @param dst - output array of clipped segments, must have space for size segments. Can be same as src.
+	 * @return number of segments written to the output array.
+	 */
+	static size_t clip(const segment2* src, size_t size, const rectangle<T>& rect, segment2* dst)noexcept;
+
+private:
+	// type of cross and dot products, for integer component type it is wide enough to hold products of the coordinates
+	typedef typename std::conditional<std::is_integral<T>::value, int64_t, T>::type product_type;
+
+	static constexpr product_type cross(const vector2<T>& a, const vector2<T>& b)noexcept{
+		return product_type(a.x()) * product_type(b.y()) - product_type(a.y()) * product_type(b.x());
+	}
+
+	static constexpr product_type dot(const vector2<T>& a, const vector2<T>& b)noexcept{
+		return product_type(a.x()) * product_type(b.x()) + product_type(a.y()) * product_type(b.y());
+	}
+
+	// sign of the cross product, positive if c is to the left of a->b line
+	static constexpr product_type orientation(const vector2<T>& a, const vector2<T>& b, const vector2<T>& c)noexcept{
+		return cross(b - a, c - a);
+	}
+
+	// v * num / den, where 0 <= num <= den, den > 0,
+	// for integer component type it is calculated in floating point to avoid overflow of v * num and rounded to nearest
+	static constexpr vector2<T> scale_by_ratio(const vector2<T>& v, product_type num, product_type den)noexcept{
+		if constexpr(std::is_floating_point<T>::value){
+			return v * num / den;
+		}else{
+			double f = double(num) / double(den);
+			// NOTE: std::round() is not constexpr
+			auto round = [](double x){
+				return T(x < 0 ? x - 0.5 : x + 0.5);
+			};
+			return vector2<T>(round(double(v.x()) * f), round(double(v.y()) * f));
+		}
+	}
+
+	// check if the point is within the bounding box of the segment end points
+	constexpr bool bounds_contain(const vector2<T>& p)const noexcept{
+		using std::min;
+		using std::max;
+		return
+				min(this->p1.x(), this->p2.x()) <= p.x() && p.x() <= max(this->p1.x(), this->p2.x()) &&
+				min(this->p1.y(), this->p2.y()) <= p.y() && p.y() <= max(this->p1.y(), this->p2.y())
+			;
+	}
 };
 
+template <class T> segment2<T> segment2<T>::bounding_box(const vector2<T>* points, size_t size)noexcept{
+	segment2 ret;
+	ret.set_empty_bounding_box();
+	for(auto p = points, e = points + size; p != e; ++p){
+		using std::min;
+		using std::max;
+		ret.p1 = min(ret.p1, *p);
+		ret.p2 = max(ret.p2, *p);
+	}
+	return ret;
+}
+
+template <class T> bool segment2<T>::clip(const rectangle<T>& rect)noexcept{
+	// parameters of the clipped segment are calculated in floating point also for integer component type
+	typedef typename std::conditional<std::is_floating_point<T>::value, T, double>::type real;
+
+	real x1 = real(this->p1.x());
+	real y1 = real(this->p1.y());
+	real dx = real(this->p2.x()) - x1;
+	real dy = real(this->p2.y()) - y1;
+
+	// Liang-Barsky: the segment is p1 + t * d, 0 <= t <= 1, for each rectangle edge p * t <= q
+	const real p[] = {-dx, dx, -dy, dy};
+	const real q[] = {
+		x1 - real(rect.p.x()),
+		real(rect.x2()) - x1,
+		y1 - real(rect.p.y()),
+		real(rect.y2()) - y1
+	};
+
+	real t0 = 0;
+	real t1 = 1;
+	for(unsigned i = 0; i != 4; ++i){
+		if(p[i] == 0){
+			// segment is parallel to the edge
+			if(q[i] < 0){
+				return false;
+			}
+			continue;
+		}
+		real r = q[i] / p[i];
+		if(p[i] < 0){
+			if(r > t0){
+				t0 = r;
+			}
+		}else{
+			if(r < t1){
+				t1 = r;
+			}
+		}
+	}
+
+	if(t0 > t1){
+		return false;
+	}
+
+	auto to_t = [](real v){
+		if(std::is_floating_point<T>::value){
+			return T(v);
+		}
+		using std::round;
+		return T(round(v));
+	};
+
+	vector2<T> clipped_p1(this->p1);
+	if(t0 > 0){
+		clipped_p1 = vector2<T>(to_t(x1 + t0 * dx), to_t(y1 + t0 * dy));
+	}
+	if(t1 < 1){
+		this->p2 = vector2<T>(to_t(x1 + t1 * dx), to_t(y1 + t1 * dy));
+	}
+	this->p1 = clipped_p1;
+	return true;
+}
+
+template <class T> size_t segment2<T>::clip(const segment2* src, size_t size, const rectangle<T>& rect, segment2* dst)noexcept{
+	auto out = dst;
+	for(auto e = src + size; src != e; ++src){
+		segment2 s = *src;
+		if(s.clip(rect)){
+			*out = s;
+			++out;
+		}
+	}
+	return size_t(out - dst);
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of segment2<float> batch operations
+
+template <> inline segment2<float> segment2<float>::bounding_box(const vector2<float>* points, size_t size)noexcept{
+	segment2 ret;
+	ret.set_empty_bounding_box();
+
+	auto p = reinterpret_cast<const float*>(points);
+
+	size_t i = 0;
+	if(size >= 4){
+		// each register holds two points (x, y, x, y), two pairs of accumulators to hide latency
+		auto min0 = simd::load(p);
+		auto max0 = min0;
+		auto min1 = simd::load(p + 4);
+		auto max1 = min1;
+		for(i = 4; i + 4 <= size; i += 4){
+			auto a = simd::load(p + i * 2);
+			auto b = simd::load(p + i * 2 + 4);
+			min0 = simd::min(min0, a);
+			max0 = simd::max(max0, a);
+			min1 = simd::min(min1, b);
+			max1 = simd::max(max1, b);
+		}
+		float mn[4];
+		float mx[4];
+		simd::store(mn, simd::min(min0, min1));
+		simd::store(mx, simd::max(max0, max1));
+		using std::min;
+		using std::max;
+		ret.p1 = vector2<float>(min(mn[0], mn[2]), min(mn[1], mn[3]));
+		ret.p2 = vector2<float>(max(mx[0], mx[2]), max(mx[1], mx[3]));
+	}
+	for(; i != size; ++i){
+		ret.p1 = min(ret.p1, points[i]);
+		ret.p2 = max(ret.p2, points[i]);
+	}
+	return ret;
+}
+
+template <> inline size_t segment2<float>::clip(const segment2* src, size_t size, const rectangle<float>& rect, segment2* dst)noexcept{
+	const auto zero = simd::splat(0.0f);
+	const auto one = simd::splat(1.0f);
+	const auto inf = simd::splat(std::numeric_limits<float>::infinity());
+	const auto neg_inf = simd::negate(inf);
+
+	const auto x_min = simd::splat(rect.p.x());
+	const auto y_min = simd::splat(rect.p.y());
+	const auto x_max = simd::splat(rect.x2());
+	const auto y_max = simd::splat(rect.y2());
+
+	auto out = dst;
+
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4){
+		// each segment is (x1, y1, x2, y2), transpose 4 segments to get the components in separate registers
+		auto s = reinterpret_cast<const float*>(src + i);
+		simd::float4 x1 = simd::load(s), y1 = simd::load(s + 4), x2 = simd::load(s + 8), y2 = simd::load(s + 12);
+		simd::transpose(x1, y1, x2, y2);
+
+		auto dx = simd::sub(x2, x1);
+		auto dy = simd::sub(y2, y1);
+
+		auto t0 = zero;
+		auto t1 = one;
+
+		const simd::float4 p[] = {simd::negate(dx), dx, simd::negate(dy), dy};
+		const simd::float4 q[] = {simd::sub(x1, x_min), simd::sub(x_max, x1), simd::sub(y1, y_min), simd::sub(y_max, y1)};
+
+		unsigned rejected = 0;
+		for(unsigned k = 0; k != 4; ++k){
+			auto r = simd::div(q[k], p[k]);
+			auto p_neg = simd::cmp_lt(p[k], zero);
+			auto p_pos = simd::cmp_lt(zero, p[k]);
+			// segment parallel to the edge and outside of it, also for such lanes r is infinite or NaN and is not selected below
+			rejected |= simd::mask_bits(simd::and_mask(simd::cmp_eq(p[k], zero), simd::cmp_lt(q[k], zero)));
+			t0 = simd::max(t0, simd::select(p_neg, r, neg_inf));
+			t1 = simd::min(t1, simd::select(p_pos, r, inf));
+		}
+
+		unsigned visible = ~rejected & simd::mask_bits(simd::cmp_le(t0, t1));
+		if(visible == 0){
+			continue;
+		}
+
+		// t0 is 0 and t1 is 1 for unclipped end points, so these are calculated exactly
+		auto nx1 = simd::mul_add(t0, dx, x1);
+		auto ny1 = simd::mul_add(t0, dy, y1);
+		auto nx2 = simd::select(simd::cmp_lt(t1, one), simd::mul_add(t1, dx, x1), x2);
+		auto ny2 = simd::select(simd::cmp_lt(t1, one), simd::mul_add(t1, dy, y1), y2);
+		simd::transpose(nx1, ny1, nx2, ny2);
+
+		const simd::float4 clipped[] = {nx1, ny1, nx2, ny2};
+		for(unsigned k = 0; k != 4; ++k){
+			if(visible & (1 << k)){
+				simd::store(reinterpret_cast<float*>(out), clipped[k]);
+				++out;
+			}
+		}
+	}
+
+	for(; i != size; ++i){
+		segment2 s = src[i];
+		if(s.clip(rect)){
+			*out = s;
+			++out;
+		}
+	}
+
+	return size_t(out - dst);
+}
+
+#endif
+
+static_assert(sizeof(segment2<float>) == sizeof(float) * 4, "size mismatch");
+static_assert(sizeof(segment2<double>) == sizeof(double) * 4, "size mismatch");
+
 }
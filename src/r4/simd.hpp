@@ -0,0 +1,1281 @@
+#pragma once
+
+// Compile-time selection of SIMD backend.
+// The backend is selected according to the instruction sets enabled for the compiler,
+// i.e. -msse4.1, -mavx, -mfpu=neon etc. Defining R4_NO_SIMD before including any r4 header
+// forces the scalar fallback.
+#if defined(R4_NO_SIMD)
+#elif defined(__AVX__)
+#	define R4_SIMD_AVX
+#	define R4_SIMD_SSE4_1
+#	define R4_SIMD_SSE2
+#elif defined(__SSE4_1__)
+#	define R4_SIMD_SSE4_1
+#	define R4_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define R4_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define R4_SIMD_NEON
+#endif
+
+#if defined(R4_SIMD_SSE2) || defined(R4_SIMD_NEON)
+#	define R4_SIMD
+#endif
+
+#if defined(R4_SIMD_AVX)
+#	include <immintrin.h>
+#elif defined(R4_SIMD_SSE4_1)
+#	include <smmintrin.h>
+#elif defined(R4_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(R4_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
+#ifdef R4_SIMD
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace r4{
+
+/**
+ * @brief Thin wrappers around platform specific SIMD intrinsics.
+ * Only float operations needed by r4 are wrapped.
+ * These are implementation details of r4 and are not intended for use by library users.
+ */
+namespace simd{
+
+#if defined(R4_SIMD_SSE2)
+typedef __m128 float4;
+#elif defined(R4_SIMD_NEON)
+typedef float32x4_t float4;
+#endif
+
+/**
+ * @brief Load 4 floats from unaligned memory.
+ */
+inline float4 load(const float* p)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_loadu_ps(p);
+#elif defined(R4_SIMD_NEON)
+	return vld1q_f32(p);
+#endif
+}
+
+/**
+ * @brief Store 4 floats to unaligned memory.
+ */
+inline void store(float* p, float4 v)noexcept{
+#if defined(R4_SIMD_SSE2)
+	_mm_storeu_ps(p, v);
+#elif defined(R4_SIMD_NEON)
+	vst1q_f32(p, v);
+#endif
+}
+
+/**
+ * @brief Broadcast scalar to all 4 lanes.
+ */
+inline float4 splat(float f)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_set1_ps(f);
+#elif defined(R4_SIMD_NEON)
+	return vdupq_n_f32(f);
+#endif
+}
+
+/**
+ * @brief Broadcast given lane to all 4 lanes.
+ */
+template <unsigned lane> float4 splat(float4 v)noexcept{
+	static_assert(lane < 4, "lane index out of range");
+#if defined(R4_SIMD_SSE2)
+	return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+#elif defined(R4_SIMD_NEON)
+	return vdupq_n_f32(vgetq_lane_f32(v, lane));
+#endif
+}
+
+inline float4 add(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_add_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vaddq_f32(a, b);
+#endif
+}
+
+inline float4 sub(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_sub_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vsubq_f32(a, b);
+#endif
+}
+
+inline float4 mul(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_mul_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vmulq_f32(a, b);
+#endif
+}
+
+inline float4 div(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_div_ps(a, b);
+#elif defined(R4_SIMD_NEON) && defined(__aarch64__)
+	return vdivq_f32(a, b);
+#elif defined(R4_SIMD_NEON)
+	// armv7 NEON has no division instruction, refine reciprocal estimate with two Newton-Raphson steps
+	float32x4_t r = vrecpeq_f32(b);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	return vmulq_f32(a, r);
+#endif
+}
+
+/**
+ * @brief Multiply and add.
+ * @return a * b + c.
+ */
+inline float4 mul_add(float4 a, float4 b, float4 c)noexcept{
+#if defined(R4_SIMD_SSE2) && defined(__FMA__)
+	return _mm_fmadd_ps(a, b, c);
+#elif defined(R4_SIMD_SSE2)
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#elif defined(R4_SIMD_NEON) && defined(__aarch64__)
+	return vfmaq_f32(c, a, b);
+#elif defined(R4_SIMD_NEON)
+	return vmlaq_f32(c, a, b);
+#endif
+}
+
+inline float4 min(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_min_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vminq_f32(a, b);
+#endif
+}
+
+inline float4 max(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_max_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vmaxq_f32(a, b);
+#endif
+}
+
+inline float4 negate(float4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_xor_ps(a, _mm_set1_ps(-0.0f));
+#elif defined(R4_SIMD_NEON)
+	return vnegq_f32(a);
+#endif
+}
+
+inline float4 sqrt(float4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_sqrt_ps(a);
+#elif defined(R4_SIMD_NEON) && defined(__aarch64__)
+	return vsqrtq_f32(a);
+#elif defined(R4_SIMD_NEON)
+	// armv7 NEON has no square root instruction, refine reciprocal square root estimate with two Newton-Raphson steps
+	float32x4_t r = vrsqrteq_f32(a);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+	// sqrt(a) = a * (1 / sqrt(a)), for a = 0 the reciprocal is infinity, so mask the result out
+	return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(a, r)), vmvnq_u32(vceqq_f32(a, vdupq_n_f32(0)))));
+#endif
+}
+
+inline float4 abs(float4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+#elif defined(R4_SIMD_NEON)
+	return vabsq_f32(a);
+#endif
+}
+
+#if defined(R4_SIMD_SSE2)
+typedef __m128i int4;
+#elif defined(R4_SIMD_NEON)
+typedef int32x4_t int4;
+#endif
+
+/**
+ * @brief Load 4 32-bit integers from unaligned memory.
+ */
+inline int4 load_int(const int32_t* p)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+#elif defined(R4_SIMD_NEON)
+	return vld1q_s32(p);
+#endif
+}
+
+/**
+ * @brief Store 4 32-bit integers to unaligned memory.
+ */
+inline void store_int(int32_t* p, int4 v)noexcept{
+#if defined(R4_SIMD_SSE2)
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+#elif defined(R4_SIMD_NEON)
+	vst1q_s32(p, v);
+#endif
+}
+
+/**
+ * @brief Convert floats to integers, truncating towards zero.
+ * The numbers must be in range of int32_t.
+ */
+inline int4 to_int4(float4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cvttps_epi32(a);
+#elif defined(R4_SIMD_NEON)
+	return vcvtq_s32_f32(a);
+#endif
+}
+
+/**
+ * @brief Convert integers to floats.
+ */
+inline float4 to_float4(int4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cvtepi32_ps(a);
+#elif defined(R4_SIMD_NEON)
+	return vcvtq_f32_s32(a);
+#endif
+}
+
+/**
+ * @brief Lane-wise shift left of integers.
+ */
+template <int n> int4 shift_left(int4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_slli_epi32(a, n);
+#elif defined(R4_SIMD_NEON)
+	return vshlq_n_s32(a, n);
+#endif
+}
+
+/**
+ * @brief Lane-wise arithmetic shift right of integers.
+ */
+template <int n> int4 shift_right(int4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_srai_epi32(a, n);
+#elif defined(R4_SIMD_NEON)
+	return vshrq_n_s32(a, n);
+#endif
+}
+
+/**
+ * @brief Lane mask type.
+ * Result of lane-wise comparison, each lane has either all bits set or all bits cleared.
+ */
+#if defined(R4_SIMD_SSE2)
+typedef __m128 mask4;
+#elif defined(R4_SIMD_NEON)
+typedef uint32x4_t mask4;
+#endif
+
+/**
+ * @brief Lane-wise less or equal comparison.
+ */
+inline mask4 cmp_le(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cmple_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vcleq_f32(a, b);
+#endif
+}
+
+/**
+ * @brief Lane-wise less comparison.
+ */
+inline mask4 cmp_lt(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cmplt_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vcltq_f32(a, b);
+#endif
+}
+
+/**
+ * @brief Lane-wise equality comparison.
+ */
+inline mask4 cmp_eq(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cmpeq_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vceqq_f32(a, b);
+#endif
+}
+
+/**
+ * @brief Lane-wise select.
+ * @return for each lane, value from a if the mask lane is set, value from b otherwise.
+ */
+inline float4 select(mask4 m, float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE4_1)
+	return _mm_blendv_ps(b, a, m);
+#elif defined(R4_SIMD_SSE2)
+	return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+#elif defined(R4_SIMD_NEON)
+	return vbslq_f32(m, a, b);
+#endif
+}
+
+/**
+ * @brief Round to nearest integer, halfway cases are rounded away from zero.
+ * Gives the same results as std::round() for numbers in range of int32_t.
+ */
+inline float4 round(float4 a)noexcept{
+	// fraction of the truncated number is exact
+	float4 t = to_float4(to_int4(a));
+	float4 away = select(cmp_lt(a, splat(0.0f)), splat(-1.0f), splat(1.0f));
+	return add(t, select(cmp_le(splat(0.5f), abs(sub(a, t))), away, splat(0.0f)));
+}
+
+/**
+ * @brief Lane-wise logical AND of two masks.
+ */
+inline mask4 and_mask(mask4 a, mask4 b)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_and_ps(a, b);
+#elif defined(R4_SIMD_NEON)
+	return vandq_u32(a, b);
+#endif
+}
+
+/**
+ * @brief Get mask bits.
+ * @return integer whose lowest 4 bits are set according to the mask lanes.
+ */
+inline unsigned mask_bits(mask4 m)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return unsigned(_mm_movemask_ps(m));
+#elif defined(R4_SIMD_NEON)
+	// take one bit from every lane and weight it with lane's bit
+	static const uint32_t weights[] = {1, 2, 4, 8};
+	uint32x4_t b = vandq_u32(m, vld1q_u32(weights));
+	uint32x2_t s = vorr_u32(vget_low_u32(b), vget_high_u32(b));
+	return vget_lane_u32(s, 0) | vget_lane_u32(s, 1);
+#endif
+}
+
+/**
+ * @brief Sum of all 4 lanes.
+ */
+inline float sum(float4 a)noexcept{
+#if defined(R4_SIMD_SSE2)
+	// (a0 + a2, a1 + a3, ...)
+	__m128 s = _mm_add_ps(a, _mm_movehl_ps(a, a));
+	// (a0 + a2 + a1 + a3, ...)
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(s);
+#elif defined(R4_SIMD_NEON) && defined(__aarch64__)
+	return vaddvq_f32(a);
+#elif defined(R4_SIMD_NEON)
+	float32x2_t s = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+	return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+
+/**
+ * @brief Dot product of two 4-lane vectors.
+ */
+inline float dot(float4 a, float4 b)noexcept{
+#if defined(R4_SIMD_SSE4_1)
+	return _mm_cvtss_f32(_mm_dp_ps(a, b, 0xf1));
+#else
+	return sum(mul(a, b));
+#endif
+}
+
+/**
+ * @brief Transpose 4x4 matrix given by its rows.
+ */
+inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3)noexcept{
+#if defined(R4_SIMD_SSE2)
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#elif defined(R4_SIMD_NEON)
+	float32x4x2_t t01 = vtrnq_f32(r0, r1);
+	float32x4x2_t t23 = vtrnq_f32(r2, r3);
+	r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#endif
+}
+
+/**
+ * @brief Sums of lanes of 4 vectors.
+ * @return (sum(a), sum(b), sum(c), sum(d)).
+ */
+inline float4 sum4(float4 a, float4 b, float4 c, float4 d)noexcept{
+	transpose(a, b, c, d);
+	return add(add(a, b), add(c, d));
+}
+
+/**
+ * @brief Multiply 4x4 matrix by 4d vector.
+ * Matrix is given by its rows.
+ * @return (r0 * v, r1 * v, r2 * v, r3 * v).
+ */
+inline float4 mat_vec(float4 r0, float4 r1, float4 r2, float4 r3, float4 v)noexcept{
+	return sum4(mul(r0, v), mul(r1, v), mul(r2, v), mul(r3, v));
+}
+
+/**
+ * @brief Multiply row vector by 4x4 matrix.
+ * The matrix is given by its rows. The operation is a linear combination of
+ * the matrix rows with the vector components as coefficients.
+ * @return v * M.
+ */
+inline float4 vec_mat(float4 v, float4 r0, float4 r1, float4 r2, float4 r3)noexcept{
+	float4 ret = mul(splat<0>(v), r0);
+	ret = mul_add(splat<1>(v), r1, ret);
+	ret = mul_add(splat<2>(v), r2, ret);
+	return mul_add(splat<3>(v), r3, ret);
+}
+
+/**
+ * @brief Multiply two 4x4 matrices stored in row-major order.
+ * Output may alias with any of the inputs.
+ * @param out - 16 floats to store the product a * b to.
+ * @param a - 16 floats of the left matrix.
+ * @param b - 16 floats of the right matrix.
+ */
+inline void mat_mul(float* out, const float* a, const float* b)noexcept{
+	// every row of the product is a linear combination of rows of b
+#if defined(R4_SIMD_AVX)
+	__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+	__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+	__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+	__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+	__m256 a01 = _mm256_loadu_ps(a);
+	__m256 a23 = _mm256_loadu_ps(a + 8);
+
+	// two rows of the product per iteration, lane k of each 128 bit half is broadcasted with permute
+	auto row_pair = [&](__m256 ar){
+		__m256 r = _mm256_mul_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+#	if defined(__FMA__)
+		r = _mm256_fmadd_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(1, 1, 1, 1)), b1, r);
+		r = _mm256_fmadd_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(2, 2, 2, 2)), b2, r);
+		r = _mm256_fmadd_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(3, 3, 3, 3)), b3, r);
+#	else
+		r = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(1, 1, 1, 1)), b1), r);
+		r = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(2, 2, 2, 2)), b2), r);
+		r = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(ar, _MM_SHUFFLE(3, 3, 3, 3)), b3), r);
+#	endif
+		return r;
+	};
+
+	__m256 r01 = row_pair(a01);
+	__m256 r23 = row_pair(a23);
+
+	_mm256_storeu_ps(out, r01);
+	_mm256_storeu_ps(out + 8, r23);
+#else
+	float4 b0 = load(b);
+	float4 b1 = load(b + 4);
+	float4 b2 = load(b + 8);
+	float4 b3 = load(b + 12);
+
+	float4 r0 = vec_mat(load(a), b0, b1, b2, b3);
+	float4 r1 = vec_mat(load(a + 4), b0, b1, b2, b3);
+	float4 r2 = vec_mat(load(a + 8), b0, b1, b2, b3);
+	float4 r3 = vec_mat(load(a + 12), b0, b1, b2, b3);
+
+	store(out, r0);
+	store(out + 4, r1);
+	store(out + 8, r2);
+	store(out + 12, r3);
+#endif
+}
+
+/**
+ * @brief Get first lane.
+ */
+inline float first(float4 v)noexcept{
+#if defined(R4_SIMD_SSE2)
+	return _mm_cvtss_f32(v);
+#elif defined(R4_SIMD_NEON)
+	return vgetq_lane_f32(v, 0);
+#endif
+}
+
+/**
+ * @brief Combine lanes of two vectors.
+ * @return (a[i0], a[i1], b[i2], b[i3]).
+ */
+template <unsigned i0, unsigned i1, unsigned i2, unsigned i3> float4 shuffle(float4 a, float4 b)noexcept{
+	static_assert(i0 < 4 && i1 < 4 && i2 < 4 && i3 < 4, "lane index out of range");
+#if defined(R4_SIMD_SSE2)
+	return _mm_shuffle_ps(a, b, _MM_SHUFFLE(i3, i2, i1, i0));
+#elif defined(R4_SIMD_NEON)
+	float32x2_t lo = vset_lane_f32(vgetq_lane_f32(a, i1), vdup_n_f32(vgetq_lane_f32(a, i0)), 1);
+	float32x2_t hi = vset_lane_f32(vgetq_lane_f32(b, i3), vdup_n_f32(vgetq_lane_f32(b, i2)), 1);
+	return vcombine_f32(lo, hi);
+#endif
+}
+
+/**
+ * @brief Rearrange lanes of a vector.
+ * @return (v[i0], v[i1], v[i2], v[i3]).
+ */
+template <unsigned i0, unsigned i1, unsigned i2, unsigned i3> float4 swizzle(float4 v)noexcept{
+	return shuffle<i0, i1, i2, i3>(v, v);
+}
+
+// 2x2 matrices below are packed to a single float4 in row-major order, (m00, m01, m10, m11)
+
+// a * b
+inline float4 mat2_mul(float4 a, float4 b)noexcept{
+	return add(mul(a, swizzle<0, 3, 0, 3>(b)), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// adj(a) * b
+inline float4 mat2_adj_mul(float4 a, float4 b)noexcept{
+	return sub(mul(swizzle<3, 3, 0, 0>(a), b), mul(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
+
+// a * adj(b)
+inline float4 mat2_mul_adj(float4 a, float4 b)noexcept{
+	return sub(mul(a, swizzle<3, 0, 3, 0>(b)), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+/**
+ * @brief Multiply two 3x3 matrices stored in row-major order.
+ * The matrices are loaded and stored with non-overlapping accesses, so that the result
+ * can be read right away without stalls on store forwarding.
+ * Output may alias with any of the inputs.
+ * @param out - 9 floats to store the product a * b to.
+ * @param a - 9 floats of the left matrix.
+ * @param b - 9 floats of the right matrix.
+ */
+inline void mat3_mul(float* out, const float* a, const float* b)noexcept{
+	float4 v0 = load(b);
+	float4 v1 = load(b + 4);
+	float4 v2 = splat(b[8]);
+
+	// rows of b, the last lane is ignored
+	float4 b0 = v0;
+	float4 b1 = shuffle<0, 2, 1, 1>(shuffle<3, 3, 0, 0>(v0, v1), v1);
+	float4 b2 = shuffle<2, 3, 0, 0>(v1, v2);
+
+	// every row of the product is a linear combination of rows of b
+	auto row = [&](const float* ar){
+		return mul_add(splat(ar[2]), b2, mul_add(splat(ar[1]), b1, mul(splat(ar[0]), b0)));
+	};
+
+	float4 r0 = row(a);
+	float4 r1 = row(a + 3);
+	float4 r2 = row(a + 6);
+
+	store(out, shuffle<0, 1, 0, 2>(r0, shuffle<2, 2, 0, 0>(r0, r1)));
+	store(out + 4, shuffle<1, 2, 0, 1>(r1, r2));
+	out[8] = first(swizzle<2, 2, 2, 2>(r2));
+}
+
+/**
+ * @brief Multiply two 2x3 affine matrices stored in row-major order.
+ * The matrices are thought of as 3x3 matrices with the last row (0, 0, 1).
+ * Output may alias with any of the inputs.
+ * @param out - 6 floats to store the product a * b to.
+ * @param a - 6 floats of the left matrix.
+ * @param b - 6 floats of the right matrix.
+ */
+inline void mat23_mul(float* out, const float* a, const float* b)noexcept{
+	float4 v = load(b);
+
+	// rows of b, the last lane is ignored, the third row of b is (0, 0, 1)
+	float4 b0 = v;
+	float4 b1 = shuffle<0, 2, 0, 0>(shuffle<3, 3, 0, 0>(v, splat(b[4])), splat(b[5]));
+
+	const float4 zero = splat(0.0f);
+
+	auto row = [&](const float* ar){
+		// (0, 0, ar[2]) is the contribution of the translation component of a
+		return mul_add(splat(ar[1]), b1, mul_add(splat(ar[0]), b0, shuffle<0, 0, 0, 0>(zero, splat(ar[2]))));
+	};
+
+	float4 r0 = row(a);
+	float4 r1 = row(a + 3);
+
+	store(out, shuffle<0, 1, 0, 2>(r0, shuffle<2, 2, 0, 0>(r0, r1)));
+	out[4] = first(swizzle<1, 1, 1, 1>(r1));
+	out[5] = first(swizzle<2, 2, 2, 2>(r1));
+}
+
+/**
+ * @brief Invert 4x4 matrix stored in row-major order.
+ * The matrix is split to 2x2 blocks
+ *     |A B|
+ *     |C D|
+ * and the inverse is calculated blockwise, sharing 2x2 adjugate products between the blocks.
+ * Output may alias with the input.
+ * In case the matrix is singular the output is undefined.
+ * @param out - 16 floats to store the inverse matrix to.
+ * @param m - 16 floats of the matrix to invert.
+ * @return determinant of the matrix.
+ */
+inline float mat_inv(float* out, const float* m)noexcept{
+	float4 r0 = load(m);
+	float4 r1 = load(m + 4);
+	float4 r2 = load(m + 8);
+	float4 r3 = load(m + 12);
+
+	float4 a = shuffle<0, 1, 0, 1>(r0, r1);
+	float4 b = shuffle<2, 3, 2, 3>(r0, r1);
+	float4 c = shuffle<0, 1, 0, 1>(r2, r3);
+	float4 d = shuffle<2, 3, 2, 3>(r2, r3);
+
+	// (det(A), det(B), det(C), det(D))
+	float4 det_sub = sub(
+			mul(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+			mul(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3))
+		);
+	float4 det_a = splat<0>(det_sub);
+	float4 det_b = splat<1>(det_sub);
+	float4 det_c = splat<2>(det_sub);
+	float4 det_d = splat<3>(det_sub);
+
+	float4 d_c = mat2_adj_mul(d, c);
+	float4 a_b = mat2_adj_mul(a, b);
+
+	// adjugates of the blocks of the inverse matrix
+	float4 x = sub(mul(det_d, a), mat2_mul(b, d_c));
+	float4 w = sub(mul(det_a, d), mat2_mul(c, a_b));
+	float4 y = sub(mul(det_b, c), mat2_mul_adj(d, a_b));
+	float4 z = sub(mul(det_c, b), mat2_mul_adj(a, d_c));
+
+	// det(M) = det(A) * det(D) + det(B) * det(C) - tr(adj(A) * B * adj(D) * C)
+	float4 det = sub(
+			add(mul(det_a, det_d), mul(det_b, det_c)),
+			splat(sum(mul(a_b, swizzle<0, 2, 1, 3>(d_c))))
+		);
+
+	float4 rdet = div(
+#if defined(R4_SIMD_SSE2)
+			_mm_setr_ps(1, -1, -1, 1),
+#elif defined(R4_SIMD_NEON)
+			vcombine_f32(vcreate_f32(0xbf8000003f800000ull), vcreate_f32(0x3f800000bf800000ull)),
+#endif
+			det
+		);
+
+	x = mul(x, rdet);
+	y = mul(y, rdet);
+	z = mul(z, rdet);
+	w = mul(w, rdet);
+
+	// undo the adjugate and arrange the blocks to rows
+	store(out, shuffle<3, 1, 3, 1>(x, y));
+	store(out + 4, shuffle<2, 0, 2, 0>(x, y));
+	store(out + 8, shuffle<3, 1, 3, 1>(z, w));
+	store(out + 12, shuffle<2, 0, 2, 0>(z, w));
+
+	return first(det);
+}
+
+/**
+ * @brief Load four packed 2d points and deinterleave them.
+ * @param p - 8 floats, (x0, y0, x1, y1, ...).
+ * @param x - receives (x0, x1, x2, x3).
+ * @param y - receives (y0, y1, y2, y3).
+ */
+inline void load2(const float* p, float4& x, float4& y)noexcept{
+#if defined(R4_SIMD_SSE2)
+	__m128 p0 = _mm_loadu_ps(p);
+	__m128 p1 = _mm_loadu_ps(p + 4);
+	x = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+	y = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+#elif defined(R4_SIMD_NEON)
+	float32x4x2_t v = vld2q_f32(p);
+	x = v.val[0];
+	y = v.val[1];
+#endif
+}
+
+/**
+ * @brief Interleave and store four 2d points.
+ * Inverse of load2().
+ */
+inline void store2(float* p, float4 x, float4 y)noexcept{
+#if defined(R4_SIMD_SSE2)
+	_mm_storeu_ps(p, _mm_unpacklo_ps(x, y));
+	_mm_storeu_ps(p + 4, _mm_unpackhi_ps(x, y));
+#elif defined(R4_SIMD_NEON)
+	float32x4x2_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	vst2q_f32(p, v);
+#endif
+}
+
+/**
+ * @brief Load four packed 3d points and deinterleave them.
+ * @param p - 12 floats, (x0, y0, z0, x1, y1, z1, ...).
+ * @param x - receives (x0, x1, x2, x3).
+ * @param y - receives (y0, y1, y2, y3).
+ * @param z - receives (z0, z1, z2, z3).
+ */
+inline void load3(const float* p, float4& x, float4& y, float4& z)noexcept{
+#if defined(R4_SIMD_SSE2)
+	__m128 p0 = _mm_loadu_ps(p); // x0 y0 z0 x1
+	__m128 p1 = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+	__m128 p2 = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+
+	__m128 t1 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+	__m128 t2 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+
+	x = _mm_shuffle_ps(p0, t1, _MM_SHUFFLE(2, 0, 3, 0));
+	y = _mm_shuffle_ps(t2, t1, _MM_SHUFFLE(3, 1, 2, 0));
+	z = _mm_shuffle_ps(t2, p2, _MM_SHUFFLE(3, 0, 3, 1));
+#elif defined(R4_SIMD_NEON)
+	float32x4x3_t v = vld3q_f32(p);
+	x = v.val[0];
+	y = v.val[1];
+	z = v.val[2];
+#endif
+}
+
+/**
+ * @brief Interleave and store four 3d points.
+ * Inverse of load3().
+ */
+inline void store3(float* p, float4 x, float4 y, float4 z)noexcept{
+#if defined(R4_SIMD_SSE2)
+	__m128 xy01 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0)); // x0 x1 y0 y1
+	__m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(2, 1, 1, 0)); // z0 z1 x1 x2
+	__m128 yz12 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(2, 1, 2, 1)); // y1 y2 z1 z2
+	__m128 xy23 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 2, 3, 2)); // x2 x3 y2 y3
+	__m128 zx3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 3, 2)); // z2 z3 x3 x3
+	__m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+
+	_mm_storeu_ps(p, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(p + 4, _mm_shuffle_ps(yz12, xy23, _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(p + 8, _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+#elif defined(R4_SIMD_NEON)
+	float32x4x3_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	v.val[2] = z;
+	vst3q_f32(p, v);
+#endif
+}
+
+/**
+ * @brief Transform block of four packed points by 4x4 matrix.
+ * Points of dimension 2 are thought of as (x, y, 0, 1), points of dimension 3 are thought of as (x, y, z, 1).
+ * @param dim - dimension of the points, 2 or 3. For 4d points use transform_points4().
+ * @param divide - whether to do perspective divide of the transformed points.
+ * @param m - 16 matrix elements in row-major order, each broadcasted to all 4 lanes.
+ * @param src - 4 * dim floats of source points.
+ * @param dst - 4 * dim floats to store the transformed points to, can be the same as src.
+ */
+template <unsigned dim, bool divide> void transform_block(const float4* m, const float* src, float* dst)noexcept{
+	static_assert(dim == 2 || dim == 3, "unsupported dimension");
+
+	float4 x, y, z;
+	if(dim == 2){
+		load2(src, x, y);
+	}else{
+		load3(src, x, y, z);
+	}
+
+	// NOTE: the 'dim' is known at compile time, so the compiler will eliminate the branches
+	auto row = [&](unsigned r){
+		float4 ret = mul_add(m[r * 4 + 1], y, mul_add(m[r * 4], x, m[r * 4 + 3]));
+		if(dim == 3){
+			ret = mul_add(m[r * 4 + 2], z, ret);
+		}
+		return ret;
+	};
+
+	float4 rx = row(0);
+	float4 ry = row(1);
+	float4 rz;
+	if(dim == 3 || divide){
+		rz = row(2);
+	}
+	if(divide){
+		float4 rw = row(3);
+		rx = div(rx, rw);
+		ry = div(ry, rw);
+		rz = div(rz, rw);
+	}
+
+	if(dim == 2){
+		store2(dst, rx, ry);
+	}else{
+		store3(dst, rx, ry, rz);
+	}
+}
+
+/**
+ * @brief Transform packed points by 4x4 matrix.
+ * Points of dimension 2 are thought of as (x, y, 0, 1), points of dimension 3 are thought of as (x, y, z, 1).
+ * @param dim - dimension of the points, 2 or 3. For 4d points use transform_points4().
+ * @param divide - whether to do perspective divide of the transformed points.
+ * @param m - 16 floats of the matrix in row-major order.
+ * @param src - source points.
+ * @param dst - destination points, can be the same as src, but otherwise the ranges must not overlap.
+ * @param size - number of points.
+ */
+template <unsigned dim, bool divide> void transform_points(const float* m, const float* src, float* dst, size_t size)noexcept{
+	float4 mm[16];
+	for(unsigned i = 0; i != 16; ++i){
+		mm[i] = splat(m[i]);
+	}
+
+	// process blocks of 4 points
+	const float* end = src + (size & ~size_t(3)) * dim;
+	for(; src != end; src += 4 * dim, dst += 4 * dim){
+		transform_block<dim, divide>(mm, src, dst);
+	}
+
+	// process remaining points through zero padded buffer
+	if(size_t rest = (size & 3) * dim){
+		float buf[4 * dim] = {0};
+		std::copy(src, src + rest, buf);
+		transform_block<dim, divide>(mm, buf, buf);
+		std::copy(buf, buf + rest, dst);
+	}
+}
+
+/**
+ * @brief Transform packed 4d points by 4x4 matrix.
+ * @param divide - whether to do perspective divide of the transformed points.
+ * @param m - 16 floats of the matrix in row-major order.
+ * @param src - source points.
+ * @param dst - destination points, can be the same as src, but otherwise the ranges must not overlap.
+ * @param size - number of points.
+ */
+template <bool divide> void transform_points4(const float* m, const float* src, float* dst, size_t size)noexcept{
+	// transformed vector is a linear combination of the matrix columns
+	float4 c0 = load(m);
+	float4 c1 = load(m + 4);
+	float4 c2 = load(m + 8);
+	float4 c3 = load(m + 12);
+	transpose(c0, c1, c2, c3);
+
+	for(const float* end = src + size * 4; src != end; src += 4, dst += 4){
+		float4 v = vec_mat(load(src), c0, c1, c2, c3);
+		if(divide){
+			v = div(v, splat<3>(v));
+		}
+		store(dst, v);
+	}
+}
+
+/**
+ * @brief Rotate block of four packed 3d points by unit quaternion.
+ * @param q - quaternion components (x, y, z, w), each broadcasted to all 4 lanes.
+ * @param src - 12 floats of source points.
+ * @param dst - 12 floats to store the rotated points to, can be the same as src.
+ */
+inline void rotate_block(const float4* q, const float* src, float* dst)noexcept{
+	float4 x, y, z;
+	load3(src, x, y, z);
+
+	// t = 2 * (u x v), u = (q.x, q.y, q.z)
+	float4 tx = sub(mul(q[1], z), mul(q[2], y));
+	float4 ty = sub(mul(q[2], x), mul(q[0], z));
+	float4 tz = sub(mul(q[0], y), mul(q[1], x));
+	tx = add(tx, tx);
+	ty = add(ty, ty);
+	tz = add(tz, tz);
+
+	// v' = v + w * t + u x t
+	x = mul_add(q[3], tx, add(x, sub(mul(q[1], tz), mul(q[2], ty))));
+	y = mul_add(q[3], ty, add(y, sub(mul(q[2], tx), mul(q[0], tz))));
+	z = mul_add(q[3], tz, add(z, sub(mul(q[0], ty), mul(q[1], tx))));
+
+	store3(dst, x, y, z);
+}
+
+/**
+ * @brief Rotate packed 3d points by unit quaternion.
+ * @param q - 4 floats of the quaternion, (x, y, z, w).
+ * @param src - source points.
+ * @param dst - destination points, can be the same as src, but otherwise the ranges must not overlap.
+ * @param size - number of points.
+ */
+inline void rotate_points(const float* q, const float* src, float* dst, size_t size)noexcept{
+	float4 qq[4];
+	for(unsigned i = 0; i != 4; ++i){
+		qq[i] = splat(q[i]);
+	}
+
+	// process blocks of 4 points
+	const float* end = src + (size & ~size_t(3)) * 3;
+	for(; src != end; src += 4 * 3, dst += 4 * 3){
+		rotate_block(qq, src, dst);
+	}
+
+	// process remaining points through zero padded buffer
+	if(size_t rest = (size & 3) * 3){
+		float buf[4 * 3] = {0};
+		std::copy(src, src + rest, buf);
+		rotate_block(qq, buf, buf);
+		std::copy(buf, buf + rest, dst);
+	}
+}
+
+/**
+ * @brief Interpolate block of four pairs of packed quaternions.
+ * See interpolate().
+ */
+template <bool normalized> void interpolate_block(const float* a, const float* b, const float* t, float* dst)noexcept{
+	float4 ax = load(a);
+	float4 ay = load(a + 4);
+	float4 az = load(a + 8);
+	float4 aw = load(a + 12);
+	transpose(ax, ay, az, aw);
+
+	float4 bx = load(b);
+	float4 by = load(b + 4);
+	float4 bz = load(b + 8);
+	float4 bw = load(b + 12);
+	transpose(bx, by, bz, bw);
+
+	float4 cosalpha = mul_add(aw, bw, mul_add(az, bz, mul_add(ay, by, mul(ax, bx))));
+
+	// shortest path
+	mask4 negative = cmp_lt(cosalpha, splat(0));
+	cosalpha = abs(cosalpha);
+
+	float4 one = splat(1);
+	float4 tt = load(t);
+	float4 d = sub(one, tt);
+
+	float4 sc1, sc2;
+	if(normalized){
+		sc1 = d;
+		sc2 = tt;
+	}else{
+		// see quaternion::slerp(from, to, t, dst, size) for the details of the approximation
+		const unsigned num_terms = 12;
+		const float mu = 1.894f;
+
+		float4 xm1 = sub(cosalpha, one);
+		float4 t2 = mul(tt, tt);
+		float4 d2 = mul(d, d);
+
+		sc1 = one;
+		sc2 = one;
+		for(unsigned i = num_terms; i != 0; --i){
+			float m = i == num_terms ? mu : 1;
+			float4 u = splat(m / float(i * (2 * i + 1)));
+			float4 v = splat(m * float(i) / float(2 * i + 1));
+			sc1 = mul_add(mul(sub(mul(u, d2), v), xm1), sc1, one);
+			sc2 = mul_add(mul(sub(mul(u, t2), v), xm1), sc2, one);
+		}
+		sc1 = mul(sc1, d);
+		sc2 = mul(sc2, tt);
+	}
+	sc2 = select(negative, negate(sc2), sc2);
+
+	float4 x = mul_add(bx, sc2, mul(ax, sc1));
+	float4 y = mul_add(by, sc2, mul(ay, sc1));
+	float4 z = mul_add(bz, sc2, mul(az, sc1));
+	float4 w = mul_add(bw, sc2, mul(aw, sc1));
+
+	if(normalized){
+		float4 n = sqrt(mul_add(w, w, mul_add(z, z, mul_add(y, y, mul(x, x)))));
+		x = div(x, n);
+		y = div(y, n);
+		z = div(z, n);
+		w = div(w, n);
+	}
+
+	transpose(x, y, z, w);
+	store(dst, x);
+	store(dst + 4, y);
+	store(dst + 8, z);
+	store(dst + 12, w);
+}
+
+/**
+ * @brief Interpolate pairs of packed quaternions.
+ * @param normalized - if true, then normalized linear interpolation is done, otherwise
+ *                     spherical linear interpolation is done.
+ * @param a - quaternions to interpolate from.
+ * @param b - quaternions to interpolate to.
+ * @param t - interpolation parameters.
+ * @param dst - interpolated quaternions, can be the same as a or b, but otherwise the ranges must not overlap.
+ * @param size - number of quaternions.
+ */
+template <bool normalized> void interpolate(const float* a, const float* b, const float* t, float* dst, size_t size)noexcept{
+	// process blocks of 4 quaternions
+	const float* end = a + (size & ~size_t(3)) * 4;
+	for(; a != end; a += 4 * 4, b += 4 * 4, t += 4, dst += 4 * 4){
+		interpolate_block<normalized>(a, b, t, dst);
+	}
+
+	// process remaining quaternions through padded buffers
+	if(size_t rest = size & 3){
+		// padding quaternions are identity quaternions to avoid division by zero when normalizing
+		float buf_a[4 * 4] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+		float buf_b[4 * 4] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+		float buf_t[4] = {0};
+		std::copy(a, a + rest * 4, buf_a);
+		std::copy(b, b + rest * 4, buf_b);
+		std::copy(t, t + rest, buf_t);
+		interpolate_block<normalized>(buf_a, buf_b, buf_t, buf_a);
+		std::copy(buf_a, buf_a + rest * 4, dst);
+	}
+}
+
+/**
+ * @brief Blend dual quaternions and transform block of four packed 3d points by them.
+ * For each point the dual quaternions of the bones influencing the point are gathered
+ * and blended, so that four points are processed in parallel, each lane holding one point.
+ * See dual_quaternion::skin() for the details.
+ * @param bones - dual quaternions of the bones, 8 floats each, (real x, y, z, w, dual x, y, z, w).
+ * @param indices - bone indices, 'influences' indices for each of the four points.
+ * @param weights - bone weights, 'influences' weights for each of the four points.
+ * @param influences - number of bones influencing each point, must be greater than 0.
+ * @param src - 12 floats of source points.
+ * @param dst - 12 floats to store the transformed points to, can be the same as src.
+ */
+inline void skin_block(const float* bones, const unsigned* indices, const float* weights, unsigned influences, const float* src, float* dst)noexcept{
+	// gather real and dual parts of k-th bone of each of the four points
+	auto gather = [&](unsigned k, float4* r, float4* d, float4& w){
+		const float* b0 = bones + 8 * size_t(indices[k]);
+		const float* b1 = bones + 8 * size_t(indices[influences + k]);
+		const float* b2 = bones + 8 * size_t(indices[2 * influences + k]);
+		const float* b3 = bones + 8 * size_t(indices[3 * influences + k]);
+
+		r[0] = load(b0);
+		r[1] = load(b1);
+		r[2] = load(b2);
+		r[3] = load(b3);
+		transpose(r[0], r[1], r[2], r[3]);
+
+		d[0] = load(b0 + 4);
+		d[1] = load(b1 + 4);
+		d[2] = load(b2 + 4);
+		d[3] = load(b3 + 4);
+		transpose(d[0], d[1], d[2], d[3]);
+
+		float ww[4] = {weights[k], weights[influences + k], weights[2 * influences + k], weights[3 * influences + k]};
+		w = load(ww);
+	};
+
+	float4 r[4], d[4], w;
+	gather(0, r, d, w);
+
+	// real part of the first bone, the rest of the bones are taken from the same hemisphere
+	float4 f[4] = {r[0], r[1], r[2], r[3]};
+
+	float4 br[4], bd[4];
+	for(unsigned i = 0; i != 4; ++i){
+		br[i] = mul(r[i], w);
+		bd[i] = mul(d[i], w);
+	}
+
+	for(unsigned k = 1; k != influences; ++k){
+		gather(k, r, d, w);
+
+		float4 cosalpha = mul_add(f[3], r[3], mul_add(f[2], r[2], mul_add(f[1], r[1], mul(f[0], r[0]))));
+		w = select(cmp_lt(cosalpha, splat(0)), negate(w), w);
+
+		for(unsigned i = 0; i != 4; ++i){
+			br[i] = mul_add(r[i], w, br[i]);
+			bd[i] = mul_add(d[i], w, bd[i]);
+		}
+	}
+
+	// normalize
+	float4 n = sqrt(mul_add(br[3], br[3], mul_add(br[2], br[2], mul_add(br[1], br[1], mul(br[0], br[0])))));
+	n = div(splat(1), n);
+	for(unsigned i = 0; i != 4; ++i){
+		br[i] = mul(br[i], n);
+		bd[i] = mul(bd[i], n);
+	}
+
+	// translation t = 2 * (real.w * dual.xyz - dual.w * real.xyz + real.xyz x dual.xyz)
+	float4 tx = sub(mul(br[1], bd[2]), mul(br[2], bd[1]));
+	float4 ty = sub(mul(br[2], bd[0]), mul(br[0], bd[2]));
+	float4 tz = sub(mul(br[0], bd[1]), mul(br[1], bd[0]));
+	tx = mul_add(br[3], bd[0], sub(tx, mul(bd[3], br[0])));
+	ty = mul_add(br[3], bd[1], sub(ty, mul(bd[3], br[1])));
+	tz = mul_add(br[3], bd[2], sub(tz, mul(bd[3], br[2])));
+	tx = add(tx, tx);
+	ty = add(ty, ty);
+	tz = add(tz, tz);
+
+	float4 x, y, z;
+	load3(src, x, y, z);
+
+	// rotate by real part, see rotate_block()
+	float4 ux = sub(mul(br[1], z), mul(br[2], y));
+	float4 uy = sub(mul(br[2], x), mul(br[0], z));
+	float4 uz = sub(mul(br[0], y), mul(br[1], x));
+	ux = add(ux, ux);
+	uy = add(uy, uy);
+	uz = add(uz, uz);
+
+	x = mul_add(br[3], ux, add(add(x, tx), sub(mul(br[1], uz), mul(br[2], uy))));
+	y = mul_add(br[3], uy, add(add(y, ty), sub(mul(br[2], ux), mul(br[0], uz))));
+	z = mul_add(br[3], uz, add(add(z, tz), sub(mul(br[0], uy), mul(br[1], ux))));
+
+	store3(dst, x, y, z);
+}
+
+// Widest available vector of floats, 8 lanes with AVX, 4 lanes otherwise.
+// Used by kernels operating on whole arrays of floats.
+
+#if defined(R4_SIMD_AVX)
+
+typedef __m256 floatv;
+typedef __m256 maskv;
+
+/**
+ * @brief Number of lanes in floatv.
+ */
+constexpr size_t floatv_size = 8;
+
+/**
+ * @brief Load floatv from aligned memory.
+ */
+inline floatv loadv(const float* p)noexcept{
+	return _mm256_load_ps(p);
+}
+
+/**
+ * @brief Store floatv to aligned memory.
+ */
+inline void storev(float* p, floatv v)noexcept{
+	_mm256_store_ps(p, v);
+}
+
+/**
+ * @brief Broadcast scalar to all lanes of floatv.
+ */
+inline floatv splatv(float f)noexcept{
+	return _mm256_set1_ps(f);
+}
+
+inline floatv add(floatv a, floatv b)noexcept{
+	return _mm256_add_ps(a, b);
+}
+
+inline floatv sub(floatv a, floatv b)noexcept{
+	return _mm256_sub_ps(a, b);
+}
+
+inline floatv mul(floatv a, floatv b)noexcept{
+	return _mm256_mul_ps(a, b);
+}
+
+inline floatv div(floatv a, floatv b)noexcept{
+	return _mm256_div_ps(a, b);
+}
+
+inline floatv mul_add(floatv a, floatv b, floatv c)noexcept{
+#	if defined(__FMA__)
+	return _mm256_fmadd_ps(a, b, c);
+#	else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#	endif
+}
+
+inline floatv min(floatv a, floatv b)noexcept{
+	return _mm256_min_ps(a, b);
+}
+
+inline floatv max(floatv a, floatv b)noexcept{
+	return _mm256_max_ps(a, b);
+}
+
+inline floatv negate(floatv a)noexcept{
+	return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+}
+
+inline floatv sqrt(floatv a)noexcept{
+	return _mm256_sqrt_ps(a);
+}
+
+inline floatv abs(floatv a)noexcept{
+	return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+}
+
+inline maskv cmp_le(floatv a, floatv b)noexcept{
+	return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+}
+
+inline maskv cmp_lt(floatv a, floatv b)noexcept{
+	return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+}
+
+inline maskv cmp_eq(floatv a, floatv b)noexcept{
+	return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+}
+
+inline floatv select(maskv m, floatv a, floatv b)noexcept{
+	return _mm256_blendv_ps(b, a, m);
+}
+
+inline maskv and_mask(maskv a, maskv b)noexcept{
+	return _mm256_and_ps(a, b);
+}
+
+inline unsigned mask_bits(maskv m)noexcept{
+	return unsigned(_mm256_movemask_ps(m));
+}
+
+#else
+
+typedef float4 floatv;
+typedef mask4 maskv;
+
+/**
+ * @brief Number of lanes in floatv.
+ */
+constexpr size_t floatv_size = 4;
+
+/**
+ * @brief Load floatv from aligned memory.
+ */
+inline floatv loadv(const float* p)noexcept{
+#	if defined(R4_SIMD_SSE2)
+	return _mm_load_ps(p);
+#	else
+	return load(p);
+#	endif
+}
+
+/**
+ * @brief Store floatv to aligned memory.
+ */
+inline void storev(float* p, floatv v)noexcept{
+#	if defined(R4_SIMD_SSE2)
+	_mm_store_ps(p, v);
+#	else
+	store(p, v);
+#	endif
+}
+
+/**
+ * @brief Broadcast scalar to all lanes of floatv.
+ */
+inline floatv splatv(float f)noexcept{
+	return splat(f);
+}
+
+#endif
+
+}
+
+}
+
+#endif // ~R4_SIMD
@@ -0,0 +1,644 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "vector4.hpp"
+#include "aligned_allocator.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Array of four-dimensional vectors in structure-of-arrays layout.
+ * The x, y, z and w components of the vectors are stored in four separate arrays (lanes).
+ * Each lane is aligned and padded to a multiple of the widest SIMD register size,
+ * so that arithmetic operations are done on the whole arrays with aligned SIMD loads and stores.
+ * The arithmetic operations mirror the ones of vector4 and are done element-wise.
+ * The arrays taking part in the same operation must be of equal size.
+ */
+template <class T> class soa_vector4{
+public:
+	/**
+	 * @brief Alignment of lanes in bytes.
+	 */
+	static constexpr size_t alignment = 32;
+
+	/**
+	 * @brief Type of aligned array of scalars.
+	 */
+	typedef std::vector<T, aligned_allocator<T, alignment>> lane_type;
+
+private:
+	static_assert(alignment % sizeof(T) == 0, "element type size must be divisor of lanes alignment");
+
+	// lane sizes are padded to a multiple of this number of elements
+	static constexpr size_t lane_granularity = alignment / sizeof(T);
+
+	static size_t pad(size_t size)noexcept{
+		return (size + lane_granularity - 1) / lane_granularity * lane_granularity;
+	}
+
+	// all four lanes are stored one after another in a single buffer, so that
+	// component-wise operations can be done in a single loop over the whole buffer
+	lane_type buffer;
+
+	size_t num = 0;
+
+	// padded lane size
+	size_t stride = 0;
+
+	// component-wise minimum, separate function to allow specialization
+	static soa_vector4 comp_min(const soa_vector4& va, const soa_vector4& vb){
+		ASSERT(va.size() == vb.size())
+		soa_vector4 ret(va.size());
+		for(size_t i = 0; i != ret.buffer.size(); ++i){
+			using std::min;
+			ret.buffer[i] = min(va.buffer[i], vb.buffer[i]);
+		}
+		return ret;
+	}
+
+	// component-wise maximum, separate function to allow specialization
+	static soa_vector4 comp_max(const soa_vector4& va, const soa_vector4& vb){
+		ASSERT(va.size() == vb.size())
+		soa_vector4 ret(va.size());
+		for(size_t i = 0; i != ret.buffer.size(); ++i){
+			using std::max;
+			ret.buffer[i] = max(va.buffer[i], vb.buffer[i]);
+		}
+		return ret;
+	}
+public:
+	/**
+	 * @brief Construct empty array.
+	 */
+	soa_vector4() = default;
+
+	/**
+	 * @brief Construct array of given size.
+	 * All vectors are initialized to zero vector.
+	 * @param size - number of vectors in the array.
+	 */
+	explicit soa_vector4(size_t size) :
+			buffer(pad(size) * 4),
+			num(size),
+			stride(pad(size))
+	{}
+
+	/**
+	 * @brief Construct array from array of vector4.
+	 * Gathers the components of the given vectors to the lanes.
+	 * @param src - pointer to the first vector.
+	 * @param size - number of vectors.
+	 */
+	soa_vector4(const vector4<T>* src, size_t size) :
+			soa_vector4(size)
+	{
+		this->gather(src, size);
+	}
+
+	soa_vector4(const soa_vector4&) = default;
+	soa_vector4& operator=(const soa_vector4&) = default;
+
+	soa_vector4(soa_vector4&& v)noexcept :
+			buffer(std::move(v.buffer)),
+			num(v.num),
+			stride(v.stride)
+	{
+		v.num = 0;
+		v.stride = 0;
+	}
+
+	soa_vector4& operator=(soa_vector4&& v)noexcept{
+		this->buffer = std::move(v.buffer);
+		this->num = v.num;
+		this->stride = v.stride;
+		v.num = 0;
+		v.stride = 0;
+		return *this;
+	}
+
+	/**
+	 * @brief Get number of vectors in the array.
+	 * @return number of vectors.
+	 */
+	size_t size()const noexcept{
+		return this->num;
+	}
+
+	/**
+	 * @brief Change number of vectors in the array.
+	 * Vectors which fit into the new size preserve their values, new vectors are initialized to zero vector.
+	 * @param size - new number of vectors.
+	 */
+	void resize(size_t size){
+		soa_vector4 v(size);
+		size_t n = std::min(size, this->size());
+		for(unsigned l = 0; l != 4; ++l){
+			std::copy(this->lane(l), this->lane(l) + n, v.lane(l));
+		}
+		this->operator=(std::move(v));
+	}
+
+	/**
+	 * @brief Get lane.
+	 * @param index - index of the lane, 0 for x, 1 for y, 2 for z and 3 for w.
+	 * @return pointer to the first element of the lane, the pointer is aligned to 'alignment' boundary.
+	 */
+	T* lane(unsigned index)noexcept{
+		ASSERT(index < 4)
+		return this->buffer.data() + index * this->stride;
+	}
+
+	/**
+	 * @brief Get lane.
+	 * @param index - index of the lane, 0 for x, 1 for y, 2 for z and 3 for w.
+	 * @return pointer to the first element of the lane, the pointer is aligned to 'alignment' boundary.
+	 */
+	const T* lane(unsigned index)const noexcept{
+		ASSERT(index < 4)
+		return this->buffer.data() + index * this->stride;
+	}
+
+	/**
+	 * @brief Lane of x components.
+	 */
+	T* x()noexcept{
+		return this->lane(0);
+	}
+
+	/**
+	 * @brief Lane of x components.
+	 */
+	const T* x()const noexcept{
+		return this->lane(0);
+	}
+
+	/**
+	 * @brief Lane of y components.
+	 */
+	T* y()noexcept{
+		return this->lane(1);
+	}
+
+	/**
+	 * @brief Lane of y components.
+	 */
+	const T* y()const noexcept{
+		return this->lane(1);
+	}
+
+	/**
+	 * @brief Lane of z components.
+	 */
+	T* z()noexcept{
+		return this->lane(2);
+	}
+
+	/**
+	 * @brief Lane of z components.
+	 */
+	const T* z()const noexcept{
+		return this->lane(2);
+	}
+
+	/**
+	 * @brief Lane of w components.
+	 */
+	T* w()noexcept{
+		return this->lane(3);
+	}
+
+	/**
+	 * @brief Lane of w components.
+	 */
+	const T* w()const noexcept{
+		return this->lane(3);
+	}
+
+	/**
+	 * @brief Get vector.
+	 * @param i - index of the vector.
+	 * @return vector4 composed of the i-th elements of the lanes.
+	 */
+	vector4<T> operator[](size_t i)const noexcept{
+		ASSERT(i < this->size())
+		return vector4<T>(this->x()[i], this->y()[i], this->z()[i], this->w()[i]);
+	}
+
+	/**
+	 * @brief Set vector.
+	 * @param i - index of the vector.
+	 * @param v - value to set the vector to.
+	 * @return reference to this array.
+	 */
+	soa_vector4& set(size_t i, const vector4<T>& v)noexcept{
+		ASSERT(i < this->size())
+		this->x()[i] = v.x();
+		this->y()[i] = v.y();
+		this->z()[i] = v.z();
+		this->w()[i] = v.w();
+		return *this;
+	}
+
+	/**
+	 * @brief Load vectors from array of vector4.
+	 * Resizes this array to the given size and gathers the components of the given vectors to the lanes.
+	 * @param src - pointer to the first vector.
+	 * @param size - number of vectors.
+	 * @return reference to this array.
+	 */
+	soa_vector4& gather(const vector4<T>* src, size_t size);
+
+	/**
+	 * @brief Store vectors to array of vector4.
+	 * Scatters the lanes to the array of vector4.
+	 * @param dst - pointer to the array of size() vectors to store the vectors to.
+	 */
+	void scatter(vector4<T>* dst)const noexcept{
+		const T* px = this->x();
+		const T* py = this->y();
+		const T* pz = this->z();
+		const T* pw = this->w();
+		for(size_t i = 0; i != this->size(); ++i, ++dst){
+			dst->x() = px[i];
+			dst->y() = py[i];
+			dst->z() = pz[i];
+			dst->w() = pw[i];
+		}
+	}
+
+	/**
+	 * @brief Add and assign.
+	 * Adds given vectors to this array's vectors and assigns result back to this array.
+	 * @param v - vectors to add.
+	 * @return Reference to this array.
+	 */
+	soa_vector4& operator+=(const soa_vector4& v)noexcept{
+		ASSERT(this->size() == v.size())
+		for(size_t i = 0; i != this->buffer.size(); ++i){
+			this->buffer[i] += v.buffer[i];
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Add vectors.
+	 * @param v - vectors to add.
+	 * @return Array of vectors resulting from addition.
+	 */
+	soa_vector4 operator+(const soa_vector4& v)const{
+		return (soa_vector4(*this) += v);
+	}
+
+	/**
+	 * @brief Subtract and assign.
+	 * Subtracts given vectors from this array's vectors and assigns result back to this array.
+	 * @param v - vectors to subtract.
+	 * @return Reference to this array.
+	 */
+	soa_vector4& operator-=(const soa_vector4& v)noexcept{
+		ASSERT(this->size() == v.size())
+		for(size_t i = 0; i != this->buffer.size(); ++i){
+			this->buffer[i] -= v.buffer[i];
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Subtract vectors.
+	 * @param v - vectors to subtract.
+	 * @return Array of vectors resulting from subtraction.
+	 */
+	soa_vector4 operator-(const soa_vector4& v)const{
+		return (soa_vector4(*this) -= v);
+	}
+
+	/**
+	 * @brief Multiply by scalar and assign.
+	 * @param num - scalar to multiply by.
+	 * @return Reference to this array.
+	 */
+	soa_vector4& operator*=(T num)noexcept{
+		for(auto& e : this->buffer){
+			e *= num;
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply by scalar.
+	 * @param num - scalar to multiply by.
+	 * @return Array of vectors resulting from multiplication by scalar.
+	 */
+	soa_vector4 operator*(T num)const{
+		return (soa_vector4(*this) *= num);
+	}
+
+	/**
+	 * @brief Dot product.
+	 * @param v - vectors to multiply by.
+	 * @return Array of dot products of corresponding vectors of the two arrays.
+	 */
+	lane_type operator*(const soa_vector4& v)const{
+		ASSERT(this->size() == v.size())
+		lane_type ret(this->size());
+		for(size_t i = 0; i != ret.size(); ++i){
+			ret[i] = this->x()[i] * v.x()[i] + this->y()[i] * v.y()[i] + this->z()[i] * v.z()[i] + this->w()[i] * v.w()[i];
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Cross product.
+	 * Same as vector4::operator%(), i.e. first three components of the result are the cross product
+	 * of 3d vectors formed from first three components and the fourth component is a product of fourth components.
+	 * @param v - vectors to multiply by.
+	 * @return Array of cross products of corresponding vectors of the two arrays.
+	 */
+	soa_vector4 operator%(const soa_vector4& v)const{
+		ASSERT(this->size() == v.size())
+		soa_vector4 ret(this->size());
+		for(size_t i = 0; i != ret.size(); ++i){
+			ret.x()[i] = this->y()[i] * v.z()[i] - this->z()[i] * v.y()[i];
+			ret.y()[i] = this->z()[i] * v.x()[i] - this->x()[i] * v.z()[i];
+			ret.z()[i] = this->x()[i] * v.y()[i] - this->y()[i] * v.x()[i];
+			ret.w()[i] = this->w()[i] * v.w()[i];
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Normalize vectors.
+	 * Normalizes each vector of this array.
+	 * Vectors of zero norm become (1, 0, 0, 0), same as vector4::normalize() does.
+	 * @return Reference to this array.
+	 */
+	soa_vector4& normalize()noexcept{
+		T* px = this->x();
+		T* py = this->y();
+		T* pz = this->z();
+		T* pw = this->w();
+		for(size_t i = 0; i != this->size(); ++i){
+			using std::sqrt;
+			T mag = sqrt(utki::pow2(px[i]) + utki::pow2(py[i]) + utki::pow2(pz[i]) + utki::pow2(pw[i]));
+			if(mag == 0){
+				px[i] = 1;
+				py[i] = 0;
+				pz[i] = 0;
+				pw[i] = 0;
+			}else{
+				px[i] /= mag;
+				py[i] /= mag;
+				pz[i] /= mag;
+				pw[i] /= mag;
+			}
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Snap each vector component to 0.
+	 * For each component, set it to 0 if its absolute value does not exceed the given threshold.
+	 * @param threshold - the snapping threshold.
+	 * @return reference to this array.
+	 */
+	soa_vector4& snap_to_zero(T threshold)noexcept{
+		for(auto& e : this->buffer){
+			using std::abs;
+			if(abs(e) <= threshold){
+				e = 0;
+			}
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Get component-wise minimum of two arrays of vectors.
+	 * @param va - first array.
+	 * @param vb - second array.
+	 * @return array of vectors whose components are component-wise minimum of initial vectors.
+	 */
+	friend soa_vector4 min(const soa_vector4& va, const soa_vector4& vb){
+		return soa_vector4::comp_min(va, vb);
+	}
+
+	/**
+	 * @brief Get component-wise maximum of two arrays of vectors.
+	 * @param va - first array.
+	 * @param vb - second array.
+	 * @return array of vectors whose components are component-wise maximum of initial vectors.
+	 */
+	friend soa_vector4 max(const soa_vector4& va, const soa_vector4& vb){
+		return soa_vector4::comp_max(va, vb);
+	}
+};
+
+template <class T> soa_vector4<T>& soa_vector4<T>::gather(const vector4<T>* src, size_t size){
+	if(this->size() != size){
+		this->operator=(soa_vector4(size));
+	}
+	T* px = this->x();
+	T* py = this->y();
+	T* pz = this->z();
+	T* pw = this->w();
+	for(size_t i = 0; i != size; ++i, ++src){
+		px[i] = src->x();
+		py[i] = src->y();
+		pz[i] = src->z();
+		pw[i] = src->w();
+	}
+	return *this;
+}
+
+#ifdef R4_SIMD
+
+// SIMD specializations of soa_vector4<float> operations
+
+template <> inline soa_vector4<float>& soa_vector4<float>::gather(const vector4<float>* src, size_t size){
+	if(this->size() != size){
+		this->operator=(soa_vector4(size));
+	}
+	float* px = this->x();
+	float* py = this->y();
+	float* pz = this->z();
+	float* pw = this->w();
+	auto s = reinterpret_cast<const float*>(src);
+
+	// transpose blocks of 4 vectors
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4, s += 4 * 4){
+		auto x = simd::load(s);
+		auto y = simd::load(s + 4);
+		auto z = simd::load(s + 8);
+		auto w = simd::load(s + 12);
+		simd::transpose(x, y, z, w);
+		simd::store(px + i, x);
+		simd::store(py + i, y);
+		simd::store(pz + i, z);
+		simd::store(pw + i, w);
+	}
+	for(; i != size; ++i, s += 4){
+		px[i] = s[0];
+		py[i] = s[1];
+		pz[i] = s[2];
+		pw[i] = s[3];
+	}
+	return *this;
+}
+
+template <> inline void soa_vector4<float>::scatter(vector4<float>* dst)const noexcept{
+	const float* px = this->x();
+	const float* py = this->y();
+	const float* pz = this->z();
+	const float* pw = this->w();
+	auto d = reinterpret_cast<float*>(dst);
+
+	// transpose blocks of 4 vectors
+	size_t i = 0;
+	for(; i + 4 <= this->size(); i += 4, d += 4 * 4){
+		auto x = simd::load(px + i);
+		auto y = simd::load(py + i);
+		auto z = simd::load(pz + i);
+		auto w = simd::load(pw + i);
+		simd::transpose(x, y, z, w);
+		simd::store(d, x);
+		simd::store(d + 4, y);
+		simd::store(d + 8, z);
+		simd::store(d + 12, w);
+	}
+	for(; i != this->size(); ++i, d += 4){
+		d[0] = px[i];
+		d[1] = py[i];
+		d[2] = pz[i];
+		d[3] = pw[i];
+	}
+}
+
+template <> inline soa_vector4<float>& soa_vector4<float>::operator+=(const soa_vector4<float>& v)noexcept{
+	ASSERT(this->size() == v.size())
+	float* d = this->buffer.data();
+	const float* s = v.buffer.data();
+	for(size_t i = 0; i != this->buffer.size(); i += simd::floatv_size){
+		simd::storev(d + i, simd::add(simd::loadv(d + i), simd::loadv(s + i)));
+	}
+	return *this;
+}
+
+template <> inline soa_vector4<float>& soa_vector4<float>::operator-=(const soa_vector4<float>& v)noexcept{
+	ASSERT(this->size() == v.size())
+	float* d = this->buffer.data();
+	const float* s = v.buffer.data();
+	for(size_t i = 0; i != this->buffer.size(); i += simd::floatv_size){
+		simd::storev(d + i, simd::sub(simd::loadv(d + i), simd::loadv(s + i)));
+	}
+	return *this;
+}
+
+template <> inline soa_vector4<float>& soa_vector4<float>::operator*=(float num)noexcept{
+	float* d = this->buffer.data();
+	auto n = simd::splatv(num);
+	for(size_t i = 0; i != this->buffer.size(); i += simd::floatv_size){
+		simd::storev(d + i, simd::mul(simd::loadv(d + i), n));
+	}
+	return *this;
+}
+
+template <> inline soa_vector4<float>::lane_type soa_vector4<float>::operator*(const soa_vector4<float>& v)const{
+	ASSERT(this->size() == v.size())
+	// compute padded lane and then shrink it, the capacity remains padded
+	lane_type ret(this->stride);
+	const float *ax = this->x(), *ay = this->y(), *az = this->z(), *aw = this->w();
+	const float *bx = v.x(), *by = v.y(), *bz = v.z(), *bw = v.w();
+	for(size_t i = 0; i != this->stride; i += simd::floatv_size){
+		auto r = simd::mul(simd::loadv(ax + i), simd::loadv(bx + i));
+		r = simd::mul_add(simd::loadv(ay + i), simd::loadv(by + i), r);
+		r = simd::mul_add(simd::loadv(az + i), simd::loadv(bz + i), r);
+		r = simd::mul_add(simd::loadv(aw + i), simd::loadv(bw + i), r);
+		simd::storev(ret.data() + i, r);
+	}
+	ret.resize(this->size());
+	return ret;
+}
+
+template <> inline soa_vector4<float> soa_vector4<float>::operator%(const soa_vector4<float>& v)const{
+	ASSERT(this->size() == v.size())
+	soa_vector4<float> ret(this->size());
+	const float *ax = this->x(), *ay = this->y(), *az = this->z(), *aw = this->w();
+	const float *bx = v.x(), *by = v.y(), *bz = v.z(), *bw = v.w();
+	float *rx = ret.x(), *ry = ret.y(), *rz = ret.z(), *rw = ret.w();
+	for(size_t i = 0; i != this->stride; i += simd::floatv_size){
+		auto x1 = simd::loadv(ax + i), y1 = simd::loadv(ay + i), z1 = simd::loadv(az + i);
+		auto x2 = simd::loadv(bx + i), y2 = simd::loadv(by + i), z2 = simd::loadv(bz + i);
+		simd::storev(rx + i, simd::sub(simd::mul(y1, z2), simd::mul(z1, y2)));
+		simd::storev(ry + i, simd::sub(simd::mul(z1, x2), simd::mul(x1, z2)));
+		simd::storev(rz + i, simd::sub(simd::mul(x1, y2), simd::mul(y1, x2)));
+		simd::storev(rw + i, simd::mul(simd::loadv(aw + i), simd::loadv(bw + i)));
+	}
+	return ret;
+}
+
+template <> inline soa_vector4<float>& soa_vector4<float>::normalize()noexcept{
+	float *px = this->x(), *py = this->y(), *pz = this->z(), *pw = this->w();
+	auto zero = simd::splatv(0);
+	auto one = simd::splatv(1);
+	for(size_t i = 0; i != this->stride; i += simd::floatv_size){
+		auto x = simd::loadv(px + i), y = simd::loadv(py + i), z = simd::loadv(pz + i), w = simd::loadv(pw + i);
+		auto mag = simd::sqrt(simd::mul_add(w, w, simd::mul_add(z, z, simd::mul_add(y, y, simd::mul(x, x)))));
+		auto is_zero = simd::cmp_eq(mag, zero);
+		// NOTE: division by zero in masked out lanes is harmless
+		simd::storev(px + i, simd::select(is_zero, one, simd::div(x, mag)));
+		simd::storev(py + i, simd::select(is_zero, zero, simd::div(y, mag)));
+		simd::storev(pz + i, simd::select(is_zero, zero, simd::div(z, mag)));
+		simd::storev(pw + i, simd::select(is_zero, zero, simd::div(w, mag)));
+	}
+	return *this;
+}
+
+template <> inline soa_vector4<float>& soa_vector4<float>::snap_to_zero(float threshold)noexcept{
+	float* d = this->buffer.data();
+	auto t = simd::splatv(threshold);
+	auto zero = simd::splatv(0);
+	for(size_t i = 0; i != this->buffer.size(); i += simd::floatv_size){
+		auto e = simd::loadv(d + i);
+		simd::storev(d + i, simd::select(simd::cmp_le(simd::abs(e), t), zero, e));
+	}
+	return *this;
+}
+
+template <> inline soa_vector4<float> soa_vector4<float>::comp_min(const soa_vector4<float>& va, const soa_vector4<float>& vb){
+	ASSERT(va.size() == vb.size())
+	soa_vector4<float> ret(va.size());
+	for(size_t i = 0; i != ret.buffer.size(); i += simd::floatv_size){
+		// NOTE: operands order is swapped to match std::min() semantics when comparing NaNs
+		simd::storev(ret.buffer.data() + i, simd::min(simd::loadv(vb.buffer.data() + i), simd::loadv(va.buffer.data() + i)));
+	}
+	return ret;
+}
+
+template <> inline soa_vector4<float> soa_vector4<float>::comp_max(const soa_vector4<float>& va, const soa_vector4<float>& vb){
+	ASSERT(va.size() == vb.size())
+	soa_vector4<float> ret(va.size());
+	for(size_t i = 0; i != ret.buffer.size(); i += simd::floatv_size){
+		// NOTE: operands order is swapped to match std::max() semantics when comparing NaNs
+		simd::storev(ret.buffer.data() + i, simd::max(simd::loadv(vb.buffer.data() + i), simd::loadv(va.buffer.data() + i)));
+	}
+	return ret;
+}
+
+#endif // ~R4_SIMD
+
+}
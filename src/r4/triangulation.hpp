@@ -0,0 +1,588 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include <utki/debug.hpp>
+
+#include "vector2.hpp"
+#include "rectangle.hpp"
+#include "segment2.hpp"
+#include "predicates.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Sort points lexicographically.
+ * Sorts indices of the points by x coordinate and then by y coordinate and removes indices of duplicate points,
+ * of several equal points the one with the smallest index is kept.
+ * Large inputs are sorted in parallel.
+ * @param points - pointer to array of points.
+ * @param size - number of points in the array.
+ * @param num_threads - maximal number of threads to use, 0 means number of hardware threads.
+ * @return indices of distinct points in lexicographic order.
+ */
+inline std::vector<uint32_t> sort_points(const vector2<double>* points, size_t size, unsigned num_threads = 0);
+
+/**
+ * @brief Calculate convex hull of points.
+ * Uses monotone chain algorithm with robust orientation predicate, so the result is exact.
+ * Points lying on the hull edges are not included.
+ * @param points - pointer to array of points.
+ * @param size - number of points in the array.
+ * @param num_threads - maximal number of threads to use for sorting the points, 0 means number of hardware threads.
+ * @return indices of the hull vertices in counterclockwise order, starting from the lexicographically smallest point.
+ *         In case all the points are collinear, the two end points are returned, or one point if all the points are equal.
+ */
+inline std::vector<uint32_t> convex_hull(const vector2<double>* points, size_t size, unsigned num_threads = 0);
+
+/**
+ * @brief Delaunay triangulation of points.
+ * Uses divide-and-conquer algorithm of Guibas and Stolfi on quad-edge data structure
+ * with robust orientation and in-circle predicates, so the triangulation is valid for any input.
+ * The halves of the point set are triangulated in parallel for large inputs.
+ * Duplicate points are triangulated as one point, the one with the smallest index.
+ * In case four or more points are cocircular, one of the possible triangulations is chosen.
+ */
+class delaunay_triangulation{
+public:
+	/**
+	 * @brief Triangle, indices of its vertices in the input array of points in counterclockwise order.
+	 */
+	typedef std::array<uint32_t, 3> triangle_type;
+
+private:
+	std::vector<triangle_type> tris;
+
+	rectangle<double> bounds = rectangle<double>(0, 0, 0, 0);
+
+	class builder;
+
+public:
+	/**
+	 * @brief Construct empty triangulation.
+	 */
+	delaunay_triangulation() = default;
+
+	/**
+	 * @brief Construct triangulation of points.
+	 * Same as calling build() on empty triangulation.
+	 * @param points - pointer to array of points.
+	 * @param size - number of points in the array.
+	 * @param num_threads - maximal number of threads to use, 0 means number of hardware threads.
+	 */
+	delaunay_triangulation(const vector2<double>* points, size_t size, unsigned num_threads = 0){
+		this->build(points, size, num_threads);
+	}
+
+	/**
+	 * @brief Triangulate points.
+	 * Replaces current triangulation with triangulation of given points.
+	 * @param points - pointer to array of points.
+	 * @param size - number of points in the array.
+	 * @param num_threads - maximal number of threads to use, 0 means number of hardware threads.
+	 */
+	void build(const vector2<double>* points, size_t size, unsigned num_threads = 0);
+
+	/**
+	 * @brief Get triangles.
+	 * @return triangles of the triangulation. Empty if there are less than three distinct points or all the points are collinear.
+	 */
+	const std::vector<triangle_type>& triangles()const noexcept{
+		return this->tris;
+	}
+
+	/**
+	 * @brief Get bounding box of the triangulated points.
+	 * @return bounding rectangle of the points.
+	 * @return rectangle (0, 0, 0, 0) if there are no points.
+	 */
+	const rectangle<double>& bounding_box()const noexcept{
+		return this->bounds;
+	}
+};
+
+namespace triangulation_internal{
+
+// inputs smaller than this are processed in a single thread
+constexpr size_t parallel_threshold = 1 << 15;
+
+inline unsigned resolve_num_threads(unsigned num_threads)noexcept{
+	if(num_threads == 0){
+		num_threads = std::thread::hardware_concurrency();
+	}
+	return std::max(num_threads, 1u);
+}
+
+// merge sort, halves are sorted in parallel
+template <class Compare> void parallel_sort(uint32_t* begin, uint32_t* end, Compare comp, unsigned num_threads){
+	size_t size = size_t(end - begin);
+	if(num_threads <= 1 || size < parallel_threshold){
+		std::sort(begin, end, comp);
+		return;
+	}
+	auto mid = begin + size / 2;
+	std::thread t([=](){
+		parallel_sort(begin, mid, comp, num_threads / 2);
+	});
+	parallel_sort(mid, end, comp, num_threads - num_threads / 2);
+	t.join();
+	std::inplace_merge(begin, mid, end, comp);
+}
+
+}
+
+inline std::vector<uint32_t> sort_points(const vector2<double>* points, size_t size, unsigned num_threads){
+	ASSERT(size <= size_t(~uint32_t(0)))
+	std::vector<uint32_t> ret(size);
+	for(size_t i = 0; i != size; ++i){
+		ret[i] = uint32_t(i);
+	}
+
+	// equal points are ordered by index, so that the one with the smallest index goes first
+	triangulation_internal::parallel_sort(
+			ret.data(),
+			ret.data() + ret.size(),
+			[points](uint32_t a, uint32_t b){
+				const auto& pa = points[a];
+				const auto& pb = points[b];
+				if(pa.x() != pb.x()){
+					return pa.x() < pb.x();
+				}
+				if(pa.y() != pb.y()){
+					return pa.y() < pb.y();
+				}
+				return a < b;
+			},
+			triangulation_internal::resolve_num_threads(num_threads)
+		);
+
+	ret.erase(
+			std::unique(
+					ret.begin(),
+					ret.end(),
+					[points](uint32_t a, uint32_t b){
+						return points[a] == points[b];
+					}
+				),
+			ret.end()
+		);
+	return ret;
+}
+
+inline std::vector<uint32_t> convex_hull(const vector2<double>* points, size_t size, unsigned num_threads){
+	auto sorted = sort_points(points, size, num_threads);
+	if(sorted.size() < 3){
+		return sorted;
+	}
+
+	std::vector<uint32_t> ret(sorted.size() + 1);
+	size_t n = 0;
+
+	// tests if the last two hull points and the given one do not make a left turn
+	auto no_left_turn = [&](uint32_t p){
+		return predicates::orient2d(points[ret[n - 2]], points[ret[n - 1]], points[p]) <= 0;
+	};
+
+	// lower hull
+	for(auto p : sorted){
+		for(; n >= 2 && no_left_turn(p); --n){}
+		ret[n++] = p;
+	}
+
+	// upper hull
+	size_t lower_size = n + 1;
+	for(auto i = sorted.rbegin() + 1; i != sorted.rend(); ++i){
+		for(; n >= lower_size && no_left_turn(*i); --n){}
+		ret[n++] = *i;
+	}
+
+	// the last point is the first one
+	ret.resize(n - 1);
+	return ret;
+}
+
+// Quad-edge data structure, see L. Guibas, J. Stolfi, "Primitives for the Manipulation of General Subdivisions
+// and the Computation of Voronoi Diagrams". Each edge record consists of four quarter-edges: the primal edge,
+// its dual rotated by 90 degrees, the primal edge in reverse direction and the reversed dual.
+// Quarter-edges are referred to by index = record * 4 + rotation.
+// A triangulation of n points has at most 3n edges at any stage of the algorithm, so the records
+// are preallocated and the subproblem on points [begin, end) only uses records [3 * begin, 3 * end).
+// This allows to triangulate subproblems in parallel without synchronization.
+class delaunay_triangulation::builder{
+	static constexpr uint32_t none = ~uint32_t(0);
+
+	// indices of the points in lexicographic order, vertices are identified by position in this array
+	std::vector<uint32_t> sorted;
+
+	// copy of the points in lexicographic order, so that neighbouring vertices are close in memory
+	std::vector<vector2<double>> points;
+
+	// next quarter-edge counterclockwise around the origin of the quarter-edge
+	std::vector<uint32_t> next;
+
+	// origin vertex of the primal quarter-edges, none for the first quarter-edge of free records
+	std::vector<uint32_t> vert;
+
+	// list of free edge records, linked by the 'next' of the first quarter-edge
+	struct free_list{
+		uint32_t head = none;
+		uint32_t tail = none;
+	};
+
+	// result of triangulating a subproblem
+	struct subdivision{
+		// counterclockwise convex hull edge out of the leftmost vertex
+		uint32_t left;
+
+		// clockwise convex hull edge out of the rightmost vertex
+		uint32_t right;
+
+		free_list free;
+	};
+
+	static uint32_t rot(uint32_t e)noexcept{
+		return (e & ~uint32_t(3)) | ((e + 1) & 3);
+	}
+
+	static uint32_t sym(uint32_t e)noexcept{
+		return e ^ 2;
+	}
+
+	static uint32_t inv_rot(uint32_t e)noexcept{
+		return (e & ~uint32_t(3)) | ((e + 3) & 3);
+	}
+
+	uint32_t onext(uint32_t e)const noexcept{
+		return this->next[e];
+	}
+
+	uint32_t oprev(uint32_t e)const noexcept{
+		return rot(this->onext(rot(e)));
+	}
+
+	uint32_t lnext(uint32_t e)const noexcept{
+		return rot(this->onext(inv_rot(e)));
+	}
+
+	uint32_t rprev(uint32_t e)const noexcept{
+		return this->onext(sym(e));
+	}
+
+	uint32_t org(uint32_t e)const noexcept{
+		return this->vert[e];
+	}
+
+	uint32_t dest(uint32_t e)const noexcept{
+		return this->vert[sym(e)];
+	}
+
+	const vector2<double>& point(uint32_t v)const noexcept{
+		return this->points[v];
+	}
+
+	// true if a, b and c are in counterclockwise order
+	bool ccw(uint32_t a, uint32_t b, uint32_t c)const noexcept{
+		return predicates::orient2d(this->point(a), this->point(b), this->point(c)) > 0;
+	}
+
+	bool right_of(uint32_t v, uint32_t e)const noexcept{
+		return this->ccw(v, this->dest(e), this->org(e));
+	}
+
+	bool left_of(uint32_t v, uint32_t e)const noexcept{
+		return this->ccw(v, this->org(e), this->dest(e));
+	}
+
+	// true if d lies inside of the circle passing through a, b and c
+	bool in_circle(uint32_t a, uint32_t b, uint32_t c, uint32_t d)const noexcept{
+		return predicates::incircle(this->point(a), this->point(b), this->point(c), this->point(d)) > 0;
+	}
+
+	uint32_t make_edge(free_list& fl, uint32_t a, uint32_t b)noexcept{
+		uint32_t q = fl.head;
+		ASSERT(q != none)
+		fl.head = this->next[q * 4];
+		if(fl.head == none){
+			fl.tail = none;
+		}
+		uint32_t e = q * 4;
+		this->next[e] = e;
+		this->next[e + 1] = e + 3;
+		this->next[e + 2] = e + 2;
+		this->next[e + 3] = e + 1;
+		this->vert[e] = a;
+		this->vert[e + 2] = b;
+		return e;
+	}
+
+	void splice(uint32_t a, uint32_t b)noexcept{
+		uint32_t alpha = rot(this->onext(a));
+		uint32_t beta = rot(this->onext(b));
+		std::swap(this->next[a], this->next[b]);
+		std::swap(this->next[alpha], this->next[beta]);
+	}
+
+	// add edge from destination of a to origin of b
+	uint32_t connect(free_list& fl, uint32_t a, uint32_t b)noexcept{
+		uint32_t e = this->make_edge(fl, this->dest(a), this->org(b));
+		this->splice(e, this->lnext(a));
+		this->splice(sym(e), b);
+		return e;
+	}
+
+	void delete_edge(free_list& fl, uint32_t e)noexcept{
+		this->splice(e, this->oprev(e));
+		this->splice(sym(e), this->oprev(sym(e)));
+		uint32_t q = e / 4;
+		this->vert[q * 4] = none;
+		this->next[q * 4] = fl.head;
+		fl.head = q;
+		if(fl.tail == none){
+			fl.tail = q;
+		}
+	}
+
+	free_list join(free_list a, free_list b)noexcept{
+		if(a.head == none){
+			return b;
+		}
+		if(b.head != none){
+			this->next[a.tail * 4] = b.head;
+			a.tail = b.tail;
+		}
+		return a;
+	}
+
+	subdivision triangulate(uint32_t begin, uint32_t end, unsigned num_threads);
+
+	subdivision merge(subdivision l, subdivision r)noexcept;
+
+public:
+	builder(const vector2<double>* points, size_t size, unsigned num_threads) :
+			sorted(sort_points(points, size, num_threads))
+	{
+		ASSERT(this->sorted.size() <= none / 12)
+		this->points.reserve(this->sorted.size());
+		for(auto i : this->sorted){
+			this->points.push_back(points[i]);
+		}
+		this->next.resize(this->sorted.size() * 3 * 4);
+		this->vert.resize(this->sorted.size() * 3 * 4, none);
+	}
+
+	void triangulate(unsigned num_threads){
+		if(this->sorted.size() >= 2){
+			this->triangulate(0, uint32_t(this->sorted.size()), num_threads);
+		}
+	}
+
+	// collect triangles of the records [begin, end)
+	void collect(uint32_t begin, uint32_t end, std::vector<triangle_type>& tris)const;
+
+	uint32_t num_records()const noexcept{
+		return uint32_t(this->vert.size() / 4);
+	}
+};
+
+inline delaunay_triangulation::builder::subdivision delaunay_triangulation::builder::triangulate(uint32_t begin, uint32_t end, unsigned num_threads){
+	uint32_t size = end - begin;
+	ASSERT(size >= 2)
+
+	if(size <= 3){
+		// all records of the subproblem are free
+		subdivision ret;
+		ret.free.head = begin * 3;
+		ret.free.tail = end * 3 - 1;
+		for(uint32_t q = ret.free.head; q != ret.free.tail; ++q){
+			this->next[q * 4] = q + 1;
+		}
+		this->next[ret.free.tail * 4] = none;
+
+		uint32_t a = this->make_edge(ret.free, begin, begin + 1);
+		if(size == 2){
+			ret.left = a;
+			ret.right = sym(a);
+			return ret;
+		}
+
+		uint32_t b = this->make_edge(ret.free, begin + 1, begin + 2);
+		this->splice(sym(a), b);
+		if(this->ccw(begin, begin + 1, begin + 2)){
+			this->connect(ret.free, b, a);
+			ret.left = a;
+			ret.right = sym(b);
+		}else if(this->ccw(begin, begin + 2, begin + 1)){
+			uint32_t c = this->connect(ret.free, b, a);
+			ret.left = sym(c);
+			ret.right = c;
+		}else{
+			// collinear points
+			ret.left = a;
+			ret.right = sym(b);
+		}
+		return ret;
+	}
+
+	uint32_t mid = begin + size / 2;
+	subdivision l, r;
+	if(num_threads > 1 && size >= triangulation_internal::parallel_threshold){
+		std::thread t([&](){
+			l = this->triangulate(begin, mid, num_threads / 2);
+		});
+		r = this->triangulate(mid, end, num_threads - num_threads / 2);
+		t.join();
+	}else{
+		l = this->triangulate(begin, mid, 1);
+		r = this->triangulate(mid, end, 1);
+	}
+	return this->merge(l, r);
+}
+
+inline delaunay_triangulation::builder::subdivision delaunay_triangulation::builder::merge(subdivision l, subdivision r)noexcept{
+	subdivision ret;
+	ret.free = this->join(l.free, r.free);
+	free_list& fl = ret.free;
+
+	uint32_t ldo = l.left;
+	uint32_t ldi = l.right;
+	uint32_t rdi = r.left;
+	uint32_t rdo = r.right;
+
+	// find lower common tangent of the two halves
+	for(;;){
+		if(this->left_of(this->org(rdi), ldi)){
+			ldi = this->lnext(ldi);
+		}else if(this->right_of(this->org(ldi), rdi)){
+			rdi = this->rprev(rdi);
+		}else{
+			break;
+		}
+	}
+
+	uint32_t basel = this->connect(fl, sym(rdi), ldi);
+	if(this->org(ldi) == this->org(ldo)){
+		ldo = sym(basel);
+	}
+	if(this->org(rdi) == this->org(rdo)){
+		rdo = basel;
+	}
+
+	// zip the halves from bottom to top
+	auto valid = [this, &basel](uint32_t e){
+		return this->right_of(this->dest(e), basel);
+	};
+	for(;;){
+		uint32_t lcand = this->onext(sym(basel));
+		if(valid(lcand)){
+			while(this->in_circle(this->dest(basel), this->org(basel), this->dest(lcand), this->dest(this->onext(lcand)))){
+				uint32_t t = this->onext(lcand);
+				this->delete_edge(fl, lcand);
+				lcand = t;
+			}
+		}
+
+		uint32_t rcand = this->oprev(basel);
+		if(valid(rcand)){
+			while(this->in_circle(this->dest(basel), this->org(basel), this->dest(rcand), this->dest(this->oprev(rcand)))){
+				uint32_t t = this->oprev(rcand);
+				this->delete_edge(fl, rcand);
+				rcand = t;
+			}
+		}
+
+		bool lvalid = valid(lcand);
+		bool rvalid = valid(rcand);
+		if(!lvalid && !rvalid){
+			break;
+		}
+
+		if(!lvalid || (rvalid && this->in_circle(this->dest(lcand), this->org(lcand), this->org(rcand), this->dest(rcand)))){
+			basel = this->connect(fl, rcand, sym(basel));
+		}else{
+			basel = this->connect(fl, sym(basel), sym(lcand));
+		}
+	}
+
+	ret.left = ldo;
+	ret.right = rdo;
+	return ret;
+}
+
+inline void delaunay_triangulation::builder::collect(uint32_t begin, uint32_t end, std::vector<triangle_type>& tris)const{
+	for(uint32_t q = begin; q != end; ++q){
+		if(this->vert[q * 4] == none){
+			continue;
+		}
+		for(uint32_t e = q * 4; e <= q * 4 + 2; e += 2){
+			// each triangle is traversed from its three edges, take it from the smallest one
+			uint32_t e1 = this->lnext(e);
+			uint32_t e2 = this->lnext(e1);
+			if(this->lnext(e2) != e || e1 < e || e2 < e){
+				continue;
+			}
+			// the outer face of three points is also traversed by three edges, but in clockwise order
+			if(!this->ccw(this->org(e), this->org(e1), this->org(e2))){
+				continue;
+			}
+			tris.push_back(triangle_type{{
+					this->sorted[this->org(e)],
+					this->sorted[this->org(e1)],
+					this->sorted[this->org(e2)]
+				}});
+		}
+	}
+}
+
+inline void delaunay_triangulation::build(const vector2<double>* points, size_t size, unsigned num_threads){
+	num_threads = triangulation_internal::resolve_num_threads(num_threads);
+
+	this->tris.clear();
+	if(size == 0){
+		this->bounds = rectangle<double>(0, 0, 0, 0);
+		return;
+	}
+	auto bb = segment2<double>::bounding_box(points, size);
+	this->bounds = rectangle<double>(bb.p1, bb.p2 - bb.p1);
+
+	builder b(points, size, num_threads);
+	b.triangulate(num_threads);
+
+	// collect triangles in parallel, the result does not depend on number of threads
+	uint32_t num_records = b.num_records();
+	if(num_threads <= 1 || num_records < triangulation_internal::parallel_threshold){
+		b.collect(0, num_records, this->tris);
+		return;
+	}
+	std::vector<std::vector<triangle_type>> chunks(num_threads);
+	std::vector<std::thread> threads;
+	for(unsigned i = 0; i != num_threads; ++i){
+		threads.emplace_back([&, i](){
+			b.collect(
+					uint32_t(uint64_t(num_records) * i / num_threads),
+					uint32_t(uint64_t(num_records) * (i + 1) / num_threads),
+					chunks[i]
+				);
+		});
+	}
+	for(auto& t : threads){
+		t.join();
+	}
+	for(auto& c : chunks){
+		this->tris.insert(this->tris.end(), c.begin(), c.end());
+	}
+}
+
+}
@@ -4,6 +4,8 @@
 #include <array>
 
 #include <utki/debug.hpp>
+
+#include "config.hpp"
 #include <utki/math.hpp>
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
@@ -27,28 +29,28 @@ public:
 	/**
 	 * @brief 0th vector component.
 	 */
-	T& x()noexcept{
+	constexpr T& x()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief 0th vector component.
 	 */
-	const T& x()const noexcept{
+	constexpr const T& x()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief 1th vector component.
 	 */
-	T& y()noexcept{
+	constexpr T& y()noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief 1th vector component.
 	 */
-	const T& y()const noexcept{
+	constexpr const T& y()const noexcept{
 		return this->operator[](1);
 	}
 
@@ -92,7 +94,7 @@ public:
 	 * component as argument of the target type constructor.
      * @return converted vector2.
      */
-	template <class TT> vector2<TT> to()const noexcept{
+	template <class TT> constexpr vector2<TT> to()const noexcept{
 		return vector2<TT>{
 				TT(this->x()),
 				TT(this->y())
@@ -105,7 +107,7 @@ public:
 	 * @param vec - reference to the vector3 object to assign value from.
 	 * @return reference to this vector2 object.
 	 */
-	vector2& operator=(const vector3<T>& vec)noexcept;
+	constexpr vector2& operator=(const vector3<T>& vec)noexcept;
 
 	/**
 	 * @brief Add vector2 and vector3.
@@ -113,7 +115,7 @@ public:
 	 * @param vec - reference to the vector3 object to add.
 	 * @return instance of the resulting vector2.
 	 */
-	vector2 operator+(const vector3<T>& vec)const noexcept;
+	constexpr vector2 operator+(const vector3<T>& vec)const noexcept;
 
 	/**
 	 * @brief Add and assign.
@@ -121,7 +123,7 @@ public:
 	 * @param vec - reference to the vector2 object to add.
 	 * @return reference to this vector2 object.
 	 */
-	vector2& operator+=(const vector2& vec)noexcept{
+	constexpr vector2& operator+=(const vector2& vec)noexcept{
 		this->x() += vec.x();
 		this->y() += vec.y();
 		return *this;
@@ -132,7 +134,7 @@ public:
 	 * @param vec - reference to the vector2 object to add.
 	 * @return instance of the resulting vector2.
 	 */
-	vector2 operator+(const vector2& vec)const noexcept{
+	constexpr vector2 operator+(const vector2& vec)const noexcept{
 		return (vector2(*this) += vec);
 	}
 
@@ -141,7 +143,7 @@ public:
 	 * @param num - number to add.
 	 * @return resulting vector.
 	 */
-	vector2 operator+(T num)const noexcept{
+	constexpr vector2 operator+(T num)const noexcept{
 		return vector2{
 			this->x() + num,
 			this->y() + num
@@ -154,7 +156,7 @@ public:
      * @param vec - vector to subtract from this one.
      * @return Reference to this vector object.
      */
-	vector2& operator-=(const vector2& vec)noexcept{
+	constexpr vector2& operator-=(const vector2& vec)noexcept{
 		this->x() -= vec.x();
 		this->y() -= vec.y();
 		return *this;
@@ -165,7 +167,7 @@ public:
      * @param vec - vector to subtract from this one.
      * @return Vector resulting from subtraction of given vector from this vector.
      */
-	vector2 operator-(const vector2& vec)const noexcept{
+	constexpr vector2 operator-(const vector2& vec)const noexcept{
 		return (vector2(*this) -= vec);
 	}
 
@@ -176,13 +178,13 @@ public:
      * @param vec - vector to subtract from this one.
      * @return Resulting two-dimensional vector.
      */
-	vector2 operator-(const vector3<T>& vec)const noexcept;
+	constexpr vector2 operator-(const vector3<T>& vec)const noexcept;
 
 	/**
 	 * @brief Unary minus.
 	 * @return Vector resulting from negating this vector.
 	 */
-	vector2 operator-()const noexcept{
+	constexpr vector2 operator-()const noexcept{
 		return vector2(-this->x(), -this->y());
 	}
 
@@ -192,7 +194,7 @@ public:
      * @param num - scalar to multiply by.
      * @return Reference to this vector object.
      */
-	vector2& operator*=(T num)noexcept{
+	constexpr vector2& operator*=(T num)noexcept{
 		this->x() *= num;
 		this->y() *= num;
 		return *this;
@@ -203,7 +205,7 @@ public:
 	 * @param num - scalar to multiply by.
 	 * @return Vector resulting from multiplication of this vector by given scalar.
 	 */
-	vector2 operator*(T num)const noexcept{
+	constexpr vector2 operator*(T num)const noexcept{
 		return (vector2(*this) *= num);
 	}
 
@@ -213,7 +215,7 @@ public:
      * @param vec - vector to multiply by.
      * @return Vector resulting from multiplication of given scalar by given vector.
      */
-	friend vector2 operator*(T num, const vector2& vec)noexcept{
+	friend constexpr vector2 operator*(T num, const vector2& vec)noexcept{
 		return vec * num;
 	}
 
@@ -223,7 +225,7 @@ public:
 	 * @param vb - second vector.
 	 * @return vector2 whose components are component-wise minimum of initial vectors.
 	 */
-	friend vector2 min(const vector2& va, const vector2& vb)noexcept{
+	friend constexpr vector2 min(const vector2& va, const vector2& vb)noexcept{
 		using std::min;
 		return vector2{
 				min(va[0], vb[0]),
@@ -237,7 +239,7 @@ public:
 	 * @param vb - second vector.
 	 * @return vector2 whose components are component-wise maximum of initial vectors.
 	 */
-	friend vector2 max(const vector2& va, const vector2& vb)noexcept{
+	friend constexpr vector2 max(const vector2& va, const vector2& vb)noexcept{
 		using std::max;
 		return vector2{
 				max(va[0], vb[0]),
@@ -251,8 +253,8 @@ public:
      * @param num - scalar to divide by.
      * @return Reference to this vector object.
      */
-	vector2& operator/=(T num)noexcept{
-		ASSERT(num != 0)
+	constexpr vector2& operator/=(T num)noexcept{
+		R4_ASSERT(num != 0);
 		this->x() /= num;
 		this->y() /= num;
 		return *this;
@@ -263,8 +265,8 @@ public:
 	 * @param num - scalar to divide this vector by.
 	 * @return Vector resulting from dividing this vector by given scalar.
 	 */
-	vector2 operator/(T num)const noexcept{
-		ASSERT(num != 0)
+	constexpr vector2 operator/(T num)const noexcept{
+		R4_ASSERT(num != 0);
 		return (vector2(*this) /= num);
 	}
 
@@ -273,7 +275,7 @@ public:
 	 * Dot product of this vector and a given vector.
 	 * @return Dot product of two vectors (x1 * x2 + y1 * y2).
 	 */
-	T operator*(const vector2& vec)const noexcept{
+	constexpr T operator*(const vector2& vec)const noexcept{
 		return this->x() * vec.x() + this->y() * vec.y();
 	}
 
@@ -285,7 +287,7 @@ public:
      * @param vec - vector to multiply by.
      * @return Vector resulting from component-wise multiplication.
      */
-	vector2 comp_mul(const vector2& vec)const noexcept{
+	constexpr vector2 comp_mul(const vector2& vec)const noexcept{
 		return vector2{
 				this->x() * vec.x(),
 				this->y() * vec.y()
@@ -299,7 +301,7 @@ public:
      * @param vec - vector to multiply by.
      * @return reference to this vector2 instance.
      */
-	vector2& comp_multiply(const vector2& vec)noexcept{
+	constexpr vector2& comp_multiply(const vector2& vec)noexcept{
 		this->x() *= vec.x();
 		this->y() *= vec.y();
 		return *this;
@@ -313,7 +315,7 @@ public:
      * @param v - vector to divide by.
      * @return Vector resulting from component-wise division.
      */
-	vector2 comp_div(const vector2& v)const noexcept{
+	constexpr vector2 comp_div(const vector2& v)const noexcept{
 		return vector2{
 				this->x() / v.x(),
 				this->y() / v.y()
@@ -327,7 +329,7 @@ public:
      * @param v - vector to divide by.
      * @return reference to this vector2 instance.
      */
-	vector2& comp_divide(const vector2& v)noexcept{
+	constexpr vector2& comp_divide(const vector2& v)noexcept{
 		this->x() /= v.x();
 		this->y() /= v.y();
 		return *this;
@@ -338,7 +340,7 @@ public:
 	 * @return true if both vector components are zero.
 	 * @return false otherwise.
 	 */
-	bool is_zero()const noexcept{
+	constexpr bool is_zero()const noexcept{
 		return this->x() == 0 && this->y() == 0;
 	}
 
@@ -347,7 +349,7 @@ public:
 	 * @return true if both vector components are positive or zero.
 	 * @return false otherwise.
 	 */
-	bool is_positive_or_zero()const noexcept{
+	constexpr bool is_positive_or_zero()const noexcept{
 		return this->x() >= 0 && this->y() >= 0;
 	}
 
@@ -356,7 +358,7 @@ public:
 	 * @return true if both vector components are positive.
      * @return false otherwise.
      */
-	bool is_positive()const noexcept{
+	constexpr bool is_positive()const noexcept{
 		return this->x() > 0 && this->y() > 0;
 	}
 
@@ -365,7 +367,7 @@ public:
 	 * @return true if both vector components are negative.
      * @return false otherwise.
      */
-	bool is_negative()const noexcept{
+	constexpr bool is_negative()const noexcept{
 		return this->x() < 0 && this->y() < 0;
 	}
 
@@ -373,7 +375,7 @@ public:
 	 * @brief Negate this vector.
      * @return Reference to this vector object.
      */
-	vector2& negate()noexcept{
+	constexpr vector2& negate()noexcept{
 		// NOTE: this should be faster than (*this) = -(*this);
 		this->x() = -this->x();
 		this->y() = -this->y();
@@ -396,7 +398,7 @@ public:
 	 * @brief Calculate power 2 of vector norm.
 	 * @return Power 2 of this vector norm.
 	 */
-	T norm_pow2()noexcept{
+	constexpr T norm_pow2()const noexcept{
 		return utki::pow2(this->x()) + utki::pow2(this->y());
 	}
 
@@ -404,8 +406,9 @@ public:
 	 * @brief Calculate norm of the vector.
 	 * @return norm of this vector.
 	 */
-	T norm()noexcept{
-		return T(std::sqrt(this->norm_pow2()));
+	T norm()const noexcept{
+		using std::sqrt;
+		return T(sqrt(this->norm_pow2()));
 	}
 
 	/**
@@ -436,7 +439,7 @@ public:
 	 * @param val - value to set vector components to.
 	 * @return Reference to this vector object.
 	 */
-	vector2& set(T val)noexcept{
+	constexpr vector2& set(T val)noexcept{
 		this->x() = val;
 		this->y() = val;
 		return *this;
@@ -523,20 +526,20 @@ template <class T> constexpr vector2<T>::vector2(const vector3<T>& vec)noexcept
 		vector2{vec[0], vec[1]}
 {}
 
-template <class T> vector2<T>& vector2<T>::operator=(const vector3<T>& vec)noexcept{
+template <class T> constexpr vector2<T>& vector2<T>::operator=(const vector3<T>& vec)noexcept{
 	this->x() = vec.x();
 	this->y() = vec.y();
 	return *this;
 }
 
-template <class T> vector2<T> vector2<T>::operator+(const vector3<T>& vec)const noexcept{
+template <class T> constexpr vector2<T> vector2<T>::operator+(const vector3<T>& vec)const noexcept{
 	return vector2<T>{
 			this->x() + vec.x(),
 			this->y() + vec.y()
 		};
 }
 
-template <class T> vector2<T> vector2<T>::operator-(const vector3<T>& vec)const noexcept{
+template <class T> constexpr vector2<T> vector2<T>::operator-(const vector3<T>& vec)const noexcept{
 	return vector2<T>{
 			this->x() - vec.x(),
 			this->y() - vec.y()
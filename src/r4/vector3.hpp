@@ -4,6 +4,8 @@
 #include <array>
 
 #include <utki/debug.hpp>
+
+#include "config.hpp"
 #include <utki/math.hpp>
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
@@ -30,84 +32,84 @@ public:
 	/**
 	 * @brief First vector component.
 	 */
-	T& x()noexcept{
+	constexpr T& x()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& x()const noexcept{
+	constexpr const T& x()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	T& r()noexcept{
+	constexpr T& r()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& r()const noexcept{
+	constexpr const T& r()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	T& y(){
+	constexpr T& y(){
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	const T& y()const noexcept{
+	constexpr const T& y()const noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	T& g(){
+	constexpr T& g(){
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	const T& g()const noexcept{
+	constexpr const T& g()const noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Third vector component.
 	 */
-	T& z(){
+	constexpr T& z(){
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
 	 */
-	const T& z()const noexcept{
+	constexpr const T& z()const noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
 	 */
-	T& b(){
+	constexpr T& b(){
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
 	 */
-	const T& b()const noexcept{
+	constexpr const T& b()const noexcept{
 		return this->operator[](2);
 	}
 
@@ -169,7 +171,7 @@ public:
 	 * component as argument of the target type constructor.
 	 * @return converted vector3.
 	 */
-	template <typename TT> vector3<TT> to()noexcept{
+	template <typename TT> constexpr vector3<TT> to()noexcept{
 		return vector3<TT>{
 				TT(this->x()),
 				TT(this->y()),
@@ -184,7 +186,7 @@ public:
 	 * @param vec - 2d vector to assign first two components from.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator=(const vector2<T>& vec)noexcept;
+	constexpr vector3& operator=(const vector2<T>& vec)noexcept;
 
 	/**
 	 * @brief Assign a number.
@@ -192,7 +194,7 @@ public:
 	 * @param num - number to use for assignment.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator=(T num)noexcept{
+	constexpr vector3& operator=(T num)noexcept{
 		this->x() = num;
 		this->y() = num;
 		this->z() = num;
@@ -204,7 +206,7 @@ public:
 	 * @param val - value to set vector components to.
 	 * @return Reference to this vector object.
 	 */
-	vector3& set(T val)noexcept{
+	constexpr vector3& set(T val)noexcept{
 		this->x() = val;
 		this->y() = val;
 		this->z() = val;
@@ -218,7 +220,7 @@ public:
 	 * @param vec - 2d vector to use for addition.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator+=(const vector2<T>& vec)noexcept;
+	constexpr vector3& operator+=(const vector2<T>& vec)noexcept;
 
 	/**
 	 * @brief Add and assign.
@@ -226,7 +228,7 @@ public:
 	 * @param vec - vector to add.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator+=(const vector3& vec)noexcept{
+	constexpr vector3& operator+=(const vector3& vec)noexcept{
 		this->x() += vec.x();
 		this->y() += vec.y();
 		this->z() += vec.z();
@@ -239,7 +241,7 @@ public:
 	 * @param vec - vector to add.
 	 * @return Vector resulting from vector addition.
 	 */
-	vector3 operator+(const vector3& vec)const noexcept{
+	constexpr vector3 operator+(const vector3& vec)const noexcept{
 		return (vector3(*this) += vec);
 	}
 
@@ -249,7 +251,7 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator-=(const vector3& vec)noexcept{
+	constexpr vector3& operator-=(const vector3& vec)noexcept{
 		this->x() -= vec.x();
 		this->y() -= vec.y();
 		this->z() -= vec.z();
@@ -262,7 +264,7 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Vector resulting from vector subtraction.
 	 */
-	vector3 operator-(const vector3& vec)const noexcept{
+	constexpr vector3 operator-(const vector3& vec)const noexcept{
 		return (vector3(*this) -= vec);
 	}
 
@@ -270,7 +272,7 @@ public:
 	 * @brief Unary minus.
 	 * @return Negated vector.
 	 */
-	vector3 operator-()const noexcept{
+	constexpr vector3 operator-()const noexcept{
 		return vector3(*this).negate();
 	}
 
@@ -280,7 +282,7 @@ public:
 	 * @param num - scalar to multiply by.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator*=(T num)noexcept{
+	constexpr vector3& operator*=(T num)noexcept{
 		this->x() *= num;
 		this->y() *= num;
 		this->z() *= num;
@@ -293,7 +295,7 @@ public:
 	 * @param num - scalar to multiply by.
 	 * @return Vector resulting from multiplication of this vector by scalar.
 	 */
-	vector3 operator*(T num)const noexcept{
+	constexpr vector3 operator*(T num)const noexcept{
 		return (vector3(*this) *= num);
 	}
 
@@ -303,7 +305,7 @@ public:
      * @param num - scalar to divide by.
      * @return Vector resulting from division of this vector by scalar.
      */
-	vector3 operator/(T num)const noexcept{
+	constexpr vector3 operator/(T num)const noexcept{
 		return {
 			this->x() / num,
 			this->y() / num,
@@ -317,7 +319,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from multiplication of given scalar by given vector.
 	 */
-	friend vector3 operator*(T num, const vector3& vec)noexcept{
+	friend constexpr vector3 operator*(T num, const vector3& vec)noexcept{
 		return vec * num;
 	}
 
@@ -327,8 +329,8 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Reference to this vector object.
 	 */
-	vector3& operator/=(T num)noexcept{
-		ASSERT(num != 0)
+	constexpr vector3& operator/=(T num)noexcept{
+		R4_ASSERT(num != 0);
 		this->x() /= num;
 		this->y() /= num;
 		this->z() /= num;
@@ -341,8 +343,8 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Vector resulting from division of this vector by scalars.
 	 */
-	vector3 operator/(T num)noexcept{
-		ASSERT_INFO(num != 0, "vector3::operator/(): division by 0")
+	constexpr vector3 operator/(T num)noexcept{
+		R4_ASSERT_INFO(num != 0, "vector3::operator/(): division by 0");
 		return (vector3(*this) /= num);
 	}
 
@@ -351,7 +353,7 @@ public:
 	 * @param vec -vector to multiply by.
 	 * @return Dot product of this vector and given vector.
 	 */
-	T operator*(const vector3& vec)const noexcept{
+	constexpr T operator*(const vector3& vec)const noexcept{
 		return this->x() * vec.x()
 				+ this->y() * vec.y()
 				+ this->z() * vec.z();
@@ -364,7 +366,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from component-wise multiplication.
 	 */
-	vector3 comp_mul(const vector3& vec)const noexcept{
+	constexpr vector3 comp_mul(const vector3& vec)const noexcept{
 		return vector3{
 				this->x() * vec.x(),
 				this->y() * vec.y(),
@@ -379,7 +381,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return reference to this vector.
 	 */
-	vector3& comp_multiply(const vector3& vec)noexcept{
+	constexpr vector3& comp_multiply(const vector3& vec)noexcept{
 		this->x() *= vec.x();
 		this->y() *= vec.y();
 		this->z() *= vec.z();
@@ -394,7 +396,7 @@ public:
      * @param v - vector to divide by.
      * @return Vector resulting from component-wise division.
      */
-	vector3 comp_div(const vector3& v)const noexcept{
+	constexpr vector3 comp_div(const vector3& v)const noexcept{
 		return vector3{
 				this->x() / v.x(),
 				this->y() / v.y(),
@@ -409,7 +411,7 @@ public:
      * @param v - vector to divide by.
      * @return reference to this vector instance.
      */
-	vector3& comp_divide(const vector3& v)noexcept{
+	constexpr vector3& comp_divide(const vector3& v)noexcept{
 		this->x() /= v.x();
 		this->y() /= v.y();
 		this->z() /= v.z();
@@ -421,7 +423,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from the cross product.
 	 */
-	vector3 operator%(const vector3& vec)const noexcept{
+	constexpr vector3 operator%(const vector3& vec)const noexcept{
 		return vector3{
 				this->y() * vec.z() - this->z() * vec.y(),
 				this->z() * vec.x() - this->x() * vec.z(),
@@ -434,7 +436,7 @@ public:
 	 * @return true if all components of this vector are zero.
 	 * @return false otherwise.
 	 */
-	bool is_zero()const noexcept{
+	constexpr bool is_zero()const noexcept{
 		return this->x() == 0 && this->y() == 0 && this->z() == 0;
 	}
 
@@ -443,7 +445,7 @@ public:
 	 * Negates this vector.
 	 * @return Reference to this vector object.
 	 */
-	vector3& negate()noexcept{
+	constexpr vector3& negate()noexcept{
 		this->x() = -this->x();
 		this->y() = -this->y();
 		this->z() = -this->z();
@@ -454,7 +456,7 @@ public:
 	 * @brief Calculate power 2 of vector norm.
 	 * @return Power 2 of this vector norm.
 	 */
-	T norm_pow2()const noexcept{
+	constexpr T norm_pow2()const noexcept{
 		return utki::pow2(this->x()) + utki::pow2(this->y()) + utki::pow2(this->z());
 	}
 
@@ -463,7 +465,8 @@ public:
 	 * @return Vector norm.
 	 */
 	T norm()const noexcept{
-		return std::sqrt(this->norm_pow2());
+		using std::sqrt;
+		return T(sqrt(this->norm_pow2()));
 	}
 
 	/**
@@ -489,8 +492,8 @@ public:
 	 * @param vec - vector to project onto, it does not have to be normalized.
 	 * @return Reference to this vector object.
 	 */
-	vector3& project(const vector3& vec)noexcept{
-		ASSERT(this->norm_pow2() != 0)
+	constexpr vector3& project(const vector3& vec)noexcept{
+		R4_ASSERT(this->norm_pow2() != 0);
 		(*this) = vec * (vec * (*this)) / vec.norm_pow2();
 		return *this;
 	}
@@ -501,7 +504,7 @@ public:
 	 * @param q - quaternion which defines the rotation.
 	 * @return Reference to this vector object.
 	 */
-	vector3<T>& rotate(const quaternion<T>& q)noexcept;
+	constexpr vector3<T>& rotate(const quaternion<T>& q)noexcept;
 
 	/**
 	 * @brief Snap each vector component to 0.
@@ -525,7 +528,7 @@ public:
 	 * @param vb - second vector.
 	 * @return vector3 whose components are component-wise minimum of initial vectors.
 	 */
-	friend vector3 min(const vector3& va, const vector3& vb)noexcept{
+	friend constexpr vector3 min(const vector3& va, const vector3& vb)noexcept{
 		using std::min;
 		return vector3{
 				min(va[0], vb[0]),
@@ -540,7 +543,7 @@ public:
 	 * @param vb - second vector.
 	 * @return vector3 whose components are component-wise maximum of initial vectors.
 	 */
-	friend vector3 max(const vector3& va, const vector3& vb)noexcept{
+	friend constexpr vector3 max(const vector3& va, const vector3& vb)noexcept{
 		using std::max;
 		return vector3{
 				max(va[0], vb[0]),
@@ -572,21 +575,24 @@ template <class T> constexpr vector3<T>::vector3(const vector4<T>& vec)noexcept
 		std::array<T, 3>{{vec[0], vec[1], vec[2]}}
 {}
 
-template <class T> vector3<T>& vector3<T>::operator=(const vector2<T>& vec)noexcept{
+template <class T> constexpr vector3<T>& vector3<T>::operator=(const vector2<T>& vec)noexcept{
 	this->x() = vec.x();
 	this->y() = vec.y();
 	this->z() = 0;
 	return *this;
 }
 
-template <class T> vector3<T>& vector3<T>::operator+=(const vector2<T>& vec)noexcept{
+template <class T> constexpr vector3<T>& vector3<T>::operator+=(const vector2<T>& vec)noexcept{
 	this->x() += vec.x();
 	this->y() += vec.y();
 	return *this;
 }
 
-template <class T> vector3<T>& vector3<T>::rotate(const quaternion<T>& q)noexcept{
-	*this = q.to_matrix4() * (*this);
+template <class T> constexpr vector3<T>& vector3<T>::rotate(const quaternion<T>& q)noexcept{
+	// v' = q * v * q^-1 expands to v' = v + w * t + u x t, where u = (q.x, q.y, q.z) and t = 2 * (u x v)
+	vector3<T> u(q.x(), q.y(), q.z());
+	vector3<T> t = (u % (*this)) * T(2);
+	*this += t * q.w() + u % t;
 	return *this;
 }
 
@@ -4,6 +4,8 @@
 #include <array>
 
 #include <utki/debug.hpp>
+
+#include "config.hpp"
 #include <utki/math.hpp>
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
@@ -24,116 +26,138 @@ template <class T> class vector3;
  */
 template <class T> class vector4 : public std::array<T, 4>{
 	typedef std::array<T, 4> base_type;
+
+	// component-wise minimum, separate function to allow specialization
+	static constexpr vector4 comp_min(const vector4& va, const vector4& vb)noexcept{
+		using std::min;
+		return vector4{
+				min(va[0], vb[0]),
+				min(va[1], vb[1]),
+				min(va[2], vb[2]),
+				min(va[3], vb[3])
+			};
+	}
+
+	// component-wise maximum, separate function to allow specialization
+	static constexpr vector4 comp_max(const vector4& va, const vector4& vb)noexcept{
+		using std::max;
+		return vector4{
+				max(va[0], vb[0]),
+				max(va[1], vb[1]),
+				max(va[2], vb[2]),
+				max(va[3], vb[3])
+			};
+	}
 public:
 	/**
 	 * @brief First vector component.
 	 */
-	T& x()noexcept{
+	constexpr T& x()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& x()const noexcept{
+	constexpr const T& x()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	T& r()noexcept{
+	constexpr T& r()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& r()const noexcept{
+	constexpr const T& r()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	T& y()noexcept{
+	constexpr T& y()noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	const T& y()const noexcept{
+	constexpr const T& y()const noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	T& g()noexcept{
+	constexpr T& g()noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Second vector component.
 	 */
-	const T& g()const noexcept{
+	constexpr const T& g()const noexcept{
 		return this->operator[](1);
 	}
 
 	/**
 	 * @brief Third vector component.
      */
-	T& z()noexcept{
+	constexpr T& z()noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
      */
-	const T& z()const noexcept{
+	constexpr const T& z()const noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
      */
-	T& b()noexcept{
+	constexpr T& b()noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Third vector component.
      */
-	const T& b()const noexcept{
+	constexpr const T& b()const noexcept{
 		return this->operator[](2);
 	}
 
 	/**
 	 * @brief Fourth vector component.
      */
-	T& w()noexcept{
+	constexpr T& w()noexcept{
 		return this->operator[](3);
 	}
 
 	/**
 	 * @brief Fourth vector component.
      */
-	const T& w()const noexcept{
+	constexpr const T& w()const noexcept{
 		return this->operator[](3);
 	}
 
 	/**
 	 * @brief Fourth vector component.
      */
-	T& a()noexcept{
+	constexpr T& a()noexcept{
 		return this->operator[](3);
 	}
 
 	/**
 	 * @brief Fourth vector component.
      */
-	const T& a()const noexcept{
+	constexpr const T& a()const noexcept{
 		return this->operator[](3);
 	}
 
@@ -198,7 +222,7 @@ public:
 	 * component as argument of the target type constructor.
 	 * @return converted vector4.
 	 */
-	template <typename TT> vector4<TT> to()noexcept{
+	template <typename TT> constexpr vector4<TT> to()noexcept{
 		return vector4<TT>{
 				TT(this->x()),
 				TT(this->y()),
@@ -214,7 +238,7 @@ public:
 	 * @param vec - 3d vector to assign first three components from.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator=(const vector3<T>& vec)noexcept;
+	constexpr vector4& operator=(const vector3<T>& vec)noexcept;
 
 	/**
 	 * @brief Assign from 2d vector.
@@ -224,7 +248,7 @@ public:
 	 * @param vec - 2d vector to assign first two components from.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator=(const vector2<T>& vec)noexcept;
+	constexpr vector4& operator=(const vector2<T>& vec)noexcept;
 
 	/**
 	 * @brief Assign a number.
@@ -232,7 +256,7 @@ public:
      * @param num - number to use for assignment.
      * @return Reference to this vector object.
      */
-	vector4& operator=(T num)noexcept{
+	constexpr vector4& operator=(T num)noexcept{
 		this->set(num);
 		return *this;
 	}
@@ -242,7 +266,7 @@ public:
 	 * @param val - value to set vector components to.
 	 * @return Reference to this vector object.
 	 */
-	vector4& set(T val)noexcept{
+	constexpr vector4& set(T val)noexcept{
 		this->x() = val;
 		this->y() = val;
 		this->z() = val;
@@ -257,7 +281,7 @@ public:
 	 * @param vec - 2d vector to use for addition.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator+=(const vector2<T>& vec)noexcept;
+	constexpr vector4& operator+=(const vector2<T>& vec)noexcept;
 
 	/**
 	 * @brief Add and assign.
@@ -266,7 +290,7 @@ public:
 	 * @param vec - 3d vector to use for addition.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator+=(const vector3<T>& vec)noexcept;
+	constexpr vector4& operator+=(const vector3<T>& vec)noexcept;
 
 	/**
 	 * @brief Add and assign.
@@ -274,7 +298,7 @@ public:
 	 * @param vec - vector to add.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator+=(const vector4& vec)noexcept{
+	constexpr vector4& operator+=(const vector4& vec)noexcept{
 		this->x() += vec.x();
 		this->y() += vec.y();
 		this->z() += vec.z();
@@ -288,7 +312,7 @@ public:
 	 * @param vec - vector to add.
 	 * @return Vector resulting from vector addition.
 	 */
-	vector4 operator+(const vector4& vec)const noexcept{
+	constexpr vector4 operator+(const vector4& vec)const noexcept{
 		return (vector4(*this) += vec);
 	}
 
@@ -298,7 +322,7 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator-=(const vector4& vec)noexcept{
+	constexpr vector4& operator-=(const vector4& vec)noexcept{
 		this->x() -= vec.x();
 		this->y() -= vec.y();
 		this->z() -= vec.z();
@@ -312,7 +336,7 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Vector resulting from vector subtraction.
 	 */
-	vector4 operator-(const vector4& vec)const noexcept{
+	constexpr vector4 operator-(const vector4& vec)const noexcept{
 		return (vector4(*this) -= vec);
 	}
 
@@ -320,7 +344,7 @@ public:
 	 * @brief Unary minus.
      * @return Negated vector.
      */
-	vector4 operator-()const noexcept{
+	constexpr vector4 operator-()const noexcept{
 		return vector4(*this).negate();
 	}
 
@@ -330,7 +354,7 @@ public:
      * @param num - scalar to multiply by.
      * @return Reference to this vector object.
      */
-	vector4& operator*=(T num)noexcept{
+	constexpr vector4& operator*=(T num)noexcept{
 		this->x() *= num;
 		this->y() *= num;
 		this->z() *= num;
@@ -344,7 +368,7 @@ public:
      * @param num - scalar to multiply by.
      * @return Vector resulting from multiplication of this vector by scalar.
      */
-	vector4 operator*(T num)const noexcept{
+	constexpr vector4 operator*(T num)const noexcept{
 		return (vector4(*this) *= num);
 	}
 
@@ -354,7 +378,7 @@ public:
      * @param num - scalar to divide by.
      * @return Vector resulting from division of this vector by scalar.
      */
-	vector4 operator/(T num)const noexcept{
+	constexpr vector4 operator/(T num)const noexcept{
 		return {
 			this->x() / num,
 			this->y() / num,
@@ -369,7 +393,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from multiplication of given scalar by given vector.
 	 */
-	friend vector4 operator*(T num, const vector4& vec)noexcept{
+	friend constexpr vector4 operator*(T num, const vector4& vec)noexcept{
 		return vec * num;
 	}
 
@@ -379,8 +403,8 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Reference to this vector object.
 	 */
-	vector4& operator/=(T num)noexcept{
-		ASSERT_INFO(num != 0, "vector4::operator/=(): division by 0")
+	constexpr vector4& operator/=(T num)noexcept{
+		R4_ASSERT_INFO(num != 0, "vector4::operator/=(): division by 0");
 		this->x() /= num;
 		this->y() /= num;
 		this->z() /= num;
@@ -394,8 +418,8 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Vector resulting from division of this vector by scalars.
 	 */
-	vector4 operator/(T num)noexcept{
-		ASSERT_INFO(num != 0, "vector4::operator/(): division by 0")
+	constexpr vector4 operator/(T num)noexcept{
+		R4_ASSERT_INFO(num != 0, "vector4::operator/(): division by 0");
 		return (vector4(*this) /= num);
 	}
 
@@ -404,7 +428,7 @@ public:
      * @param vec -vector to multiply by.
      * @return Dot product of this vector and given vector.
      */
-	T operator*(const vector4& vec)const noexcept{
+	constexpr T operator*(const vector4& vec)const noexcept{
 		return this->x() * vec.x()
 				+ this->y() * vec.y()
 				+ this->z() * vec.z()
@@ -419,7 +443,7 @@ public:
      * @param vec - vector to multiply by.
      * @return Four-dimensional vector resulting from the cross product.
      */
-	vector4 operator%(const vector4& vec)const noexcept{
+	constexpr vector4 operator%(const vector4& vec)const noexcept{
 		return vector4(
 				this->y() * vec.z() - this->z() * vec.y(),
 				this->z() * vec.x() - this->x() * vec.z(),
@@ -435,7 +459,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from component-wise multiplication.
 	 */
-	vector4 comp_mul(const vector4& vec)const noexcept{
+	constexpr vector4 comp_mul(const vector4& vec)const noexcept{
 		return vector4{
 				this->x() * vec.x(),
 				this->y() * vec.y(),
@@ -451,7 +475,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return reference to this vector.
 	 */
-	vector4& comp_multiply(const vector4& vec)noexcept{
+	constexpr vector4& comp_multiply(const vector4& vec)noexcept{
 		this->x() *= vec.x();
 		this->y() *= vec.y();
 		this->z() *= vec.z();
@@ -467,7 +491,7 @@ public:
      * @param v - vector to divide by.
      * @return Vector resulting from component-wise division.
      */
-	vector4 comp_div(const vector4& v)const noexcept{
+	constexpr vector4 comp_div(const vector4& v)const noexcept{
 		return vector4{
 				this->x() / v.x(),
 				this->y() / v.y(),
@@ -483,7 +507,7 @@ public:
      * @param v - vector to divide by.
      * @return reference to this vector instance.
      */
-	vector4& comp_divide(const vector4& v)noexcept{
+	constexpr vector4& comp_divide(const vector4& v)noexcept{
 		this->x() /= v.x();
 		this->y() /= v.y();
 		this->z() /= v.z();
@@ -496,7 +520,7 @@ public:
 	 * Negates this vector.
 	 * @return Reference to this vector object.
 	 */
-	vector4& negate()noexcept{
+	constexpr vector4& negate()noexcept{
 		this->x() = -this->x();
 		this->y() = -this->y();
 		this->z() = -this->z();
@@ -508,7 +532,7 @@ public:
 	 * @brief Calculate power 2 of vector norm.
 	 * @return Power 2 of this vector norm.
 	 */
-	T norm_pow2()const noexcept{
+	constexpr T norm_pow2()const noexcept{
 		return utki::pow2(this->x())
 				+ utki::pow2(this->y())
 				+ utki::pow2(this->z())
@@ -520,7 +544,8 @@ public:
 	 * @return Vector norm.
 	 */
 	T norm()const noexcept{
-		return sqrt(this->norm_pow2());
+		using std::sqrt;
+		return T(sqrt(this->norm_pow2()));
 	}
 
 	/**
@@ -564,14 +589,8 @@ public:
 	 * @param vb - second vector.
 	 * @return vector4 whose components are component-wise minimum of initial vectors.
 	 */
-	friend vector4 min(const vector4& va, const vector4& vb)noexcept{
-		using std::min;
-		return vector4{
-				min(va[0], vb[0]),
-				min(va[1], vb[1]),
-				min(va[2], vb[2]),
-				min(va[3], vb[3])
-			};
+	friend constexpr vector4 min(const vector4& va, const vector4& vb)noexcept{
+		return vector4::comp_min(va, vb);
 	}
 
 	/**
@@ -580,14 +599,8 @@ public:
 	 * @param vb - second vector.
 	 * @return vector4 whose components are component-wise maximum of initial vectors.
 	 */
-	friend vector4 max(const vector4& va, const vector4& vb)noexcept{
-		using std::max;
-		return vector4{
-				max(va[0], vb[0]),
-				max(va[1], vb[1]),
-				max(va[2], vb[2]),
-				max(va[3], vb[3])
-			};
+	friend constexpr vector4 max(const vector4& va, const vector4& vb)noexcept{
+		return vector4::comp_max(va, vb);
 	}
 
 	friend std::ostream& operator<<(std::ostream& s, const vector4<T>& vec){
@@ -600,6 +613,7 @@ public:
 
 #include "vector2.hpp"
 #include "vector3.hpp"
+#include "simd.hpp"
 
 namespace r4{
 
@@ -611,7 +625,7 @@ template <class T> constexpr vector4<T>::vector4(const vector3<T>& vec, T w)noex
 		vector4(vec.x(), vec.y(), vec.z(), w)
 {}
 
-template <class T> vector4<T>& vector4<T>::operator=(const vector3<T>& vec)noexcept{
+template <class T> constexpr vector4<T>& vector4<T>::operator=(const vector3<T>& vec)noexcept{
 	this->x() = vec.x();
 	this->y() = vec.y();
 	this->z() = vec.z();
@@ -619,7 +633,7 @@ template <class T> vector4<T>& vector4<T>::operator=(const vector3<T>& vec)noexc
 	return *this;
 }
 
-template <class T> vector4<T>& vector4<T>::operator=(const vector2<T>& vec)noexcept{
+template <class T> constexpr vector4<T>& vector4<T>::operator=(const vector2<T>& vec)noexcept{
 	this->x() = vec.x();
 	this->y() = vec.y();
 	this->z() = 0;
@@ -627,14 +641,14 @@ template <class T> vector4<T>& vector4<T>::operator=(const vector2<T>& vec)noexc
 	return *this;
 }
 
-template <class T> vector4<T>& vector4<T>::operator+=(const vector2<T>& vec)noexcept{
+template <class T> constexpr vector4<T>& vector4<T>::operator+=(const vector2<T>& vec)noexcept{
 	this->x() += vec.x();
 	this->y() += vec.y();
 	this->w() += T(1);
 	return *this;
 }
 
-template <class T> vector4<T>& vector4<T>::operator+=(const vector3<T>& vec)noexcept{
+template <class T> constexpr vector4<T>& vector4<T>::operator+=(const vector3<T>& vec)noexcept{
 	this->x() += vec.x();
 	this->y() += vec.y();
 	this->z() += vec.z();
@@ -642,6 +656,143 @@ template <class T> vector4<T>& vector4<T>::operator+=(const vector3<T>& vec)noex
 	return *this;
 }
 
+#ifdef R4_SIMD
+
+// SIMD specializations of vector4<float> operations.
+// SIMD intrinsics cannot be evaluated at compile time, so during constant evaluation plain scalar code is used.
+
+template <> constexpr vector4<float>& vector4<float>::operator+=(const vector4<float>& vec)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != this->size(); ++i){
+			(*this)[i] += vec[i];
+		}
+	}else{
+		simd::store(this->data(), simd::add(simd::load(this->data()), simd::load(vec.data())));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float>& vector4<float>::operator-=(const vector4<float>& vec)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != this->size(); ++i){
+			(*this)[i] -= vec[i];
+		}
+	}else{
+		simd::store(this->data(), simd::sub(simd::load(this->data()), simd::load(vec.data())));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float>& vector4<float>::operator*=(float num)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(auto& e : *this){
+			e *= num;
+		}
+	}else{
+		simd::store(this->data(), simd::mul(simd::load(this->data()), simd::splat(num)));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float>& vector4<float>::operator/=(float num)noexcept{
+	R4_ASSERT_INFO(num != 0, "vector4::operator/=(): division by 0");
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(auto& e : *this){
+			e /= num;
+		}
+	}else{
+		simd::store(this->data(), simd::div(simd::load(this->data()), simd::splat(num)));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float> vector4<float>::operator/(float num)const noexcept{
+	vector4<float> ret = *this;
+	return ret /= num;
+}
+
+template <> constexpr float vector4<float>::operator*(const vector4<float>& vec)const noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		return this->x() * vec.x() + this->y() * vec.y() + this->z() * vec.z() + this->w() * vec.w();
+	}
+	return simd::dot(simd::load(this->data()), simd::load(vec.data()));
+}
+
+template <> constexpr vector4<float>& vector4<float>::comp_multiply(const vector4<float>& vec)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != this->size(); ++i){
+			(*this)[i] *= vec[i];
+		}
+	}else{
+		simd::store(this->data(), simd::mul(simd::load(this->data()), simd::load(vec.data())));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float> vector4<float>::comp_mul(const vector4<float>& vec)const noexcept{
+	vector4<float> ret = *this;
+	return ret.comp_multiply(vec);
+}
+
+template <> constexpr vector4<float>& vector4<float>::comp_divide(const vector4<float>& v)noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != this->size(); ++i){
+			(*this)[i] /= v[i];
+		}
+	}else{
+		simd::store(this->data(), simd::div(simd::load(this->data()), simd::load(v.data())));
+	}
+	return *this;
+}
+
+template <> constexpr vector4<float> vector4<float>::comp_div(const vector4<float>& v)const noexcept{
+	vector4<float> ret = *this;
+	return ret.comp_divide(v);
+}
+
+template <> constexpr vector4<float>& vector4<float>::negate()noexcept{
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(auto& e : *this){
+			e = -e;
+		}
+	}else{
+		simd::store(this->data(), simd::negate(simd::load(this->data())));
+	}
+	return *this;
+}
+
+template <> constexpr float vector4<float>::norm_pow2()const noexcept{
+	return this->operator*(*this);
+}
+
+template <> constexpr vector4<float> vector4<float>::comp_min(const vector4<float>& va, const vector4<float>& vb)noexcept{
+	vector4<float> ret{};
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != ret.size(); ++i){
+			ret[i] = std::min(va[i], vb[i]);
+		}
+	}else{
+		// NOTE: operands order is swapped to match std::min() semantics when comparing NaNs
+		simd::store(ret.data(), simd::min(simd::load(vb.data()), simd::load(va.data())));
+	}
+	return ret;
+}
+
+template <> constexpr vector4<float> vector4<float>::comp_max(const vector4<float>& va, const vector4<float>& vb)noexcept{
+	vector4<float> ret{};
+	if(R4_IS_CONSTANT_EVALUATED()){
+		for(size_t i = 0; i != ret.size(); ++i){
+			ret[i] = std::max(va[i], vb[i]);
+		}
+	}else{
+		// NOTE: operands order is swapped to match std::max() semantics when comparing NaNs
+		simd::store(ret.data(), simd::max(simd::load(vb.data()), simd::load(va.data())));
+	}
+	return ret;
+}
+
+#endif // ~R4_SIMD
+
 static_assert(sizeof(vector4<float>) == sizeof(float) * 4, "size mismatch");
 static_assert(sizeof(vector4<double>) == sizeof(double) * 4, "size mismatch");
 
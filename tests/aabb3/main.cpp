@@ -0,0 +1,81 @@
+#include <sstream>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/aabb3.hpp"
+
+int main(int argc, char** argv){
+
+	// test constructor and operator<<
+	{
+		r4::aabb3<int> b{{1, 2, 3}, {4, 5, 6}};
+
+		ASSERT_ALWAYS(b.p1 == r4::vector3<int>(1, 2, 3))
+		ASSERT_ALWAYS(b.p2 == r4::vector3<int>(4, 5, 6))
+
+		std::stringstream ss;
+		ss << b;
+		ASSERT_INFO_ALWAYS(ss.str() == "[(1, 2, 3)(4, 5, 6)]", "ss.str() = " << ss.str())
+	}
+
+	// test set_empty(), is_empty(), unite()
+	{
+		r4::aabb3<float> b;
+		b.set_empty();
+		ASSERT_ALWAYS(b.is_empty())
+
+		b.unite(r4::vector3<float>(1, -2, 3));
+		ASSERT_ALWAYS(!b.is_empty())
+		ASSERT_ALWAYS(b == r4::aabb3<float>({1, -2, 3}, {1, -2, 3}))
+
+		b.unite(r4::vector3<float>(-1, 5, 0));
+		ASSERT_ALWAYS(b == r4::aabb3<float>({-1, -2, 0}, {1, 5, 3}))
+
+		b.unite(r4::aabb3<float>({0, 0, -4}, {2, 1, 1}));
+		ASSERT_INFO_ALWAYS(b == r4::aabb3<float>({-1, -2, -4}, {2, 5, 3}), "b = " << b)
+	}
+
+	// test center(), dims(), extent()
+	{
+		r4::aabb3<double> b{{-1, 2, 3}, {3, 4, 9}};
+		ASSERT_ALWAYS(b.center() == r4::vector3<double>(1, 3, 6))
+		ASSERT_ALWAYS(b.dims() == r4::vector3<double>(4, 2, 6))
+		ASSERT_ALWAYS(b.extent() == r4::vector3<double>(2, 1, 3))
+	}
+
+	// test intersect(), overlaps(), contains()
+	{
+		r4::aabb3<int> a{{0, 0, 0}, {10, 10, 10}};
+		r4::aabb3<int> b{{5, -5, 8}, {15, 5, 12}};
+		r4::aabb3<int> c{{11, 0, 0}, {12, 1, 1}};
+		r4::aabb3<int> d{{10, 10, 10}, {12, 12, 12}};
+
+		ASSERT_ALWAYS(a.overlaps(b))
+		ASSERT_ALWAYS(b.overlaps(a))
+		ASSERT_ALWAYS(!a.overlaps(c))
+		ASSERT_ALWAYS(a.overlaps(d))
+
+		auto i = a;
+		i.intersect(b);
+		ASSERT_INFO_ALWAYS(i == r4::aabb3<int>({5, 0, 8}, {10, 5, 10}), "i = " << i)
+		ASSERT_ALWAYS(!i.is_empty())
+
+		i = a;
+		i.intersect(c);
+		ASSERT_ALWAYS(i.is_empty())
+
+		ASSERT_ALWAYS(a.contains(r4::vector3<int>(0, 10, 5)))
+		ASSERT_ALWAYS(!a.contains(r4::vector3<int>(0, 11, 5)))
+	}
+
+	// test compile time evaluation
+	{
+		constexpr auto b = r4::aabb3<float>().set_empty().unite(r4::vector3<float>(1, 2, 3)).unite(r4::vector3<float>(3, 0, 1));
+		static_assert(b.p1.x() == 1 && b.p1.y() == 0 && b.p1.z() == 1);
+		static_assert(b.p2.x() == 3 && b.p2.y() == 2 && b.p2.z() == 3);
+		static_assert(b.center().x() == 2);
+		static_assert(b.overlaps(r4::aabb3<float>({3, 2, 3}, {4, 4, 4})));
+	}
+
+	return 0;
+}
@@ -0,0 +1,249 @@
+#include <sstream>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/affine3.hpp"
+
+int main(int argc, char** argv){
+
+	// test constructor(vector4, vector4, vector4) and operator<<
+	{
+		r4::affine3<int> m{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12}
+		};
+
+		std::stringstream ss;
+		ss << m;
+		auto str = ss.str();
+		auto cmp = "\n\t/1 2 3 4\\"
+		           "\n\t|5 6 7 8|"
+		           "\n\t\\9 10 11 12/";
+		ASSERT_INFO_ALWAYS(str == cmp, "str = " << str)
+	}
+
+	// test conversion to and from matrix4
+	{
+		r4::matrix4<int> m{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{0, 0, 0, 1}
+		};
+
+		r4::affine3<int> a(m);
+		ASSERT_ALWAYS(a[0] == m[0])
+		ASSERT_ALWAYS(a[1] == m[1])
+		ASSERT_ALWAYS(a[2] == m[2])
+
+		ASSERT_ALWAYS(a.to_matrix4() == m)
+	}
+
+	// test conversion to and from quaternion
+	{
+		r4::quaternion<double> q;
+		q.set_rotation(1, 2, 3, utki::pi<double>() / 6);
+
+		// the two conversions may round differently, e.g. when multiply-add is contracted to FMA
+		r4::affine3<double> a(q);
+		auto m = q.to_matrix4();
+		auto diff = a.to_matrix4() - m;
+		diff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "a = " << a << ", m = " << m)
+
+		// check all branches of to_quaternion()
+		for(auto axis : {r4::vector3<double>(1, 2, 3), r4::vector3<double>(1, 0, 0), r4::vector3<double>(0, 1, 0), r4::vector3<double>(0, 0, 1)}){
+			r4::quaternion<double> rq;
+			rq.set_rotation(axis.normalize(), utki::pi<double>() * 0.9);
+
+			auto qq = r4::affine3<double>(rq).to_quaternion();
+			auto dq = qq + rq * -1.0;
+			ASSERT_INFO_ALWAYS(dq.norm() < 1e-12, "qq = " << qq << ", rq = " << rq)
+		}
+	}
+
+	// test operator*(vector3) and transform_direction()
+	{
+		r4::affine3<int> m{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12}
+		};
+
+		r4::vector3<int> v{-1, 2, 3};
+
+		auto p = m * v;
+		ASSERT_INFO_ALWAYS(p == r4::vector3<int>(16, 36, 56), "p = " << p)
+
+		auto d = m.transform_direction(v);
+		ASSERT_INFO_ALWAYS(d == r4::vector3<int>(12, 28, 44), "d = " << d)
+	}
+
+	// test transform_points()
+	{
+		r4::affine3<float> m{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12}
+		};
+
+		std::vector<r4::vector3<float>> points;
+		for(int i = 0; i != 7; ++i){
+			points.emplace_back(float(i), float(-i * 2), float(i + 3));
+		}
+
+		std::vector<r4::vector3<float>> transformed(points.size());
+		m.transform_points(points.data(), transformed.data(), points.size());
+
+		for(size_t i = 0; i != points.size(); ++i){
+			ASSERT_INFO_ALWAYS(transformed[i] == m * points[i], "i = " << i)
+		}
+
+		m.transform_points(points.data(), points.size());
+		ASSERT_ALWAYS(points == transformed)
+	}
+
+	// test operator*(affine3), must be same as product of matrix4
+	{
+		r4::affine3<int> a{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12}
+		};
+
+		r4::affine3<int> b{
+			{-3, 2, 1, 7},
+			{4, 0, -6, 5},
+			{2, 8, 3, -1}
+		};
+
+		auto r = a * b;
+		ASSERT_INFO_ALWAYS(r.to_matrix4() == a.to_matrix4() * b.to_matrix4(), "r = " << r)
+
+		auto fa = a.to<float>();
+		auto fb = b.to<float>();
+		auto fr = fa * fb;
+		ASSERT_INFO_ALWAYS(fr.to_matrix4() == fa.to_matrix4() * fb.to_matrix4(), "fr = " << fr)
+
+		auto c = a;
+		c *= b;
+		ASSERT_ALWAYS(c == r)
+
+		c = a;
+		c.right_mul(b);
+		ASSERT_ALWAYS(c == r)
+
+		c = b;
+		c.left_mul(a);
+		ASSERT_ALWAYS(c == r)
+	}
+
+	// test set_identity(), scale(), translate(), rotate(), must be same as for matrix4
+	{
+		r4::quaternion<double> q;
+		q.set_rotation(r4::vector3<double>(1, -2, 3).normalize(), 0.7);
+
+		r4::affine3<double> a;
+		a.set_identity();
+		a.translate(1, 2, 3);
+		a.rotate(q);
+		a.scale(2, 3, 4);
+		a.translate(r4::vector3<double>(-1, 5, 2));
+		a.scale(r4::vector3<double>(0.5, 1, 2));
+		a.scale(3);
+
+		r4::matrix4<double> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		m.rotate(q);
+		m.scale(2, 3, 4);
+		m.translate(r4::vector3<double>(-1, 5, 2));
+		m.scale(r4::vector3<double>(0.5, 1, 2));
+		m.scale(3);
+
+		auto diff = a.to_matrix4() - m;
+		diff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "a = " << a << ", m = " << m)
+	}
+
+	// test det(), inv(), invert() and rigid_inv()
+	{
+		r4::affine3<double> a{
+			{2, 1, 0, 4},
+			{-1, 3, 2, -2},
+			{0, 1, 5, 7}
+		};
+
+		ASSERT_ALWAYS(a.det() == a.to_matrix4().det())
+
+		auto i = a.inv();
+		auto id = a * i;
+		r4::affine3<double> expected;
+		expected.set_identity();
+		auto diff = id - expected;
+		diff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "id = " << id)
+
+		auto mdiff = i.to_matrix4() - a.to_matrix4().inv();
+		mdiff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(mdiff == decltype(mdiff)().set(0), "i = " << i)
+
+		auto b = a;
+		b.invert();
+		ASSERT_ALWAYS(b == i)
+
+		r4::quaternion<double> q;
+		q.set_rotation(r4::vector3<double>(3, 1, -2).normalize(), 1.3);
+		r4::affine3<double> rigid(q);
+		rigid.translate(4, -5, 6);
+
+		auto rdiff = rigid.rigid_inv() - rigid.inv();
+		rdiff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(rdiff == decltype(rdiff)().set(0), "rdiff = " << rdiff)
+	}
+
+	// test inv() for integer type, elements are divided by determinant like in matrix4::affine_inv()
+	{
+		r4::affine3<int> a{
+			{2, 1, 0, 4},
+			{1, 1, 0, -3},
+			{0, 0, 1, 5}
+		};
+		ASSERT_ALWAYS(a.det() == 1)
+		ASSERT_INFO_ALWAYS(
+				a.inv() == r4::affine3<int>({1, -1, 0, -7}, {-1, 2, 0, 10}, {0, 0, 1, -5}),
+				"a.inv() = " << a.inv()
+			)
+
+		// 1 / det truncates to 0, but the elements of the inverse do not all truncate to 0
+		r4::affine3<int> b{
+			{2, 0, 0, 4},
+			{0, 1, 0, -6},
+			{0, 0, 1, 2}
+		};
+		ASSERT_ALWAYS(b.det() == 2)
+		ASSERT_INFO_ALWAYS(b.inv().to_matrix4() == b.to_matrix4().affine_inv(), "b.inv() = " << b.inv())
+		ASSERT_INFO_ALWAYS(
+				b.inv() == r4::affine3<int>({0, 0, 0, 0}, {0, 1, 0, 6}, {0, 0, 1, -2}),
+				"b.inv() = " << b.inv()
+			)
+	}
+
+	// test compile time evaluation
+	{
+		constexpr auto a = r4::affine3<float>().set_identity().translate(1, 2, 3).scale(2, 4, 8);
+		static_assert(a[0][0] == 2 && a[1][1] == 4 && a[2][2] == 8);
+		static_assert(a[0][3] == 1 && a[1][3] == 2 && a[2][3] == 3);
+
+		constexpr auto p = a * r4::vector3<float>(1, 1, 1);
+		static_assert(p.x() == 3 && p.y() == 6 && p.z() == 11);
+
+		constexpr auto id = a * a.inv();
+		static_assert(id[0][0] == 1 && id[1][1] == 1 && id[2][2] == 1);
+		static_assert(id[0][3] == 0 && id[1][3] == 0 && id[2][3] == 0);
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstdint>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/aligned.hpp"
+#include "../../src/r4/matrix4.hpp"
+
+namespace{
+bool is_aligned(const void* p, size_t alignment){
+	return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+}
+
+int main(int argc, char** argv){
+
+	static_assert(alignof(r4::aligned<r4::vector4<float>>) == 16);
+	static_assert(sizeof(r4::aligned<r4::vector4<float>>) == 16);
+	static_assert(sizeof(r4::aligned<r4::vector3<float>>) == 16);
+	static_assert(alignof(r4::aligned<r4::matrix4<float>, 64>) == 64);
+	static_assert(sizeof(r4::aligned<r4::matrix4<float>, 64>) == 64);
+	static_assert(alignof(r4::aligned<r4::quaternion<double>, 32>) == 32);
+	static_assert(alignof(r4::aligned<r4::matrix4<double>, r4::cache_line_size>) == r4::cache_line_size);
+
+	// test constructors inherited from the wrapped type and arithmetic
+	{
+		r4::aligned<r4::vector4<float>> a(1, 2, 3, 4);
+		r4::aligned<r4::vector4<float>> b{5, 6, 7, 8};
+
+		ASSERT_ALWAYS(is_aligned(&a, 16))
+		ASSERT_ALWAYS(is_aligned(&b, 16))
+
+		r4::aligned<r4::vector4<float>> c = a + b;
+		ASSERT_ALWAYS(c == r4::vector4<float>(6, 8, 10, 12))
+
+		c += a;
+		ASSERT_ALWAYS(c.get() == r4::vector4<float>(7, 10, 13, 16))
+
+		r4::aligned<r4::matrix4<float>, 64> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		ASSERT_ALWAYS(is_aligned(&m, 64))
+
+		auto p = m * r4::vector4<float>(1, 1, 1, 1);
+		ASSERT_ALWAYS(p == r4::vector4<float>(2, 3, 4, 1))
+
+		m = m * m;
+		ASSERT_ALWAYS(m[0][3] == 2 && m[1][3] == 4 && m[2][3] == 6)
+
+		r4::aligned<r4::quaternion<float>, 32> q(r4::vector3<float>(0, 0, 0));
+		ASSERT_ALWAYS(is_aligned(&q, 32))
+		ASSERT_ALWAYS(q.w() == 1)
+	}
+
+	// test aligned_vector
+	{
+		r4::aligned_vector<r4::matrix4<float>, r4::cache_line_size> v;
+		for(unsigned i = 0; i != 17; ++i){
+			v.emplace_back();
+			v.back().set_identity();
+			v.back().scale(float(i));
+		}
+		for(auto& m : v){
+			ASSERT_ALWAYS(is_aligned(&m, r4::cache_line_size))
+		}
+		ASSERT_ALWAYS(v[5][1][1] == 5)
+
+		r4::aligned_vector<r4::vector3<float>> vv(9, r4::vector3<float>(1, 2, 3));
+		for(auto& e : vv){
+			ASSERT_ALWAYS(is_aligned(&e, 16))
+			ASSERT_ALWAYS(e == r4::vector3<float>(1, 2, 3))
+		}
+	}
+
+	// test compile time evaluation
+	{
+		constexpr r4::aligned<r4::vector4<int>> a(1, 2, 3, 4);
+		constexpr r4::aligned<r4::vector4<int>> b = a * 2;
+		static_assert(b[0] == 2 && b[3] == 8);
+	}
+
+	return 0;
+}
@@ -0,0 +1,776 @@
+// Micro-benchmarks of r4 operations.
+// Usage: bench [<filter>]
+// Runs benchmarks whose name contains <filter> substring (all by default) and prints
+// results in JSON format to stdout, the format follows the one of Google Benchmark,
+// so the same tools can be used to compare the results.
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../src/r4/vector2.hpp"
+#include "../../src/r4/vector3.hpp"
+#include "../../src/r4/vector4.hpp"
+#include "../../src/r4/matrix2.hpp"
+#include "../../src/r4/matrix3.hpp"
+#include "../../src/r4/matrix4.hpp"
+#include "../../src/r4/matrix_kinds.hpp"
+#include "../../src/r4/affine3.hpp"
+#include "../../src/r4/dual_quaternion.hpp"
+#include "../../src/r4/charconv.hpp"
+#include "../../src/r4/frustum.hpp"
+#include "../../src/r4/packed.hpp"
+#include "../../src/r4/predicates.hpp"
+#include "../../src/r4/quaternion.hpp"
+#include "../../src/r4/rectangle.hpp"
+#include "../../src/r4/rectangle_tree.hpp"
+#include "../../src/r4/rectangle_set.hpp"
+#include "../../src/r4/region.hpp"
+#include "../../src/r4/segment2.hpp"
+#include "../../src/r4/triangulation.hpp"
+
+namespace{
+
+// prevent the compiler from optimizing away computation of the value or from assuming the value is constant
+template <class T> void do_not_optimize(T& value){
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+struct result{
+	std::string name;
+	size_t iterations;
+	double ns_per_iteration;
+};
+
+std::vector<result> results;
+
+const char* filter = nullptr;
+
+// minimal time to run each benchmark for
+const std::chrono::nanoseconds min_time = std::chrono::milliseconds(200);
+
+template <class F> void run(const std::string& name, F f){
+	if(filter && name.find(filter) == std::string::npos){
+		return;
+	}
+
+	// warm up
+	for(unsigned i = 0; i != 1000; ++i){
+		f();
+	}
+
+	// double the number of iterations until the run takes long enough
+	for(size_t iterations = 1000;; iterations *= 2){
+		auto start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i != iterations; ++i){
+			f();
+		}
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		if(elapsed >= min_time){
+			results.push_back(result{
+					name,
+					iterations,
+					double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / double(iterations)
+				});
+			return;
+		}
+	}
+}
+
+template <class T> const char* scalar_name();
+template <> const char* scalar_name<int>(){ return "int"; }
+template <> const char* scalar_name<float>(){ return "float"; }
+template <> const char* scalar_name<double>(){ return "double"; }
+
+const char* simd_name(){
+#if defined(R4_SIMD_AVX)
+	return "avx";
+#elif defined(R4_SIMD_SSE4_1)
+	return "sse4.1";
+#elif defined(R4_SIMD_SSE2)
+	return "sse2";
+#elif defined(R4_SIMD_NEON)
+	return "neon";
+#else
+	return "none";
+#endif
+}
+
+// operations which make sense for all scalar types
+template <class T> void bench_all(){
+	const std::string s = std::string("<") + scalar_name<T>() + ">";
+
+	r4::matrix4<T> m4{
+		{1, 3, 5, 9},
+		{1, 3, 1, 7},
+		{4, 3, 9, 7},
+		{5, 2, 0, 9}
+	};
+	r4::matrix4<T> n4 = m4;
+	n4.transpose();
+
+	r4::affine3<T> a3{m4[0], m4[1], m4[2]};
+	r4::affine3<T> b3{n4[0], n4[1], n4[2]};
+
+	r4::matrix3<T> m3{
+		{1, 3, 5},
+		{1, 7, 4},
+		{3, 9, 7}
+	};
+	r4::matrix3<T> n3 = m3;
+	n3.transpose();
+
+	r4::matrix2<T> m2{
+		{1, 3, 5},
+		{4, 7, 2}
+	};
+	r4::matrix2<T> n2{
+		{2, 1, 3},
+		{5, 4, 7}
+	};
+
+	r4::vector2<T> v2{3, 4};
+	r4::vector3<T> v3{3, 4, 5};
+	r4::vector4<T> v4{3, 4, 5, 6};
+
+	r4::quaternion<T> q1{1, 2, 3, 4};
+	r4::quaternion<T> q2{5, 6, 7, 8};
+
+	r4::rectangle<T> r1{1, 2, 10, 20};
+	r4::rectangle<T> r2{5, 6, 10, 20};
+
+	run("matrix4" + s + "/operator*(matrix4)", [&]{
+		auto r = m4 * n4;
+		do_not_optimize(r);
+		do_not_optimize(m4);
+	});
+	run("matrix4" + s + "/operator*(vector4)", [&]{
+		auto r = m4 * v4;
+		do_not_optimize(r);
+		do_not_optimize(m4);
+	});
+	run("matrix4" + s + "/operator*(vector3)", [&]{
+		auto r = m4 * v3;
+		do_not_optimize(r);
+		do_not_optimize(m4);
+	});
+	run("matrix4" + s + "/det()", [&]{
+		auto r = m4.det();
+		do_not_optimize(r);
+		do_not_optimize(m4);
+	});
+	run("matrix4" + s + "/inv()", [&]{
+		auto r = m4.inv();
+		do_not_optimize(r);
+		do_not_optimize(m4);
+	});
+
+	run("affine3" + s + "/operator*(affine3)", [&]{
+		auto r = a3 * b3;
+		do_not_optimize(r);
+		do_not_optimize(a3);
+	});
+	run("affine3" + s + "/operator*(vector3)", [&]{
+		auto r = a3 * v3;
+		do_not_optimize(r);
+		do_not_optimize(a3);
+	});
+	run("affine3" + s + "/inv()", [&]{
+		auto r = a3.inv();
+		do_not_optimize(r);
+		do_not_optimize(a3);
+	});
+
+	run("matrix3" + s + "/operator*(matrix3)", [&]{
+		auto r = m3 * n3;
+		do_not_optimize(r);
+		do_not_optimize(m3);
+	});
+	run("matrix3" + s + "/operator*(vector3)", [&]{
+		auto r = m3 * v3;
+		do_not_optimize(r);
+		do_not_optimize(m3);
+	});
+	run("matrix3" + s + "/det()", [&]{
+		auto r = m3.det();
+		do_not_optimize(r);
+		do_not_optimize(m3);
+	});
+	run("matrix3" + s + "/inv()", [&]{
+		auto r = m3.inv();
+		do_not_optimize(r);
+		do_not_optimize(m3);
+	});
+
+	run("matrix2" + s + "/operator*(matrix2)", [&]{
+		auto r = m2 * n2;
+		do_not_optimize(r);
+		do_not_optimize(m2);
+	});
+	run("matrix2" + s + "/operator*(vector2)", [&]{
+		auto r = m2 * v2;
+		do_not_optimize(r);
+		do_not_optimize(m2);
+	});
+	run("matrix2" + s + "/det()", [&]{
+		auto r = m2.det();
+		do_not_optimize(r);
+		do_not_optimize(m2);
+	});
+
+	run("quaternion" + s + "/operator%(quaternion)", [&]{
+		auto r = q1 % q2;
+		do_not_optimize(r);
+		do_not_optimize(q1);
+	});
+
+	run("rectangle" + s + "/intersect()", [&]{
+		auto r = r1;
+		r.intersect(r2);
+		do_not_optimize(r);
+		do_not_optimize(r1);
+	});
+	run("rectangle" + s + "/unite()", [&]{
+		auto r = r1;
+		r.unite(r2);
+		do_not_optimize(r);
+		do_not_optimize(r1);
+	});
+
+	// segments crossing the clipping rectangle boundary in various ways
+	std::vector<r4::segment2<T>> segments;
+	std::vector<r4::vector2<T>> polyline;
+	for(unsigned i = 0; i != 1024; ++i){
+		r4::vector2<T> a(T(i % 61) - 30, T(i % 53) - 26);
+		r4::vector2<T> b(T(i % 17) * 3 - 24, T(i % 23) * 2 - 22);
+		segments.push_back(r4::segment2<T>{a, b});
+		polyline.push_back(a);
+	}
+	std::vector<r4::segment2<T>> clipped(segments.size());
+	r4::rectangle<T> clip_rect{-10, -10, 20, 20};
+	run("segment2" + s + "/clip(rectangle)[1024]", [&]{
+		auto n = r4::segment2<T>::clip(segments.data(), segments.size(), clip_rect, clipped.data());
+		do_not_optimize(n);
+		do_not_optimize(clipped);
+	});
+	run("segment2" + s + "/bounding_box(vector2)[1024]", [&]{
+		auto r = r4::segment2<T>::bounding_box(polyline.data(), polyline.size());
+		do_not_optimize(r);
+		do_not_optimize(polyline);
+	});
+
+	// spatial queries over 4096 rectangles laid out in a grid
+	std::vector<r4::rectangle<T>> rects;
+	for(unsigned i = 0; i != 4096; ++i){
+		rects.emplace_back(T(i % 64 * 10), T(i / 64 * 10), T(15), T(15));
+	}
+	r4::rectangle_tree<T> tree(rects.data(), rects.size());
+	r4::vector2<T> p{317, 452};
+	run("rectangle_tree" + s + "/build()[4096]", [&]{
+		tree.build(rects.data(), rects.size());
+		do_not_optimize(tree);
+	});
+	run("rectangle_tree" + s + "/query(vector2)[4096]", [&]{
+		size_t n = 0;
+		tree.query(p, [&n](size_t){++n;});
+		do_not_optimize(n);
+		do_not_optimize(p);
+	});
+	run("rectangle_tree" + s + "/query(rectangle)[4096]", [&]{
+		size_t n = 0;
+		tree.query(r1, [&n](size_t){++n;});
+		do_not_optimize(n);
+		do_not_optimize(r1);
+	});
+	run("rectangle_tree" + s + "/nearest()[4096]", [&]{
+		auto r = tree.nearest(p, 4);
+		do_not_optimize(r);
+		do_not_optimize(p);
+	});
+
+	// batch operations over the same 4096 rectangles, compared to one rectangle at a time
+	r4::rectangle_set<T> rect_set(rects.data(), rects.size());
+	r4::rectangle_set<T> rect_set_work(rects.size());
+	std::vector<r4::rectangle<T>> rects_work(rects.size());
+	std::vector<uint32_t> hits((rects.size() + 31) / 32);
+	r4::rectangle<T> scissor{100, 150, 200, 120};
+	run("rectangle" + s + "/intersect()[4096]", [&]{
+		rects_work = rects;
+		for(auto& r : rects_work){
+			r.intersect(scissor);
+		}
+		do_not_optimize(rects_work);
+	});
+	run("rectangle_set" + s + "/intersect()[4096]", [&]{
+		rect_set_work = rect_set;
+		rect_set_work.intersect(scissor);
+		do_not_optimize(rect_set_work);
+	});
+	run("rectangle" + s + "/unite()[4096]", [&]{
+		auto r = rects[0];
+		for(auto& e : rects){
+			r.unite(e);
+		}
+		do_not_optimize(r);
+		do_not_optimize(rects);
+	});
+	run("rectangle_set" + s + "/unite()[4096]", [&]{
+		auto r = rect_set.unite();
+		do_not_optimize(r);
+		do_not_optimize(rect_set);
+	});
+	run("rectangle" + s + "/overlaps(vector2)[4096]", [&]{
+		std::fill(hits.begin(), hits.end(), 0);
+		for(size_t i = 0; i != rects.size(); ++i){
+			if(rects[i].overlaps(p)){
+				hits[i / 32] |= uint32_t(1) << (i % 32);
+			}
+		}
+		do_not_optimize(hits);
+		do_not_optimize(p);
+	});
+	run("rectangle_set" + s + "/overlaps(vector2)[4096]", [&]{
+		rect_set.overlaps(p, hits.data());
+		do_not_optimize(hits);
+		do_not_optimize(p);
+	});
+	run("rectangle_set" + s + "/intersect()+compact()[4096]", [&]{
+		rect_set_work = rect_set;
+		rect_set_work.intersect(scissor);
+		auto n = rect_set_work.compact();
+		do_not_optimize(n);
+		do_not_optimize(rect_set_work);
+	});
+
+	// damage tracking, accumulating 256 scattered rectangles into a region
+	run("region" + s + "/unite(rectangle)[256]", [&]{
+		r4::region<T> damage;
+		for(size_t i = 0; i != 256; ++i){
+			damage.unite(rects[i * 13 % rects.size()]);
+		}
+		do_not_optimize(damage);
+	});
+	r4::region<T> damage;
+	for(size_t i = 0; i != 256; ++i){
+		damage.unite(rects[i * 13 % rects.size()]);
+	}
+	run("region" + s + "/subtract(rectangle)", [&]{
+		auto r = damage;
+		r.subtract(scissor);
+		do_not_optimize(r);
+	});
+	run("region" + s + "/overlaps(vector2)", [&]{
+		auto r = damage.overlaps(p);
+		do_not_optimize(r);
+		do_not_optimize(p);
+	});
+}
+
+// operations which only make sense for floating point scalar types
+template <class T> void bench_floating_point(){
+	const std::string s = std::string("<") + scalar_name<T>() + ">";
+
+	r4::vector2<T> v2{3, 4};
+	r4::vector3<T> v3{3, 4, 5};
+	r4::vector4<T> v4{3, 4, 5, 6};
+
+	r4::quaternion<T> q1{r4::vector3<T>{1, 2, 3}};
+	r4::quaternion<T> q2{r4::vector3<T>{-2, 1, 0.5}};
+
+	run("vector2" + s + "/normalize()", [&]{
+		auto r = v2;
+		r.normalize();
+		do_not_optimize(r);
+		do_not_optimize(v2);
+	});
+	run("vector3" + s + "/normalize()", [&]{
+		auto r = v3;
+		r.normalize();
+		do_not_optimize(r);
+		do_not_optimize(v3);
+	});
+	run("vector4" + s + "/normalize()", [&]{
+		auto r = v4;
+		r.normalize();
+		do_not_optimize(r);
+		do_not_optimize(v4);
+	});
+	run("vector3" + s + "/rotate(quaternion)", [&]{
+		auto r = v3;
+		r.rotate(q1);
+		do_not_optimize(r);
+		do_not_optimize(v3);
+	});
+
+	run("quaternion" + s + "/normalize()", [&]{
+		auto r = q1;
+		r.normalize();
+		do_not_optimize(r);
+		do_not_optimize(q1);
+	});
+	run("quaternion" + s + "/slerp()", [&]{
+		auto r = q1.slerp(q2, T(0.3));
+		do_not_optimize(r);
+		do_not_optimize(q1);
+	});
+	run("quaternion" + s + "/to_matrix4()", [&]{
+		auto r = q1.to_matrix4();
+		do_not_optimize(r);
+		do_not_optimize(q1);
+	});
+
+	auto fm = q1.to_matrix4();
+	fm.translate(1, 2, 3);
+
+	run("matrix4" + s + "/rotate(quaternion)", [&]{
+		auto r = fm;
+		r.rotate(q2);
+		do_not_optimize(r);
+		do_not_optimize(q2);
+	});
+	run("matrix4" + s + "/frustum()", [&]{
+		auto r = fm;
+		r.frustum(-1, 1, -1, 1, 1, 10);
+		do_not_optimize(r);
+	});
+
+	// products of sparse matrix kinds compared to full matrix4 products
+	r4::translation3<T> kt{1, 2, 3};
+	r4::rotation3<T> kr{q2};
+	r4::perspective_projection<T> kp{-1, 1, -1, 1, 1, 10};
+	run("translation3" + s + "*rotation3", [&]{
+		auto r = kt * kr;
+		do_not_optimize(r);
+		do_not_optimize(kt);
+	});
+	run("matrix4" + s + "*matrix4/translation*rotation", [&]{
+		auto r = kt.to_matrix4() * kr.to_matrix4();
+		do_not_optimize(r);
+		do_not_optimize(kt);
+	});
+	run("perspective_projection" + s + "*matrix4", [&]{
+		auto r = kp * fm;
+		do_not_optimize(r);
+		do_not_optimize(kp);
+	});
+	run("matrix4" + s + "*matrix4/perspective*matrix4", [&]{
+		auto r = kp.to_matrix4() * fm;
+		do_not_optimize(r);
+		do_not_optimize(kp);
+	});
+
+	run("matrix4" + s + "/to_chars()", [&]{
+		char buf[512];
+		auto res = r4::to_chars(buf, buf + sizeof(buf), fm);
+		do_not_optimize(res);
+		do_not_optimize(buf);
+	});
+	run("matrix4" + s + "/operator<<", [&]{
+		std::ostringstream ss;
+		ss << fm;
+		auto str = ss.str();
+		do_not_optimize(str);
+	});
+	{
+		char buf[512];
+		auto end = r4::to_chars(buf, buf + sizeof(buf), fm).ptr;
+		run("matrix4" + s + "/from_chars()", [&]{
+			r4::matrix4<T> r;
+			auto res = r4::from_chars(buf, end, r);
+			do_not_optimize(res);
+			do_not_optimize(r);
+		});
+	}
+
+	// batch operations, per point
+	const size_t num_points = 1024;
+	std::vector<r4::vector3<T>> points;
+	for(size_t i = 0; i != num_points; ++i){
+		points.emplace_back(T(i), T(i % 7), T(1) / T(i + 1));
+	}
+	auto m = q1.to_matrix4();
+	m.translate(1, 2, 3);
+
+	run("matrix4" + s + "/transform_points(vector3)[1024]", [&]{
+		m.transform_points(points.data(), points.size());
+		do_not_optimize(points);
+	});
+	r4::affine3<T> a(m);
+	run("affine3" + s + "/transform_points(vector3)[1024]", [&]{
+		a.transform_points(points.data(), points.size());
+		do_not_optimize(points);
+	});
+	run("quaternion" + s + "/rotate_points(vector3)[1024]", [&]{
+		q1.rotate_points(points.data(), points.size());
+		do_not_optimize(points);
+	});
+
+	// per-view matrices, per view
+	std::vector<r4::vector3<T>> eyes;
+	std::vector<r4::vector3<T>> centers;
+	std::vector<r4::vector3<T>> ups(num_points, r4::vector3<T>(0, 1, 0));
+	std::vector<T> fovys;
+	std::vector<T> aspects(num_points, T(1.5));
+	std::vector<T> nears(num_points, T(0.1));
+	std::vector<T> fars(num_points, T(100));
+	for(size_t i = 0; i != num_points; ++i){
+		eyes.emplace_back(T(i), T(2), T(i % 5));
+		centers.emplace_back(T(1), T(i % 3), T(-1));
+		fovys.push_back(T(0.5) + T(i % 10) / T(10));
+	}
+	std::vector<r4::matrix4<T>> views(num_points);
+
+	run("matrix4" + s + "/set_look_at()", [&]{
+		r4::matrix4<T> r;
+		r.set_look_at(eyes[1], centers[1], ups[1]);
+		do_not_optimize(r);
+		do_not_optimize(eyes);
+	});
+	run("matrix4" + s + "/make_look_at()[1024]", [&]{
+		r4::matrix4<T>::make_look_at(eyes.data(), centers.data(), ups.data(), views.data(), num_points);
+		do_not_optimize(views);
+	});
+	run("matrix4" + s + "/make_perspective()[1024]", [&]{
+		r4::matrix4<T>::make_perspective(fovys.data(), aspects.data(), nears.data(), fars.data(), views.data(), num_points);
+		do_not_optimize(views);
+	});
+
+	// 2d ui vertices
+	std::vector<r4::vector2<T>> vertices;
+	for(size_t i = 0; i != num_points; ++i){
+		vertices.emplace_back(T(i % 32), T(i / 32));
+	}
+	std::vector<r4::vector2<T>> transformed_vertices(num_points);
+	r4::matrix2<T> ui{
+		{T(0.9), T(-0.1), 10},
+		{T(0.1), T(0.9), 20}
+	};
+
+	run("matrix2" + s + "/transform_points(vector2)[1024]", [&]{
+		ui.transform_points(vertices.data(), transformed_vertices.data(), num_points);
+		do_not_optimize(transformed_vertices);
+	});
+	run("matrix2" + s + "/transform_points_bound(vector2)[1024]", [&]{
+		auto r = ui.transform_points_bound(vertices.data(), transformed_vertices.data(), num_points);
+		do_not_optimize(r);
+		do_not_optimize(transformed_vertices);
+	});
+
+	// skinning with 4 bone influences per point
+	const unsigned num_bones = 32;
+	const unsigned influences = 4;
+	std::vector<r4::dual_quaternion<T>> bones;
+	for(unsigned i = 0; i != num_bones; ++i){
+		r4::quaternion<T> q;
+		q.set_rotation(r4::vector3<T>(T(i), 1, 2).normalize(), T(i) / T(num_bones));
+		bones.emplace_back(q, r4::vector3<T>(T(i), T(1), T(2)));
+	}
+	std::vector<unsigned> indices;
+	std::vector<T> weights;
+	for(size_t i = 0; i != num_points * influences; ++i){
+		indices.push_back(unsigned(i * 7) % num_bones);
+		weights.push_back(T(1) / T(influences));
+	}
+	std::vector<r4::vector3<T>> skinned(num_points);
+
+	run("dual_quaternion" + s + "/skin(vector3)[1024]", [&]{
+		r4::dual_quaternion<T>::skin(bones.data(), indices.data(), weights.data(), influences, points.data(), skinned.data(), num_points);
+		do_not_optimize(skinned);
+	});
+
+	// frustum culling of boxes and spheres scattered around the frustum
+	r4::matrix4<T> proj;
+	proj.set_frustum(-1, 1, -1, 1, 1, 100);
+	r4::frustum<T> frustum(proj);
+	std::vector<r4::aabb3<T>> boxes;
+	std::vector<r4::vector4<T>> spheres;
+	for(size_t i = 0; i != num_points; ++i){
+		r4::vector3<T> c(T(i % 41) - 20, T(i % 37) - 18, -T(i % 113));
+		boxes.emplace_back(c - r4::vector3<T>(1), c + r4::vector3<T>(1));
+		spheres.emplace_back(c, T(1));
+	}
+	std::vector<uint32_t> visible(num_points);
+
+	run("frustum" + s + "/cull_mask(aabb3)[1024]", [&]{
+		frustum.cull_mask(boxes.data(), boxes.size(), visible.data());
+		do_not_optimize(visible);
+	});
+	run("frustum" + s + "/cull_mask(vector4)[1024]", [&]{
+		frustum.cull_mask(spheres.data(), spheres.size(), visible.data());
+		do_not_optimize(visible);
+	});
+	run("frustum" + s + "/cull_indices(aabb3)[1024]", [&]{
+		auto n = frustum.cull_indices(boxes.data(), boxes.size(), visible.data());
+		do_not_optimize(n);
+		do_not_optimize(visible);
+	});
+
+	std::vector<r4::vector3<T>> normals;
+	std::vector<r4::quaternion<T>> rotations;
+	for(size_t i = 0; i != num_points; ++i){
+		normals.push_back(r4::vector3<T>(T(i % 7) - 3, T(i % 5) - 2, T(i % 3) + 1).normalize());
+		rotations.push_back(r4::quaternion<T>(T(i % 7) - 3, T(i % 5) - 2, T(i % 3) + 1, 1).normalize());
+	}
+	std::vector<r4::packed_unit_vector3> packed_normals(num_points);
+	std::vector<r4::packed_quaternion> packed_rotations(num_points);
+
+	run("packed_unit_vector3" + s + "/pack[1024]", [&]{
+		r4::packed_unit_vector3::pack(normals.data(), packed_normals.data(), num_points);
+		do_not_optimize(packed_normals);
+	});
+	run("packed_unit_vector3" + s + "/unpack[1024]", [&]{
+		r4::packed_unit_vector3::unpack(packed_normals.data(), normals.data(), num_points);
+		do_not_optimize(normals);
+	});
+	run("packed_quaternion" + s + "/pack[1024]", [&]{
+		r4::packed_quaternion::pack(rotations.data(), packed_rotations.data(), num_points);
+		do_not_optimize(packed_rotations);
+	});
+	run("packed_quaternion" + s + "/unpack[1024]", [&]{
+		r4::packed_quaternion::unpack(packed_rotations.data(), rotations.data(), num_points);
+		do_not_optimize(rotations);
+	});
+}
+
+// robust predicates, for double only
+void bench_predicates(){
+	namespace p = r4::predicates;
+
+	std::vector<r4::vector2<double>> points2;
+	std::vector<r4::vector3<double>> points3;
+	std::vector<r4::vector2<double>> collinear;
+	for(unsigned i = 0; i != 1024; ++i){
+		points2.emplace_back(double(i % 61) - 30.5, double(i % 53) - 26.25);
+		points3.emplace_back(double(i % 61) - 30.5, double(i % 53) - 26.25, double(i % 47) - 20.75);
+		// nearly collinear points, for which the filter fails and exact evaluation is needed
+		collinear.emplace_back(0.5 + std::ldexp(double(i % 32), -53), 0.5 + std::ldexp(double(i / 32), -53));
+	}
+	std::vector<double> results(points2.size());
+	r4::vector2<double> a{-3, -1}, b{4, 2}, c{-1, 5};
+	r4::vector3<double> a3{-3, -1, 2}, b3{4, 2, -1}, c3{-1, 5, 3};
+
+	run("predicates/orient2d()[1024]", [&]{
+		for(size_t i = 0; i != points2.size(); ++i){
+			results[i] = p::orient2d(a, b, points2[i]);
+		}
+		do_not_optimize(results);
+	});
+	run("predicates/orient2d(batch)[1024]", [&]{
+		p::orient2d(a, b, points2.data(), points2.size(), results.data());
+		do_not_optimize(results);
+	});
+	run("predicates/orient2d(nearly_collinear)[1024]", [&]{
+		p::orient2d(r4::vector2<double>{12, 12}, r4::vector2<double>{24, 24}, collinear.data(), collinear.size(), results.data());
+		do_not_optimize(results);
+	});
+	run("predicates/orient3d()[1024]", [&]{
+		for(size_t i = 0; i != points3.size(); ++i){
+			results[i] = p::orient3d(a3, b3, c3, points3[i]);
+		}
+		do_not_optimize(results);
+	});
+	run("predicates/orient3d(batch)[1024]", [&]{
+		p::orient3d(a3, b3, c3, points3.data(), points3.size(), results.data());
+		do_not_optimize(results);
+	});
+	run("predicates/incircle()[1024]", [&]{
+		for(size_t i = 0; i != points2.size(); ++i){
+			results[i] = p::incircle(a, b, c, points2[i]);
+		}
+		do_not_optimize(results);
+	});
+	run("predicates/incircle(batch)[1024]", [&]{
+		p::incircle(a, b, c, points2.data(), points2.size(), results.data());
+		do_not_optimize(results);
+	});
+}
+
+void bench_triangulation(){
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> dist(-1000, 1000);
+	std::vector<r4::vector2<double>> points;
+	for(unsigned i = 0; i != 1024; ++i){
+		points.emplace_back(dist(gen), dist(gen));
+	}
+
+	run("triangulation/sort_points()[1024]", [&]{
+		auto sorted = r4::sort_points(points.data(), points.size(), 1);
+		do_not_optimize(sorted);
+	});
+	run("triangulation/convex_hull()[1024]", [&]{
+		auto hull = r4::convex_hull(points.data(), points.size(), 1);
+		do_not_optimize(hull);
+	});
+	run("triangulation/delaunay_triangulation()[1024]", [&]{
+		r4::delaunay_triangulation dt(points.data(), points.size(), 1);
+		do_not_optimize(dt);
+	});
+}
+
+void print_json(std::ostream& o){
+	char date[64];
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	o << "{\n";
+	o << "  \"context\": {\n";
+	o << "    \"date\": \"" << date << "\",\n";
+#if defined(__VERSION__)
+	o << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+#if defined(DEBUG)
+	o << "    \"library_build_type\": \"debug\",\n";
+#else
+	o << "    \"library_build_type\": \"release\",\n";
+#endif
+	o << "    \"simd\": \"" << simd_name() << "\"\n";
+	o << "  },\n";
+	o << "  \"benchmarks\": [";
+	for(auto i = results.begin(); i != results.end(); ++i){
+		if(i != results.begin()){
+			o << ",";
+		}
+		o << "\n    {\n";
+		o << "      \"name\": \"" << i->name << "\",\n";
+		o << "      \"run_type\": \"iteration\",\n";
+		o << "      \"iterations\": " << i->iterations << ",\n";
+		o << "      \"real_time\": " << i->ns_per_iteration << ",\n";
+		o << "      \"time_unit\": \"ns\"\n";
+		o << "    }";
+	}
+	o << "\n  ]\n";
+	o << "}\n";
+}
+
+}
+
+int main(int argc, char** argv){
+	if(argc > 1){
+		filter = argv[1];
+	}
+
+	bench_all<int>();
+	bench_all<float>();
+	bench_all<double>();
+
+	bench_floating_point<float>();
+	bench_floating_point<double>();
+
+	bench_predicates();
+	bench_triangulation();
+
+	print_json(std::cout);
+
+	return 0;
+}
@@ -0,0 +1,210 @@
+#include <cstdio>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/binary.hpp"
+#include "../../src/r4/mapped_file.hpp"
+#include "../../src/r4/aligned_allocator.hpp"
+
+namespace{
+template <class T> std::vector<T> make_matrices(size_t size){
+	std::vector<T> ret;
+	for(size_t i = 0; i != size; ++i){
+		T m;
+		for(size_t r = 0; r != m.size(); ++r){
+			for(size_t c = 0; c != m[r].size(); ++c){
+				m[r][c] = typename T::value_type::value_type(i * 16 + r * 4 + c);
+			}
+		}
+		ret.push_back(m);
+	}
+	return ret;
+}
+
+template <class E> bool throws(const std::function<void()>& f){
+	try{
+		f();
+	}catch(const E&){
+		return true;
+	}
+	return false;
+}
+
+// memory buffer aligned to page boundary, as memory-mapped files are
+typedef std::vector<uint8_t, r4::aligned_allocator<uint8_t, 4096>> buffer_type;
+}
+
+int main(int argc, char** argv){
+	// test type ids
+	{
+		static_assert(r4::binary_traits<float>::type_id == 1);
+		static_assert(r4::binary_traits<r4::vector3<float>>::type_id == 0x201);
+		static_assert(r4::binary_traits<r4::matrix4<double>>::type_id == 0x802);
+		static_assert(r4::binary_traits<r4::vector2<int>>::type_id == 0x103);
+		static_assert(r4::binary_traits<r4::quaternion<r4::half>>::type_id == 0x404);
+	}
+
+	// test layout
+	{
+		std::vector<r4::vector3<float>> v = {{1, 2, 3}, {4, 5, 6}};
+
+		buffer_type buf(r4::binary_size<r4::vector3<float>>(v.size()));
+		ASSERT_ALWAYS(buf.size() == 64 + 2 * 12)
+		r4::write_binary(buf.data(), v.data(), v.size());
+
+		// header is little-endian: magic, version, type id, element size, count, data offset
+		const uint8_t expected_header[] = {
+			'r', '4', 'b', 'a',
+			1, 0, 0, 0,
+			1, 2, 0, 0,
+			12, 0, 0, 0,
+			2, 0, 0, 0, 0, 0, 0, 0,
+			64, 0, 0, 0, 0, 0, 0, 0
+		};
+		ASSERT_ALWAYS(std::memcmp(buf.data(), expected_header, sizeof(expected_header)) == 0)
+		for(size_t i = sizeof(expected_header); i != 64; ++i){
+			ASSERT_ALWAYS(buf[i] == 0)
+		}
+
+		float f;
+		std::memcpy(&f, buf.data() + 64 + 4 * 4, sizeof(f));
+		ASSERT_ALWAYS(f == 5)
+	}
+
+	// test view of memory
+	{
+		auto m = make_matrices<r4::matrix4<float>>(100);
+
+		buffer_type buf(r4::binary_size<r4::matrix4<float>>(m.size()));
+		r4::write_binary(buf.data(), m.data(), m.size());
+
+		r4::binary_view<r4::matrix4<float>> view(buf.data(), buf.size());
+		ASSERT_ALWAYS(view.size() == m.size())
+		ASSERT_ALWAYS(!view.empty())
+		ASSERT_ALWAYS(reinterpret_cast<const uint8_t*>(view.data()) == buf.data() + 64)
+		for(size_t i = 0; i != m.size(); ++i){
+			ASSERT_ALWAYS(view[i] == m[i])
+		}
+		ASSERT_ALWAYS(std::equal(view.begin(), view.end(), m.begin(), m.end()))
+
+		// empty array
+		buffer_type empty_buf(r4::binary_size<r4::matrix4<float>>(0));
+		r4::write_binary<r4::matrix4<float>>(empty_buf.data(), nullptr, 0);
+		r4::binary_view<r4::matrix4<float>> empty_view(empty_buf.data(), empty_buf.size());
+		ASSERT_ALWAYS(empty_view.empty())
+		ASSERT_ALWAYS(empty_view.begin() == empty_view.end())
+
+		ASSERT_ALWAYS(r4::binary_view<r4::vector3<float>>().empty())
+	}
+
+	// test validation
+	{
+		std::vector<r4::quaternion<double>> q(10, r4::quaternion<double>(1, 2, 3, 4));
+
+		buffer_type buf(r4::binary_size<r4::quaternion<double>>(q.size()));
+		r4::write_binary(buf.data(), q.data(), q.size());
+
+		typedef r4::binary_view<r4::quaternion<double>> view_type;
+
+		// valid
+		ASSERT_ALWAYS(view_type(buf.data(), buf.size()).size() == 10)
+
+		// wrong type
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ r4::binary_view<r4::quaternion<float>>(buf.data(), buf.size()); }))
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ r4::binary_view<r4::vector4<double>>(buf.data(), buf.size()); }))
+
+		// truncated data and header
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ view_type(buf.data(), buf.size() - 1); }))
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ view_type(buf.data(), 63); }))
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ view_type(buf.data(), 16); }))
+
+		// misaligned buffer
+		buffer_type shifted(buf.size() + 8);
+		std::memcpy(shifted.data() + 4, buf.data(), buf.size());
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ view_type(shifted.data() + 4, buf.size()); }))
+		std::memcpy(shifted.data() + 8, buf.data(), buf.size());
+		ASSERT_ALWAYS(view_type(shifted.data() + 8, buf.size()).size() == 10)
+
+		// corrupted header fields
+		auto corrupt = [&](size_t offset, uint8_t value){
+			buffer_type b = buf;
+			b[offset] = value;
+			return throws<std::invalid_argument>([&]{ view_type(b.data(), b.size()); });
+		};
+		ASSERT_ALWAYS(corrupt(0, 'x')) // magic
+		ASSERT_ALWAYS(corrupt(4, 2)) // version
+		ASSERT_ALWAYS(corrupt(12, 16)) // element size
+		ASSERT_ALWAYS(corrupt(16, 11)) // count
+		ASSERT_ALWAYS(corrupt(23, 0x80)) // huge count
+		ASSERT_ALWAYS(corrupt(24, 4)) // data offset less than header size
+		ASSERT_ALWAYS(corrupt(24, 68)) // misaligned data offset
+	}
+
+	// test stream roundtrip
+	{
+		auto m = make_matrices<r4::matrix3<double>>(1000);
+
+		std::stringstream ss;
+		r4::write_binary(ss, m.data(), m.size());
+		ASSERT_ALWAYS(ss.str().size() == r4::binary_size<r4::matrix3<double>>(m.size()))
+
+		auto r = r4::read_binary<r4::matrix3<double>>(ss);
+		ASSERT_ALWAYS(r == m)
+
+		std::stringstream wrong(ss.str());
+		ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ r4::read_binary<r4::matrix3<float>>(wrong); }))
+
+		std::stringstream truncated(ss.str().substr(0, ss.str().size() - 1));
+		ASSERT_ALWAYS(throws<std::runtime_error>([&]{ r4::read_binary<r4::matrix3<double>>(truncated); }))
+
+		std::stringstream empty;
+		ASSERT_ALWAYS(throws<std::runtime_error>([&]{ r4::read_binary<r4::matrix3<double>>(empty); }))
+	}
+
+	// test memory-mapped file
+	{
+		const char* file_name = "binary_test.tmp";
+
+		auto m = make_matrices<r4::matrix4<float>>(10000);
+		{
+			std::ofstream f(file_name, std::ios::binary);
+			r4::write_binary(f, m.data(), m.size());
+		}
+
+		{
+			r4::mapped_file f(file_name);
+			ASSERT_ALWAYS(f.size() == r4::binary_size<r4::matrix4<float>>(m.size()))
+
+			r4::binary_view<r4::matrix4<float>> view(f.data(), f.size());
+			ASSERT_ALWAYS(view.size() == m.size())
+			ASSERT_ALWAYS(std::equal(view.begin(), view.end(), m.begin(), m.end()))
+
+			// move
+			r4::mapped_file g(std::move(f));
+			ASSERT_ALWAYS(f.data() == nullptr)
+			ASSERT_ALWAYS(static_cast<const uint8_t*>(g.data()) + 64 == reinterpret_cast<const uint8_t*>(view.data()))
+			ASSERT_ALWAYS(g.size() == r4::binary_size<r4::matrix4<float>>(m.size()))
+			ASSERT_ALWAYS(view[9999] == m[9999])
+		}
+
+		// empty file
+		{
+			std::ofstream f(file_name, std::ios::binary);
+		}
+		{
+			r4::mapped_file f(file_name);
+			ASSERT_ALWAYS(f.size() == 0)
+			ASSERT_ALWAYS(throws<std::invalid_argument>([&]{ r4::binary_view<r4::matrix4<float>>(f.data(), f.size()); }))
+		}
+
+		std::remove(file_name);
+
+		ASSERT_ALWAYS(throws<std::system_error>([&]{ r4::mapped_file("non_existent_file.bin"); }))
+	}
+
+	return 0;
+}
@@ -0,0 +1,255 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/charconv.hpp"
+
+namespace{
+template <class V> std::string format(const V& v){
+	char buf[512];
+	auto res = r4::to_chars(buf, buf + sizeof(buf), v);
+	ASSERT_ALWAYS(res.ec == std::errc())
+	return std::string(buf, res.ptr);
+}
+
+template <class V> std::string stream(const V& v){
+	std::stringstream ss;
+	ss << v;
+	return ss.str();
+}
+
+// format, parse back and compare
+template <class V> void check_roundtrip(const V& v){
+	auto str = format(v);
+	V p;
+	auto res = r4::from_chars(str.data(), str.data() + str.size(), p);
+	ASSERT_INFO_ALWAYS(res.ec == std::errc(), "str = " << str)
+	ASSERT_INFO_ALWAYS(res.ptr == str.data() + str.size(), "str = " << str)
+	ASSERT_INFO_ALWAYS(p == v, "str = " << str << ", p = " << p)
+}
+
+// check that text produced by operator<< is parsed
+template <class V> void check_stream_parse(const V& v){
+	auto str = stream(v);
+	V p;
+	auto res = r4::from_chars(str.data(), str.data() + str.size(), p);
+	ASSERT_INFO_ALWAYS(res.ec == std::errc(), "str = " << str)
+	ASSERT_INFO_ALWAYS(res.ptr == str.data() + str.size(), "str = " << str)
+	ASSERT_INFO_ALWAYS(p == v, "str = " << str << ", p = " << p)
+}
+
+template <class V> bool parse_fails(const std::string& str){
+	V p;
+	auto res = r4::from_chars(str.data(), str.data() + str.size(), p);
+	return res.ec != std::errc() && res.ptr == str.data();
+}
+}
+
+int main(int argc, char** argv){
+	// test format is the same as of operator<< for values which are printed exactly by both
+	{
+		r4::vector2<int> v2{1, -2};
+		ASSERT_INFO_ALWAYS(format(v2) == "(1, -2)", format(v2))
+		ASSERT_ALWAYS(format(v2) == stream(v2))
+
+		r4::vector3<float> v3{1.5, -2, 3.25};
+		ASSERT_INFO_ALWAYS(format(v3) == "(1.5, -2, 3.25)", format(v3))
+		ASSERT_ALWAYS(format(v3) == stream(v3))
+
+		r4::vector4<double> v4{1, 2, 3, 4};
+		ASSERT_ALWAYS(format(v4) == stream(v4))
+
+		r4::quaternion<float> q{0.5, 0.5, -0.5, 0.5};
+		ASSERT_ALWAYS(format(q) == stream(q))
+
+		r4::dual_quaternion<float> dq{{1, 2, 3, 4}, {5, 6, 7, 8}};
+		ASSERT_INFO_ALWAYS(format(dq) == "((1, 2, 3, 4), (5, 6, 7, 8))", format(dq))
+		ASSERT_ALWAYS(format(dq) == stream(dq))
+
+		r4::matrix2<float> m2{{1, 2, 3}, {4, 5, 6}};
+		ASSERT_INFO_ALWAYS(format(m2) == "\n\t/1 2 3\\\n\t\\4 5 6/", format(m2))
+		ASSERT_ALWAYS(format(m2) == stream(m2))
+
+		r4::matrix3<int> m3{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+		ASSERT_INFO_ALWAYS(format(m3) == "\n\t/1 2 3\\\n\t|4 5 6|\n\t\\7 8 9/", format(m3))
+		ASSERT_ALWAYS(format(m3) == stream(m3))
+
+		r4::matrix4<double> m4;
+		m4.set_identity();
+		ASSERT_ALWAYS(format(m4) == stream(m4))
+
+		r4::affine3<float> a;
+		a.set_identity();
+		ASSERT_ALWAYS(format(a) == stream(a))
+
+		r4::rectangle<int> r{{1, 2}, {3, 4}};
+		ASSERT_INFO_ALWAYS(format(r) == "[(1, 2)(3, 4)]", format(r))
+		ASSERT_ALWAYS(format(r) == stream(r))
+
+		r4::aabb3<float> b{{1, 2, 3}, {4, 5, 6}};
+		ASSERT_ALWAYS(format(b) == stream(b))
+	}
+
+	// test shortest round trip format of floats
+	{
+		ASSERT_INFO_ALWAYS(format(r4::vector2<float>(0.1f, 1e-7f)) == "(0.1, 1e-07)", format(r4::vector2<float>(0.1f, 1e-7f)))
+		ASSERT_INFO_ALWAYS(format(r4::vector2<double>(0.1, 1.0 / 3)) == "(0.1, 0.3333333333333333)", format(r4::vector2<double>(0.1, 1.0 / 3)))
+	}
+
+	// test round trip of random values
+	{
+		std::mt19937 gen(1);
+		std::uniform_real_distribution<double> dist(-1e3, 1e3);
+		std::uniform_int_distribution<int> exp_dist(-30, 30);
+		auto rnd = [&]{
+			return std::ldexp(dist(gen), exp_dist(gen));
+		};
+
+		for(unsigned i = 0; i != 1000; ++i){
+			check_roundtrip(r4::vector2<float>(float(rnd()), float(rnd())));
+			check_roundtrip(r4::vector3<double>(rnd(), rnd(), rnd()));
+			check_roundtrip(r4::vector4<float>(float(rnd()), float(rnd()), float(rnd()), float(rnd())));
+			check_roundtrip(r4::vector3<int>(int(rnd()), int(rnd()), int(rnd())));
+			check_roundtrip(r4::quaternion<double>(rnd(), rnd(), rnd(), rnd()));
+
+			r4::matrix4<float> m4;
+			for(auto& r : m4){
+				for(auto& c : r){
+					c = float(rnd());
+				}
+			}
+			check_roundtrip(m4);
+
+			r4::matrix3<double> m3;
+			for(auto& r : m3){
+				for(auto& c : r){
+					c = rnd();
+				}
+			}
+			check_roundtrip(m3);
+
+			check_roundtrip(r4::matrix2<float>(r4::vector3<float>(m4[0]), r4::vector3<float>(m4[1])));
+
+			r4::affine3<double> a;
+			for(auto& r : a){
+				for(auto& c : r){
+					c = rnd();
+				}
+			}
+			check_roundtrip(a);
+
+			check_roundtrip(r4::dual_quaternion<float>(r4::quaternion<float>(m4[2]), r4::quaternion<float>(m4[3])));
+			check_roundtrip(r4::rectangle<double>({rnd(), rnd()}, {rnd(), rnd()}));
+			check_roundtrip(r4::aabb3<float>({float(rnd()), float(rnd()), float(rnd())}, {float(rnd()), float(rnd()), float(rnd())}));
+		}
+
+		check_roundtrip(r4::vector2<r4::half>(r4::half(0.1), r4::half(-1000)));
+		check_roundtrip(r4::vector3<r4::fixed<16>>(0.1, -1000, 1.0 / 3));
+	}
+
+	// test parsing text produced by operator<<
+	{
+		check_stream_parse(r4::vector2<int>(1, -2));
+		check_stream_parse(r4::vector3<float>(1.5, -2, 3.25));
+		check_stream_parse(r4::vector4<double>(1, 2, 3, 4));
+		check_stream_parse(r4::quaternion<float>(0.5, 0.5, -0.5, 0.5));
+		check_stream_parse(r4::dual_quaternion<double>({1, 2, 3, 4}, {5, 6, 7, 8}));
+		check_stream_parse(r4::matrix2<float>({1, 2, 3}, {4, 5, 6}));
+		check_stream_parse(r4::matrix3<int>({1, 2, 3}, {4, 5, 6}, {7, 8, 9}));
+		check_stream_parse(r4::matrix4<double>({1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16}));
+		check_stream_parse(r4::affine3<float>({1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}));
+		check_stream_parse(r4::rectangle<int>({1, 2}, {3, 4}));
+		check_stream_parse(r4::aabb3<double>({1, 2, 3}, {4, 5, 6}));
+	}
+
+	// test parsing with arbitrary whitespace and trailing text
+	{
+		std::string str = "  ( 1 ,2,\n\t3 ) tail";
+		r4::vector3<int> v;
+		auto res = r4::from_chars(str.data(), str.data() + str.size(), v);
+		ASSERT_ALWAYS(res.ec == std::errc())
+		ASSERT_ALWAYS(v == r4::vector3<int>(1, 2, 3))
+		ASSERT_ALWAYS(std::string(res.ptr) == " tail")
+
+		std::string m = "/1 0\t0\\ \\0 1 0/";
+		r4::matrix2<float> m2;
+		res = r4::from_chars(m.data(), m.data() + m.size(), m2);
+		ASSERT_ALWAYS(res.ec == std::errc())
+		ASSERT_ALWAYS(m2 == r4::matrix2<float>().set_identity())
+	}
+
+	// test parse errors
+	{
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>(""))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>("(1, 2"))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>("(1 2)"))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>("(1, 2, 3)"))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>("[1, 2]"))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<float>>("(1, x)"))
+		ASSERT_ALWAYS(parse_fails<r4::vector2<int>>("(1.5, 2)"))
+		ASSERT_ALWAYS(parse_fails<r4::vector3<float>>("(1, 2)"))
+		ASSERT_ALWAYS(parse_fails<r4::matrix2<float>>("/1 2 3\\ |4 5 6|"))
+		ASSERT_ALWAYS(parse_fails<r4::matrix3<float>>("/1 2 3\\ |4 5 6| |7 8 9/"))
+		ASSERT_ALWAYS(parse_fails<r4::rectangle<int>>("[(1, 2)(3, 4)"))
+
+		// out of range
+		std::string big = "(1, 1e100)";
+		r4::vector2<float> v(7, 8);
+		auto res = r4::from_chars(big.data(), big.data() + big.size(), v);
+		ASSERT_ALWAYS(res.ec == std::errc::result_out_of_range)
+		ASSERT_ALWAYS(res.ptr == big.data())
+		// value is not modified on failure
+		ASSERT_ALWAYS(v == r4::vector2<float>(7, 8))
+
+		// out of range of fixed-point type
+		typedef r4::fixed<16> fixed;
+		auto parse_fixed = [](const std::string& str, fixed& f){
+			return r4::from_chars(str.data(), str.data() + str.size(), f).ec;
+		};
+		fixed f = fixed(7);
+		ASSERT_ALWAYS(parse_fixed("100000", f) == std::errc::result_out_of_range)
+		ASSERT_ALWAYS(parse_fixed("-100000", f) == std::errc::result_out_of_range)
+		ASSERT_ALWAYS(parse_fixed("32767.99999999", f) == std::errc::result_out_of_range)
+		ASSERT_ALWAYS(parse_fixed("1e300", f) == std::errc::result_out_of_range)
+		ASSERT_ALWAYS(f == fixed(7))
+		ASSERT_ALWAYS(parse_fixed("32767.99999", f) == std::errc())
+		ASSERT_ALWAYS(f == std::numeric_limits<fixed>::max())
+		ASSERT_ALWAYS(parse_fixed("-32768", f) == std::errc())
+		ASSERT_ALWAYS(f == std::numeric_limits<fixed>::lowest())
+		ASSERT_ALWAYS(parse_fails<r4::vector2<fixed>>("(1, 40000)"))
+	}
+
+	// test formatting to too small buffer
+	{
+		r4::matrix4<float> m;
+		m.set_identity();
+		auto str = format(m);
+		for(size_t size = 0; size != str.size(); ++size){
+			char buf[512];
+			auto res = r4::to_chars(buf, buf + size, m);
+			ASSERT_ALWAYS(res.ec == std::errc::value_too_large)
+			ASSERT_ALWAYS(res.ptr == buf + size)
+		}
+		char buf[512];
+		auto res = r4::to_chars(buf, buf + str.size(), m);
+		ASSERT_ALWAYS(res.ec == std::errc())
+		ASSERT_ALWAYS(res.ptr == buf + str.size())
+	}
+
+	// test special values
+	{
+		auto inf = std::numeric_limits<float>::infinity();
+		check_roundtrip(r4::vector2<float>(inf, -inf));
+		r4::vector2<float> v;
+		std::string str = format(r4::vector2<float>(std::numeric_limits<float>::quiet_NaN(), 0));
+		auto res = r4::from_chars(str.data(), str.data() + str.size(), v);
+		ASSERT_ALWAYS(res.ec == std::errc())
+		ASSERT_ALWAYS(std::isnan(v.x()))
+	}
+
+	return 0;
+}
@@ -0,0 +1,198 @@
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/dual_quaternion.hpp"
+
+int main(int argc, char** argv){
+
+	auto distance = [](const r4::vector3<double>& a, const r4::vector3<double>& b){
+		return (a - b).norm();
+	};
+
+	// test constructor(quaternion, vector3), translation(), operator*(vector3)
+	{
+		r4::quaternion<double> q;
+		q.set_rotation(r4::vector3<double>(1, 2, 3).normalize(), 0.8);
+		r4::vector3<double> t(4, -5, 6);
+
+		r4::dual_quaternion<double> dq(q, t);
+
+		ASSERT_ALWAYS(dq.rotation() == q)
+		ASSERT_INFO_ALWAYS(distance(dq.translation(), t) < 1e-12, "dq.translation() = " << dq.translation())
+
+		r4::vector3<double> p(7, 8, -9);
+		auto expected = r4::vector3<double>(p).rotate(q) + t;
+		ASSERT_INFO_ALWAYS(distance(dq * p, expected) < 1e-12, "dq * p = " << dq * p << ", expected = " << expected)
+	}
+
+	// test set_identity()
+	{
+		r4::dual_quaternion<double> dq;
+		dq.set_identity();
+
+		r4::vector3<double> p(7, 8, -9);
+		ASSERT_ALWAYS(dq * p == p)
+	}
+
+	// test conversion to and from matrix4 and affine3
+	{
+		r4::quaternion<double> q;
+		q.set_rotation(r4::vector3<double>(-3, 1, 2).normalize(), 2.1);
+		r4::vector3<double> t(1, 2, 3);
+
+		r4::dual_quaternion<double> dq(q, t);
+
+		r4::matrix4<double> m;
+		m.set_identity();
+		m.translate(t);
+		m.rotate(q);
+
+		auto mdiff = dq.to_matrix4() - m;
+		mdiff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(mdiff == decltype(mdiff)().set(0), "dq.to_matrix4() = " << dq.to_matrix4() << ", m = " << m)
+
+		auto adiff = dq.to_affine3() - r4::affine3<double>(m);
+		adiff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(adiff == decltype(adiff)().set(0), "dq.to_affine3() = " << dq.to_affine3())
+
+		r4::vector3<double> p(-4, 5, 1);
+
+		r4::dual_quaternion<double> fm(m);
+		ASSERT_INFO_ALWAYS(distance(fm * p, m * p) < 1e-12, "fm = " << fm)
+
+		r4::dual_quaternion<double> fa(dq.to_affine3());
+		ASSERT_INFO_ALWAYS(distance(fa * p, m * p) < 1e-12, "fa = " << fa)
+	}
+
+	// test operator%(dual_quaternion), operator!()
+	{
+		r4::quaternion<double> qa;
+		qa.set_rotation(r4::vector3<double>(1, 0, 1).normalize(), 0.3);
+		r4::quaternion<double> qb;
+		qb.set_rotation(r4::vector3<double>(0, 1, 1).normalize(), -1.2);
+
+		r4::dual_quaternion<double> a(qa, r4::vector3<double>(1, 2, 3));
+		r4::dual_quaternion<double> b(qb, r4::vector3<double>(-3, 0, 5));
+
+		r4::vector3<double> p(3, -1, 2);
+
+		auto ab = a % b;
+		ASSERT_INFO_ALWAYS(distance(ab * p, a * (b * p)) < 1e-12, "ab = " << ab)
+
+		auto c = a;
+		c %= b;
+		ASSERT_ALWAYS(c == ab)
+
+		auto ai = !a;
+		ASSERT_INFO_ALWAYS(distance(ai * (a * p), p) < 1e-12, "ai = " << ai)
+
+		c = a;
+		c.conjugate();
+		ASSERT_ALWAYS(c == ai)
+	}
+
+	// test normalize()
+	{
+		r4::quaternion<double> q;
+		q.set_rotation(r4::vector3<double>(1, 1, 1).normalize(), 1);
+		r4::dual_quaternion<double> dq(q, r4::vector3<double>(1, -2, 3));
+
+		auto n = dq * 3.0;
+		ASSERT_ALWAYS(std::abs(n.norm() - 3) < 1e-12)
+
+		n.normalize();
+		ASSERT_ALWAYS(std::abs(n.norm() - 1) < 1e-12)
+		ASSERT_ALWAYS(std::abs(n.real() * n.dual()) < 1e-12)
+
+		r4::vector3<double> p(3, -1, 2);
+		ASSERT_ALWAYS(distance(n * p, dq * p) < 1e-12)
+	}
+
+	// test transform_points()
+	{
+		r4::quaternion<float> q;
+		q.set_rotation(r4::vector3<float>(1, 2, 3).normalize(), 0.8f);
+		r4::dual_quaternion<float> dq(q, r4::vector3<float>(4, -5, 6));
+
+		std::vector<r4::vector3<float>> points;
+		for(int i = 0; i != 7; ++i){
+			points.emplace_back(float(i), float(-i * 2), float(i + 3));
+		}
+
+		std::vector<r4::vector3<float>> transformed(points.size());
+		dq.transform_points(points.data(), transformed.data(), points.size());
+
+		for(size_t i = 0; i != points.size(); ++i){
+			auto expected = dq * points[i];
+			ASSERT_INFO_ALWAYS((transformed[i] - expected).norm() < 1e-5f, "i = " << i << ", transformed[i] = " << transformed[i] << ", expected = " << expected)
+		}
+	}
+
+	// test blend() and skin()
+	{
+		const unsigned num_bones = 5;
+		std::vector<r4::dual_quaternion<float>> bones;
+		std::vector<r4::dual_quaternion<double>> dbones;
+		for(unsigned i = 0; i != num_bones; ++i){
+			r4::quaternion<float> q;
+			q.set_rotation(r4::vector3<float>(float(i), 1, float(i % 2)).normalize(), 0.5f * float(i));
+			// some of the bones are in opposite hemisphere
+			if(i % 3 == 2){
+				q.negate();
+			}
+			bones.emplace_back(q, r4::vector3<float>(float(i), float(i * 2) - 3, 1));
+			dbones.push_back(bones.back().to<double>());
+		}
+
+		const unsigned influences = 3;
+		const size_t num_points = 11; // not multiple of 4 to check the tail processing
+
+		std::vector<r4::vector3<float>> points;
+		std::vector<unsigned> indices;
+		std::vector<float> weights;
+		for(size_t i = 0; i != num_points; ++i){
+			points.emplace_back(float(i), float(i % 3) - 1, 2 - float(i) * 0.5f);
+			for(unsigned k = 0; k != influences; ++k){
+				indices.push_back(unsigned(i + k * 2) % num_bones);
+			}
+			weights.push_back(0.5f);
+			weights.push_back(0.3f);
+			weights.push_back(i % 2 == 0 ? 0.2f : 0);
+		}
+
+		std::vector<r4::vector3<float>> skinned(num_points);
+		r4::dual_quaternion<float>::skin(bones.data(), indices.data(), weights.data(), influences, points.data(), skinned.data(), num_points);
+
+		for(size_t i = 0; i != num_points; ++i){
+			std::vector<double> w(weights.begin() + i * influences, weights.begin() + (i + 1) * influences);
+			auto b = r4::dual_quaternion<double>::blend(dbones.data(), indices.data() + i * influences, w.data(), influences);
+			auto expected = b * points[i].to<double>();
+
+			ASSERT_INFO_ALWAYS(distance(skinned[i].to<double>(), expected) < 1e-4, "i = " << i << ", skinned[i] = " << skinned[i] << ", expected = " << expected)
+		}
+
+		// single bone with weight 1 is same as transformation by the bone
+		std::vector<unsigned> single_indices(num_points, 1);
+		std::vector<float> single_weights(num_points, 1);
+		r4::dual_quaternion<float>::skin(bones.data(), single_indices.data(), single_weights.data(), 1, points.data(), skinned.data(), num_points);
+		for(size_t i = 0; i != num_points; ++i){
+			auto expected = bones[1] * points[i];
+			ASSERT_INFO_ALWAYS((skinned[i] - expected).norm() < 1e-4f, "i = " << i << ", skinned[i] = " << skinned[i] << ", expected = " << expected)
+		}
+	}
+
+	// test compile time evaluation
+	{
+		// rotation by pi around z axis, then translation
+		constexpr r4::dual_quaternion<float> dq(r4::quaternion<float>(0, 0, 1, 0), r4::vector3<float>(1, 2, 3));
+
+		constexpr auto t = dq.translation();
+		static_assert(t.x() == 1 && t.y() == 2 && t.z() == 3);
+
+		constexpr auto p = dq * r4::vector3<float>(1, 1, 1);
+		static_assert(p.x() == 0 && p.y() == 1 && p.z() == 4);
+	}
+
+	return 0;
+}
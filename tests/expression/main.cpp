@@ -0,0 +1,145 @@
+#include <utki/debug.hpp>
+
+#include "../../src/r4/expression.hpp"
+
+int main(int argc, char** argv){
+
+	// test vector expressions
+	{
+		r4::vector4<int> a{1, 2, 3, 4};
+		r4::vector4<int> b{5, -6, 7, 8};
+		r4::vector4<int> c{-9, 10, 11, 12};
+
+		r4::vector4<int> r = r4::lazy(a) + r4::lazy(b) * 3 - c;
+		ASSERT_INFO_ALWAYS(r == a + b * 3 - c, "r = " << r)
+
+		r = 2 * r4::lazy(a) - (r4::lazy(b) + c) / 2;
+		ASSERT_INFO_ALWAYS(r == a * 2 - (b + c) / 2, "r = " << r)
+
+		r = -r4::lazy(a) + b;
+		ASSERT_INFO_ALWAYS(r == b - a, "r = " << r)
+
+		auto e = (r4::lazy(a) - b).eval();
+		static_assert(std::is_same<decltype(e), r4::vector4<int>>::value, "eval() result type mismatch");
+		ASSERT_ALWAYS(e == a - b)
+	}
+
+	// test vector2 and vector3 expressions
+	{
+		r4::vector2<float> a2{1, 2};
+		r4::vector2<float> b2{3, 4};
+		r4::vector2<float> r2 = r4::lazy(a2) * 0.5f + b2;
+		ASSERT_INFO_ALWAYS(r2 == a2 * 0.5f + b2, "r2 = " << r2)
+
+		r4::vector3<double> a3{1, 2, 3};
+		r4::vector3<double> b3{3, 4, 5};
+		r4::vector3<double> r3 = r4::lazy(a3) - r4::lazy(b3) * 2.0;
+		ASSERT_INFO_ALWAYS(r3 == a3 - b3 * 2.0, "r3 = " << r3)
+	}
+
+	// test matrix chain applied to vector
+	{
+		r4::matrix4<int> m1{
+			{1, 3, 5, 9},
+			{1, 3, 1, 7},
+			{4, 3, 9, 7},
+			{5, 2, 0, 9}
+		};
+		r4::matrix4<int> m2{
+			{2, -1, 0, 3},
+			{1, 4, -2, 5},
+			{0, 3, 7, -1},
+			{6, -2, 1, 1}
+		};
+		r4::matrix4<int> m3 = m1;
+		m3.transpose();
+
+		r4::vector4<int> v{1, -2, 3, -4};
+
+		r4::vector4<int> r = r4::lazy(m1) * m2 * m3 * v;
+		ASSERT_INFO_ALWAYS(r == m1 * m2 * m3 * v, "r = " << r)
+
+		// matrix-vector product within vector expression
+		r = r4::lazy(m1) * m2 * (r4::lazy(v) * 2) + v;
+		ASSERT_INFO_ALWAYS(r == m1 * m2 * (v * 2) + v, "r = " << r)
+
+		// evaluation of matrix expression
+		r4::matrix4<int> m = r4::lazy(m1) * m2 * m3;
+		ASSERT_ALWAYS(m == m1 * m2 * m3)
+
+		// vector3 is transformed as (x, y, z, 1), the w-component of the product must not be lost between the matrices
+		r4::vector3<int> v3{1, 2, 3};
+		r4::vector3<int> r3 = r4::lazy(m1) * m2 * v3;
+		ASSERT_INFO_ALWAYS(r3 == (m1 * m2) * v3, "r3 = " << r3)
+
+		// vector2 is transformed as (x, y, 0, 1)
+		r4::vector2<int> v2{1, -2};
+		r4::vector2<int> r2 = r4::lazy(m1) * m2 * m3 * v2;
+		ASSERT_INFO_ALWAYS(r2 == (m1 * m2 * m3) * v2, "r2 = " << r2)
+	}
+
+	// test chains with translation, projection and rotation applied to vectors of lower dimension
+	{
+		r4::matrix4<double> translation{
+			{1, 0, 0, 1},
+			{0, 1, 0, 2},
+			{0, 0, 1, 3},
+			{0, 0, 0, 1}
+		};
+		r4::matrix4<double> projection{
+			{1, 0, 0, 0},
+			{0, 1, 0, 0},
+			{0, 0, 1, 0},
+			{0, 0, -1, 0}
+		};
+
+		r4::vector3<double> v3{1, 2, -3};
+		r4::vector3<double> r3 = r4::lazy(translation) * projection * v3;
+		ASSERT_INFO_ALWAYS(r3 == (translation * projection) * v3, "r3 = " << r3)
+		ASSERT_INFO_ALWAYS(r3 == r4::vector3<double>(4, 8, 6), "r3 = " << r3)
+
+		// rotations by +90 and -90 degrees about x-axis
+		r4::matrix4<double> rotation{
+			{1, 0, 0, 0},
+			{0, 0, -1, 0},
+			{0, 1, 0, 0},
+			{0, 0, 0, 1}
+		};
+		r4::matrix4<double> inverse_rotation = rotation;
+		inverse_rotation.transpose();
+
+		r4::vector2<double> v2{1, 2};
+		r4::vector2<double> r2 = r4::lazy(rotation) * inverse_rotation * v2;
+		ASSERT_INFO_ALWAYS(r2 == (rotation * inverse_rotation) * v2, "r2 = " << r2)
+		ASSERT_INFO_ALWAYS(r2 == v2, "r2 = " << r2)
+	}
+
+	// test matrix3 and matrix2 chains
+	{
+		r4::matrix3<float> m1{
+			{1, 3, 5},
+			{1, 7, 4},
+			{3, 9, 7}
+		};
+		r4::matrix3<float> m2 = m1;
+		m2.transpose();
+
+		r4::vector3<float> v{1, 2, 3};
+		r4::vector3<float> r = r4::lazy(m1) * m2 * v;
+		ASSERT_INFO_ALWAYS(r == m1 * m2 * v, "r = " << r)
+
+		r4::matrix2<float> a{
+			{1, 3, 5},
+			{4, 7, 2}
+		};
+		r4::matrix2<float> b{
+			{2, 1, 3},
+			{5, 4, 7}
+		};
+		r4::vector2<float> v2{1, -1};
+		r4::vector2<float> r2 = r4::lazy(a) * b * v2;
+		ASSERT_INFO_ALWAYS(r2 == a * b * v2, "r2 = " << r2)
+	}
+
+	return 0;
+}
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <limits>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/fixed.hpp"
+#include "../../src/r4/vector2.hpp"
+#include "../../src/r4/vector3.hpp"
+#include "../../src/r4/vector4.hpp"
+#include "../../src/r4/quaternion.hpp"
+
+int main(int argc, char** argv){
+	typedef r4::fixed<16> fixed;
+
+	// test constexpr construction and arithmetic
+	{
+		constexpr fixed a = 1.5;
+		constexpr fixed b = 2;
+		static_assert(a.raw() == 0x18000);
+		static_assert(b.raw() == 0x20000);
+		static_assert(a + b == fixed(3.5));
+		static_assert(a - b == fixed(-0.5));
+		static_assert(a * b == fixed(3));
+		static_assert(b / fixed(4) == fixed(0.5));
+		static_assert(-a == fixed(-1.5));
+		static_assert(abs(-a) == a);
+		static_assert(sqrt(fixed(16)) == fixed(4));
+		static_assert(sqrt(fixed(2.25)) == fixed(1.5));
+		static_assert(a < b);
+		static_assert(double(a) == 1.5);
+		static_assert(int(fixed(-2.75)) == -2);
+
+		constexpr r4::vector3<fixed> v(1, 2, 3);
+		constexpr auto w = v + v * fixed(0.5);
+		static_assert(w.x() == fixed(1.5) && w.y() == fixed(3) && w.z() == fixed(4.5));
+		static_assert(v * v == fixed(14));
+	}
+
+	// test conversions and rounding
+	{
+		ASSERT_ALWAYS(fixed(0.25f).raw() == 0x4000)
+		ASSERT_ALWAYS(fixed(-0.25).raw() == -0x4000)
+		// half of the least significant bit rounds away from zero
+		ASSERT_ALWAYS(fixed(std::ldexp(1.0, -17)).raw() == 1)
+		ASSERT_ALWAYS(fixed(-std::ldexp(1.0, -17)).raw() == -1)
+		ASSERT_ALWAYS(fixed(std::ldexp(1.0, -18)).raw() == 0)
+		ASSERT_ALWAYS(fixed::from_raw(1).raw() == 1)
+		ASSERT_ALWAYS(float(fixed::from_raw(1)) == std::ldexp(1.0f, -16))
+		ASSERT_ALWAYS(int(fixed(7.9)) == 7)
+		ASSERT_ALWAYS(int(fixed(-7.9)) == -7)
+
+		// other formats
+		ASSERT_ALWAYS(r4::fixed<8>(1.5).raw() == 0x180)
+		ASSERT_ALWAYS(r4::fixed<0>(5) * r4::fixed<0>(3) == r4::fixed<0>(15))
+		ASSERT_ALWAYS(double(r4::fixed<24>(0.125) * r4::fixed<24>(4)) == 0.5)
+	}
+
+	// test multiplication rounding and division truncation
+	{
+		auto e = fixed::from_raw(1);
+		// 2^-16 * 0.5 = 2^-17 rounds to 2^-16
+		ASSERT_ALWAYS((e * fixed(0.5)).raw() == 1)
+		ASSERT_ALWAYS((e * fixed(0.25)).raw() == 0)
+		ASSERT_ALWAYS((fixed(1) / fixed(3)).raw() == 0x5555)
+		ASSERT_ALWAYS((fixed(-1) / fixed(3)).raw() == -0x5555)
+		ASSERT_ALWAYS((fixed(2) / fixed(3)).raw() == 0xaaab)
+		ASSERT_ALWAYS((fixed(-2) / fixed(3)).raw() == -0xaaab)
+		ASSERT_ALWAYS((fixed(2) / fixed(-3)).raw() == -0xaaab)
+		ASSERT_ALWAYS((e / fixed(2)).raw() == 1)
+		ASSERT_ALWAYS((e / fixed(3)).raw() == 0)
+	}
+
+	// test wrap around on overflow
+	{
+		auto m = std::numeric_limits<fixed>::max();
+		ASSERT_ALWAYS(m + fixed::from_raw(1) == std::numeric_limits<fixed>::lowest())
+		ASSERT_ALWAYS(std::numeric_limits<fixed>::epsilon().raw() == 1)
+		static_assert(std::numeric_limits<fixed>::round_style == std::round_to_nearest);
+
+		// conversion from out of range floating point numbers saturates
+		ASSERT_ALWAYS(fixed(100000.0) == std::numeric_limits<fixed>::max())
+		ASSERT_ALWAYS(fixed(-1e30f) == std::numeric_limits<fixed>::lowest())
+		ASSERT_ALWAYS(fixed(std::numeric_limits<double>::infinity()) == std::numeric_limits<fixed>::max())
+		ASSERT_ALWAYS(fixed(std::numeric_limits<double>::quiet_NaN()) == fixed(0))
+		ASSERT_ALWAYS(fixed(-32768.0) == std::numeric_limits<fixed>::lowest())
+		static_assert(fixed(1e10) == std::numeric_limits<fixed>::max());
+		ASSERT_ALWAYS(std::numeric_limits<fixed>::lowest().raw() == std::numeric_limits<int32_t>::min())
+	}
+
+	// test square root
+	for(int32_t r = 0; r < (int32_t(1) << 30); r = r * 3 + 1){
+		auto f = fixed::from_raw(r);
+		double expected = std::sqrt(double(f));
+		double actual = double(sqrt(f));
+		ASSERT_INFO_ALWAYS(actual <= expected && expected - actual < std::ldexp(1.0, -16), "r = " << r)
+	}
+
+	// test vectors of fixed-point numbers
+	{
+		r4::vector2<fixed> v2(3, 4);
+		ASSERT_ALWAYS(v2.norm_pow2() == fixed(25))
+		ASSERT_ALWAYS(v2.norm() == fixed(5))
+		v2.normalize();
+		ASSERT_ALWAYS(std::abs(double(v2.x()) - 0.6) < 1e-4)
+		ASSERT_ALWAYS(std::abs(double(v2.y()) - 0.8) < 1e-4)
+
+		r4::vector3<fixed> v3(2, 3, 6);
+		ASSERT_ALWAYS(v3.norm() == fixed(7))
+		auto n3 = r4::vector3<fixed>(v3).normalize().to<double>();
+		ASSERT_INFO_ALWAYS(std::abs(n3.norm() - 1) < 1e-4, "n3 = " << n3)
+
+		auto c = r4::vector3<fixed>(1, 0, 0) % r4::vector3<fixed>(0, 1, 0);
+		ASSERT_ALWAYS(c == r4::vector3<fixed>(0, 0, 1))
+
+		r4::vector4<fixed> v4(1, 1, 1, 1);
+		ASSERT_ALWAYS(v4.norm() == fixed(2))
+		v4.normalize();
+		ASSERT_ALWAYS(v4 == r4::vector4<fixed>(0.5, 0.5, 0.5, 0.5))
+
+		ASSERT_ALWAYS(sizeof(r4::vector3<fixed>) == 12)
+	}
+
+	// test quaternion of fixed-point numbers
+	{
+		r4::quaternion<fixed> q(1, 2, 3, 4);
+		ASSERT_ALWAYS(q.norm_pow2() == fixed(30))
+		q.normalize();
+		ASSERT_INFO_ALWAYS(std::abs(double(q.norm()) - 1) < 1e-4, "q = " << q)
+	}
+
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/frustum.hpp"
+
+namespace{
+// simple deterministic pseudo-random number generator, so that test results are reproducible
+float next_random(unsigned& state){
+	state = state * 1103515245 + 12345;
+	return float((state >> 16) & 0x7fff) / float(0x7fff);
+}
+}
+
+int main(int argc, char** argv){
+
+	r4::matrix4<float> proj;
+	proj.set_frustum(-1, 1, -1, 1, 1, 10);
+
+	// test planes extraction and contains()
+	{
+		r4::frustum<float> f(proj);
+
+		for(auto& p : f){
+			ASSERT_ALWAYS(std::abs(r4::vector3<float>(p).norm() - 1) < 1e-6f)
+		}
+
+		ASSERT_ALWAYS(f.contains(r4::vector3<float>(0, 0, -5)))
+		ASSERT_ALWAYS(f.contains(r4::vector3<float>(0.9f, -0.9f, -1.1f)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, 0, 5)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, 0, -0.5f)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, 0, -11)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(3, 0, -2)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, -3, -2)))
+
+		// points inside of the frustum must be inside of the clip space volume
+		unsigned seed = 1;
+		for(unsigned i = 0; i != 1000; ++i){
+			r4::vector3<float> p(next_random(seed) * 20 - 10, next_random(seed) * 20 - 10, next_random(seed) * 20 - 15);
+			auto c = proj * r4::vector4<float>(p, 1);
+			bool inside = std::abs(c.x()) <= c.w() && std::abs(c.y()) <= c.w() && std::abs(c.z()) <= c.w();
+			ASSERT_INFO_ALWAYS(f.contains(p) == inside, "p = " << p)
+		}
+	}
+
+	// planes extracted from combined matrix are in model space
+	{
+		r4::matrix4<float> model;
+		model.set_identity();
+		model.translate(0, 0, -100);
+
+		r4::frustum<float> f(proj * model);
+		ASSERT_ALWAYS(f.contains(r4::vector3<float>(0, 0, 95)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, 0, -5)))
+	}
+
+	// test intersects()
+	{
+		r4::frustum<double> f(proj.to<double>());
+
+		ASSERT_ALWAYS(f.intersects(r4::aabb3<double>({-0.5, -0.5, -6}, {0.5, 0.5, -5})))
+		ASSERT_ALWAYS(f.intersects(r4::aabb3<double>({-100, -100, -100}, {100, 100, 100})))
+		ASSERT_ALWAYS(f.intersects(r4::aabb3<double>({0, 0, -0.5}, {1, 1, 5})) == false)
+		ASSERT_ALWAYS(f.intersects(r4::aabb3<double>({-10, -10, -20}, {10, 10, -12})) == false)
+		ASSERT_ALWAYS(f.intersects(r4::aabb3<double>({5, -1, -3}, {6, 1, -2})) == false)
+
+		ASSERT_ALWAYS(f.intersects(r4::vector4<double>(0, 0, -5, 1)))
+		ASSERT_ALWAYS(f.intersects(r4::vector4<double>(0, 0, 0, 1.5)))
+		ASSERT_ALWAYS(!f.intersects(r4::vector4<double>(0, 0, 0, 0.5)))
+		ASSERT_ALWAYS(!f.intersects(r4::vector4<double>(0, 0, -12, 1)))
+	}
+
+	// test cull_mask() and cull_indices(), must give same results as intersects()
+	{
+		r4::frustum<float> f(proj);
+
+		const size_t num_objects = 1001; // not multiple of 4 and 32 to check tail processing
+
+		std::vector<r4::aabb3<float>> boxes;
+		std::vector<r4::vector4<float>> spheres;
+		unsigned seed = 7;
+		for(size_t i = 0; i != num_objects; ++i){
+			r4::vector3<float> c(next_random(seed) * 30 - 15, next_random(seed) * 30 - 15, next_random(seed) * 30 - 20);
+			r4::vector3<float> e(next_random(seed) * 3, next_random(seed) * 3, next_random(seed) * 3);
+			boxes.emplace_back(c - e, c + e);
+			spheres.emplace_back(c, e.x());
+		}
+
+		std::vector<uint32_t> mask((num_objects + 31) / 32, 0xdeadbeef);
+		std::vector<uint32_t> indices(num_objects);
+
+		f.cull_mask(boxes.data(), boxes.size(), mask.data());
+		size_t num_visible = f.cull_indices(boxes.data(), boxes.size(), indices.data());
+
+		std::vector<uint32_t> expected;
+		for(size_t i = 0; i != num_objects; ++i){
+			bool visible = f.intersects(boxes[i]);
+			ASSERT_INFO_ALWAYS(((mask[i / 32] >> (i % 32)) & 1) == unsigned(visible), "i = " << i)
+			if(visible){
+				expected.push_back(uint32_t(i));
+			}
+		}
+		ASSERT_ALWAYS(expected.size() != 0 && expected.size() != num_objects)
+		ASSERT_ALWAYS(std::vector<uint32_t>(indices.begin(), indices.begin() + num_visible) == expected)
+
+		std::fill(mask.begin(), mask.end(), 0xdeadbeef);
+		f.cull_mask(spheres.data(), spheres.size(), mask.data());
+		num_visible = f.cull_indices(spheres.data(), spheres.size(), indices.data());
+
+		expected.clear();
+		for(size_t i = 0; i != num_objects; ++i){
+			bool visible = f.intersects(spheres[i]);
+			ASSERT_INFO_ALWAYS(((mask[i / 32] >> (i % 32)) & 1) == unsigned(visible), "i = " << i)
+			if(visible){
+				expected.push_back(uint32_t(i));
+			}
+		}
+		ASSERT_ALWAYS(expected.size() != 0 && expected.size() != num_objects)
+		ASSERT_ALWAYS(std::vector<uint32_t>(indices.begin(), indices.begin() + num_visible) == expected)
+	}
+
+	// test frustum of infinite perspective projection, the far plane is at infinity
+	{
+		r4::matrix4<float> inf;
+		inf.set_perspective_infinite(utki::pi<float>() / 2, 1, 1);
+
+		r4::matrix4<float> view;
+		view.set_identity();
+		view.translate(1, 2, 3);
+
+		for(const auto& m : {inf, inf * view}){
+			r4::frustum<float> f(m);
+			for(auto& p : f){
+				ASSERT_ALWAYS(!std::isnan(p.x()) && !std::isnan(p.y()) && !std::isnan(p.z()) && !std::isnan(p.w()))
+			}
+			ASSERT_ALWAYS(f[5] == r4::vector4<float>(0, 0, 0, 1))
+		}
+
+		r4::frustum<float> f(inf);
+		ASSERT_ALWAYS(f.contains(r4::vector3<float>(0, 0, -1e6f)))
+		ASSERT_ALWAYS(!f.contains(r4::vector3<float>(0, 0, -0.5f)))
+
+		std::vector<r4::aabb3<float>> boxes = {
+			r4::aabb3<float>({-1, -1, -10}, {1, 1, -5}),
+			r4::aabb3<float>({-1, -1, -1e6f}, {1, 1, -1e5f}),
+			r4::aabb3<float>({-1, -1, 1}, {1, 1, 2}),
+			r4::aabb3<float>({10, -1, -3}, {12, 1, -2}),
+			r4::aabb3<float>({-1, -1, -3}, {1, 1, -2})
+		};
+		const bool expected[] = {true, true, false, false, true};
+
+		uint32_t mask = 0;
+		f.cull_mask(boxes.data(), boxes.size(), &mask);
+		for(size_t i = 0; i != boxes.size(); ++i){
+			ASSERT_INFO_ALWAYS(f.intersects(boxes[i]) == expected[i], "i = " << i)
+			ASSERT_INFO_ALWAYS(((mask >> i) & 1) == unsigned(expected[i]), "i = " << i)
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include <cmath>
+#include <limits>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/half.hpp"
+#include "../../src/r4/vector2.hpp"
+#include "../../src/r4/vector3.hpp"
+#include "../../src/r4/vector4.hpp"
+#include "../../src/r4/quaternion.hpp"
+
+int main(int argc, char** argv){
+	typedef r4::half half;
+
+	// test conversion of exactly representable numbers
+	{
+		ASSERT_ALWAYS(half(0).bits() == 0x0000)
+		ASSERT_ALWAYS(half(-0.0f).bits() == 0x8000)
+		ASSERT_ALWAYS(half(1).bits() == 0x3c00)
+		ASSERT_ALWAYS(half(-2).bits() == 0xc000)
+		ASSERT_ALWAYS(half(0.5).bits() == 0x3800)
+		ASSERT_ALWAYS(half(65504).bits() == 0x7bff)
+		ASSERT_ALWAYS(float(half(1)) == 1.0f)
+		ASSERT_ALWAYS(float(half(-3.5f)) == -3.5f)
+		ASSERT_ALWAYS(int(half(1000)) == 1000)
+		ASSERT_ALWAYS(double(half::from_bits(0x7bff)) == 65504)
+	}
+
+	// test subnormals
+	{
+		float d = std::ldexp(1.0f, -24);
+		ASSERT_ALWAYS(half(d).bits() == 0x0001)
+		ASSERT_ALWAYS(float(half::from_bits(0x0001)) == d)
+		ASSERT_ALWAYS(float(half::from_bits(0x03ff)) == std::ldexp(1023.0f, -24))
+		static_assert(std::numeric_limits<half>::has_denorm == std::denorm_present);
+		ASSERT_ALWAYS(float(std::numeric_limits<half>::denorm_min()) == d)
+		ASSERT_ALWAYS(half(std::ldexp(1.0f, -26)).bits() == 0)
+	}
+
+	// test rounding to nearest even
+	{
+		// 1 + 2^-11 is exactly half way between 1 and next half, rounds down to even
+		ASSERT_ALWAYS(half(1.0f + std::ldexp(1.0f, -11)).bits() == 0x3c00)
+		// 1 + 3 * 2^-11 is half way between 1 + 2^-10 and 1 + 2^-9, rounds up to even
+		ASSERT_ALWAYS(half(1.0f + 3 * std::ldexp(1.0f, -11)).bits() == 0x3c02)
+		ASSERT_ALWAYS(half(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)).bits() == 0x3c01)
+	}
+
+	// test overflow, infinity and NaN
+	{
+		ASSERT_ALWAYS(half(1e6f).bits() == 0x7c00)
+		ASSERT_ALWAYS(half(-1e6f).bits() == 0xfc00)
+		ASSERT_ALWAYS(half(std::numeric_limits<float>::infinity()).bits() == 0x7c00)
+		ASSERT_ALWAYS(std::isinf(float(std::numeric_limits<half>::infinity())))
+		ASSERT_ALWAYS(std::isnan(float(half(std::numeric_limits<float>::quiet_NaN()))))
+		ASSERT_ALWAYS(std::isnan(float(std::numeric_limits<half>::quiet_NaN())))
+		auto nan = std::numeric_limits<half>::quiet_NaN();
+		ASSERT_ALWAYS(nan != nan)
+	}
+
+	// test roundtrip of all finite halves
+	for(uint32_t b = 0; b != 0x10000; ++b){
+		auto h = half::from_bits(uint16_t(b));
+		if(std::isnan(float(h))){
+			continue;
+		}
+		ASSERT_INFO_ALWAYS(half(float(h)).bits() == b, "b = " << b)
+	}
+
+	// test numeric limits
+	{
+		typedef std::numeric_limits<half> limits;
+		ASSERT_ALWAYS(limits::is_specialized)
+		ASSERT_ALWAYS(float(limits::max()) == 65504)
+		ASSERT_ALWAYS(float(limits::lowest()) == -65504)
+		ASSERT_ALWAYS(float(limits::min()) == std::ldexp(1.0f, -14))
+		ASSERT_ALWAYS(float(limits::epsilon()) == std::ldexp(1.0f, -10))
+		ASSERT_ALWAYS(float(limits::denorm_min()) == std::ldexp(1.0f, -24))
+	}
+
+	// test arithmetic
+	{
+		half a = 1.5;
+		half b = 2;
+		ASSERT_ALWAYS(a + b == half(3.5))
+		ASSERT_ALWAYS(a - b == half(-0.5))
+		ASSERT_ALWAYS(a * b == half(3))
+		ASSERT_ALWAYS(b / a == half(2.0f / 1.5f))
+		ASSERT_ALWAYS(-a == half(-1.5))
+		ASSERT_ALWAYS(abs(-a) == a)
+		ASSERT_ALWAYS(sqrt(half(16)) == half(4))
+		ASSERT_ALWAYS(a < b)
+		ASSERT_ALWAYS(b >= a)
+		ASSERT_ALWAYS(half(0.0f) == half(-0.0f))
+
+		a += b;
+		ASSERT_ALWAYS(a == half(3.5))
+		a *= b;
+		ASSERT_ALWAYS(a == half(7))
+		a -= half(1);
+		ASSERT_ALWAYS(a == half(6))
+		a /= half(3);
+		ASSERT_ALWAYS(a == half(2))
+	}
+
+	// test vectors of halves
+	{
+		r4::vector2<half> v2(3, 4);
+		ASSERT_ALWAYS(v2.norm_pow2() == half(25))
+		ASSERT_ALWAYS(v2.norm() == half(5))
+		v2.normalize();
+		ASSERT_ALWAYS(v2 == r4::vector2<half>(0.6, 0.8))
+
+		r4::vector3<half> v3(2, 3, 6);
+		ASSERT_ALWAYS(v3.norm() == half(7))
+		ASSERT_ALWAYS((v3 * v3) == half(49))
+		auto n3 = r4::vector3<half>(v3).normalize().to<float>();
+		ASSERT_INFO_ALWAYS(std::abs(n3.norm() - 1) < 2e-3f, "n3 = " << n3)
+
+		r4::vector4<half> v4(1, 1, 1, 1);
+		ASSERT_ALWAYS(v4.norm() == half(2))
+		v4.normalize();
+		ASSERT_ALWAYS(v4 == r4::vector4<half>(0.5, 0.5, 0.5, 0.5))
+
+		auto s = r4::vector3<half>(1, 2, 3) + r4::vector3<half>(4, 5, 6);
+		ASSERT_ALWAYS(s == r4::vector3<half>(5, 7, 9))
+
+		ASSERT_ALWAYS(sizeof(r4::vector3<half>) == 6)
+	}
+
+	// test quaternion of halves
+	{
+		r4::quaternion<half> q(1, 2, 3, 4);
+		ASSERT_ALWAYS(q.norm_pow2() == half(30))
+		q.normalize();
+		ASSERT_INFO_ALWAYS(std::abs(float(q.norm()) - 1) < 2e-3f, "q = " << q)
+	}
+
+	return 0;
+}
@@ -4,6 +4,7 @@
 #include "../../src/r4/matrix2.hpp"
 
 #include <sstream>
+#include <vector>
 
 int main(int argc, char** argv){
     // test operator<<
@@ -108,6 +109,27 @@ int main(int argc, char** argv){
         ASSERT_ALWAYS(m[1][0] == 42) ASSERT_ALWAYS(m[1][1] == 51) ASSERT_ALWAYS(m[1][2] == 66)
     }
 
+	// test operator*(matrix2) for float, it is specialized when SIMD is available
+	{
+		r4::matrix2<float> m0{
+			{1, 2, 3},
+			{4, 5, 6}
+		};
+
+		r4::matrix2<float> m1{
+			{3, 4, 5},
+			{6, 7, 8}
+		};
+
+		auto m = m0 * m1;
+
+		ASSERT_INFO_ALWAYS(m[0] == r4::vector3<float>(15, 18, 24), "m = " << m)
+		ASSERT_INFO_ALWAYS(m[1] == r4::vector3<float>(42, 51, 66), "m = " << m)
+
+		constexpr auto c = r4::matrix2<float>{{1, 2, 3}, {4, 5, 6}} * r4::matrix2<float>{{3, 4, 5}, {6, 7, 8}};
+		static_assert(c[0][0] == 15 && c[0][2] == 24 && c[1][1] == 51 && c[1][2] == 66, "");
+	}
+
     // test operator*=(matrix2)
     {
         r4::matrix2<int> m{
@@ -296,5 +318,55 @@ int main(int argc, char** argv){
 		ASSERT_INFO_ALWAYS(diff == decltype(m)().set(0), std::endl << "i = " << i.snap_to_zero(epsilon) << std::endl << "diff = " << diff)
 	}
 
+	// test transform_points() and transform_points_bound()
+	{
+		auto check = [](auto m){
+			typedef typename decltype(m)::value_type::value_type T;
+			for(size_t size = 0; size != 13; ++size){
+				std::vector<r4::vector2<T>> src;
+				for(size_t i = 0; i != size; ++i){
+					src.emplace_back(T(i) * T(1.5) - T(7), T(i * i % 5) - T(2));
+				}
+
+				std::vector<r4::vector2<T>> expected;
+				for(const auto& p : src){
+					expected.push_back(m * p);
+				}
+
+				std::vector<r4::vector2<T>> dst(size);
+				m.transform_points(src.data(), dst.data(), size);
+				ASSERT_INFO_ALWAYS(dst == expected, "size = " << size)
+
+				auto in_place = src;
+				m.transform_points(in_place.data(), size);
+				ASSERT_INFO_ALWAYS(in_place == expected, "size = " << size)
+
+				r4::rectangle<T> expected_bound(0, 0, 0, 0);
+				if(size != 0){
+					auto min_xy = expected.front();
+					auto max_xy = expected.front();
+					for(const auto& p : expected){
+						min_xy = min(min_xy, p);
+						max_xy = max(max_xy, p);
+					}
+					expected_bound = r4::rectangle<T>(min_xy, max_xy - min_xy);
+				}
+
+				std::fill(dst.begin(), dst.end(), r4::vector2<T>(0));
+				auto bound = m.transform_points_bound(src.data(), dst.data(), size);
+				ASSERT_INFO_ALWAYS(dst == expected, "size = " << size)
+				ASSERT_INFO_ALWAYS(bound.p == expected_bound.p && bound.d == expected_bound.d, "size = " << size << ", bound = " << bound)
+
+				in_place = src;
+				bound = m.transform_points_bound(in_place.data(), in_place.data(), size);
+				ASSERT_INFO_ALWAYS(in_place == expected, "size = " << size)
+				ASSERT_INFO_ALWAYS(bound.p == expected_bound.p && bound.d == expected_bound.d, "size = " << size << ", bound = " << bound)
+			}
+		};
+
+		check(r4::matrix2<float>{{0.5f, -2, 3}, {1, 0.25f, -4}});
+		check(r4::matrix2<double>{{0.5, -2, 3}, {1, 0.25, -4}});
+	}
+
     return 0;
 }
@@ -177,6 +177,34 @@ int main(int argc, char** argv){
         ASSERT_INFO_ALWAYS(r[2][2] == 7 * 4 + 8 * 7 + 9 * 10, "r[2][2] = " << r[2][2])
     }
 
+	// test operator*(matrix3) for float, it is specialized when SIMD is available
+	{
+		r4::matrix3<float> m1{
+				{1, 2, 3},
+				{4, 5, 6},
+				{7, 8, 9}
+			};
+
+		r4::matrix3<float> m2{
+				{2, 3, 4},
+				{5, 6, 7},
+				{8, 9, 10}
+			};
+
+		auto r = m1 * m2;
+
+		ASSERT_INFO_ALWAYS(r[0] == r4::vector3<float>(36, 42, 48), "r = " << r)
+		ASSERT_INFO_ALWAYS(r[1] == r4::vector3<float>(81, 96, 111), "r = " << r)
+		ASSERT_INFO_ALWAYS(r[2] == r4::vector3<float>(126, 150, 174), "r = " << r)
+
+		// in-place multiplication
+		m1 *= m2;
+		ASSERT_INFO_ALWAYS(m1[0] == r[0] && m1[1] == r[1] && m1[2] == r[2], "m1 = " << m1)
+
+		constexpr auto c = r4::matrix3<float>{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}} * r4::matrix3<float>{{2, 3, 4}, {5, 6, 7}, {8, 9, 10}};
+		static_assert(c[0][0] == 36 && c[1][1] == 96 && c[2][2] == 174 && c[2][0] == 126, "");
+	}
+
     // test operator*=(matrix3)
     {
         r4::matrix3<int> m1{
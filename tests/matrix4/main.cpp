@@ -2,7 +2,9 @@
 
 #include "../../src/r4/matrix4.hpp"
 
+#include <cmath>
 #include <sstream>
+#include <vector>
 
 int main(int argc, char** argv){
 
@@ -131,6 +133,134 @@ int main(int argc, char** argv){
 		ASSERT_INFO_ALWAYS(r[3][3] == 13 * 20 + 14 * 24 + 15 * 28 + 16 * 32, "r = " << r)
 	}
 
+	// test operator*(matrix4) for float, this is specialized when SIMD is available
+	{
+		r4::matrix4<int> mi{
+		 	{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+
+		r4::matrix4<int> mi2{
+		 	{17, 18, 19, 20},
+			{21, 22, 23, 24},
+			{25, 26, 27, 28},
+			{29, 30, 31, 32}
+		};
+
+		auto m = mi.to<float>();
+		auto m2 = mi2.to<float>();
+
+		ASSERT_ALWAYS((m * m2).to<int>() == mi * mi2)
+
+		m *= m2;
+		ASSERT_ALWAYS(m.to<int>() == mi * mi2)
+
+		auto v = mi.to<float>() * r4::vector4<float>{3, 4, 5, 6};
+		ASSERT_INFO_ALWAYS(v.to<int>() == mi * r4::vector4<int>(3, 4, 5, 6), "v = " << v)
+
+		auto v3 = mi.to<float>() * r4::vector3<float>{3, 4, 5};
+		ASSERT_INFO_ALWAYS(v3.to<int>() == mi * r4::vector3<int>(3, 4, 5), "v3 = " << v3)
+	}
+
+	// test transform_points() and project_points()
+	{
+		r4::matrix4<float> m;
+		m.set_frustum(-2, 2, -1.5, 1.5, 2, 100);
+		m.translate(1, 2, -10);
+		m.rotate(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+
+		const float epsilon = 1e-4f;
+
+		// 7 points to test remainder of not complete SIMD block too
+		std::vector<r4::vector3<float>> p3;
+		for(unsigned i = 0; i != 7; ++i){
+			p3.push_back(r4::vector3<float>(float(i), float(i) * 0.5f - 1, 3 - float(i)));
+		}
+
+		{
+			std::vector<r4::vector3<float>> out(p3.size());
+			m.transform_points(p3.data(), out.data(), p3.size());
+			for(size_t i = 0; i != p3.size(); ++i){
+				auto cmp = m * p3[i];
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		{
+			auto out = p3;
+			m.project_points(out.data(), out.size());
+			for(size_t i = 0; i != p3.size(); ++i){
+				auto v = m * r4::vector4<float>(p3[i]);
+				auto cmp = r4::vector3<float>(v / v.w());
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		std::vector<r4::vector2<float>> p2;
+		for(const auto& p : p3){
+			p2.push_back(r4::vector2<float>(p));
+		}
+
+		{
+			auto out = p2;
+			m.transform_points(out.data(), out.size());
+			for(size_t i = 0; i != p2.size(); ++i){
+				auto cmp = m * p2[i];
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		{
+			std::vector<r4::vector2<float>> out(p2.size());
+			m.project_points(p2.data(), out.data(), p2.size());
+			for(size_t i = 0; i != p2.size(); ++i){
+				auto v = m * r4::vector4<float>(p2[i]);
+				auto cmp = r4::vector2<float>(v.x() / v.w(), v.y() / v.w());
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		std::vector<r4::vector4<float>> p4;
+		for(const auto& p : p3){
+			p4.push_back(r4::vector4<float>(p, 0.5f));
+		}
+
+		{
+			auto out = p4;
+			m.transform_points(out.data(), out.size());
+			for(size_t i = 0; i != p4.size(); ++i){
+				auto cmp = m * p4[i];
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		{
+			std::vector<r4::vector4<float>> out(p4.size());
+			m.project_points(p4.data(), out.data(), p4.size());
+			for(size_t i = 0; i != p4.size(); ++i){
+				auto v = m * p4[i];
+				auto cmp = v / v.w();
+				ASSERT_INFO_ALWAYS((out[i] - cmp).norm() < epsilon, "i = " << i << " out = " << out[i] << " cmp = " << cmp)
+			}
+		}
+
+		// integer version goes through generic implementation
+		r4::matrix4<int> mi{
+		 	{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+		std::array<r4::vector3<int>, 2> pi = {{ {3, 4, 5}, {-1, 2, -3} }};
+		auto cmp0 = mi * pi[0];
+		auto cmp1 = mi * pi[1];
+		mi.transform_points(pi.data(), pi.size());
+		ASSERT_ALWAYS(pi[0] == cmp0)
+		ASSERT_ALWAYS(pi[1] == cmp1)
+	}
+
 	// test transpose()
 	{
 		r4::matrix4<int> m{
@@ -333,6 +463,182 @@ int main(int argc, char** argv){
 		ASSERT_INFO_ALWAYS(str == cmp, "str = " << str)
 	}
 
+	// test set_ortho(l, r, b, t, n, f) and ortho(l, r, b, t, n, f)
+	{
+		r4::matrix4<double> m;
+		m.set_ortho(-2, 6, -1, 3, 1, 5);
+
+		r4::matrix4<double> cmp{
+			{0.25, 0, 0, -0.5},
+			{0, 0.5, 0, -0.5},
+			{0, 0, -0.5, -1.5},
+			{0, 0, 0, 1}
+		};
+		ASSERT_INFO_ALWAYS(m == cmp, "m = " << m)
+
+		r4::matrix4<double> n{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+		auto expected = n * m;
+		n.ortho(-2, 6, -1, 3, 1, 5);
+		ASSERT_INFO_ALWAYS(n == expected, "n = " << n << "\nexpected = " << expected)
+	}
+
+	// test set_perspective(fovy, aspect, n, f) and perspective(fovy, aspect, n, f)
+	{
+		const double fovy = utki::pi<double>() / 3;
+		const double t = 2 * std::tan(fovy / 2);
+
+		r4::matrix4<double> m;
+		m.set_perspective(fovy, 1.5, 2, 100);
+
+		auto f = r4::matrix4<double>().set_frustum(-1.5 * t, 1.5 * t, -t, t, 2, 100);
+		auto diff = m - f;
+		diff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(diff == r4::matrix4<double>().set(0), "m = " << m << "\nf = " << f)
+
+		r4::matrix4<double> n{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+		auto expected = n * m;
+		n.perspective(fovy, 1.5, 2, 100);
+		diff = n - expected;
+		diff.snap_to_zero(1e-9);
+		ASSERT_INFO_ALWAYS(diff == r4::matrix4<double>().set(0), "n = " << n << "\nexpected = " << expected)
+	}
+
+	// test set_perspective_infinite(fovy, aspect, n) and set_perspective_reversed_z(fovy, aspect, n)
+	{
+		const double fovy = utki::pi<double>() / 2;
+
+		auto depth = [](const r4::matrix4<double>& m, double z){
+			auto p = m * r4::vector4<double>(0, 0, z, 1);
+			return p.z() / p.w();
+		};
+
+		r4::matrix4<double> m;
+		m.set_perspective_infinite(fovy, 2, 0.5);
+		ASSERT_ALWAYS(std::abs(depth(m, -0.5) - (-1)) < 1e-12)
+		ASSERT_ALWAYS(std::abs(depth(m, -1e12) - 1) < 1e-9)
+
+		auto f = r4::matrix4<double>().set_perspective(fovy, 2, 0.5, 1e12);
+		auto diff = m - f;
+		diff.snap_to_zero(1e-9);
+		ASSERT_INFO_ALWAYS(diff == r4::matrix4<double>().set(0), "m = " << m << "\nf = " << f)
+
+		m.set_perspective_reversed_z(fovy, 2, 0.5);
+		ASSERT_ALWAYS(std::abs(depth(m, -0.5) - 1) < 1e-12)
+		ASSERT_ALWAYS(std::abs(depth(m, -1e12)) < 1e-9)
+		ASSERT_ALWAYS(m[0] == f[0])
+		ASSERT_ALWAYS(m[1] == f[1])
+		ASSERT_ALWAYS(m[3] == f[3])
+	}
+
+	// test set_look_at(eye, center, up) and look_at(eye, center, up)
+	{
+		r4::vector3<double> eye(1, 2, 3);
+		r4::vector3<double> center(-4, 5, 1);
+		r4::vector3<double> up(0, 1, 0);
+
+		r4::matrix4<double> m;
+		m.set_look_at(eye, center, up);
+
+		ASSERT_ALWAYS((m * eye).norm() < 1e-12)
+
+		auto c = m * center;
+		ASSERT_INFO_ALWAYS((c - r4::vector3<double>(0, 0, -(center - eye).norm())).norm() < 1e-12, "c = " << c)
+
+		auto u = m * (eye + up);
+		ASSERT_INFO_ALWAYS(std::abs(u.x()) < 1e-12 && u.y() > 0, "u = " << u)
+
+		// rotation part is orthonormal
+		for(unsigned i = 0; i != 3; ++i){
+			for(unsigned j = 0; j != 3; ++j){
+				auto d = m[i][0] * m[j][0] + m[i][1] * m[j][1] + m[i][2] * m[j][2];
+				ASSERT_ALWAYS(std::abs(d - (i == j ? 1 : 0)) < 1e-12)
+			}
+		}
+		ASSERT_ALWAYS(std::abs(m.det() - 1) < 1e-12)
+
+		r4::matrix4<double> n{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+		auto expected = n * m;
+		n.look_at(eye, center, up);
+		auto diff = n - expected;
+		diff.snap_to_zero(1e-9);
+		ASSERT_INFO_ALWAYS(diff == r4::matrix4<double>().set(0), "n = " << n << "\nexpected = " << expected)
+	}
+
+	// test make_ortho(), make_perspective() and make_look_at()
+	{
+		const size_t size = 7;
+
+		std::vector<r4::aabb3<float>> volumes;
+		std::vector<float> fovy;
+		std::vector<float> aspect;
+		std::vector<float> near_val;
+		std::vector<float> far_val;
+		std::vector<r4::vector3<float>> eye;
+		std::vector<r4::vector3<float>> center;
+		std::vector<r4::vector3<float>> up;
+		for(size_t i = 0; i != size; ++i){
+			auto f = float(i);
+			volumes.push_back(r4::aabb3<float>{{-1 - f, -2, 1}, {1 + f, 2 + f, 10 + f}});
+			fovy.push_back(0.5f + 0.1f * f);
+			aspect.push_back(1 + 0.25f * f);
+			near_val.push_back(0.1f + f);
+			far_val.push_back(100 + f);
+			eye.emplace_back(f, 2, -f);
+			center.emplace_back(1, f, 3);
+			up.push_back(i % 2 == 0 ? r4::vector3<float>(0, 1, 0) : r4::vector3<float>(0, 0, 1));
+		}
+
+		std::vector<r4::matrix4<float>> out(size);
+
+		r4::matrix4<float>::make_ortho(volumes.data(), out.data(), size);
+		for(size_t i = 0; i != size; ++i){
+			const auto& v = volumes[i];
+			auto expected = r4::matrix4<float>().set_ortho(v.p1.x(), v.p2.x(), v.p1.y(), v.p2.y(), v.p1.z(), v.p2.z());
+			ASSERT_INFO_ALWAYS(out[i] == expected, "i = " << i)
+		}
+
+		r4::matrix4<float>::make_perspective(fovy.data(), aspect.data(), near_val.data(), far_val.data(), out.data(), size);
+		for(size_t i = 0; i != size; ++i){
+			auto expected = r4::matrix4<float>().set_perspective(fovy[i], aspect[i], near_val[i], far_val[i]);
+			ASSERT_INFO_ALWAYS(out[i] == expected, "i = " << i)
+		}
+
+		r4::matrix4<float>::make_look_at(eye.data(), center.data(), up.data(), out.data(), size);
+		for(size_t i = 0; i != size; ++i){
+			auto expected = r4::matrix4<float>().set_look_at(eye[i], center[i], up[i]);
+			auto diff = out[i] - expected;
+			diff.snap_to_zero(1e-5f);
+			ASSERT_INFO_ALWAYS(diff == r4::matrix4<float>().set(0), "i = " << i << "\nout = " << out[i] << "\nexpected = " << expected)
+		}
+
+		// eye coinciding with center gives the same matrix as set_look_at(), both inside of 4-wide block and in the tail
+		for(size_t i : {size_t(1), size - 1}){
+			center[i] = eye[i];
+		}
+		r4::matrix4<float>::make_look_at(eye.data(), center.data(), up.data(), out.data(), size);
+		for(size_t i = 0; i != size; ++i){
+			auto expected = r4::matrix4<float>().set_look_at(eye[i], center[i], up[i]);
+			auto diff = out[i] - expected;
+			diff.snap_to_zero(1e-5f);
+			ASSERT_INFO_ALWAYS(diff == r4::matrix4<float>().set(0), "i = " << i << "\nout = " << out[i] << "\nexpected = " << expected)
+		}
+	}
+
 	// test set(quaternion)
 	{
 		r4::matrix4<float> m{
@@ -796,6 +1102,162 @@ int main(int argc, char** argv){
 		ASSERT_INFO_ALWAYS(diff == decltype(m)().set(0), std::endl << "i = " << i.snap_to_zero(epsilon) << std::endl << "diff = " << diff)
 	}
 
+	// test det() against expansion by minors
+	{
+		r4::matrix4<int> m{
+			{2, -1, 0, 3},
+			{1, 4, -2, 5},
+			{0, 3, 7, -1},
+			{6, -2, 1, 1}
+		};
+
+		int d = m[0][0] * m.minor(0, 0) - m[0][1] * m.minor(0, 1) + m[0][2] * m.minor(0, 2) - m[0][3] * m.minor(0, 3);
+
+		ASSERT_INFO_ALWAYS(m.det() == d, "m.det() = " << m.det() << ", d = " << d)
+	}
+
+	// test inv() and invert() for float and double
+	{
+		r4::matrix4<double> md{
+			{2, -1, 0, 3},
+			{1, 4, -2, 5},
+			{0, 3, 7, -1},
+			{6, -2, 1, 1}
+		};
+		r4::matrix4<float> mf{
+			{2, -1, 0, 3},
+			{1, 4, -2, 5},
+			{0, 3, 7, -1},
+			{6, -2, 1, 1}
+		};
+
+		auto id = md.inv();
+		auto mi = mf;
+		mi.invert();
+
+		ASSERT_ALWAYS(mi == mf.inv())
+
+		for(unsigned r = 0; r != 4; ++r){
+			for(unsigned c = 0; c != 4; ++c){
+				using std::abs;
+				ASSERT_INFO_ALWAYS(abs(mi[r][c] - float(id[r][c])) < 1e-5f, "r = " << r << ", c = " << c << ", mi = " << mi << ", id = " << id)
+			}
+		}
+
+		auto i = md * id;
+		auto diff = decltype(md)().set_identity() - i;
+		diff.snap_to_zero(1e-12);
+		ASSERT_INFO_ALWAYS(diff == decltype(md)().set(0), "diff = " << diff)
+	}
+
+	// test inv(), invert() and affine_inv() of singular matrix
+	{
+		// the third row is the sum of the first two
+		r4::matrix4<double> md{
+			{1, 2, 3, 4},
+			{0, 1, 5, 2},
+			{1, 3, 8, 6},
+			{0, 0, 0, 1}
+		};
+		ASSERT_ALWAYS(md.det() == 0)
+		ASSERT_INFO_ALWAYS(md.inv() == r4::matrix4<double>().set(0), "md.inv() = " << md.inv())
+		ASSERT_INFO_ALWAYS(md.affine_inv() == r4::matrix4<double>().set(0), "md.affine_inv() = " << md.affine_inv())
+
+		auto mf = md.to<float>();
+		ASSERT_INFO_ALWAYS(mf.inv() == r4::matrix4<float>().set(0), "mf.inv() = " << mf.inv())
+		ASSERT_INFO_ALWAYS(mf.affine_inv() == r4::matrix4<float>().set(0), "mf.affine_inv() = " << mf.affine_inv())
+		mf.invert();
+		ASSERT_INFO_ALWAYS(mf == r4::matrix4<float>().set(0), "mf = " << mf)
+
+		r4::matrix4<int> mi = md.to<int>();
+		ASSERT_ALWAYS(mi.inv() == r4::matrix4<int>().set(0))
+
+		constexpr auto mc = r4::matrix4<float>().set(1).inv();
+		static_assert(mc[0][0] == 0 && mc[3][3] == 0);
+	}
+
+	// test affine_inv() and rigid_inv()
+	{
+		r4::matrix4<double> rigid;
+		rigid.set_identity();
+		rigid.translate(3, -4, 5);
+		rigid.rotate(r4::vector3<double>(0.3, -0.2, 0.7));
+
+		auto affine = rigid;
+		affine.scale(2, 0.5, 3);
+
+		const double epsilon = 1e-12;
+
+		auto diff = rigid.rigid_inv() - rigid.inv();
+		diff.snap_to_zero(epsilon);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "diff = " << diff)
+
+		diff = rigid.affine_inv() - rigid.inv();
+		diff.snap_to_zero(epsilon);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "diff = " << diff)
+
+		diff = affine.affine_inv() - affine.inv();
+		diff.snap_to_zero(epsilon);
+		ASSERT_INFO_ALWAYS(diff == decltype(diff)().set(0), "diff = " << diff)
+
+		auto fa = affine.to<float>();
+		auto fdiff = fa.affine_inv() - fa.inv();
+		fdiff.snap_to_zero(1e-5f);
+		ASSERT_INFO_ALWAYS(fdiff == decltype(fdiff)().set(0), "fdiff = " << fdiff)
+	}
+
+	// test compile time evaluation, float operations are specialized when SIMD is available
+	{
+		constexpr auto m = r4::matrix4<float>().set_identity().translate(1, 2, 3).scale(2, 4, 8);
+		static_assert(m[0][0] == 2 && m[1][1] == 4 && m[2][2] == 8 && m[3][3] == 1);
+		static_assert(m[0][3] == 1 && m[1][3] == 2 && m[2][3] == 3);
+
+		constexpr auto v = m * r4::vector4<float>(1, 1, 1, 1);
+		static_assert(v.x() == 3 && v.y() == 6 && v.z() == 11 && v.w() == 1);
+
+		constexpr auto p = m * r4::vector3<float>(1, 1, 1);
+		static_assert(p.x() == 3 && p.y() == 6 && p.z() == 11);
+
+		static_assert(m.det() == 64);
+
+		constexpr auto mi = m.inv();
+		constexpr auto id = m * mi;
+		static_assert(id[0][0] == 1 && id[1][1] == 1 && id[2][2] == 1 && id[3][3] == 1);
+		static_assert(id[0][3] == 0 && id[1][3] == 0 && id[2][3] == 0);
+
+		static_assert(m.affine_inv()[0][3] == mi[0][3] && m.affine_inv()[2][2] == mi[2][2]);
+
+		// compile time inverse of general matrix is calculated by the same algorithm as generic runtime one
+		constexpr r4::matrix4<float> g{
+			{2, -1, 0, 3},
+			{1, 4, -2, 5},
+			{0, 3, 7, -1},
+			{6, -2, 1, 1}
+		};
+		constexpr auto gi = g.inv();
+		auto gd = r4::matrix4<float>(g).to<double>().inv();
+		for(unsigned r = 0; r != 4; ++r){
+			for(unsigned c = 0; c != 4; ++c){
+				using std::abs;
+				ASSERT_INFO_ALWAYS(abs(gi[r][c] - float(gd[r][c])) < 1e-6f, "gi = " << gi << ", gd = " << gd)
+			}
+		}
+
+		constexpr auto f = r4::matrix4<float>().set_frustum(-2, 2, -1, 1, 1, 3);
+		static_assert(f[0][0] == 0.5f && f[1][1] == 1 && f[2][2] == -2 && f[2][3] == -3 && f[3][2] == -1);
+
+		constexpr auto q = r4::matrix4<float>(r4::quaternion<float>(0, 0, 1, 0));
+		static_assert(q[0][0] == -1 && q[1][1] == -1 && q[2][2] == 1 && q[3][3] == 1);
+
+		constexpr auto t = r4::matrix4<int>{
+				{1, 2, 3, 4},
+				{5, 6, 7, 8},
+				{9, 10, 11, 12},
+				{13, 14, 15, 16}
+			}.transpose();
+		static_assert(t[0][1] == 5 && t[1][0] == 2 && t[3][2] == 12 && t[2][3] == 15);
+	}
+
     // test operator<<
     {
         r4::matrix4<int> m;
@@ -0,0 +1,187 @@
+#include <type_traits>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/matrix_kinds.hpp"
+
+namespace{
+template <class T> bool is_near(const r4::matrix4<T>& a, const r4::matrix4<T>& b, T epsilon){
+	auto diff = a - b;
+	diff.snap_to_zero(epsilon);
+	return diff == r4::matrix4<T>().set(0);
+}
+
+template <class T> r4::matrix4<T> to_matrix4(const r4::matrix4<T>& m){
+	return m;
+}
+
+template <class K> auto to_matrix4(const K& k){
+	return k.to_matrix4();
+}
+
+// generic code which works with matrix4
+template <class T> r4::matrix4<T> pass_matrix4(const r4::matrix4<T>& m){
+	return m;
+}
+
+template <class T> class kinds{
+public:
+	r4::matrix4<T> m{
+		{1, 2, 3, 4},
+		{5, -6, 7, 8},
+		{9, 10, -11, 12},
+		{13, 14, 15, 16}
+	};
+	r4::affine3<T> a{
+		{1, -2, 3, 4},
+		{5, 6, 7, -8},
+		{-9, 10, 11, 12}
+	};
+	r4::translation3<T> t{1, -2, 3};
+	r4::scaling3<T> s{2, 3, -4};
+	r4::rotation3<T> r;
+	r4::orthographic_projection<T> o{-2, 3, -1, 4, 1, 10};
+	r4::perspective_projection<T> p{-2, 3, -1, 4, 1, 10};
+
+	kinds(){
+		this->r.q.set_rotation(r4::vector3<T>(1, 2, 3).normalize(), T(0.7));
+	}
+};
+
+template <class A, class B, class T> void check_product(const A& a, const B& b, T epsilon){
+	auto expected = to_matrix4(a) * to_matrix4(b);
+	auto actual = to_matrix4(a * b);
+	ASSERT_INFO_ALWAYS(is_near(actual, expected, epsilon), "actual = " << actual << "\nexpected = " << expected)
+}
+
+template <class T, class A> void check_products_with_all(const kinds<T>& k, const A& a, T epsilon){
+	check_product(a, k.m, epsilon);
+	check_product(k.m, a, epsilon);
+	check_product(a, k.a, epsilon);
+	check_product(k.a, a, epsilon);
+	check_product(a, k.t, epsilon);
+	check_product(k.t, a, epsilon);
+	check_product(a, k.s, epsilon);
+	check_product(k.s, a, epsilon);
+	check_product(a, k.r, epsilon);
+	check_product(k.r, a, epsilon);
+	check_product(a, k.o, epsilon);
+	check_product(k.o, a, epsilon);
+	check_product(a, k.p, epsilon);
+	check_product(k.p, a, epsilon);
+}
+
+template <class T> void check_all_products(T epsilon){
+	kinds<T> k;
+	check_products_with_all(k, k.a, epsilon);
+	check_products_with_all(k, k.t, epsilon);
+	check_products_with_all(k, k.s, epsilon);
+	check_products_with_all(k, k.r, epsilon);
+	check_products_with_all(k, k.o, epsilon);
+	check_products_with_all(k, k.p, epsilon);
+}
+}
+
+int main(int argc, char** argv){
+	// test result types of products
+	{
+		typedef r4::matrix4<float> m4;
+		typedef r4::affine3<float> a3;
+		typedef r4::translation3<float> t3;
+		typedef r4::scaling3<float> s3;
+		typedef r4::rotation3<float> r3;
+		typedef r4::orthographic_projection<float> op;
+		typedef r4::perspective_projection<float> pp;
+
+		static_assert(std::is_same<decltype(t3() * t3()), t3>::value, "");
+		static_assert(std::is_same<decltype(s3() * s3()), s3>::value, "");
+		static_assert(std::is_same<decltype(r3() * r3()), r3>::value, "");
+		static_assert(std::is_same<decltype(op() * op()), op>::value, "");
+		static_assert(std::is_same<decltype(a3() * a3()), a3>::value, "");
+		static_assert(std::is_same<decltype(t3() * s3()), a3>::value, "");
+		static_assert(std::is_same<decltype(r3() * t3()), a3>::value, "");
+		static_assert(std::is_same<decltype(op() * r3()), a3>::value, "");
+		static_assert(std::is_same<decltype(a3() * t3()), a3>::value, "");
+		static_assert(std::is_same<decltype(s3() * a3()), a3>::value, "");
+		static_assert(std::is_same<decltype(pp() * t3()), m4>::value, "");
+		static_assert(std::is_same<decltype(a3() * pp()), m4>::value, "");
+		static_assert(std::is_same<decltype(pp() * pp()), m4>::value, "");
+		static_assert(std::is_same<decltype(m4() * t3()), m4>::value, "");
+		static_assert(std::is_same<decltype(pp() * m4()), m4>::value, "");
+		static_assert(std::is_same<decltype(m4() * a3()), m4>::value, "");
+	}
+
+	// test conversion to matrix4
+	{
+		r4::matrix4<double> m = r4::translation3<double>(1, 2, 3);
+		ASSERT_ALWAYS(m == r4::matrix4<double>().set_identity().translate(1, 2, 3))
+
+		m = r4::scaling3<double>(1, 2, 3);
+		ASSERT_ALWAYS(m == r4::matrix4<double>().set_identity().scale(1, 2, 3))
+
+		m = r4::perspective_projection<double>(-2, 3, -1, 4, 1, 10);
+		ASSERT_ALWAYS(m == r4::matrix4<double>().set_frustum(-2, 3, -1, 4, 1, 10))
+
+		r4::quaternion<double> q;
+		q.set_rotation(1, 2, 3, 0.5);
+		m = r4::rotation3<double>(q);
+		ASSERT_ALWAYS(m == r4::matrix4<double>(q))
+
+		// products of affine kinds are affine3, which is also convertible to matrix4
+		auto expected = r4::matrix4<double>().set_identity().translate(1, 2, 3).scale(2, 3, 4);
+		r4::matrix4<double> ts = r4::translation3<double>(1, 2, 3) * r4::scaling3<double>(2, 3, 4);
+		ASSERT_ALWAYS(ts == expected)
+		ASSERT_ALWAYS(pass_matrix4<double>(r4::translation3<double>(1, 2, 3) * r4::scaling3<double>(2, 3, 4)) == expected)
+		m = r4::translation3<double>(1, 2, 3) * r4::scaling3<double>(2, 3, 4);
+		ASSERT_ALWAYS(m == expected)
+
+		r4::matrix4<float> mf = r4::translation3<float>(1, 2, 3) * r4::scaling3<float>(2, 3, 4);
+		ASSERT_ALWAYS(mf == expected.to<float>())
+	}
+
+	// test constexpr products
+	{
+		constexpr auto a = r4::translation3<int>(1, 2, 3) * r4::scaling3<int>(2, 3, 4);
+		static_assert(a[0][0] == 2 && a[0][1] == 0 && a[0][3] == 1, "");
+		static_assert(a[1][1] == 3 && a[1][2] == 0 && a[1][3] == 2, "");
+		static_assert(a[2][0] == 0 && a[2][2] == 4 && a[2][3] == 3, "");
+
+		constexpr auto t = r4::translation3<int>(1, 2, 3) * r4::translation3<int>(4, 5, 6);
+		static_assert(t.t[0] == 5 && t.t[1] == 7 && t.t[2] == 9, "");
+	}
+
+	// test transformation of points
+	{
+		kinds<double> k;
+		r4::vector3<double> v(1, -2, 3);
+
+		ASSERT_ALWAYS((k.t * v - k.t.to_matrix4() * v).norm() < 1e-12)
+		ASSERT_ALWAYS((k.s * v - k.s.to_matrix4() * v).norm() < 1e-12)
+		ASSERT_ALWAYS((k.r * v - k.r.to_matrix4() * v).norm() < 1e-12)
+		ASSERT_ALWAYS((k.o * v - k.o.to_matrix4() * v).norm() < 1e-12)
+
+		r4::vector4<double> h(1, -2, 3, 1);
+		ASSERT_ALWAYS((k.p * h - k.p.to_matrix4() * h).norm() < 1e-12)
+	}
+
+	// test products of all kinds against full matrix product
+	{
+		check_all_products<double>(1e-9);
+		check_all_products<float>(1e-3f);
+	}
+
+	// test matrix4::rotate() and matrix4::frustum() against full matrix product
+	{
+		kinds<float> k;
+
+		auto m = k.m;
+		m.rotate(k.r.q);
+		ASSERT_ALWAYS(is_near(m, k.m * r4::matrix4<float>(k.r.q), 1e-4f))
+
+		m = k.m;
+		m.frustum(-2, 3, -1, 4, 1, 10);
+		ASSERT_ALWAYS(is_near(m, k.m * r4::matrix4<float>().set_frustum(-2, 3, -1, 4, 1, 10), 1e-4f))
+	}
+
+	return 0;
+}
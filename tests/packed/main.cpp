@@ -0,0 +1,210 @@
+#include <cmath>
+#include <vector>
+#include <random>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/packed.hpp"
+
+namespace{
+template <class T> r4::vector3<T> random_unit_vector3(std::mt19937& gen){
+	std::normal_distribution<T> dist;
+	for(;;){
+		r4::vector3<T> v(dist(gen), dist(gen), dist(gen));
+		if(v.norm() > T(1e-3)){
+			return v.normalize();
+		}
+	}
+}
+
+template <class T> r4::quaternion<T> random_unit_quaternion(std::mt19937& gen){
+	std::normal_distribution<T> dist;
+	for(;;){
+		r4::quaternion<T> q(dist(gen), dist(gen), dist(gen), dist(gen));
+		if(q.norm() > T(1e-3)){
+			return q.normalize();
+		}
+	}
+}
+
+// acos() of dot product is imprecise for small angles, use chord length instead
+template <class T> T angle_between(const r4::vector3<T>& a, const r4::vector3<T>& b){
+	return T(2) * std::asin((a - b).norm() / T(2));
+}
+
+template <class T> void test_packed_unit_vector3(){
+	std::mt19937 gen(1);
+
+	// axes and diagonals
+	{
+		std::vector<r4::vector3<T>> vecs = {
+			{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+			{1, 1, 1}, {-1, -1, -1}, {1, -1, -1}, {-1, 1, -1}, {0, 1, -1}, {-1, 0, -1}
+		};
+		for(auto& v : vecs){
+			auto n = v.normalize();
+			auto u = r4::packed_unit_vector3(n).template to<T>();
+			ASSERT_INFO_ALWAYS((u - n).norm() < T(1e-4), "n = " << n << ", u = " << u)
+		}
+	}
+
+	// random vectors, error bound
+	{
+		T max_angle = 0;
+		for(unsigned i = 0; i != 100000; ++i){
+			auto v = random_unit_vector3<T>(gen);
+			auto p = r4::packed_unit_vector3(v);
+			auto u = p.template to<T>();
+			ASSERT_INFO_ALWAYS(std::abs(u.norm() - T(1)) < T(1e-5), "u = " << u)
+			max_angle = std::max(max_angle, angle_between(u, v));
+
+			// repacking of the unpacked vector does not accumulate error,
+			// though the bits may differ on the fold edges of the octahedron where the sign of zero is lost
+			auto r = r4::packed_unit_vector3(u).template to<T>();
+			ASSERT_INFO_ALWAYS((r - u).norm() < T(1e-4), "v = " << v)
+		}
+		ASSERT_INFO_ALWAYS(max_angle < T(1e-4), "max_angle = " << max_angle)
+	}
+
+	// batch packing agrees with one by one packing, including tails
+	for(size_t size : {0, 1, 3, 4, 5, 8, 127}){
+		std::vector<r4::vector3<T>> src;
+		for(size_t i = 0; i != size; ++i){
+			src.push_back(random_unit_vector3<T>(gen));
+		}
+
+		std::vector<r4::packed_unit_vector3> packed(size);
+		r4::packed_unit_vector3::pack(src.data(), packed.data(), size);
+
+		std::vector<r4::vector3<T>> unpacked(size);
+		r4::packed_unit_vector3::unpack(packed.data(), unpacked.data(), size);
+
+		for(size_t i = 0; i != size; ++i){
+			auto p = r4::packed_unit_vector3(src[i]);
+			// batch packing must give the same bits as packing one by one
+			ASSERT_INFO_ALWAYS(p == packed[i], "i = " << i << ", size = " << size << ", " << std::hex << p.bits() << " != " << packed[i].bits())
+
+			auto u = packed[i].template to<T>();
+			ASSERT_INFO_ALWAYS((unpacked[i] - u).norm() < T(1e-6), "i = " << i << ", size = " << size)
+			ASSERT_INFO_ALWAYS(angle_between(unpacked[i], src[i]) < T(1e-4), "i = " << i << ", size = " << size)
+		}
+	}
+
+	// batch packing gives the same bits as one by one packing also for vectors with zero components,
+	// negative zeros and components giving halfway cases of rounding
+	{
+		std::vector<r4::vector3<T>> src;
+		for(int x = -3; x <= 3; ++x){
+			for(int y = -3; y <= 3; ++y){
+				for(int z = -3; z <= 3; ++z){
+					if(x == 0 && y == 0 && z == 0){
+						continue;
+					}
+					src.emplace_back(T(x), T(y), T(z));
+				}
+			}
+		}
+		src.emplace_back(T(-0.0), T(-0.0), T(-1));
+		src.emplace_back(T(-0.0), T(1), T(-0.0));
+		src.emplace_back(T(0.5), T(-0.0), T(-0.5));
+		for(int k = 0; k != 1000; ++k){
+			// octahedral coordinates scaled to the packed range are close to halfway cases
+			T x = (T(k) + T(0.5)) / T(32767);
+			src.emplace_back(x, 1 - x, T(0));
+			src.emplace_back(-x, T(0), x - 1);
+		}
+
+		std::vector<r4::packed_unit_vector3> packed(src.size());
+		r4::packed_unit_vector3::pack(src.data(), packed.data(), src.size());
+		for(size_t i = 0; i != src.size(); ++i){
+			auto p = r4::packed_unit_vector3(src[i]);
+			ASSERT_INFO_ALWAYS(p == packed[i], "v = " << src[i] << ", " << std::hex << p.bits() << " != " << packed[i].bits())
+		}
+	}
+}
+
+template <class T> void test_packed_quaternion(){
+	std::mt19937 gen(2);
+
+	// identity and axis rotations
+	{
+		std::vector<r4::quaternion<T>> quats = {
+			{0, 0, 0, 1}, {1, 0, 0, 0}, {0, -1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, -1}
+		};
+		for(auto& q : quats){
+			auto u = r4::packed_quaternion(q).template to<T>();
+			ASSERT_INFO_ALWAYS(std::abs(std::abs(u * q) - T(1)) < T(1e-6), "q = " << q << ", u = " << u)
+		}
+	}
+
+	// random quaternions, error bound
+	{
+		T max_error = 0;
+		for(unsigned i = 0; i != 100000; ++i){
+			auto q = random_unit_quaternion<T>(gen);
+			auto p = r4::packed_quaternion(q);
+			auto u = p.template to<T>();
+			ASSERT_INFO_ALWAYS(std::abs(u.norm() - T(1)) < T(1e-5), "u = " << u)
+
+			// q and -q are the same rotation
+			if(u * q < 0){
+				u.negate();
+			}
+			for(unsigned j = 0; j != 4; ++j){
+				max_error = std::max(max_error, std::abs(u[j] - q[j]));
+			}
+		}
+		ASSERT_INFO_ALWAYS(max_error < T(3e-6), "max_error = " << max_error)
+	}
+
+	// batch packing
+	{
+		const size_t size = 33;
+		std::vector<r4::quaternion<T>> src;
+		for(size_t i = 0; i != size; ++i){
+			src.push_back(random_unit_quaternion<T>(gen));
+		}
+
+		std::vector<r4::packed_quaternion> packed(size);
+		r4::packed_quaternion::pack(src.data(), packed.data(), size);
+
+		std::vector<r4::quaternion<T>> unpacked(size);
+		r4::packed_quaternion::unpack(packed.data(), unpacked.data(), size);
+
+		for(size_t i = 0; i != size; ++i){
+			ASSERT_ALWAYS(packed[i] == r4::packed_quaternion(src[i]))
+			auto u = packed[i].template to<T>();
+			ASSERT_ALWAYS(unpacked[i] == u)
+		}
+	}
+}
+}
+
+int main(int argc, char** argv){
+	// test binary representation
+	{
+		auto p = r4::packed_unit_vector3(r4::vector3<float>(0, 0, 1));
+		ASSERT_INFO_ALWAYS(p.bits() == 0, "p.bits() = " << p.bits())
+
+		p = r4::packed_unit_vector3(r4::vector3<float>(1, 0, 0));
+		ASSERT_INFO_ALWAYS(p.bits() == 0x7fff, "p.bits() = " << p.bits())
+
+		p = r4::packed_unit_vector3(r4::vector3<float>(0, -1, 0));
+		ASSERT_INFO_ALWAYS(p.bits() == 0x80010000, "p.bits() = " << p.bits())
+
+		ASSERT_ALWAYS(r4::packed_unit_vector3::from_bits(0x12345678).bits() == 0x12345678)
+
+		auto q = r4::packed_quaternion(r4::quaternion<float>(0, 0, 0, -1));
+		// index of the largest component is 3, the rest of the components are 0 mapped to the middle of the range
+		ASSERT_INFO_ALWAYS(q.bits() == ((uint64_t(3) << 62) | (uint64_t(0x7ffff) << 40) | (uint64_t(0x7ffff) << 20) | 0x7ffff), "q.bits() = " << q.bits())
+		ASSERT_ALWAYS(r4::packed_quaternion::from_bits(q.bits()) == q)
+	}
+
+	test_packed_unit_vector3<float>();
+	test_packed_unit_vector3<double>();
+
+	test_packed_quaternion<float>();
+	test_packed_quaternion<double>();
+
+	return 0;
+}
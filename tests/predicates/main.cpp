@@ -0,0 +1,268 @@
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <cmath>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/predicates.hpp"
+
+namespace{
+// The exact reference values are computed with multi-word integers,
+// the test points have coordinates which are multiples of a power of two,
+// so that the scaled coordinates are exact 64-bit integers and the determinants fit into 256 bits.
+
+// minimal 256-bit two's complement integer
+class int256{
+	std::array<uint32_t, 8> w;
+public:
+	int256(int64_t v = 0){
+		uint64_t u = uint64_t(v);
+		w[0] = uint32_t(u);
+		w[1] = uint32_t(u >> 32);
+		std::fill(w.begin() + 2, w.end(), v < 0 ? ~uint32_t(0) : 0);
+	}
+
+	int256 operator+(const int256& v)const{
+		int256 ret;
+		uint64_t carry = 0;
+		for(size_t i = 0; i != w.size(); ++i){
+			carry += uint64_t(this->w[i]) + v.w[i];
+			ret.w[i] = uint32_t(carry);
+			carry >>= 32;
+		}
+		return ret;
+	}
+
+	int256 operator-()const{
+		int256 ret;
+		for(size_t i = 0; i != w.size(); ++i){
+			ret.w[i] = ~this->w[i];
+		}
+		return ret + int256(1);
+	}
+
+	int256 operator-(const int256& v)const{
+		return *this + -v;
+	}
+
+	int256 operator*(const int256& v)const{
+		int256 ret;
+		for(size_t i = 0; i != w.size(); ++i){
+			uint64_t carry = 0;
+			for(size_t j = 0; i + j != w.size(); ++j){
+				carry += uint64_t(this->w[i]) * v.w[j] + ret.w[i + j];
+				ret.w[i + j] = uint32_t(carry);
+				carry >>= 32;
+			}
+		}
+		return ret;
+	}
+
+	friend int sign(const int256& v){
+		if(v.w.back() >> 31){
+			return -1;
+		}
+		return std::any_of(v.w.begin(), v.w.end(), [](uint32_t e){return e != 0;}) ? 1 : 0;
+	}
+};
+
+int sign(double v){
+	return v > 0 ? 1 : (v < 0 ? -1 : 0);
+}
+
+int256 to_int(double v, double scale = 1){
+	double s = v * scale;
+	ASSERT_ALWAYS(s == std::floor(s))
+	ASSERT_ALWAYS(std::abs(s) < std::ldexp(1.0, 63))
+	return int256(int64_t(s));
+}
+
+int orient2d_reference(const r4::vector2<double>& a, const r4::vector2<double>& b, const r4::vector2<double>& c, double scale){
+	int256 acx = to_int(a.x(), scale) - to_int(c.x(), scale);
+	int256 bcx = to_int(b.x(), scale) - to_int(c.x(), scale);
+	int256 acy = to_int(a.y(), scale) - to_int(c.y(), scale);
+	int256 bcy = to_int(b.y(), scale) - to_int(c.y(), scale);
+	return sign(acx * bcy - acy * bcx);
+}
+
+int orient3d_reference(const r4::vector3<double>& a, const r4::vector3<double>& b, const r4::vector3<double>& c, const r4::vector3<double>& d){
+	int256 adx = to_int(a.x()) - to_int(d.x()), bdx = to_int(b.x()) - to_int(d.x()), cdx = to_int(c.x()) - to_int(d.x());
+	int256 ady = to_int(a.y()) - to_int(d.y()), bdy = to_int(b.y()) - to_int(d.y()), cdy = to_int(c.y()) - to_int(d.y());
+	int256 adz = to_int(a.z()) - to_int(d.z()), bdz = to_int(b.z()) - to_int(d.z()), cdz = to_int(c.z()) - to_int(d.z());
+	return sign(adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) + cdz * (adx * bdy - bdx * ady));
+}
+
+int incircle_reference(const r4::vector2<double>& a, const r4::vector2<double>& b, const r4::vector2<double>& c, const r4::vector2<double>& d){
+	int256 adx = to_int(a.x()) - to_int(d.x()), bdx = to_int(b.x()) - to_int(d.x()), cdx = to_int(c.x()) - to_int(d.x());
+	int256 ady = to_int(a.y()) - to_int(d.y()), bdy = to_int(b.y()) - to_int(d.y()), cdy = to_int(c.y()) - to_int(d.y());
+	int256 alift = adx * adx + ady * ady;
+	int256 blift = bdx * bdx + bdy * bdy;
+	int256 clift = cdx * cdx + cdy * cdy;
+	return sign(alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady));
+}
+
+// naive evaluation, used to check that the tests do contain cases where plain arithmetic fails
+double incircle_naive(const r4::vector2<double>& a, const r4::vector2<double>& b, const r4::vector2<double>& c, const r4::vector2<double>& d){
+	double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+	double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+	double alift = adx * adx + ady * ady;
+	double blift = bdx * bdx + bdy * bdy;
+	double clift = cdx * cdx + cdy * cdy;
+	return alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady);
+}
+
+double orient2d_naive(const r4::vector2<double>& a, const r4::vector2<double>& b, const r4::vector2<double>& c){
+	return (a.x() - c.x()) * (b.y() - c.y()) - (a.y() - c.y()) * (b.x() - c.x());
+}
+}
+
+int main(int argc, char** argv){
+	namespace p = r4::predicates;
+
+	// test expansion arithmetic
+	{
+		double x, y;
+		p::two_product(134217729.0, 134217729.0, x, y); // (2^27 + 1)^2 = 2^54 + 2^28 + 1
+		ASSERT_ALWAYS(x == 18014398777917440.0)
+		ASSERT_ALWAYS(y == 1)
+
+		p::two_sum(1e16, 1.0, x, y);
+		ASSERT_ALWAYS(x + y == 1e16 + 1.0 || (x == 1e16 && y == 1))
+
+		auto e = p::sum(p::difference(1e20, 1), p::difference(-1e20, 1));
+		ASSERT_ALWAYS(e.approximation() == -2)
+
+		auto q = p::product(p::difference(1e20, 1), p::difference(1e20, -1)); // 1e40 - 1
+		auto r = p::sum(q, p::negate(p::product(p::difference(1e20, 0), p::difference(1e20, 0))));
+		ASSERT_ALWAYS(r.approximation() == -1)
+	}
+
+	// test simple cases
+	{
+		r4::vector2<double> a(0, 0), b(1, 0), c(0, 1);
+		ASSERT_ALWAYS(p::orient2d(a, b, c) == 1)
+		ASSERT_ALWAYS(p::orient2d(a, c, b) == -1)
+		ASSERT_ALWAYS(p::orient2d(a, b, r4::vector2<double>(2, 0)) == 0)
+
+		ASSERT_ALWAYS(p::incircle(a, b, c, r4::vector2<double>(0.5, 0.5)) > 0)
+		ASSERT_ALWAYS(p::incircle(a, b, c, r4::vector2<double>(2, 2)) < 0)
+		ASSERT_ALWAYS(p::incircle(a, b, c, r4::vector2<double>(1, 1)) == 0)
+		ASSERT_ALWAYS(p::incircle(a, c, b, r4::vector2<double>(0.5, 0.5)) < 0)
+
+		r4::vector3<double> a3(0, 0, 0), b3(1, 0, 0), c3(0, 1, 0);
+		ASSERT_ALWAYS(p::orient3d(a3, b3, c3, r4::vector3<double>(0, 0, -1)) > 0)
+		ASSERT_ALWAYS(p::orient3d(a3, b3, c3, r4::vector3<double>(0, 0, 1)) < 0)
+		ASSERT_ALWAYS(p::orient3d(a3, b3, c3, r4::vector3<double>(5, 7, 0)) == 0)
+	}
+
+	// test orient2d on nearly collinear points, the classic example where plain evaluation gives wrong results
+	{
+		const double ulp = std::ldexp(1.0, -53);
+		r4::vector2<double> b(12, 12), c(24, 24);
+		size_t num_naive_wrong = 0;
+		std::vector<r4::vector2<double>> points;
+		for(int i = 0; i != 64; ++i){
+			for(int j = 0; j != 64; ++j){
+				points.emplace_back(0.5 + i * ulp, 0.5 + j * ulp);
+			}
+		}
+		std::vector<double> batch(points.size());
+		p::orient2d(b, c, points.data(), points.size(), batch.data());
+		for(size_t i = 0; i != points.size(); ++i){
+			const auto& a = points[i];
+			int expected = orient2d_reference(a, b, c, std::ldexp(1.0, 53));
+			ASSERT_INFO_ALWAYS(sign(p::orient2d(a, b, c)) == expected, "a = " << a)
+			ASSERT_ALWAYS(sign(batch[i]) == orient2d_reference(b, c, a, std::ldexp(1.0, 53)))
+			if(sign(orient2d_naive(a, b, c)) != expected){
+				++num_naive_wrong;
+			}
+		}
+		ASSERT_ALWAYS(num_naive_wrong != 0)
+	}
+
+	// test orient3d on nearly coplanar points with large integer coordinates
+	{
+		std::mt19937 gen(1);
+		std::uniform_int_distribution<int> coord(-(1 << 20), 1 << 20);
+		std::uniform_int_distribution<int> small(-3, 3);
+		for(unsigned iter = 0; iter != 200; ++iter){
+			// points on the plane through a spanned by u and v, the last point is displaced by a tiny amount
+			r4::vector3<double> a(coord(gen), coord(gen), coord(gen));
+			r4::vector3<double> u(coord(gen) / 16, coord(gen) / 16, coord(gen) / 16);
+			r4::vector3<double> v(coord(gen) / 16, coord(gen) / 16, coord(gen) / 16);
+			auto b = a + u * 7;
+			auto c = a + v * 11;
+			std::vector<r4::vector3<double>> points;
+			for(int k = 0; k != 8; ++k){
+				auto d = a + u * double(small(gen)) + v * double(small(gen));
+				d += r4::vector3<double>(small(gen) / 3, small(gen) / 3, small(gen) / 3);
+				points.push_back(d);
+			}
+			std::vector<double> batch(points.size());
+			p::orient3d(a, b, c, points.data(), points.size(), batch.data());
+			for(size_t k = 0; k != points.size(); ++k){
+				int expected = orient3d_reference(a, b, c, points[k]);
+				ASSERT_ALWAYS(sign(p::orient3d(a, b, c, points[k])) == expected)
+				ASSERT_ALWAYS(sign(batch[k]) == expected)
+			}
+		}
+	}
+
+	// test incircle on cocircular and nearly cocircular points with large integer coordinates
+	{
+		// integer points on circle of radius 5 * 13 * 17 * 29 * 37 around big center
+		const int64_t radius = 5 * 13 * 17 * 29 * 37;
+		const double cx = 3 << 20, cy = -(5 << 19);
+		std::vector<r4::vector2<double>> circle;
+		for(int64_t x = 0; x <= radius; x += 1){
+			int64_t y2 = radius * radius - x * x;
+			auto y = int64_t(std::sqrt(double(y2)));
+			for(; y * y < y2; ++y){}
+			for(; y * y > y2; --y){}
+			if(y * y == y2){
+				circle.emplace_back(cx + double(x), cy + double(y));
+				circle.emplace_back(cx - double(y), cy + double(x));
+				circle.emplace_back(cx - double(x), cy - double(y));
+				circle.emplace_back(cx + double(y), cy - double(x));
+			}
+		}
+		ASSERT_ALWAYS(circle.size() > 16)
+
+		std::mt19937 gen(2);
+		std::uniform_int_distribution<size_t> index(0, circle.size() - 1);
+		std::uniform_int_distribution<int> small(-1, 1);
+		size_t num_naive_wrong = 0;
+		size_t num_zero = 0;
+		for(unsigned iter = 0; iter != 300; ++iter){
+			auto a = circle[index(gen)], b = circle[index(gen)], c = circle[index(gen)];
+			if(p::orient2d(a, b, c) == 0){
+				continue;
+			}
+			std::vector<r4::vector2<double>> points;
+			for(int k = 0; k != 8; ++k){
+				points.push_back(circle[index(gen)] + r4::vector2<double>(small(gen), small(gen)));
+			}
+			std::vector<double> batch(points.size());
+			p::incircle(a, b, c, points.data(), points.size(), batch.data());
+			for(size_t k = 0; k != points.size(); ++k){
+				const auto& d = points[k];
+				int expected = incircle_reference(a, b, c, d);
+				ASSERT_INFO_ALWAYS(sign(p::incircle(a, b, c, d)) == expected, "a = " << a << ", b = " << b << ", c = " << c << ", d = " << d)
+				ASSERT_ALWAYS(sign(batch[k]) == expected)
+				if(sign(incircle_naive(a, b, c, d)) != expected){
+					++num_naive_wrong;
+				}
+				if(expected == 0){
+					++num_zero;
+				}
+			}
+		}
+		ASSERT_ALWAYS(num_naive_wrong != 0)
+		ASSERT_ALWAYS(num_zero != 0)
+	}
+
+	return 0;
+}
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <utki/debug.hpp>
 
 #include "../../src/r4/quaternion.hpp"
@@ -278,10 +280,110 @@ int main(int argc, char** argv){
 		// TODO:
 	}
 
+	// test rotate_points()
+	{
+		r4::quaternion<float> q{r4::vector3<float>{1, 2, 3}};
+		r4::quaternion<double> qd{r4::vector3<double>{1, 2, 3}};
+
+		// 7 points to exercise both the blocks of 4 and the remainder
+		std::vector<r4::vector3<float>> src;
+		for(int i = 0; i != 7; ++i){
+			src.emplace_back(float(i - 3), float(2 * i + 1), float(5 - i * i));
+		}
+
+		std::vector<r4::vector3<float>> dst(src.size());
+		q.rotate_points(src.data(), dst.data(), src.size());
+
+		auto in_place = src;
+		q.rotate_points(in_place.data(), in_place.size());
+
+		for(size_t i = 0; i != src.size(); ++i){
+			// compare to rotation by matrix
+			auto expected = qd.to_matrix4() * src[i].to<double>();
+			auto diff = dst[i].to<double>() - expected;
+			ASSERT_INFO_ALWAYS(diff.norm() < 1e-4, "i = " << i << ", dst[i] = " << dst[i] << ", expected = " << expected)
+			ASSERT_ALWAYS(in_place[i] == dst[i])
+
+			auto v = src[i];
+			v.rotate(q);
+			ASSERT_INFO_ALWAYS((v - dst[i]).norm() < 1e-4f, "i = " << i << ", v = " << v << ", dst[i] = " << dst[i])
+		}
+	}
+
+	// test slerp(from, to, t, dst, size) and nlerp(from, to, t, dst, size)
+	{
+		// 11 pairs to exercise both the blocks of 4 and the remainder,
+		// some pairs are more than 90 degrees apart to test the shortest path
+		std::vector<r4::quaternion<float>> from;
+		std::vector<r4::quaternion<float>> to;
+		std::vector<float> t;
+		for(int i = 0; i != 11; ++i){
+			from.push_back(r4::quaternion<float>(r4::vector3<float>(0.1f * i, 1, -0.3f * i)));
+			to.push_back(r4::quaternion<float>(r4::vector3<float>(2 - 0.5f * i, 0.2f * i, 1)));
+			t.push_back(float(i) / 10);
+		}
+
+		std::vector<r4::quaternion<float>> s(from.size());
+		r4::quaternion<float>::slerp(from.data(), to.data(), t.data(), s.data(), s.size());
+
+		std::vector<r4::quaternion<double>> from_d;
+		std::vector<r4::quaternion<double>> to_d;
+		std::vector<double> t_d;
+		for(size_t i = 0; i != from.size(); ++i){
+			from_d.push_back(from[i].to<double>());
+			to_d.push_back(to[i].to<double>());
+			t_d.push_back(t[i]);
+		}
+		std::vector<r4::quaternion<double>> sd(from.size());
+		r4::quaternion<double>::slerp(from_d.data(), to_d.data(), t_d.data(), sd.data(), sd.size());
+
+		std::vector<r4::quaternion<float>> n(from);
+		r4::quaternion<float>::nlerp(n.data(), to.data(), t.data(), n.data(), n.size());
+
+		// quaternion has no subtraction
+		auto distance = [](const r4::quaternion<double>& a, const r4::quaternion<double>& b){
+			return (a + b * -1.0).norm();
+		};
+
+		for(size_t i = 0; i != from.size(); ++i){
+			auto fd = from[i].to<double>();
+			auto td = to[i].to<double>();
+
+			auto expected = fd.slerp(td, double(t[i]));
+			ASSERT_INFO_ALWAYS(distance(s[i].to<double>(), expected) < 2e-6, "i = " << i << ", s[i] = " << s[i] << ", expected = " << expected)
+
+			ASSERT_INFO_ALWAYS(distance(sd[i], expected) < 2e-6, "i = " << i << ", sd[i] = " << sd[i] << ", expected = " << expected)
+
+			auto expected_n = fd.nlerp(td, double(t[i]));
+			ASSERT_INFO_ALWAYS(distance(n[i].to<double>(), expected_n) < 1e-6, "i = " << i << ", n[i] = " << n[i] << ", expected_n = " << expected_n)
+		}
+	}
+
 	// test slerp(quaternion, t)
 	{
 		// TODO:
 	}
 
+	// test compile time evaluation
+	{
+		constexpr r4::quaternion<float> a{1, 2, 3, 4};
+		constexpr r4::quaternion<float> b{5, 6, 7, 8};
+
+		constexpr auto p = a % b;
+		static_assert(p.x() == 24 && p.y() == 48 && p.z() == 48 && p.w() == -6);
+
+		constexpr auto s = a + b;
+		static_assert(s.x() == 6 && s.y() == 8 && s.z() == 10 && s.w() == 12);
+
+		static_assert(a * b == 70);
+		static_assert(a.norm_pow2() == 30);
+
+		// rotation by pi around z axis
+		constexpr r4::quaternion<float> q{0, 0, 1, 0};
+		constexpr auto m = q.to_matrix4();
+		static_assert(m[0][0] == -1 && m[1][1] == -1 && m[2][2] == 1 && m[3][3] == 1);
+		static_assert(m[0][1] == 0 && m[1][0] == 0 && m[0][3] == 0 && m[3][0] == 0);
+	}
+
 	return 0;
 }
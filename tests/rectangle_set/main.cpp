@@ -0,0 +1,155 @@
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/rectangle_set.hpp"
+
+namespace{
+// generate array of rectangles, some of them lie outside of the clipping rectangle used in the tests
+template <class T> std::vector<r4::rectangle<T>> make_rectangles(size_t size, int seed){
+	std::vector<r4::rectangle<T>> ret;
+	for(size_t i = 0; i != size; ++i){
+		int k = int(i) + seed;
+		ret.emplace_back(T(k % 13 * 3 - 10), T(k % 7 * 5 - 8), T(k % 5 * 4), T(k % 3 * 6 + 1));
+	}
+	return ret;
+}
+
+template <class T> void test_rectangle_set(){
+	const r4::rectangle<T> clip(T(-2), T(0), T(20), T(15));
+
+	// sizes are deliberately not multiples of SIMD register size
+	for(size_t size : {0, 1, 3, 4, 5, 7, 8, 9, 13, 16, 31, 32, 33, 70}){
+		auto v = make_rectangles<T>(size, 1);
+
+		// test gather() and scatter()
+		{
+			r4::rectangle_set<T> s(v.data(), v.size());
+			ASSERT_ALWAYS(s.size() == size)
+			for(unsigned l = 0; l != 4; ++l){
+				ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(s.lane(l)) % s.alignment == 0)
+			}
+			for(size_t i = 0; i != size; ++i){
+				ASSERT_ALWAYS(s[i] == v[i])
+			}
+
+			std::vector<r4::rectangle<T>> out(size);
+			s.scatter(out.data());
+			ASSERT_ALWAYS(out == v)
+		}
+
+		// test intersect()
+		{
+			r4::rectangle_set<T> s(v.data(), v.size());
+			s.intersect(clip);
+			for(size_t i = 0; i != size; ++i){
+				auto r = v[i];
+				r.intersect(clip);
+				ASSERT_INFO_ALWAYS(s[i] == r, "size = " << size << ", i = " << i << ", s[i] = " << s[i] << ", r = " << r)
+			}
+		}
+
+		// test unite()
+		{
+			r4::rectangle_set<T> s(v.data(), v.size());
+			r4::rectangle<T> expected(0, 0, 0, 0);
+			if(size != 0){
+				expected = v[0];
+				for(auto& r : v){
+					expected.unite(r);
+				}
+			}
+			ASSERT_INFO_ALWAYS(s.unite() == expected, "size = " << size << ", s.unite() = " << s.unite() << ", expected = " << expected)
+		}
+
+		// test overlaps()
+		{
+			r4::rectangle_set<T> s(v.data(), v.size());
+			for(auto p : {r4::vector2<T>(0, 0), r4::vector2<T>(5, 3), r4::vector2<T>(-10, -8), r4::vector2<T>(100, 100)}){
+				std::vector<uint32_t> hits((size + 31) / 32 + 1, 0xffffffff);
+				s.overlaps(p, hits.data());
+				for(size_t i = 0; i != size; ++i){
+					bool hit = (hits[i / 32] & (uint32_t(1) << (i % 32))) != 0;
+					ASSERT_INFO_ALWAYS(hit == v[i].overlaps(p), "size = " << size << ", i = " << i)
+				}
+				if(size % 32 != 0){
+					ASSERT_ALWAYS((hits[size / 32] >> (size % 32)) == 0)
+				}
+				// the word after the bit mask is not touched
+				ASSERT_ALWAYS(hits.back() == 0xffffffff)
+			}
+		}
+
+		// test compact()
+		{
+			r4::rectangle_set<T> s(v.data(), v.size());
+			s.intersect(clip);
+
+			std::vector<r4::rectangle<T>> expected;
+			std::vector<uint32_t> expected_indices;
+			for(size_t i = 0; i != size; ++i){
+				auto r = v[i];
+				r.intersect(clip);
+				if(r.d.x() > 0 && r.d.y() > 0){
+					expected.push_back(r);
+					expected_indices.push_back(uint32_t(i));
+				}
+			}
+
+			std::vector<uint32_t> indices(size);
+			auto n = s.compact(indices.data());
+			ASSERT_ALWAYS(n == expected.size())
+			ASSERT_ALWAYS(s.size() == n)
+			for(size_t i = 0; i != n; ++i){
+				ASSERT_ALWAYS(s[i] == expected[i])
+				ASSERT_ALWAYS(indices[i] == expected_indices[i])
+			}
+
+			// compacted array can be processed further
+			ASSERT_ALWAYS(s.compact() == n)
+			ASSERT_ALWAYS(s.unite() == r4::rectangle_set<T>(expected.data(), expected.size()).unite())
+			std::vector<uint32_t> hits((n + 31) / 32);
+			s.overlaps(r4::vector2<T>(0, 0), hits.data());
+			for(size_t i = 0; i != n; ++i){
+				bool hit = (hits[i / 32] & (uint32_t(1) << (i % 32))) != 0;
+				ASSERT_ALWAYS(hit == expected[i].overlaps(r4::vector2<T>(0, 0)))
+			}
+			if(n % 32 != 0){
+				ASSERT_ALWAYS((hits[n / 32] >> (n % 32)) == 0)
+			}
+		}
+	}
+}
+}
+
+int main(int argc, char** argv){
+	test_rectangle_set<float>();
+	test_rectangle_set<double>();
+	test_rectangle_set<int32_t>();
+
+	// test resize() and set()
+	{
+		r4::rectangle_set<float> s(3);
+		s.set(1, r4::rectangle<float>(1, 2, 3, 4));
+		s.resize(10);
+		ASSERT_ALWAYS(s.size() == 10)
+		ASSERT_ALWAYS(s[0] == r4::rectangle<float>(0, 0, 0, 0))
+		ASSERT_ALWAYS(s[1] == r4::rectangle<float>(1, 2, 3, 4))
+		ASSERT_ALWAYS(s[9] == r4::rectangle<float>(0, 0, 0, 0))
+		s.resize(2);
+		ASSERT_ALWAYS(s.size() == 2)
+		ASSERT_ALWAYS(s[1] == r4::rectangle<float>(1, 2, 3, 4))
+	}
+
+	// test that all rectangles are removed by compact() when clipped away
+	{
+		auto v = make_rectangles<float>(20, 0);
+		r4::rectangle_set<float> s(v.data(), v.size());
+		s.intersect(r4::rectangle<float>(1000, 1000, 10, 10));
+		ASSERT_ALWAYS(s.compact() == 0)
+		ASSERT_ALWAYS(s.size() == 0)
+		ASSERT_ALWAYS(s.unite() == r4::rectangle<float>(0, 0, 0, 0))
+	}
+
+	return 0;
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/rectangle_tree.hpp"
+
+namespace{
+// simple deterministic pseudo-random number generator, so that test results are reproducible
+unsigned next_random(unsigned& state){
+	state = state * 1103515245 + 12345;
+	return (state >> 16) & 0x7fff;
+}
+
+template <class T> std::vector<r4::rectangle<T>> make_rectangles(size_t size, unsigned seed){
+	std::vector<r4::rectangle<T>> ret;
+	for(size_t i = 0; i != size; ++i){
+		ret.emplace_back(
+				T(next_random(seed) % 1000),
+				T(next_random(seed) % 1000),
+				T(next_random(seed) % 50),
+				T(next_random(seed) % 50)
+			);
+	}
+	return ret;
+}
+
+// checks tree queries against brute force search over all alive rectangles
+template <class T> void check_queries(const r4::rectangle_tree<T>& tree, const std::vector<r4::rectangle<T>>& rects, const std::vector<bool>& alive, unsigned seed){
+	ASSERT_ALWAYS(tree.size() == size_t(std::count(alive.begin(), alive.end(), true)))
+
+	for(unsigned k = 0; k != 100; ++k){
+		r4::vector2<T> p(T(next_random(seed) % 1100), T(next_random(seed) % 1100));
+
+		std::vector<size_t> expected;
+		for(size_t i = 0; i != rects.size(); ++i){
+			if(alive[i] && rects[i].overlaps(p)){
+				expected.push_back(i);
+			}
+		}
+
+		auto found = tree.query(p);
+		std::sort(found.begin(), found.end());
+		ASSERT_INFO_ALWAYS(found == expected, "p = " << p << ", found.size() = " << found.size() << ", expected.size() = " << expected.size())
+
+		r4::rectangle<T> r(p, r4::vector2<T>(T(next_random(seed) % 100), T(next_random(seed) % 100)));
+
+		expected.clear();
+		for(size_t i = 0; i != rects.size(); ++i){
+			auto intersection = rects[i];
+			intersection.intersect(r);
+			if(alive[i] && intersection.d.x() > 0 && intersection.d.y() > 0){
+				expected.push_back(i);
+			}
+		}
+
+		found = tree.query(r);
+		std::sort(found.begin(), found.end());
+		ASSERT_INFO_ALWAYS(found == expected, "r = " << r << ", found.size() = " << found.size() << ", expected.size() = " << expected.size())
+
+		// nearest rectangles, compare distances since there can be several rectangles at the same distance
+		auto distance = [&p](const r4::rectangle<T>& rect){
+			using std::max;
+			T dx = max(max(rect.p.x() - p.x(), p.x() - rect.x2()), T(0));
+			T dy = max(max(rect.p.y() - p.y(), p.y() - rect.y2()), T(0));
+			return dx * dx + dy * dy;
+		};
+
+		std::vector<T> distances;
+		for(size_t i = 0; i != rects.size(); ++i){
+			if(alive[i]){
+				distances.push_back(distance(rects[i]));
+			}
+		}
+		std::sort(distances.begin(), distances.end());
+
+		const size_t num_nearest = 5;
+		auto nearest = tree.nearest(p, num_nearest);
+		ASSERT_ALWAYS(nearest.size() == std::min(num_nearest, distances.size()))
+		for(size_t i = 0; i != nearest.size(); ++i){
+			ASSERT_ALWAYS(alive[nearest[i]])
+			ASSERT_INFO_ALWAYS(distance(rects[nearest[i]]) == distances[i], "i = " << i << ", p = " << p)
+		}
+	}
+}
+
+template <class T> void run_tests(){
+	// test empty tree
+	{
+		r4::rectangle_tree<T> tree;
+		ASSERT_ALWAYS(tree.empty())
+		ASSERT_ALWAYS(tree.size() == 0)
+		ASSERT_ALWAYS(tree.query(r4::vector2<T>(1, 2)).empty())
+		ASSERT_ALWAYS(tree.query(r4::rectangle<T>(0, 0, 10, 10)).empty())
+		ASSERT_ALWAYS(tree.nearest(r4::vector2<T>(1, 2)).empty())
+	}
+
+	// test build()
+	for(size_t size : {1, 3, 4, 5, 17, 64, 1000}){
+		auto rects = make_rectangles<T>(size, unsigned(size));
+
+		r4::rectangle_tree<T> tree(rects.data(), rects.size());
+		ASSERT_ALWAYS(!tree.empty())
+
+		auto bounds = rects.front();
+		for(auto& r : rects){
+			bounds.unite(r);
+		}
+		ASSERT_INFO_ALWAYS(tree.bounds() == bounds, "tree.bounds() = " << tree.bounds() << ", bounds = " << bounds)
+
+		for(size_t i = 0; i != rects.size(); ++i){
+			ASSERT_ALWAYS(tree[i] == rects[i])
+		}
+
+		check_queries(tree, rects, std::vector<bool>(rects.size(), true), 7);
+	}
+
+	// test insert(), remove() and refit()
+	{
+		auto rects = make_rectangles<T>(500, 13);
+
+		r4::rectangle_tree<T> tree;
+		for(size_t i = 0; i != rects.size(); ++i){
+			auto id = tree.insert(rects[i]);
+			ASSERT_ALWAYS(id == i)
+		}
+		std::vector<bool> alive(rects.size(), true);
+
+		check_queries(tree, rects, alive, 21);
+
+		// remove every third rectangle
+		for(size_t i = 0; i < rects.size(); i += 3){
+			tree.remove(i);
+			alive[i] = false;
+		}
+		check_queries(tree, rects, alive, 22);
+
+		// move some of the rectangles
+		unsigned seed = 5;
+		for(size_t i = 1; i < rects.size(); i += 7){
+			if(!alive[i]){
+				continue;
+			}
+			rects[i].p = r4::vector2<T>(T(next_random(seed) % 1000), T(next_random(seed) % 1000));
+			tree.refit(i, rects[i]);
+			ASSERT_ALWAYS(tree[i] == rects[i])
+		}
+		check_queries(tree, rects, alive, 23);
+
+		// removed ids are reused
+		for(size_t i = 0; i < rects.size(); i += 3){
+			auto id = tree.insert(rects[i]);
+			ASSERT_ALWAYS(!alive[id])
+			rects[id] = rects[i];
+			alive[id] = true;
+		}
+		check_queries(tree, rects, alive, 24);
+
+		// remove all
+		for(size_t i = 0; i != rects.size(); ++i){
+			tree.remove(i);
+		}
+		ASSERT_ALWAYS(tree.empty())
+		ASSERT_ALWAYS(tree.size() == 0)
+
+		tree.insert(rects[0]);
+		ASSERT_ALWAYS(tree.size() == 1)
+		ASSERT_ALWAYS(tree.nearest(rects[0].p) == std::vector<size_t>(1, 0))
+	}
+
+	// test interleaved removals and insertions, removals dissolve underfull nodes and reinsert their children
+	{
+		auto rects = make_rectangles<T>(300, 31);
+
+		r4::rectangle_tree<T> tree(rects.data(), rects.size());
+		std::vector<bool> alive(rects.size(), true);
+
+		unsigned seed = 8;
+		for(unsigned round = 0; round != 10; ++round){
+			// remove most of the rectangles in random order
+			for(unsigned k = 0; k != 250; ++k){
+				size_t i = next_random(seed) % rects.size();
+				if(!alive[i]){
+					continue;
+				}
+				tree.remove(i);
+				alive[i] = false;
+			}
+			check_queries(tree, rects, alive, 40 + round);
+
+			// insert some back
+			for(unsigned k = 0; k != 150; ++k){
+				r4::rectangle<T> r(
+						T(next_random(seed) % 1000),
+						T(next_random(seed) % 1000),
+						T(next_random(seed) % 50),
+						T(next_random(seed) % 50)
+					);
+				auto id = tree.insert(r);
+				ASSERT_ALWAYS(id < rects.size() && !alive[id])
+				rects[id] = r;
+				alive[id] = true;
+			}
+			check_queries(tree, rects, alive, 50 + round);
+		}
+	}
+}
+}
+
+int main(int argc, char** argv){
+	run_tests<int>();
+	run_tests<float>();
+	run_tests<double>();
+
+	return 0;
+}
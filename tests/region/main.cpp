@@ -0,0 +1,261 @@
+#include <vector>
+#include <random>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/region.hpp"
+
+namespace{
+const int grid_size = 24;
+
+// rasterize region to a grid of pixels
+std::vector<bool> rasterize(const r4::region<int>& r){
+	std::vector<bool> ret(grid_size * grid_size);
+	for(int y = 0; y != grid_size; ++y){
+		for(int x = 0; x != grid_size; ++x){
+			ret[y * grid_size + x] = r.overlaps(r4::vector2<int>(x, y));
+		}
+	}
+	return ret;
+}
+
+// rasterize region by testing its rectangles directly, not using region::overlaps()
+std::vector<bool> rasterize_rectangles(const r4::region<int>& r){
+	std::vector<bool> ret(grid_size * grid_size);
+	for(const auto& rect : r.rectangles()){
+		for(int y = rect.p.y(); y != rect.y2(); ++y){
+			for(int x = rect.p.x(); x != rect.x2(); ++x){
+				ASSERT_ALWAYS(x >= 0 && x < grid_size && y >= 0 && y < grid_size)
+				ASSERT_INFO_ALWAYS(!ret[y * grid_size + x], "rectangles overlap, r = " << r)
+				ret[y * grid_size + x] = true;
+			}
+		}
+	}
+	return ret;
+}
+
+// check that the rectangles are in canonical y-x banded order
+void check_banded(const r4::region<int>& r){
+	const auto& rects = r.rectangles();
+	for(size_t i = 0; i != rects.size(); ++i){
+		ASSERT_INFO_ALWAYS(rects[i].d.x() > 0 && rects[i].d.y() > 0, "r = " << r)
+		if(i == 0){
+			continue;
+		}
+		const auto& p = rects[i - 1];
+		const auto& c = rects[i];
+		if(p.p.y() == c.p.y()){
+			// same band
+			ASSERT_INFO_ALWAYS(p.d.y() == c.d.y(), "r = " << r)
+			ASSERT_INFO_ALWAYS(p.x2() < c.p.x(), "r = " << r)
+		}else{
+			ASSERT_INFO_ALWAYS(p.y2() <= c.p.y(), "r = " << r)
+		}
+	}
+
+	// adjacent bands must differ
+	size_t prev = 0;
+	for(size_t i = 0; i != rects.size();){
+		size_t e = i + 1;
+		for(; e != rects.size() && rects[e].p.y() == rects[i].p.y(); ++e){}
+		if(i != 0 && rects[prev].y2() == rects[i].p.y() && e - i == i - prev){
+			bool same = true;
+			for(size_t k = 0; k != e - i; ++k){
+				same = same && rects[prev + k].p.x() == rects[i + k].p.x() && rects[prev + k].d.x() == rects[i + k].d.x();
+			}
+			ASSERT_INFO_ALWAYS(!same, "bands are not coalesced, r = " << r)
+		}
+		prev = i;
+		i = e;
+	}
+}
+
+void check(const r4::region<int>& r){
+	check_banded(r);
+	ASSERT_ALWAYS(rasterize(r) == rasterize_rectangles(r))
+}
+
+r4::region<int> make_region(std::mt19937& gen, unsigned num_rects, std::vector<bool>& pixels){
+	std::uniform_int_distribution<int> coord(0, grid_size - 1);
+	std::uniform_int_distribution<int> op(0, 3);
+	r4::region<int> ret;
+	pixels.assign(grid_size * grid_size, false);
+	for(unsigned i = 0; i != num_rects; ++i){
+		int x1 = coord(gen), x2 = coord(gen), y1 = coord(gen), y2 = coord(gen);
+		r4::rectangle<int> rect(std::min(x1, x2), std::min(y1, y2), std::abs(x2 - x1) + 1, std::abs(y2 - y1) + 1);
+		bool add = op(gen) != 0;
+		if(add){
+			ret.unite(rect);
+		}else{
+			ret.subtract(rect);
+		}
+		for(int y = rect.p.y(); y != rect.y2(); ++y){
+			for(int x = rect.p.x(); x != rect.x2(); ++x){
+				pixels[y * grid_size + x] = add;
+			}
+		}
+		check(ret);
+		ASSERT_ALWAYS(rasterize(ret) == pixels)
+	}
+	return ret;
+}
+}
+
+int main(int argc, char** argv){
+	// test union of disjoint rectangles
+	{
+		r4::region<int> r(r4::rectangle<int>(0, 0, 10, 10));
+		r.unite(r4::rectangle<int>(20, 20, 10, 10));
+		ASSERT_ALWAYS(r.rectangles().size() == 2)
+		ASSERT_ALWAYS(r.rectangles()[0] == r4::rectangle<int>(0, 0, 10, 10))
+		ASSERT_ALWAYS(r.rectangles()[1] == r4::rectangle<int>(20, 20, 10, 10))
+		ASSERT_ALWAYS(r.bounding_box() == r4::rectangle<int>(0, 0, 30, 30))
+		ASSERT_ALWAYS(r.overlaps(r4::vector2<int>(5, 5)))
+		ASSERT_ALWAYS(r.overlaps(r4::vector2<int>(29, 29)))
+		ASSERT_ALWAYS(!r.overlaps(r4::vector2<int>(15, 15)))
+		ASSERT_ALWAYS(!r.overlaps(r4::vector2<int>(10, 5)))
+		ASSERT_ALWAYS(!r.overlaps(r4::vector2<int>(30, 25)))
+	}
+
+	// test union of touching rectangles gives single rectangle
+	{
+		r4::region<int> r(r4::rectangle<int>(0, 0, 10, 10));
+		r.unite(r4::rectangle<int>(10, 0, 5, 10));
+		r.unite(r4::rectangle<int>(0, 10, 15, 3));
+		ASSERT_ALWAYS(r == r4::region<int>(r4::rectangle<int>(0, 0, 15, 13)))
+	}
+
+	// test overlapping rectangles
+	{
+		r4::region<int> r(r4::rectangle<int>(0, 0, 10, 10));
+		r.unite(r4::rectangle<int>(5, 5, 10, 10));
+		// three bands: top, middle and bottom
+		ASSERT_ALWAYS(r.rectangles().size() == 3)
+		ASSERT_ALWAYS(r.rectangles()[0] == r4::rectangle<int>(0, 0, 10, 5))
+		ASSERT_ALWAYS(r.rectangles()[1] == r4::rectangle<int>(0, 5, 15, 5))
+		ASSERT_ALWAYS(r.rectangles()[2] == r4::rectangle<int>(5, 10, 10, 5))
+
+		auto i = r;
+		i.intersect(r4::rectangle<int>(8, 3, 4, 4));
+		ASSERT_ALWAYS(i.rectangles().size() == 2)
+		ASSERT_ALWAYS(i.rectangles()[0] == r4::rectangle<int>(8, 3, 2, 2))
+		ASSERT_ALWAYS(i.rectangles()[1] == r4::rectangle<int>(8, 5, 4, 2))
+
+		auto s = r;
+		s.subtract(r4::rectangle<int>(0, 0, 10, 10));
+		ASSERT_ALWAYS(s.rectangles().size() == 2)
+		ASSERT_ALWAYS(s.rectangles()[0] == r4::rectangle<int>(10, 5, 5, 5))
+		ASSERT_ALWAYS(s.rectangles()[1] == r4::rectangle<int>(5, 10, 10, 5))
+
+		s.subtract(r);
+		ASSERT_ALWAYS(s.empty())
+	}
+
+	// test hole in the middle
+	{
+		r4::region<int> r(r4::rectangle<int>(0, 0, 9, 9));
+		r.subtract(r4::rectangle<int>(3, 3, 3, 3));
+		ASSERT_ALWAYS(r.rectangles().size() == 4)
+		ASSERT_ALWAYS(r.rectangles()[0] == r4::rectangle<int>(0, 0, 9, 3))
+		ASSERT_ALWAYS(r.rectangles()[1] == r4::rectangle<int>(0, 3, 3, 3))
+		ASSERT_ALWAYS(r.rectangles()[2] == r4::rectangle<int>(6, 3, 3, 3))
+		ASSERT_ALWAYS(r.rectangles()[3] == r4::rectangle<int>(0, 6, 9, 3))
+		ASSERT_ALWAYS(!r.overlaps(r4::vector2<int>(4, 4)))
+		ASSERT_ALWAYS(r.overlaps(r4::vector2<int>(6, 4)))
+
+		r.unite(r4::rectangle<int>(3, 3, 3, 3));
+		ASSERT_ALWAYS(r == r4::region<int>(r4::rectangle<int>(0, 0, 9, 9)))
+	}
+
+	// test empty regions
+	{
+		r4::region<int> e;
+		ASSERT_ALWAYS(e.empty())
+		ASSERT_ALWAYS(r4::region<int>(r4::rectangle<int>(1, 1, 0, 5)).empty())
+		ASSERT_ALWAYS(r4::region<int>(r4::rectangle<int>(1, 1, 5, -1)).empty())
+		ASSERT_ALWAYS(e.bounding_box() == r4::rectangle<int>(0, 0, 0, 0))
+		ASSERT_ALWAYS(!e.overlaps(r4::vector2<int>(0, 0)))
+
+		r4::region<int> r(r4::rectangle<int>(1, 2, 3, 4));
+		auto u = r;
+		u.unite(e);
+		ASSERT_ALWAYS(u == r)
+		u = e;
+		u.unite(r);
+		ASSERT_ALWAYS(u == r)
+		u = r;
+		u.subtract(e);
+		ASSERT_ALWAYS(u == r)
+		u = r;
+		u.intersect(e);
+		ASSERT_ALWAYS(u.empty())
+		u = r;
+		u.intersect(r4::rectangle<int>(10, 10, 5, 5));
+		ASSERT_ALWAYS(u.empty())
+	}
+
+	// test translate()
+	{
+		r4::region<int> r(r4::rectangle<int>(0, 0, 10, 10));
+		r.unite(r4::rectangle<int>(20, 5, 10, 10));
+		auto t = r;
+		t.translate(r4::vector2<int>(-3, 7));
+		ASSERT_ALWAYS(t.rectangles().size() == r.rectangles().size())
+		for(size_t i = 0; i != r.rectangles().size(); ++i){
+			auto e = r.rectangles()[i];
+			e.p += r4::vector2<int>(-3, 7);
+			ASSERT_ALWAYS(t.rectangles()[i] == e)
+		}
+		ASSERT_ALWAYS(t.overlaps(r4::vector2<int>(-3, 7)))
+		ASSERT_ALWAYS(!t.overlaps(r4::vector2<int>(-4, 7)))
+	}
+
+	// test random operations against pixel grid
+	{
+		std::mt19937 gen(7);
+		for(unsigned iter = 0; iter != 300; ++iter){
+			std::vector<bool> pa, pb;
+			auto a = make_region(gen, 1 + iter % 9, pa);
+			auto b = make_region(gen, 1 + iter % 7, pb);
+
+			std::vector<bool> expected(pa.size());
+
+			auto u = a;
+			u.unite(b);
+			check(u);
+			for(size_t i = 0; i != expected.size(); ++i){
+				expected[i] = pa[i] || pb[i];
+			}
+			ASSERT_ALWAYS(rasterize(u) == expected)
+
+			auto n = a;
+			n.intersect(b);
+			check(n);
+			for(size_t i = 0; i != expected.size(); ++i){
+				expected[i] = pa[i] && pb[i];
+			}
+			ASSERT_ALWAYS(rasterize(n) == expected)
+
+			auto s = a;
+			s.subtract(b);
+			check(s);
+			for(size_t i = 0; i != expected.size(); ++i){
+				expected[i] = pa[i] && !pb[i];
+			}
+			ASSERT_ALWAYS(rasterize(s) == expected)
+
+			// representation is unique, so same sets of points give equal regions
+			auto u2 = b;
+			u2.unite(a);
+			ASSERT_ALWAYS(u == u2)
+			auto n2 = b;
+			n2.intersect(a);
+			ASSERT_ALWAYS(n == n2)
+			auto s2 = u;
+			s2.subtract(b);
+			ASSERT_ALWAYS(s == s2)
+		}
+	}
+
+	return 0;
+}
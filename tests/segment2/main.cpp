@@ -0,0 +1,209 @@
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/segment2.hpp"
+
+namespace{
+// simple deterministic pseudo-random number generator, so that test results are reproducible
+float next_random(unsigned& state){
+	state = state * 1103515245 + 12345;
+	return float((state >> 16) & 0x7fff) / float(0x7fff);
+}
+}
+
+int main(int argc, char** argv){
+
+	// test bounding_box()
+	{
+		for(size_t size : {0, 1, 3, 4, 7, 8, 9, 100}){
+			std::vector<r4::vector2<float>> points;
+			unsigned seed = unsigned(size);
+			for(size_t i = 0; i != size; ++i){
+				points.emplace_back(next_random(seed) * 100 - 50, next_random(seed) * 100 - 50);
+			}
+
+			r4::segment2<float> expected;
+			expected.set_empty_bounding_box();
+			for(auto& p : points){
+				expected.unite(r4::segment2<float>{p, p});
+			}
+
+			auto bb = r4::segment2<float>::bounding_box(points.data(), points.size());
+			ASSERT_INFO_ALWAYS(bb.p1 == expected.p1 && bb.p2 == expected.p2, "size = " << size << ", bb = " << bb.p1 << bb.p2)
+
+			std::vector<r4::vector2<int>> ipoints;
+			for(auto& p : points){
+				ipoints.push_back(p.to<int>());
+			}
+			auto ibb = r4::segment2<int>::bounding_box(ipoints.data(), ipoints.size());
+			auto fbb = r4::segment2<float>::bounding_box(points.data(), points.size());
+			if(size != 0){
+				ASSERT_ALWAYS(ibb.p1 == fbb.p1.to<int>() && ibb.p2 == fbb.p2.to<int>())
+			}
+		}
+	}
+
+	// test intersects()
+	{
+		r4::segment2<int> a{{0, 0}, {10, 10}};
+
+		ASSERT_ALWAYS(a.intersects(r4::segment2<int>{{0, 10}, {10, 0}}))
+		ASSERT_ALWAYS(!a.intersects(r4::segment2<int>{{1, 0}, {11, 10}}))
+
+		// touching by end point
+		ASSERT_ALWAYS(a.intersects(r4::segment2<int>{{10, 10}, {20, 0}}))
+		// end point on the other segment
+		ASSERT_ALWAYS(a.intersects(r4::segment2<int>{{5, 5}, {20, 0}}))
+
+		// collinear, overlapping and not
+		ASSERT_ALWAYS(a.intersects(r4::segment2<int>{{5, 5}, {15, 15}}))
+		ASSERT_ALWAYS(!a.intersects(r4::segment2<int>{{11, 11}, {15, 15}}))
+
+		static_assert(r4::segment2<int>{{0, 0}, {2, 2}}.intersects(r4::segment2<int>{{0, 2}, {2, 0}}));
+	}
+
+	// test intersection()
+	{
+		r4::segment2<double> a{{0, 0}, {10, 10}};
+
+		r4::vector2<double> p;
+		ASSERT_ALWAYS(a.intersection(r4::segment2<double>{{0, 10}, {10, 0}}, p))
+		ASSERT_INFO_ALWAYS(p == r4::vector2<double>(5, 5), "p = " << p)
+
+		ASSERT_ALWAYS(a.intersection(r4::segment2<double>{{10, 0}, {0, 2}}, p))
+		ASSERT_INFO_ALWAYS((p - r4::vector2<double>(10.0 / 6, 10.0 / 6)).norm() < 1e-12, "p = " << p)
+
+		ASSERT_ALWAYS(!a.intersection(r4::segment2<double>{{0, 10}, {4, 6.5}}, p))
+		ASSERT_ALWAYS(!a.intersection(r4::segment2<double>{{1, 0}, {11, 10}}, p))
+
+		r4::segment2<int> ia{{0, 0}, {4, 4}};
+		r4::vector2<int> ip;
+		ASSERT_ALWAYS(ia.intersection(r4::segment2<int>{{0, 4}, {4, 0}}, ip))
+		ASSERT_ALWAYS(ip == r4::vector2<int>(2, 2))
+
+		// intersection point is rounded to nearest integer point
+		ASSERT_ALWAYS(ia.intersection(r4::segment2<int>{{0, 3}, {3, 0}}, ip))
+		ASSERT_INFO_ALWAYS(ip == r4::vector2<int>(2, 2), "ip = " << ip)
+		r4::segment2<int> ib{{0, 0}, {-4, -4}};
+		ASSERT_ALWAYS(ib.intersection(r4::segment2<int>{{0, -3}, {-3, 0}}, ip))
+		ASSERT_INFO_ALWAYS(ip == r4::vector2<int>(-2, -2), "ip = " << ip)
+
+		// big coordinates, the cross products fit into int, but multiplying them by coordinates does not
+		r4::segment2<int> ic{{0, 0}, {40000, 0}};
+		ASSERT_ALWAYS(ic.intersection(r4::segment2<int>{{10000, -20000}, {10000, 20000}}, ip))
+		ASSERT_INFO_ALWAYS(ip == r4::vector2<int>(10000, 0), "ip = " << ip)
+
+		// big coordinates, the cross products do not fit into int
+		r4::segment2<int> id{{0, 0}, {50000, 0}};
+		r4::segment2<int> ie{{10000, -30000}, {10000, 30000}};
+		ASSERT_ALWAYS(id.intersects(ie))
+		ASSERT_ALWAYS(ie.intersects(id))
+		ASSERT_ALWAYS(id.intersection(ie, ip))
+		ASSERT_INFO_ALWAYS(ip == r4::vector2<int>(10000, 0), "ip = " << ip)
+		ASSERT_ALWAYS(!id.intersects(r4::segment2<int>{{60000, -30000}, {60000, 30000}}))
+	}
+
+	// test closest_point()
+	{
+		r4::segment2<double> a{{0, 0}, {10, 0}};
+
+		ASSERT_ALWAYS(a.closest_point(r4::vector2<double>(-5, 3)) == r4::vector2<double>(0, 0))
+		ASSERT_ALWAYS(a.closest_point(r4::vector2<double>(15, -3)) == r4::vector2<double>(10, 0))
+		ASSERT_ALWAYS(a.closest_point(r4::vector2<double>(4, 3)) == r4::vector2<double>(4, 0))
+
+		r4::segment2<int> b{{0, 0}, {4, 4}};
+		constexpr auto cp = r4::segment2<int>{{0, 0}, {4, 4}}.closest_point(r4::vector2<int>(4, 0));
+		static_assert(cp.x() == 2 && cp.y() == 2);
+		ASSERT_ALWAYS(b.closest_point(r4::vector2<int>(0, 8)) == r4::vector2<int>(4, 4))
+		ASSERT_ALWAYS(b.closest_point(r4::vector2<int>(3, 0)) == r4::vector2<int>(2, 2))
+
+		// big coordinates, the dot products fit into int, but multiplying them by coordinates does not
+		r4::segment2<int> c{{0, 0}, {30000, 30000}};
+		ASSERT_ALWAYS(c.closest_point(r4::vector2<int>(30000, 0)) == r4::vector2<int>(15000, 15000))
+
+		// big coordinates, the dot products do not fit into int
+		r4::segment2<int> d{{0, 0}, {50000, 50000}};
+		ASSERT_ALWAYS(d.closest_point(r4::vector2<int>(50000, 0)) == r4::vector2<int>(25000, 25000))
+		ASSERT_ALWAYS(d.closest_point(r4::vector2<int>(60000, 70000)) == r4::vector2<int>(50000, 50000))
+	}
+
+	// test clip()
+	{
+		r4::rectangle<float> rect{0, 0, 10, 10};
+
+		r4::segment2<float> s{{-5, 5}, {15, 5}};
+		ASSERT_ALWAYS(s.clip(rect))
+		ASSERT_INFO_ALWAYS(s.p1 == r4::vector2<float>(0, 5) && s.p2 == r4::vector2<float>(10, 5), "s = " << s.p1 << s.p2)
+
+		// direction is preserved
+		s = r4::segment2<float>{{5, 15}, {5, 3}};
+		ASSERT_ALWAYS(s.clip(rect))
+		ASSERT_INFO_ALWAYS(s.p1 == r4::vector2<float>(5, 10) && s.p2 == r4::vector2<float>(5, 3), "s = " << s.p1 << s.p2)
+
+		// inside
+		s = r4::segment2<float>{{1, 2}, {3, 4}};
+		ASSERT_ALWAYS(s.clip(rect))
+		ASSERT_ALWAYS(s.p1 == r4::vector2<float>(1, 2) && s.p2 == r4::vector2<float>(3, 4))
+
+		// outside
+		s = r4::segment2<float>{{-5, 8}, {8, 15}};
+		ASSERT_ALWAYS(!s.clip(rect))
+		ASSERT_ALWAYS(s.p1 == r4::vector2<float>(-5, 8) && s.p2 == r4::vector2<float>(8, 15))
+
+		// parallel to edge, outside
+		s = r4::segment2<float>{{-5, -1}, {15, -1}};
+		ASSERT_ALWAYS(!s.clip(rect))
+
+		// integer
+		r4::segment2<int> is{{-10, 0}, {10, 5}};
+		ASSERT_ALWAYS(is.clip(r4::rectangle<int>{0, 0, 4, 4}))
+		ASSERT_INFO_ALWAYS(is.p1 == r4::vector2<int>(0, 3) && is.p2 == r4::vector2<int>(4, 4), "is = " << is.p1 << is.p2)
+	}
+
+	// test batch clip(), must give same results as clip() of single segment
+	{
+		r4::rectangle<float> rect{-10, -5, 20, 10};
+
+		std::vector<r4::segment2<float>> segments;
+		unsigned seed = 3;
+		for(unsigned i = 0; i != 1003; ++i){
+			segments.push_back(r4::segment2<float>{
+					{next_random(seed) * 40 - 20, next_random(seed) * 40 - 20},
+					{next_random(seed) * 40 - 20, next_random(seed) * 40 - 20}
+				});
+			// some segments parallel to axes
+			if(i % 5 == 0){
+				segments.back().p2.x() = segments.back().p1.x();
+			}else if(i % 7 == 0){
+				segments.back().p2.y() = segments.back().p1.y();
+			}
+		}
+
+		std::vector<r4::segment2<float>> expected;
+		for(auto s : segments){
+			if(s.clip(rect)){
+				expected.push_back(s);
+			}
+		}
+		ASSERT_ALWAYS(expected.size() != 0 && expected.size() != segments.size())
+
+		std::vector<r4::segment2<float>> clipped(segments.size());
+		auto num = r4::segment2<float>::clip(segments.data(), segments.size(), rect, clipped.data());
+		ASSERT_INFO_ALWAYS(num == expected.size(), "num = " << num << ", expected.size() = " << expected.size())
+
+		for(size_t i = 0; i != num; ++i){
+			ASSERT_INFO_ALWAYS((clipped[i].p1 - expected[i].p1).norm() < 1e-4f, "i = " << i)
+			ASSERT_INFO_ALWAYS((clipped[i].p2 - expected[i].p2).norm() < 1e-4f, "i = " << i)
+		}
+
+		// in place
+		num = r4::segment2<float>::clip(segments.data(), segments.size(), rect, segments.data());
+		ASSERT_ALWAYS(num == expected.size())
+		for(size_t i = 0; i != num; ++i){
+			ASSERT_ALWAYS(segments[i].p1 == clipped[i].p1 && segments[i].p2 == clipped[i].p2)
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include <vector>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/soa_vector4.hpp"
+
+namespace{
+// generate array of vectors, the size is deliberately not a multiple of SIMD register size
+template <class T> std::vector<r4::vector4<T>> make_vectors(size_t size, int seed){
+	std::vector<r4::vector4<T>> ret;
+	for(size_t i = 0; i != size; ++i){
+		int k = int(i) + seed;
+		ret.emplace_back(T(k % 7 - 3), T(k % 5 - 2), T(k % 11 - 5), T(k % 3 - 1));
+	}
+	return ret;
+}
+
+bool is_close(float a, float b){
+	using std::abs;
+	return abs(a - b) < 1e-5f;
+}
+}
+
+int main(int argc, char** argv){
+
+	// test gather() and scatter()
+	{
+		for(size_t size : {0, 1, 3, 4, 5, 8, 13}){
+			auto v = make_vectors<float>(size, 1);
+
+			r4::soa_vector4<float> s(v.data(), v.size());
+			ASSERT_ALWAYS(s.size() == size)
+			ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(s.x()) % s.alignment == 0)
+			ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(s.y()) % s.alignment == 0)
+			ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(s.z()) % s.alignment == 0)
+			ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(s.w()) % s.alignment == 0)
+
+			for(size_t i = 0; i != size; ++i){
+				ASSERT_ALWAYS(s[i] == v[i])
+				ASSERT_ALWAYS(s.x()[i] == v[i].x())
+				ASSERT_ALWAYS(s.y()[i] == v[i].y())
+				ASSERT_ALWAYS(s.z()[i] == v[i].z())
+				ASSERT_ALWAYS(s.w()[i] == v[i].w())
+			}
+
+			std::vector<r4::vector4<float>> out(size);
+			s.scatter(out.data());
+			ASSERT_ALWAYS(out == v)
+		}
+	}
+
+	// test set() and resize()
+	{
+		r4::soa_vector4<int> s(3);
+		s.set(1, r4::vector4<int>(1, 2, 3, 4));
+		s.resize(10);
+		ASSERT_ALWAYS(s.size() == 10)
+		ASSERT_ALWAYS(s[0] == r4::vector4<int>(0))
+		ASSERT_ALWAYS(s[1] == r4::vector4<int>(1, 2, 3, 4))
+		ASSERT_ALWAYS(s[9] == r4::vector4<int>(0))
+		s.resize(1);
+		ASSERT_ALWAYS(s.size() == 1)
+		ASSERT_ALWAYS(s[0] == r4::vector4<int>(0))
+	}
+
+	// test arithmetic operations against vector3
+	{
+		const size_t size = 13;
+		auto a = make_vectors<float>(size, 0);
+		auto b = make_vectors<float>(size, 3);
+
+		r4::soa_vector4<float> sa(a.data(), a.size());
+		r4::soa_vector4<float> sb(b.data(), b.size());
+
+		auto sum = sa + sb;
+		auto diff = sa - sb;
+		auto scaled = sa * 3.0f;
+		auto dot = sa * sb;
+		auto cross = sa % sb;
+		auto mn = min(sa, sb);
+		auto mx = max(sa, sb);
+		auto norm = sa;
+		norm.normalize();
+		auto snapped = sa;
+		snapped.snap_to_zero(1);
+
+		ASSERT_ALWAYS(dot.size() == size)
+
+		for(size_t i = 0; i != size; ++i){
+			ASSERT_ALWAYS(sum[i] == a[i] + b[i])
+			ASSERT_ALWAYS(diff[i] == a[i] - b[i])
+			ASSERT_ALWAYS(scaled[i] == a[i] * 3.0f)
+			ASSERT_INFO_ALWAYS(is_close(dot[i], a[i] * b[i]), "i = " << i << ", dot[i] = " << dot[i])
+			ASSERT_ALWAYS(cross[i] == a[i] % b[i])
+			ASSERT_ALWAYS(mn[i] == min(a[i], b[i]))
+			ASSERT_ALWAYS(mx[i] == max(a[i], b[i]))
+			ASSERT_ALWAYS(snapped[i] == r4::vector4<float>(a[i]).snap_to_zero(1))
+
+			auto n = r4::vector4<float>(a[i]).normalize();
+			auto d = norm[i] - n;
+			ASSERT_INFO_ALWAYS(d.norm() < 1e-5f, "i = " << i << ", norm[i] = " << norm[i] << ", n = " << n)
+		}
+	}
+
+	// test normalize() of zero vector
+	{
+		r4::soa_vector4<float> s(5);
+		s.normalize();
+		for(size_t i = 0; i != s.size(); ++i){
+			ASSERT_ALWAYS(s[i] == r4::vector4<float>(1, 0, 0, 0))
+		}
+	}
+
+	// test arithmetic operations for int
+	{
+		const size_t size = 5;
+		auto a = make_vectors<int>(size, 0);
+		auto b = make_vectors<int>(size, 2);
+
+		r4::soa_vector4<int> sa(a.data(), a.size());
+		r4::soa_vector4<int> sb(b.data(), b.size());
+
+		auto sum = sa + sb;
+		auto dot = sa * sb;
+		auto cross = sa % sb;
+
+		for(size_t i = 0; i != size; ++i){
+			ASSERT_ALWAYS(sum[i] == a[i] + b[i])
+			ASSERT_ALWAYS(dot[i] == a[i] * b[i])
+			ASSERT_ALWAYS(cross[i] == a[i] % b[i])
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,230 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+#include <utki/debug.hpp>
+
+#include "../../src/r4/triangulation.hpp"
+
+namespace{
+typedef r4::delaunay_triangulation::triangle_type triangle_type;
+
+// checks that the hull is strictly convex, counterclockwise and contains all the points
+void check_hull(const std::vector<r4::vector2<double>>& points, const std::vector<uint32_t>& hull){
+	auto sorted = r4::sort_points(points.data(), points.size());
+	if(sorted.size() < 3){
+		ASSERT_ALWAYS(hull == sorted)
+		return;
+	}
+	ASSERT_ALWAYS(hull.size() >= 2)
+	ASSERT_ALWAYS(hull.front() == sorted.front())
+
+	for(size_t i = 0; i != hull.size(); ++i){
+		const auto& a = points[hull[i]];
+		const auto& b = points[hull[(i + 1) % hull.size()]];
+		for(const auto& p : points){
+			ASSERT_ALWAYS(r4::predicates::orient2d(a, b, p) >= 0)
+		}
+		if(hull.size() > 2){
+			const auto& c = points[hull[(i + 2) % hull.size()]];
+			ASSERT_ALWAYS(r4::predicates::orient2d(a, b, c) > 0)
+		}else{
+			// all points are collinear, the hull is the two end points
+			ASSERT_ALWAYS(hull[1] == sorted.back())
+		}
+	}
+}
+
+uint64_t edge_key(uint32_t a, uint32_t b){
+	return (uint64_t(a) << 32) | b;
+}
+
+// checks that the triangulation is a valid Delaunay triangulation of the points
+void check_delaunay(const std::vector<r4::vector2<double>>& points, const r4::delaunay_triangulation& dt){
+	const auto& tris = dt.triangles();
+	auto sorted = r4::sort_points(points.data(), points.size());
+	auto hull = r4::convex_hull(points.data(), points.size());
+
+	if(hull.size() < 3){
+		ASSERT_ALWAYS(tris.empty())
+		return;
+	}
+
+	// number of points on the hull boundary
+	size_t num_boundary = 0;
+	for(auto i : sorted){
+		for(size_t j = 0; j != hull.size(); ++j){
+			const auto& a = points[hull[j]];
+			const auto& b = points[hull[(j + 1) % hull.size()]];
+			if(r4::predicates::orient2d(a, b, points[i]) == 0){
+				++num_boundary;
+				break;
+			}
+		}
+	}
+
+	// Euler's formula for triangulation of all the points
+	ASSERT_INFO_ALWAYS(
+			tris.size() == 2 * sorted.size() - 2 - num_boundary,
+			"tris.size() = " << tris.size() << ", n = " << sorted.size() << ", h = " << num_boundary
+		)
+
+	// each directed edge belongs to one triangle, remember the opposite vertex
+	std::unordered_map<uint64_t, uint32_t> opposite;
+	std::vector<bool> used(points.size(), false);
+	for(const auto& t : tris){
+		ASSERT_ALWAYS(r4::predicates::orient2d(points[t[0]], points[t[1]], points[t[2]]) > 0)
+		for(unsigned i = 0; i != 3; ++i){
+			used[t[i]] = true;
+			bool inserted = opposite.emplace(edge_key(t[i], t[(i + 1) % 3]), t[(i + 2) % 3]).second;
+			ASSERT_ALWAYS(inserted)
+		}
+	}
+
+	// all distinct points are vertices of the triangulation
+	for(auto i : sorted){
+		ASSERT_ALWAYS(used[i])
+	}
+
+	// locally Delaunay everywhere means globally Delaunay
+	size_t num_boundary_edges = 0;
+	for(const auto& t : tris){
+		for(unsigned i = 0; i != 3; ++i){
+			auto o = opposite.find(edge_key(t[(i + 1) % 3], t[i]));
+			if(o == opposite.end()){
+				++num_boundary_edges;
+				continue;
+			}
+			ASSERT_ALWAYS(r4::predicates::incircle(points[t[0]], points[t[1]], points[t[2]], points[o->second]) <= 0)
+		}
+	}
+	ASSERT_ALWAYS(num_boundary_edges == num_boundary)
+}
+
+void check(const std::vector<r4::vector2<double>>& points){
+	check_hull(points, r4::convex_hull(points.data(), points.size()));
+	check_delaunay(points, r4::delaunay_triangulation(points.data(), points.size()));
+}
+}
+
+int main(int argc, char** argv){
+	std::mt19937 gen(1);
+
+	// degenerate inputs
+	{
+		std::vector<r4::vector2<double>> points;
+		check(points);
+
+		r4::delaunay_triangulation dt(points.data(), points.size());
+		ASSERT_ALWAYS(dt.triangles().empty())
+		ASSERT_ALWAYS(dt.bounding_box() == r4::rectangle<double>(0, 0, 0, 0))
+
+		points.push_back(r4::vector2<double>(1, 2));
+		check(points);
+		points.push_back(r4::vector2<double>(1, 2));
+		check(points);
+		ASSERT_ALWAYS(r4::convex_hull(points.data(), points.size()) == std::vector<uint32_t>{0})
+
+		points.push_back(r4::vector2<double>(3, 5));
+		check(points);
+		points.push_back(r4::vector2<double>(-1, -1));
+		check(points);
+		ASSERT_ALWAYS(r4::convex_hull(points.data(), points.size()) == (std::vector<uint32_t>{3, 2}))
+		ASSERT_ALWAYS(r4::delaunay_triangulation(points.data(), points.size()).triangles().empty())
+	}
+
+	// single triangle in both orientations
+	{
+		std::vector<r4::vector2<double>> points = {{0, 0}, {1, 0}, {0, 1}};
+		check(points);
+		r4::delaunay_triangulation dt(points.data(), points.size());
+		ASSERT_ALWAYS(dt.triangles().size() == 1)
+		ASSERT_ALWAYS(dt.bounding_box() == r4::rectangle<double>(0, 0, 1, 1))
+
+		std::swap(points[1], points[2]);
+		check(points);
+	}
+
+	// collinear points
+	for(unsigned n = 2; n != 20; ++n){
+		std::vector<r4::vector2<double>> points;
+		for(unsigned i = 0; i != n; ++i){
+			points.push_back(r4::vector2<double>(0.1 * (i * 7 % n), 0.3 * (i * 7 % n)));
+		}
+		check(points);
+	}
+
+	// random points
+	for(unsigned n = 3; n < 200; n += 7){
+		std::uniform_real_distribution<double> dist(-1000, 1000);
+		std::vector<r4::vector2<double>> points;
+		for(unsigned i = 0; i != n; ++i){
+			points.push_back(r4::vector2<double>(dist(gen), dist(gen)));
+		}
+		check(points);
+	}
+
+	// points on a grid with duplicates, many collinear and cocircular points
+	for(unsigned size = 1; size != 16; ++size){
+		std::uniform_int_distribution<int> dist(0, size);
+		std::vector<r4::vector2<double>> points;
+		for(unsigned i = 0; i != size * size * 2; ++i){
+			points.push_back(r4::vector2<double>(dist(gen), dist(gen)));
+		}
+		check(points);
+	}
+
+	// points on a circle, all cocircular
+	{
+		std::vector<r4::vector2<double>> points;
+		for(int x = -25; x <= 25; ++x){
+			for(int y = -25; y <= 25; ++y){
+				if(x * x + y * y == 625){
+					points.push_back(r4::vector2<double>(x, y));
+				}
+			}
+		}
+		ASSERT_ALWAYS(points.size() == 20)
+		check(points);
+	}
+
+	// nearly collinear points, where non-robust predicates fail
+	{
+		std::vector<r4::vector2<double>> points;
+		for(unsigned i = 0; i != 64; ++i){
+			for(unsigned j = 0; j != 4; ++j){
+				points.push_back(r4::vector2<double>(0.5 + i * 0x1p-53, 0.5 + j * 0x1p-53));
+			}
+		}
+		points.push_back(r4::vector2<double>(12, 12));
+		points.push_back(r4::vector2<double>(24, 24));
+		check(points);
+	}
+
+	// large input, parallel construction gives the same result as single-threaded one
+	{
+		std::uniform_real_distribution<double> dist(0, 1);
+		std::vector<r4::vector2<double>> points;
+		for(unsigned i = 0; i != 100000; ++i){
+			points.push_back(r4::vector2<double>(dist(gen), dist(gen)));
+		}
+		// some duplicates and points on a grid
+		for(unsigned i = 0; i != 10000; ++i){
+			points.push_back(points[i * 3]);
+			points.push_back(r4::vector2<double>(double(i % 100) / 64, double(i / 100) / 64));
+		}
+
+		r4::delaunay_triangulation single(points.data(), points.size(), 1);
+		r4::delaunay_triangulation parallel(points.data(), points.size(), 4);
+		ASSERT_ALWAYS(single.triangles() == parallel.triangles())
+		check_delaunay(points, parallel);
+
+		auto hull = r4::convex_hull(points.data(), points.size(), 1);
+		ASSERT_ALWAYS(hull == r4::convex_hull(points.data(), points.size(), 4))
+		ASSERT_ALWAYS(r4::sort_points(points.data(), points.size(), 1) == r4::sort_points(points.data(), points.size(), 4))
+		check_hull(points, hull);
+	}
+
+	return 0;
+}
@@ -496,5 +496,19 @@ int main(int argc, char** argv){
 		ASSERT_ALWAYS(r[1] == 3)
 	}
 
+	// test compile time evaluation
+	{
+		constexpr r4::vector2<int> a{2, 3};
+		constexpr r4::vector2<int> b{-4, 5};
+
+		constexpr auto s = a + b * 2;
+		static_assert(s.x() == -6 && s.y() == 13);
+		static_assert(a * b == 7);
+		static_assert(a.norm_pow2() == 13);
+
+		constexpr auto mn = min(a, b);
+		static_assert(mn.x() == -4 && mn.y() == 3);
+	}
+
     return 0;
 }
@@ -414,6 +414,22 @@ int main(int argc, char** argv){
 		ASSERT_ALWAYS(r[2] == -4)
 	}
 
+	// test compile time evaluation
+	{
+		constexpr r4::vector3<int> a{1, 2, 3};
+		constexpr r4::vector3<int> b{4, -5, 6};
+
+		constexpr auto s = a - b;
+		static_assert(s.x() == -3 && s.y() == 7 && s.z() == -3);
+
+		constexpr auto c = a % b;
+		static_assert(c.x() == 27 && c.y() == 6 && c.z() == -13);
+
+		// rotation by pi around z axis
+		constexpr auto r = r4::vector3<float>(1, 2, 3).rotate(r4::quaternion<float>(0, 0, 1, 0));
+		static_assert(r.x() == -1 && r.y() == -2 && r.z() == 3);
+	}
+
     return 0;
 }
 
@@ -407,5 +407,73 @@ int main(int argc, char** argv){
 		ASSERT_ALWAYS(r[3] == -6)
 	}
 
+	// test vector4<float> operations, these are specialized when SIMD is available
+	{
+		r4::vector4<float> a{2, 3, 4, -6};
+		r4::vector4<float> b{5, 1, -5, -8};
+
+		ASSERT_ALWAYS(a + b == r4::vector4<float>(7, 4, -1, -14))
+		ASSERT_ALWAYS(a - b == r4::vector4<float>(-3, 2, 9, 2))
+		ASSERT_ALWAYS(a * 2.0f == r4::vector4<float>(4, 6, 8, -12))
+		ASSERT_ALWAYS(b / 2.0f == r4::vector4<float>(2.5f, 0.5f, -2.5f, -4))
+		ASSERT_ALWAYS(-a == r4::vector4<float>(-2, -3, -4, 6))
+		ASSERT_ALWAYS(a * b == 2 * 5 + 3 * 1 + 4 * -5 + -6 * -8)
+		ASSERT_ALWAYS(a.comp_mul(b) == r4::vector4<float>(10, 3, -20, 48))
+		ASSERT_ALWAYS(a.comp_div(b) == r4::vector4<float>(2.0f / 5, 3, 4.0f / -5, 6.0f / 8))
+		ASSERT_ALWAYS(a.norm_pow2() == 4 + 9 + 16 + 36)
+		ASSERT_ALWAYS(min(a, b) == r4::vector4<float>(2, 1, -5, -8))
+		ASSERT_ALWAYS(max(a, b) == r4::vector4<float>(5, 3, 4, -6))
+	}
+
+	// test compile time evaluation, float operations are specialized when SIMD is available
+	{
+		constexpr r4::vector4<float> a{2, 3, 4, -6};
+		constexpr r4::vector4<float> b{5, 1, -5, -8};
+
+		constexpr auto sum = a + b;
+		static_assert(sum.x() == 7 && sum.y() == 4 && sum.z() == -1 && sum.w() == -14);
+
+		constexpr auto diff = (a - b) * 2.0f;
+		static_assert(diff.x() == -6 && diff.y() == 4 && diff.z() == 18 && diff.w() == 4);
+
+		constexpr auto quot = b / 2.0f;
+		static_assert(quot.x() == 2.5f && quot.y() == 0.5f && quot.z() == -2.5f && quot.w() == -4);
+
+		constexpr auto neg = -a;
+		static_assert(neg.x() == -2 && neg.y() == -3 && neg.z() == -4 && neg.w() == 6);
+
+		static_assert(a * b == 2 * 5 + 3 * 1 + 4 * -5 + -6 * -8);
+		static_assert(a.norm_pow2() == 4 + 9 + 16 + 36);
+
+		constexpr auto cm = a.comp_mul(b);
+		static_assert(cm.x() == 10 && cm.y() == 3 && cm.z() == -20 && cm.w() == 48);
+
+		constexpr auto mn = min(a, b);
+		static_assert(mn.x() == 2 && mn.y() == 1 && mn.z() == -5 && mn.w() == -8);
+
+		constexpr auto mx = max(a, b);
+		static_assert(mx.x() == 5 && mx.y() == 3 && mx.z() == 4 && mx.w() == -6);
+
+		constexpr r4::vector4<int> c = r4::vector4<int>{1, 2, 3, 4} + r4::vector4<int>{4, 3, 2, 1};
+		static_assert(c.x() == 5 && c.y() == 5 && c.z() == 5 && c.w() == 5);
+	}
+
+	// test that R4_ASSERT() and R4_ASSERT_INFO() are single statements, i.e. can be used in unbraced if-else
+	{
+		int n = 1;
+		int branch = 0;
+		if(n > 0)
+			R4_ASSERT(n > 0);
+		else
+			R4_ASSERT_INFO(n <= 0, "n = " << n);
+
+		if(n < 0)
+			R4_ASSERT(n < 0);
+		else
+			branch = 1;
+
+		ASSERT_ALWAYS(branch == 1)
+	}
+
 	return 0;
 }